@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+# Copyright (C) 2020 Zilliqa
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Throughput benchmark for the isolated server, using gentxn load:
+#
+#   gentxn --json --begin 0 --end 10       # writes to TXN_PATH
+#   isolated_server_bench.py accounts TXN_PATH accounts.json
+#   isolated_server -f accounts.json -t 1000 [-B 500]
+#   isolated_server_bench.py run TXN_PATH --url http://localhost:5555
+
+import argparse
+import glob
+import json
+import os
+import sys
+import threading
+import time
+from collections import defaultdict
+from urllib import request
+
+BALANCE = '1000000000000000000000'
+
+def load_txns(txn_path):
+	# gentxn --json writes <sender>_<first nonce>.json
+	senders = defaultdict(list)
+	for fileName in glob.glob(os.path.join(txn_path, '*.json')):
+		sender, begin = os.path.basename(fileName)[:-len('.json')].split('_')
+		senders[sender].append((int(begin), fileName))
+	txns = {}
+	for sender, files in senders.items():
+		txns[sender] = []
+		for _, fileName in sorted(files):
+			with open(fileName) as f:
+				txns[sender].extend(json.load(f))
+	return txns
+
+def call(url, method, params):
+	body = json.dumps({'id': '1', 'jsonrpc': '2.0', 'method': method, 'params': params})
+	req = request.Request(url, data=body.encode('ascii'), headers={'Content-Type': 'application/json'})
+	with request.urlopen(req) as resp:
+		return json.loads(resp.read().decode('ascii'))
+
+def write_accounts(args):
+	txns = load_txns(args.txn_path)
+	accounts = {sender: {'amount': BALANCE, 'nonce': 0} for sender in txns}
+	with open(args.accounts, 'w') as f:
+		json.dump(accounts, f, indent=2)
+	print('Wrote {} accounts to {}'.format(len(accounts), args.accounts))
+
+def run(args):
+	txns = load_txns(args.txn_path)
+	total = sum(len(t) for t in txns.values())
+	if total == 0:
+		print('No txns found in ' + args.txn_path)
+		return 1
+
+	errors = []
+	lastIds = []
+	lock = threading.Lock()
+
+	# Nonces of a sender must arrive in order, so there is one thread per sender
+	def send(senderTxns):
+		lastId = None
+		for txn in senderTxns:
+			resp = call(args.url, 'CreateTransaction', [txn])
+			if 'error' in resp:
+				with lock:
+					errors.append(resp['error'])
+				return
+			lastId = resp['result']['TranID']
+		with lock:
+			lastIds.append(lastId)
+
+	start = time.time()
+	threads = [threading.Thread(target=send, args=(t,)) for t in txns.values()]
+	for t in threads:
+		t.start()
+	for t in threads:
+		t.join()
+	sent = time.time() - start
+
+	# A sender's txns are all done once its last one can be fetched
+	deadline = time.time() + args.timeout
+	pending = list(lastIds)
+	while pending and time.time() < deadline:
+		pending = [i for i in pending if 'error' in call(args.url, 'GetTransaction', [i])]
+		if pending:
+			time.sleep(0.05)
+	done = time.time() - start
+
+	print('Senders: {}, txns: {}, errors: {}'.format(len(txns), total, len(errors)))
+	if errors:
+		print('First error: {}'.format(errors[0]))
+	print('Submitted in {:.2f} s ({:.0f} txns/s)'.format(sent, total / sent))
+	if pending:
+		print('{} senders still have unconfirmed txns after {} s'.format(len(pending), args.timeout))
+		return 1
+	print('Confirmed in {:.2f} s ({:.0f} txns/s)'.format(done, total / done))
+	return 1 if errors else 0
+
+def main():
+	parser = argparse.ArgumentParser(description='Isolated server throughput benchmark using gentxn --json load')
+	sub = parser.add_subparsers(dest='command')
+	accounts = sub.add_parser('accounts', help='write the bootstrap account file for the txn senders')
+	accounts.add_argument('txn_path')
+	accounts.add_argument('accounts')
+	bench = sub.add_parser('run', help='send the txns and wait until all are confirmed')
+	bench.add_argument('txn_path')
+	bench.add_argument('--url', default='http://localhost:5555')
+	bench.add_argument('--timeout', type=int, default=600, help='seconds to wait for confirmation')
+	args = parser.parse_args()
+
+	if args.command == 'accounts':
+		write_accounts(args)
+		return 0
+	if args.command == 'run':
+		return run(args)
+	parser.print_help()
+	return 1
+
+if __name__ == '__main__':
+	sys.exit(main())
@@ -23,6 +23,7 @@
 
 #include "libData/AccountData/TransactionReceipt.h"
 #include "libPersistence/BlockStorage.h"
+#include "libPersistence/TxnArchive.h"
 #include "libServer/JSONConversion.h"
 #include "libUtils/FileSystem.h"
 
@@ -45,7 +46,7 @@ string GetAwsS3CpString(const string& source, const string& dest) {
 
 int main(int argc, char* argv[]) {
   string bucketName, backupFolderName, jsonOutputPath;
-  bool saveToJsonFormat = false;
+  bool saveToJsonFormat = false, skipDownload = false;
   po::options_description desc("Options");
 
   desc.add_options()("help,h", "Print help messages")(
@@ -55,6 +56,8 @@ int main(int argc, char* argv[]) {
                         "backup folder name in S3")(
       "saveToJsonFormat,j", po::bool_switch(&saveToJsonFormat),
       "Save the txns in json format to file")(
+      "skipDownload,s", po::bool_switch(&skipDownload),
+      "Read the backup folder already in the current directory")(
       "jsonOutputPath,p",
       po::value<string>(&jsonOutputPath)
           ->default_value(bfs::current_path().string() + "/" +
@@ -80,9 +83,11 @@ int main(int argc, char* argv[]) {
     string localBackupPath =
         bfs::current_path().string() + "/" + backupFolderName;
     // Download from S3
-    if (!SysCommand::ExecuteCmd(
-            SysCommand::WITHOUT_OUTPUT,
-            GetAwsS3CpString(remoteS3Path, localBackupPath))) {
+    if (skipDownload) {
+      LOG_GENERAL(INFO, "Using local backup folder " << localBackupPath);
+    } else if (!SysCommand::ExecuteCmd(
+                   SysCommand::WITHOUT_OUTPUT,
+                   GetAwsS3CpString(remoteS3Path, localBackupPath))) {
       LOG_GENERAL(WARNING, "Failed to download backup folder from S3 : s3://"
                                << bucketName << "/" << backupFolderName);
       return ERROR_DOWNLOADING_BACKUP;
@@ -102,58 +107,59 @@ int main(int argc, char* argv[]) {
       }
     }
 
-    // Loop through all files in backupFolderName and store to leveldb
-    vector<string> listOfTxnFiles = getAllFilesInDir(localBackupPath);
-    for (const auto& txns_filename : listOfTxnFiles) {
-      ifstream infile;
-      LOG_GENERAL(INFO, "Parsing " << txns_filename << endl);
+    // Loop through all segments in backupFolderName and store to leveldb.
+    // Files uploaded before segments were introduced are read as well
+    LocalTxnArchiveBackend archive(localBackupPath);
+    vector<string> segmentNames;
+    archive.ListSegments(segmentNames);
+    for (const auto& segmentName : segmentNames) {
+      LOG_GENERAL(INFO, "Parsing " << segmentName << endl);
+      bytes segment;
+      ArchivedTxns txns;
+      if (!archive.GetSegment(segmentName, segment) ||
+          !TxnArchive::ReadSegmentOrLegacyTxns(segment, txns)) {
+        LOG_GENERAL(WARNING, "Failed to read segment - " << segmentName);
+        err = true;
+        continue;
+      }
+
+      // Segments are named txns_shard_<id>_txblk_<epoch>
+      uint64_t epochNum = 0;
       try {
-        // Now read back file to see if the TransactionWithReceipt is good
-        infile.open(txns_filename, ios::in | ios::binary);
-        TxnHash r_txn_hash;
-        bytes buff;
-
-        // Get the txnHash length and raw bytes of txnHash itself
-        size_t len;
-        // Loop through each txn in file
-        while (infile.read(reinterpret_cast<char*>(&len), sizeof(len))) {
-          infile.read(reinterpret_cast<char*>(&r_txn_hash), len);
-
-          // get the TxnReceipt length and raw bytes of TxnReceipt itself
-          infile.read(reinterpret_cast<char*>(&len), sizeof(len));
-          buff.clear();
-          buff.resize(len);
-          infile.read(reinterpret_cast<char*>(buff.data()), len);
-
-          // Deserialize the TxnReceipt bytes
-          TransactionWithReceipt r_tr;
-          r_tr.Deserialize(buff, 0);
-
-          if (r_tr.GetTransaction().GetTranID() != r_txn_hash) {
-            LOG_CHECK_FAIL("Txn Receipt Hash", r_txn_hash,
-                           r_tr.GetTransaction().GetTranID());
-            err = true;
-            continue;
-          }
-
-          BlockStorage::GetBlockStorage().PutTxBody(r_txn_hash, buff);
-          LOG_GENERAL(INFO, "Inserted Txn : " << r_txn_hash << endl);
-          if (saveToJsonFormat) {
-            Json::Value v = JSONConversion::convertTxtoJson(r_tr);
-
-            // create file with filename as "<<txnhash>>.json"
-            ofstream ofile(jsonOutputPath + "/" + r_txn_hash.hex() + ".json");
-            ofile << v.toStyledString();
-            ofile.close();
-          }
-        }
+        epochNum = stoull(segmentName.substr(segmentName.rfind('_') + 1));
       } catch (...) {
-        clog << boost::current_exception_diagnostic_information() << endl;
-        LOG_GENERAL(WARNING,
-                    "Exception while reading file - " << txns_filename << endl);
-        err = true;
+        LOG_GENERAL(WARNING, "No epoch in segment name - " << segmentName);
+      }
+
+      for (const auto& txn : txns) {
+        const auto& r_txn_hash = txn.first;
+        // Deserialize the TxnReceipt bytes
+        TransactionWithReceipt r_tr;
+        if (!r_tr.Deserialize(txn.second, 0)) {
+          LOG_GENERAL(WARNING, "Failed to deserialize txn " << r_txn_hash);
+          err = true;
+          continue;
+        }
+
+        if (r_tr.GetTransaction().GetTranID() != r_txn_hash) {
+          LOG_CHECK_FAIL("Txn Receipt Hash", r_txn_hash,
+                         r_tr.GetTransaction().GetTranID());
+          err = true;
+          continue;
+        }
+
+        BlockStorage::GetBlockStorage().PutTxBody(epochNum, r_txn_hash,
+                                                  txn.second);
+        LOG_GENERAL(INFO, "Inserted Txn : " << r_txn_hash << endl);
+        if (saveToJsonFormat) {
+          Json::Value v = JSONConversion::convertTxtoJson(r_tr);
+
+          // create file with filename as "<<txnhash>>.json"
+          ofstream ofile(jsonOutputPath + "/" + r_txn_hash.hex() + ".json");
+          ofile << v.toStyledString();
+          ofile.close();
+        }
       }
-      infile.close();
     }
   } catch (boost::program_options::required_option& e) {
     SWInfo::LogBrandBugReport();
@@ -23,12 +23,15 @@
 
 #include <boost/program_options.hpp>
 
+#include <json/json.h>
+
 #include <Schnorr.h>
 #include "libCrypto/Sha2.h"
 #include "libData/AccountData/Account.h"
 #include "libData/AccountData/Address.h"
 #include "libData/AccountData/Transaction.h"
 #include "libMessage/Messenger.h"
+#include "libServer/AddressChecksum.h"
 #include "libUtils/Logger.h"
 
 namespace po = boost::program_options;
@@ -124,6 +127,71 @@ void gen_txn_file(const std::string& prefix, const KeyPairAddress& from,
   }
 }
 
+// Same transactions as gen_txn_file, as CreateTransaction parameters
+void gen_txn_json_file(const std::string& prefix, const KeyPairAddress& from,
+                       const Address& toAddr, const NonceRange& nonce_range) {
+  const auto& privKey = std::get<0>(from);
+  const auto& pubKey = std::get<1>(from);
+  const auto& address = std::get<2>(from);
+
+  const auto& begin = std::get<0>(nonce_range);
+  const auto& end = std::get<1>(nonce_range);
+
+  std::ostringstream oss;
+  oss << prefix << "/" << address.hex() << "_" << begin << ".json";
+  std::string txn_filename(oss.str());
+
+  const auto toAddrStr = AddressChecksum::GetCheckSumedAddress(toAddr.hex());
+  std::string pubKeyStr;
+  if (!DataConversion::SerializableToHexStr(pubKey, pubKeyStr)) {
+    std::cout << "DataConversion::SerializableToHexStr failed." << std::endl;
+    return;
+  }
+
+  Json::Value txns = Json::arrayValue;
+  for (auto nonce = begin; nonce < end; nonce++) {
+    Transaction txn{DataConversion::Pack(CHAIN_ID, TRANSACTION_VERSION),
+                    nonce,
+                    toAddr,
+                    std::make_pair(privKey, pubKey),
+                    nonce,
+                    GAS_PRICE_MIN_VALUE,
+                    1,
+                    {},
+                    {}};
+
+    std::string signatureStr;
+    if (!DataConversion::SerializableToHexStr(txn.GetSignature(),
+                                              signatureStr)) {
+      std::cout << "DataConversion::SerializableToHexStr failed."
+                << std::endl;
+      return;
+    }
+
+    Json::Value _json;
+    _json["version"] = txn.GetVersion();
+    _json["nonce"] = Json::UInt64(txn.GetNonce());
+    _json["toAddr"] = toAddrStr;
+    _json["amount"] = txn.GetAmount().str();
+    _json["pubKey"] = pubKeyStr;
+    _json["gasPrice"] = txn.GetGasPrice().str();
+    _json["gasLimit"] = std::to_string(txn.GetGasLimit());
+    _json["code"] = "";
+    _json["data"] = "";
+    _json["signature"] = signatureStr;
+    txns.append(_json);
+  }
+
+  std::ofstream txn_file(txn_filename);
+  txn_file << Json::FastWriter().write(txns);
+
+  if (txn_file) {
+    std::cout << "Write to file " << txn_filename << "\n";
+  } else {
+    std::cerr << "Error writing to file " << txn_filename << "\n";
+  }
+}
+
 using namespace std;
 
 void description() {
@@ -136,12 +204,15 @@ void description() {
          "to one random wallet\n";
   std::cout << "\tThe batch size is decided by NUM_TXN_TO_SEND_PER_ACCOUNT "
                "(constants.xml)\n";
+  std::cout << "\tWith --json, the transactions are written as "
+               "CreateTransaction parameters instead\n";
 }
 
 int main(int argc, char** argv) {
   try {
     const unsigned long delta = 10000;
     unsigned long begin = 0, end;
+    bool json = false;
 
     po::options_description desc("Options");
 
@@ -150,7 +221,9 @@ int main(int argc, char** argv) {
         "Start of transaction batch (default to 0)")(
         "end, e", po::value<unsigned long>(&end),
         "End of transaction batch (default to parameter value --begin + "
-        "10000)");
+        "10000)")("json,j", po::bool_switch(&json),
+                  "Write JSON for CreateTransaction (e.g. for the isolated "
+                  "server) instead of binary");
 
     po::variables_map vm;
     try {
@@ -211,7 +284,11 @@ int main(int argc, char** argv) {
       auto nonce_range = std::make_tuple(begin_nonce, end_nonce);
 
       for (auto& from : fromAccounts) {
-        gen_txn_file(txn_path, from, toAddr, nonce_range);
+        if (json) {
+          gen_txn_json_file(txn_path, from, toAddr, nonce_range);
+        } else {
+          gen_txn_file(txn_path, from, toAddr, nonce_range);
+        }
       }
     }
 
@@ -76,6 +76,7 @@ int main(int argc, const char* argv[]) {
   uint port{5555};
   string blocknum_str{"1"};
   uint timeDelta{0};
+  uint batchSize{0};
   bool loadPersistence{false};
   try {
     po::options_description desc("Options");
@@ -90,6 +91,9 @@ int main(int argc, const char* argv[]) {
         "time,t", po::value<uint>(&timeDelta),
         "the automatic blocktime for incrementing block number (in ms)  "
         "(Disabled by default)")(
+        "batch,B", po::value<uint>(&batchSize),
+        "queue txns and apply them once per block, or once this many are "
+        "queued; requires --time (Disabled by default)")(
         "load,l", po::bool_switch()->default_value(false),
         "Load from persistence folder (False by default)");
 
@@ -164,8 +168,11 @@ int main(int argc, const char* argv[]) {
       }
     }
     auto isolatedServerConnector = make_unique<jsonrpc::SafeHttpServer>(port);
+    if (batchSize > 0 && timeDelta == 0) {
+      LOG_GENERAL(WARNING, "Batching requires time-trigger mode, ignored");
+    }
     auto isolatedServer = make_shared<IsolatedServer>(
-        mediator, *isolatedServerConnector, blocknum, timeDelta);
+        mediator, *isolatedServerConnector, blocknum, timeDelta, batchSize);
 
     if (loadPersistence) {
       LOG_GENERAL(INFO, "Trying to load persistence.. ");
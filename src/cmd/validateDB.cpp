@@ -23,6 +23,8 @@
 
 /// Should be run from a folder with dsnodes.xml and constants.xml and a folder
 /// named "persistence" consisting of the persistence
+/// Tx block progress is checkpointed to validateDB.checkpoint in the same
+/// folder so an interrupted run resumes; delete it to validate from scratch
 
 using namespace std;
 int main() {
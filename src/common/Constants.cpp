@@ -90,6 +90,8 @@ const string GENESIS_PUBKEY{
 const unsigned int UPGRADE_TARGET_DS_NUM{
     ReadConstantNumeric("UPGRADE_TARGET_DS_NUM")};
 const string STORAGE_PATH{ReadConstantString("STORAGE_PATH", "node.general.")};
+const unsigned int SCHEDULER_WORKER_THREADS{
+    ReadConstantNumeric("SCHEDULER_WORKER_THREADS", "node.general.")};
 
 // Version constants
 const unsigned int MSG_VERSION{
@@ -116,6 +118,8 @@ const unsigned int ACCOUNT_VERSION{
     ReadConstantNumeric("ACCOUNT_VERSION", "node.version.")};
 const unsigned int CONTRACT_STATE_VERSION{
     ReadConstantNumeric("CONTRACT_STATE_VERSION", "node.version.")};
+const unsigned int STATE_DELTA_VERSION{
+    ReadConstantNumeric("STATE_DELTA_VERSION", "node.version.")};
 
 // Seed constans
 const bool ARCHIVAL_LOOKUP{
@@ -145,6 +149,18 @@ const string REMOTESTORAGE_DB_TLS_FILE{
 bool REMOTESTORAGE_DB_ENABLE{
     ReadConstantString("REMOTESTORAGE_DB_ENABLE", "node.remotestorageDB.") ==
     "true"};
+const unsigned int REMOTESTORAGE_DB_QUEUE_SIZE{ReadConstantNumeric(
+    "REMOTESTORAGE_DB_QUEUE_SIZE", "node.remotestorageDB.")};
+const unsigned int REMOTESTORAGE_DB_BATCH_SIZE{ReadConstantNumeric(
+    "REMOTESTORAGE_DB_BATCH_SIZE", "node.remotestorageDB.")};
+const unsigned int REMOTESTORAGE_DB_BATCH_INTERVAL_MS{ReadConstantNumeric(
+    "REMOTESTORAGE_DB_BATCH_INTERVAL_MS", "node.remotestorageDB.")};
+const string REMOTESTORAGE_DB_OVERFLOW_POLICY{ReadConstantString(
+    "REMOTESTORAGE_DB_OVERFLOW_POLICY", "node.remotestorageDB.")};
+const unsigned int REMOTESTORAGE_DB_MAX_RETRIES{ReadConstantNumeric(
+    "REMOTESTORAGE_DB_MAX_RETRIES", "node.remotestorageDB.")};
+const unsigned int REMOTESTORAGE_DB_RETRY_BACKOFF_MS{ReadConstantNumeric(
+    "REMOTESTORAGE_DB_RETRY_BACKOFF_MS", "node.remotestorageDB.")};
 
 // Consensus constants
 const double TOLERANCE_FRACTION{
@@ -353,6 +369,10 @@ const bool ENABLE_STAKING_RPC{
     ReadConstantString("ENABLE_STAKING_RPC", "node.jsonrpc.") == "true"};
 const bool ENABLE_STATUS_RPC{
     ReadConstantString("ENABLE_STATUS_RPC", "node.jsonrpc.") == "true"};
+const bool ENABLE_METRICS_HTTP{
+    ReadConstantString("ENABLE_METRICS_HTTP", "node.jsonrpc.") == "true"};
+const unsigned int METRICS_HTTP_PORT{
+    ReadConstantNumeric("METRICS_HTTP_PORT", "node.jsonrpc.")};
 const unsigned int NUM_SHARD_PEER_TO_REVEAL{
     ReadConstantNumeric("NUM_SHARD_PEER_TO_REVEAL", "node.jsonrpc.")};
 const std::string SCILLA_IPC_SOCKET_PATH{
@@ -368,6 +388,24 @@ const unsigned int WEBSOCKET_PORT{
 const bool ENABLE_GETTXNBODIESFORTXBLOCK{
     ReadConstantString("ENABLE_GETTXNBODIESFORTXBLOCK", "node.jsonrpc.") ==
     "true"};
+const unsigned int RPC_RESPONSE_CACHE_SIZE{
+    ReadConstantNumeric("RPC_RESPONSE_CACHE_SIZE", "node.jsonrpc.")};
+const unsigned int RPC_CONNECTION_TIMEOUT_IN_SECONDS{
+    ReadConstantNumeric("RPC_CONNECTION_TIMEOUT_IN_SECONDS", "node.jsonrpc.")};
+const unsigned int RPC_MAX_CONNECTIONS{
+    ReadConstantNumeric("RPC_MAX_CONNECTIONS", "node.jsonrpc.")};
+const unsigned int RPC_MAX_BATCH_SIZE{
+    ReadConstantNumeric("RPC_MAX_BATCH_SIZE", "node.jsonrpc.")};
+const unsigned int RPC_BATCH_THREADS{
+    ReadConstantNumeric("RPC_BATCH_THREADS", "node.jsonrpc.")};
+const unsigned int RPC_HEAVY_METHOD_MAX_RUNNING{
+    ReadConstantNumeric("RPC_HEAVY_METHOD_MAX_RUNNING", "node.jsonrpc.")};
+const unsigned int RPC_HEAVY_METHOD_MAX_QUEUED{
+    ReadConstantNumeric("RPC_HEAVY_METHOD_MAX_QUEUED", "node.jsonrpc.")};
+const unsigned int RPC_HEAVY_METHOD_BUDGET{
+    ReadConstantNumeric("RPC_HEAVY_METHOD_BUDGET", "node.jsonrpc.")};
+const unsigned int RPC_ADMISSION_TIMEOUT_IN_MS{
+    ReadConstantNumeric("RPC_ADMISSION_TIMEOUT_IN_MS", "node.jsonrpc.")};
 const unsigned int NUM_TTL_PENDING_TXN{
     ReadConstantNumeric("NUM_TTL_PENDING_TXN", "node.jsonrpc.pending_txn.")};
 const unsigned int NUM_TTL_DROPPED_TXN{
@@ -428,6 +466,10 @@ const bool CUDA_GPU_MINE{ReadConstantString("CUDA_GPU_MINE", "node.pow.") ==
                          "true"};
 const bool FULL_DATASET_MINE{
     ReadConstantString("FULL_DATASET_MINE", "node.pow.") == "true"};
+const unsigned int CPU_MINE_THREADS{
+    ReadConstantNumeric("CPU_MINE_THREADS", "node.pow.")};
+const bool CPU_MINE_AFFINITY{
+    ReadConstantString("CPU_MINE_AFFINITY", "node.pow.") == "true"};
 const bool OPENCL_GPU_MINE{ReadConstantString("OPENCL_GPU_MINE", "node.pow.") ==
                            "true"};
 const bool REMOTE_MINE{ReadConstantString("REMOTE_MINE", "node.pow.") ==
@@ -454,6 +496,10 @@ const unsigned int POW_BOUNDARY_N_DIVIDED_START{
     ReadConstantNumeric("POW_BOUNDARY_N_DIVIDED_START", "node.pow.")};
 const unsigned int POW_SUBMISSION_LIMIT{
     ReadConstantNumeric("POW_SUBMISSION_LIMIT", "node.pow.")};
+const unsigned int POW_VERIFY_THREADS{
+    ReadConstantNumeric("POW_VERIFY_THREADS", "node.pow.")};
+const unsigned int POW_VERIFY_QUEUE_SIZE{
+    ReadConstantNumeric("POW_VERIFY_QUEUE_SIZE", "node.pow.")};
 const unsigned int NUM_FINAL_BLOCK_PER_POW{
     ReadConstantNumeric("NUM_FINAL_BLOCK_PER_POW", "node.pow.")};
 const unsigned int POW_CHANGE_TO_ADJ_DIFF{
@@ -607,6 +653,14 @@ const unsigned int SYS_TIMESTAMP_VARIANCE_IN_SECONDS{ReadConstantNumeric(
     "SYS_TIMESTAMP_VARIANCE_IN_SECONDS", "node.transactions.")};
 const unsigned int TXN_MISORDER_TOLERANCE_IN_PERCENT{ReadConstantNumeric(
     "TXN_MISORDER_TOLERANCE_IN_PERCENT", "node.transactions.")};
+const bool ENABLE_LEADER_TXN_ORDER_REPLAY{
+    ReadConstantString("ENABLE_LEADER_TXN_ORDER_REPLAY",
+                       "node.transactions.") == "true"};
+const unsigned int LEADER_TXN_ORDER_BATCH_SIZE{
+    ReadConstantNumeric("LEADER_TXN_ORDER_BATCH_SIZE", "node.transactions.")};
+const bool ENABLE_COMPACT_TXN_RELAY{
+    ReadConstantString("ENABLE_COMPACT_TXN_RELAY", "node.transactions.") ==
+    "true"};
 const unsigned int PACKET_EPOCH_LATE_ALLOW{
     ReadConstantNumeric("PACKET_EPOCH_LATE_ALLOW", "node.transactions.")};
 const unsigned int PACKET_BYTESIZE_LIMIT{
@@ -633,6 +687,20 @@ const bool ENABLE_TXNS_BACKUP{
 const bool SHARDLDR_SAVE_TXN_LOCALLY{
     ReadConstantString("SHARDLDR_SAVE_TXN_LOCALLY", "node.transactions.") ==
     "true"};
+const string TXN_ARCHIVE_BACKEND{
+    ReadConstantString("TXN_ARCHIVE_BACKEND", "node.transactions.")};
+const string TXN_ARCHIVE_PATH{
+    ReadConstantString("TXN_ARCHIVE_PATH", "node.transactions.")};
+const unsigned int TXN_ARCHIVE_QUEUE_SIZE{
+    ReadConstantNumeric("TXN_ARCHIVE_QUEUE_SIZE", "node.transactions.")};
+const bool TXBODY_SEGMENT_STORE{
+    ReadConstantString("TXBODY_SEGMENT_STORE", "node.transactions.") == "true"};
+const unsigned int TXBODY_SEGMENT_SIZE{
+    ReadConstantNumeric("TXBODY_SEGMENT_SIZE", "node.transactions.")};
+const unsigned int TXBODY_SEGMENT_RETAIN_EPOCHS{
+    ReadConstantNumeric("TXBODY_SEGMENT_RETAIN_EPOCHS", "node.transactions.")};
+const string TXBODY_SEGMENT_ARCHIVE_PATH{
+    ReadConstantString("TXBODY_SEGMENT_ARCHIVE_PATH", "node.transactions.")};
 const double BLOOM_FILTER_FALSE_RATE{
     ReadConstantDouble("BLOOM_FILTER_FALSE_RATE", "node.transactions.")};
 
@@ -65,6 +65,11 @@ const unsigned int INIT_DS_EPOCH_NUM = 2;
 
 const unsigned int MAINNET_CHAIN_ID = 1;
 
+// State delta layouts (STATE_DELTA_VERSION)
+// 1: single ProtoAccountStore message
+// 2: length-prefixed per-account records (see libMessage/StateDeltaStream.h)
+const unsigned int STATE_DELTA_VERSION_STREAM = 2;
+
 // Testing parameters
 
 // Metadata type
@@ -134,6 +139,7 @@ extern const uint16_t CHAIN_ID;
 extern const std::string GENESIS_PUBKEY;
 extern const unsigned int UPGRADE_TARGET_DS_NUM;
 extern const std::string STORAGE_PATH;
+extern const unsigned int SCHEDULER_WORKER_THREADS;
 
 // Version constants
 extern const unsigned int MSG_VERSION;
@@ -148,6 +154,7 @@ extern const unsigned int DSCOMMITTEE_VERSION;
 extern const unsigned int SHARDINGSTRUCTURE_VERSION;
 extern const unsigned int ACCOUNT_VERSION;
 extern const unsigned int CONTRACT_STATE_VERSION;
+extern const unsigned int STATE_DELTA_VERSION;
 
 // Seed Node
 extern const bool ARCHIVAL_LOOKUP;
@@ -164,6 +171,12 @@ extern const unsigned int REMOTESTORAGE_DB_PORT;
 extern const unsigned int REMOTESTORAGE_DB_SERVER_SELECTION_TIMEOUT_MS;
 extern const std::string REMOTESTORAGE_DB_TLS_FILE;
 extern bool REMOTESTORAGE_DB_ENABLE;
+extern const unsigned int REMOTESTORAGE_DB_QUEUE_SIZE;
+extern const unsigned int REMOTESTORAGE_DB_BATCH_SIZE;
+extern const unsigned int REMOTESTORAGE_DB_BATCH_INTERVAL_MS;
+extern const std::string REMOTESTORAGE_DB_OVERFLOW_POLICY;
+extern const unsigned int REMOTESTORAGE_DB_MAX_RETRIES;
+extern const unsigned int REMOTESTORAGE_DB_RETRY_BACKOFF_MS;
 
 // Consensus constants
 extern const double TOLERANCE_FRACTION;
@@ -279,6 +292,8 @@ extern const unsigned int STATUS_RPC_PORT;
 extern const std::string IP_TO_BIND;  // Only for non-lookup nodes
 extern const bool ENABLE_STAKING_RPC;
 extern const bool ENABLE_STATUS_RPC;
+extern const bool ENABLE_METRICS_HTTP;
+extern const unsigned int METRICS_HTTP_PORT;
 extern const unsigned int NUM_SHARD_PEER_TO_REVEAL;
 extern const std::string SCILLA_IPC_SOCKET_PATH;
 extern const std::string SCILLA_SERVER_SOCKET_PATH;
@@ -286,6 +301,15 @@ extern const std::string SCILLA_SERVER_BINARY;
 extern bool ENABLE_WEBSOCKET;
 extern const unsigned int WEBSOCKET_PORT;
 extern const bool ENABLE_GETTXNBODIESFORTXBLOCK;
+extern const unsigned int RPC_RESPONSE_CACHE_SIZE;
+extern const unsigned int RPC_CONNECTION_TIMEOUT_IN_SECONDS;
+extern const unsigned int RPC_MAX_CONNECTIONS;
+extern const unsigned int RPC_MAX_BATCH_SIZE;
+extern const unsigned int RPC_BATCH_THREADS;
+extern const unsigned int RPC_HEAVY_METHOD_MAX_RUNNING;
+extern const unsigned int RPC_HEAVY_METHOD_MAX_QUEUED;
+extern const unsigned int RPC_HEAVY_METHOD_BUDGET;
+extern const unsigned int RPC_ADMISSION_TIMEOUT_IN_MS;
 extern const unsigned int NUM_TTL_PENDING_TXN;
 extern const unsigned int NUM_TTL_DROPPED_TXN;
 
@@ -319,6 +343,8 @@ extern const unsigned int SENDJOBPEERS_TIMEOUT;
 // PoW constants
 extern const bool CUDA_GPU_MINE;
 extern const bool FULL_DATASET_MINE;
+extern const unsigned int CPU_MINE_THREADS;
+extern const bool CPU_MINE_AFFINITY;
 extern const bool OPENCL_GPU_MINE;
 extern const bool REMOTE_MINE;
 extern const std::string MINING_PROXY_URL;
@@ -332,6 +358,8 @@ extern const unsigned int POW_DIFFICULTY;
 extern const unsigned int POW_BOUNDARY_N_DIVIDED;
 extern const unsigned int POW_BOUNDARY_N_DIVIDED_START;
 extern const unsigned int POW_SUBMISSION_LIMIT;
+extern const unsigned int POW_VERIFY_THREADS;
+extern const unsigned int POW_VERIFY_QUEUE_SIZE;
 extern const unsigned int NUM_FINAL_BLOCK_PER_POW;
 extern const unsigned int POW_CHANGE_TO_ADJ_DIFF;
 extern const unsigned int POW_CHANGE_TO_ADJ_DS_DIFF;
@@ -414,6 +442,9 @@ extern const unsigned int SCILLA_CHECKER_INVOKE_GAS;
 extern const unsigned int SCILLA_RUNNER_INVOKE_GAS;
 extern const unsigned int SYS_TIMESTAMP_VARIANCE_IN_SECONDS;
 extern const unsigned int TXN_MISORDER_TOLERANCE_IN_PERCENT;
+extern const bool ENABLE_LEADER_TXN_ORDER_REPLAY;
+extern const unsigned int LEADER_TXN_ORDER_BATCH_SIZE;
+extern const bool ENABLE_COMPACT_TXN_RELAY;
 extern const unsigned int PACKET_EPOCH_LATE_ALLOW;
 extern const unsigned int PACKET_BYTESIZE_LIMIT;
 extern const unsigned int SMALL_TXN_SIZE;
@@ -426,6 +457,13 @@ extern const std::string BUCKET_NAME;
 extern const std::string TXN_PERSISTENCE_NAME;
 extern const bool ENABLE_TXNS_BACKUP;
 extern const bool SHARDLDR_SAVE_TXN_LOCALLY;
+extern const std::string TXN_ARCHIVE_BACKEND;
+extern const std::string TXN_ARCHIVE_PATH;
+extern const unsigned int TXN_ARCHIVE_QUEUE_SIZE;
+extern const bool TXBODY_SEGMENT_STORE;
+extern const unsigned int TXBODY_SEGMENT_SIZE;
+extern const unsigned int TXBODY_SEGMENT_RETAIN_EPOCHS;
+extern const std::string TXBODY_SEGMENT_ARCHIVE_PATH;
 extern const double BLOOM_FILTER_FALSE_RATE;
 
 // Viewchange constants
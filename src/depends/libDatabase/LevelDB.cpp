@@ -24,6 +24,7 @@
 #include "depends/common/Common.h"
 #include "depends/common/CommonData.h"
 #include "depends/common/FixedHash.h"
+#include "libUtils/Metrics.h"
 
 using namespace std;
 
@@ -32,6 +33,7 @@ LevelDB::LevelDB(const string& dbName, const string& path, const string& subdire
 {
     this->m_subdirectory = subdirectory;
     this->m_dbName = dbName;
+    InitMetrics();
     this->m_db = NULL;
 
     if(!(boost::filesystem::exists(path)))
@@ -77,6 +79,7 @@ LevelDB::LevelDB(const std::string & dbName, const std::string& subdirectory, bo
 {
     this->m_subdirectory = subdirectory;
     this->m_dbName = dbName;
+    InitMetrics();
 
     m_options.max_open_files = 256;
     m_options.create_if_missing = true;
@@ -105,6 +108,15 @@ LevelDB::LevelDB(const std::string & dbName, const std::string& subdirectory, bo
     m_db.reset(db);
 }
 
+void LevelDB::InitMetrics()
+{
+    const string labels = "db=\"" + m_dbName + "\"";
+    auto& metrics = Metrics::GetInstance();
+    m_getLatency = &metrics.GetHistogram("zilliqa_db_get_us", labels);
+    m_putLatency = &metrics.GetHistogram("zilliqa_db_put_us", labels);
+    m_batchLatency = &metrics.GetHistogram("zilliqa_db_batch_us", labels);
+}
+
 void LevelDB::Reopen() {
     LOG_MARKER();
     m_db.reset();
@@ -141,6 +153,7 @@ string LevelDB::GetDBName()
 
 string LevelDB::Lookup(const std::string & key) const
 {
+    Metrics::ScopedTimer timer(*m_getLatency);
     string value;
     leveldb::Status s = m_db->Get(leveldb::ReadOptions(), key, &value);
     if (!s.ok())
@@ -154,6 +167,7 @@ string LevelDB::Lookup(const std::string & key) const
 
 string LevelDB::Lookup(const boost::multiprecision::uint256_t & blockNum) const
 {
+    Metrics::ScopedTimer timer(*m_getLatency);
     string value;
     leveldb::Status s = m_db->Get(leveldb::ReadOptions(), blockNum.convert_to<string>(), &value);
 
@@ -168,6 +182,7 @@ string LevelDB::Lookup(const boost::multiprecision::uint256_t & blockNum) const
 
 string LevelDB::Lookup(const boost::multiprecision::uint256_t & blockNum, bool &found) const
 {
+    Metrics::ScopedTimer timer(*m_getLatency);
     string value;
     leveldb::Status s = m_db->Get(leveldb::ReadOptions(), blockNum.convert_to<string>(), &value);
 
@@ -182,6 +197,7 @@ string LevelDB::Lookup(const boost::multiprecision::uint256_t & blockNum, bool &
 
 string LevelDB::Lookup(const dev::h256 & key) const
 {
+    Metrics::ScopedTimer timer(*m_getLatency);
     string value;
     leveldb::Status s = m_db->Get(leveldb::ReadOptions(), leveldb::Slice(key.hex()), &value);
     if (!s.ok())
@@ -195,6 +211,7 @@ string LevelDB::Lookup(const dev::h256 & key) const
 
 string LevelDB::Lookup(const dev::bytesConstRef & key) const
 {
+    Metrics::ScopedTimer timer(*m_getLatency);
     string value;
     leveldb::Status s = m_db->Get(leveldb::ReadOptions(), ldb::Slice((char const*)key.data(), 32),
                                   &value);
@@ -220,6 +237,7 @@ int LevelDB::Insert(const dev::h256 & key, dev::bytesConstRef value)
 int LevelDB::Insert(const boost::multiprecision::uint256_t & blockNum,
                     const vector<unsigned char> & body)
 {
+    Metrics::ScopedTimer timer(*m_putLatency);
     leveldb::Status s = m_db->Put(leveldb::WriteOptions(),
                                   leveldb::Slice(blockNum.convert_to<string>()),
                                   leveldb::Slice(vector_ref<const unsigned char>(&body[0],
@@ -237,6 +255,7 @@ int LevelDB::Insert(const boost::multiprecision::uint256_t & blockNum,
 int LevelDB::Insert(const boost::multiprecision::uint256_t & blockNum,
                     const std::string & body)
 {
+    Metrics::ScopedTimer timer(*m_putLatency);
     leveldb::Status s = m_db->Put(leveldb::WriteOptions(),
                                   leveldb::Slice(blockNum.convert_to<string>()),
                                   leveldb::Slice(body.c_str(), body.size()));
@@ -257,6 +276,7 @@ int LevelDB::Insert(const string & key, const vector<unsigned char> & body)
 
 int LevelDB::Insert(const leveldb::Slice & key, dev::bytesConstRef value)
 {
+    Metrics::ScopedTimer timer(*m_putLatency);
     leveldb::Status s = m_db->Put(leveldb::WriteOptions(), key, ldb::Slice(value));
     if (!s.ok())
     {
@@ -269,6 +289,7 @@ int LevelDB::Insert(const leveldb::Slice & key, dev::bytesConstRef value)
 
 int LevelDB::Insert(const dev::h256 & key, const string & value)
 {
+    Metrics::ScopedTimer timer(*m_putLatency);
     leveldb::Status s = m_db->Put(leveldb::WriteOptions(),
                                   ldb::Slice((char const*)key.data(), key.size),
                                   ldb::Slice(value.data(), value.size()));
@@ -283,6 +304,7 @@ int LevelDB::Insert(const dev::h256 & key, const string & value)
 
 int LevelDB::Insert(const dev::h256 & key, const vector<unsigned char> & body)
 {
+    Metrics::ScopedTimer timer(*m_putLatency);
     leveldb::Status s = m_db->Put(leveldb::WriteOptions(), leveldb::Slice(key.hex()),
                                   leveldb::Slice(vector_ref<const unsigned char>(&body[0],
                                                                                  body.size())));
@@ -297,6 +319,7 @@ int LevelDB::Insert(const dev::h256 & key, const vector<unsigned char> & body)
 
 int LevelDB::Insert(const leveldb::Slice & key, const leveldb::Slice & value)
 {
+    Metrics::ScopedTimer timer(*m_putLatency);
     leveldb::Status s = m_db->Put(leveldb::WriteOptions(), key, value);
     
     if (!s.ok())
@@ -311,6 +334,7 @@ int LevelDB::Insert(const leveldb::Slice & key, const leveldb::Slice & value)
 bool LevelDB::BatchInsert(const std::unordered_map<dev::h256, std::pair<std::string, unsigned>> & m_main,
                           const std::unordered_map<dev::h256, std::pair<dev::bytes, bool>> & m_aux)
 {
+    Metrics::ScopedTimer timer(*m_batchLatency);
     ldb::WriteBatch batch;
 
     for (const auto & i: m_main) {
@@ -341,6 +365,7 @@ bool LevelDB::BatchInsert(const std::unordered_map<dev::h256, std::pair<std::str
 
 bool LevelDB::BatchInsert(const std::unordered_map<std::string, std::string>& kv_map)
 {
+    Metrics::ScopedTimer timer(*m_batchLatency);
     ldb::WriteBatch batch;
 
     for (const auto & i: kv_map) {
@@ -361,6 +386,7 @@ bool LevelDB::BatchInsert(const std::unordered_map<std::string, std::string>& kv
 }
 
 bool LevelDB::BatchDelete(const std::vector<dev::h256>& toDelete) {
+    Metrics::ScopedTimer timer(*m_batchLatency);
     ldb::WriteBatch batch;
     for (const auto& i : toDelete) {
         batch.Delete(leveldb::Slice(i.hex()));
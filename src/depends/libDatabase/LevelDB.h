@@ -28,6 +28,7 @@
 
 #include "depends/common/Common.h"
 #include "depends/common/FixedHash.h"
+#include "libUtils/Metrics.h"
 //#include "libUtils/Logger.h"
 
 leveldb::Slice toSlice(boost::multiprecision::uint256_t num);
@@ -45,6 +46,13 @@ class LevelDB
 
     std::string m_open_db_path;
 
+    /// Operation latencies, labelled with the database name.
+    Metrics::Histogram* m_getLatency;
+    Metrics::Histogram* m_putLatency;
+    Metrics::Histogram* m_batchLatency;
+
+    void InitMetrics();
+
 public:
 
     /// Constructor.
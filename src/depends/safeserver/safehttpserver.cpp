@@ -27,10 +27,12 @@ struct mhd_coninfo {
         int code;
 };
 
-SafeHttpServer::SafeHttpServer(int port, const std::string &sslcert, const std::string &sslkey, int threads) :
+SafeHttpServer::SafeHttpServer(int port, const std::string &sslcert, const std::string &sslkey, int threads, unsigned int connectionTimeout, unsigned int connectionLimit) :
     AbstractServerConnector(),
     port(port),
     threads(threads),
+    connectionTimeout(connectionTimeout),
+    connectionLimit(connectionLimit),
     running(false),
     path_sslcert(sslcert),
     path_sslkey(sslkey),
@@ -52,13 +54,21 @@ bool SafeHttpServer::StartListening()
 {
     if(!this->running)
     {
+        // Idle keep-alive connections are closed after connectionTimeout, so
+        // that they do not hold on to the connection limit. A zero limit
+        // ends the array early and keeps the MHD default.
+        struct MHD_OptionItem connectionOptions[] = {
+            {MHD_OPTION_CONNECTION_TIMEOUT, this->connectionTimeout, NULL},
+            {this->connectionLimit > 0 ? MHD_OPTION_CONNECTION_LIMIT : MHD_OPTION_END, this->connectionLimit, NULL},
+            {MHD_OPTION_END, 0, NULL}};
+
         if (this->path_sslcert != "" && this->path_sslkey != "")
         {
             try {
                 SpecificationParser::GetFileContent(this->path_sslcert, this->sslcert);
                 SpecificationParser::GetFileContent(this->path_sslkey, this->sslkey);
 
-                this->daemon = MHD_start_daemon(MHD_USE_SSL | MHD_USE_SELECT_INTERNALLY, this->port, NULL, NULL, SafeHttpServer::callback, this, MHD_OPTION_HTTPS_MEM_KEY, this->sslkey.c_str(), MHD_OPTION_HTTPS_MEM_CERT, this->sslcert.c_str(), MHD_OPTION_THREAD_POOL_SIZE, this->threads, MHD_OPTION_END);
+                this->daemon = MHD_start_daemon(MHD_USE_SSL | MHD_USE_SELECT_INTERNALLY, this->port, NULL, NULL, SafeHttpServer::callback, this, MHD_OPTION_HTTPS_MEM_KEY, this->sslkey.c_str(), MHD_OPTION_HTTPS_MEM_CERT, this->sslcert.c_str(), MHD_OPTION_THREAD_POOL_SIZE, this->threads, MHD_OPTION_ARRAY, connectionOptions, MHD_OPTION_END);
             }
             catch (JsonRpcException& ex)
             {
@@ -67,7 +77,7 @@ bool SafeHttpServer::StartListening()
         }
         else
         {
-            this->daemon = MHD_start_daemon(MHD_USE_SELECT_INTERNALLY, this->port, NULL, NULL, SafeHttpServer::callback, this,   MHD_OPTION_THREAD_POOL_SIZE, this->threads, MHD_OPTION_END);
+            this->daemon = MHD_start_daemon(MHD_USE_SELECT_INTERNALLY, this->port, NULL, NULL, SafeHttpServer::callback, this, MHD_OPTION_THREAD_POOL_SIZE, this->threads, MHD_OPTION_ARRAY, connectionOptions, MHD_OPTION_END);
         }
         if (this->daemon != NULL)
             this->running = true;
@@ -120,6 +130,23 @@ void SafeHttpServer::SetUrlHandler(const string &url, IClientConnectionHandler *
     this->SetHandler(NULL);
 }
 
+void SafeHttpServer::SetTextHandler(const string &url, const std::function<std::string()> &handler)
+{
+    this->texthandler[url] = handler;
+}
+
+bool SafeHttpServer::SendTextResponse(const string& response, void* addInfo)
+{
+    struct mhd_coninfo* client_connection = static_cast<struct mhd_coninfo*>(addInfo);
+    struct MHD_Response *result = MHD_create_response_from_buffer(response.size(),(void *) response.c_str(), MHD_RESPMEM_MUST_COPY);
+
+    MHD_add_response_header(result, "Content-Type", "text/plain; version=0.0.4");
+
+    int ret = MHD_queue_response(client_connection->connection, client_connection->code, result);
+    MHD_destroy_response(result);
+    return ret == MHD_YES;
+}
+
 int SafeHttpServer::callback(void *cls, MHD_Connection *connection, const char *url, const char *method, const char *version, const char *upload_data, size_t *upload_data_size, void **con_cls)
 {
     (void)version;
@@ -157,6 +184,11 @@ int SafeHttpServer::callback(void *cls, MHD_Connection *connection, const char *
                 client_connection->server->SendResponse(response, client_connection);
             }
         }
+    }
+    else if (string("GET") == method && client_connection->server->texthandler.count(url) > 0)
+    {
+        client_connection->code = MHD_HTTP_OK;
+        client_connection->server->SendTextResponse(client_connection->server->texthandler.at(url)(), client_connection);
     }
 	else if (string("OPTIONS") == method) {
         client_connection->code = MHD_HTTP_OK;
@@ -25,6 +25,7 @@ typedef intptr_t ssize_t;
 #include <sys/socket.h>
 #endif
 
+#include <functional>
 #include <map>
 #include <microhttpd.h>
 #include "jsonrpccpp/server/abstractserverconnector.h"
@@ -46,8 +47,10 @@ namespace jsonrpc
              * @param port on which the server is listening
              * @param enableSpecification - defines if the specification is returned in case of a GET request
              * @param sslcert - defines the path to a SSL certificate, if this path is != "", then SSL/HTTPS is used with the given certificate.
+             * @param connectionTimeout - seconds after which an idle (keep-alive) connection is closed, 0 for no timeout
+             * @param connectionLimit - maximum number of concurrent connections, 0 for the libmicrohttpd default
              */
-            SafeHttpServer(int port, const std::string& sslcert = "", const std::string& sslkey = "", int threads = 50);
+            SafeHttpServer(int port, const std::string& sslcert = "", const std::string& sslkey = "", int threads = 50, unsigned int connectionTimeout = 0, unsigned int connectionLimit = 0);
 
             virtual bool StartListening();
             virtual bool StopListening();
@@ -58,9 +61,16 @@ namespace jsonrpc
 
             void SetUrlHandler(const std::string &url, IClientConnectionHandler *handler);
 
+            /**
+             * @brief SetTextHandler, serves the text returned by handler for GET requests to url, e.g. for metrics scraping
+             */
+            void SetTextHandler(const std::string &url, const std::function<std::string()> &handler);
+
         private:
             int port;
             int threads;
+            unsigned int connectionTimeout;
+            unsigned int connectionLimit;
             bool running;
             std::string path_sslcert;
             std::string path_sslkey;
@@ -70,6 +80,9 @@ namespace jsonrpc
             struct MHD_Daemon *daemon;
 
             std::map<std::string, IClientConnectionHandler*> urlhandler;
+            std::map<std::string, std::function<std::string()>> texthandler;
+
+            bool SendTextResponse(const std::string& response, void* addInfo);
 
             static int callback(void *cls, struct MHD_Connection *connection, const char *url, const char *method, const char *version, const char *upload_data, size_t *upload_data_size, void **con_cls);
 
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+
+#include <MultiSig.h>
+#include "AggregateKeyCache.h"
+#include "libCrypto/Sha2.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace {
+// DS committee plus every shard, with room for one committee change
+const unsigned int MAX_COMMITTEES = 16;
+const unsigned int MAX_BITMAPS_PER_COMMITTEE = 32;
+
+/// Computes minuend - subtrahend on the curve.
+shared_ptr<PubKey> SubtractKey(const PubKey& minuend,
+                               const PubKey& subtrahend) {
+  const Curve& curve = Schnorr::GetCurve();
+
+  unique_ptr<BN_CTX, decltype(&BN_CTX_free)> ctx(BN_CTX_new(), BN_CTX_free);
+  unique_ptr<EC_POINT, decltype(&EC_POINT_clear_free)> negated(
+      EC_POINT_dup(subtrahend.m_P.get(), curve.m_group.get()),
+      EC_POINT_clear_free);
+  if (!ctx || !negated) {
+    LOG_GENERAL(WARNING, "Memory allocation failure");
+    return nullptr;
+  }
+
+  if (EC_POINT_invert(curve.m_group.get(), negated.get(), ctx.get()) != 1) {
+    LOG_GENERAL(WARNING, "EC_POINT_invert failed");
+    return nullptr;
+  }
+
+  auto result = make_shared<PubKey>(minuend);
+  if (EC_POINT_add(curve.m_group.get(), result->m_P.get(), result->m_P.get(),
+                   negated.get(), ctx.get()) != 1) {
+    LOG_GENERAL(WARNING, "EC_POINT_add failed");
+    return nullptr;
+  }
+
+  return result;
+}
+}  // namespace
+
+AggregateKeyCache& AggregateKeyCache::GetInstance() {
+  static AggregateKeyCache cache;
+  return cache;
+}
+
+AggregateKeyCache::CommitteeHash AggregateKeyCache::HashCommittee(
+    const vector<const PubKey*>& committee) {
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  bytes serializedKey;
+  for (const auto& key : committee) {
+    serializedKey.clear();
+    key->Serialize(serializedKey, 0);
+    sha2.Update(serializedKey);
+  }
+  return CommitteeHash(sha2.Finalize());
+}
+
+AggregateKeyCache::Entry* AggregateKeyCache::FindOrAddEntry(
+    const CommitteeHash& committeeHash,
+    const vector<const PubKey*>& committee) {
+  auto found = m_index.find(committeeHash);
+  if (found != m_index.end()) {
+    if (found->second->m_keys.size() != committee.size()) {
+      LOG_GENERAL(WARNING, "Committee hash does not match committee size");
+      return nullptr;
+    }
+
+    // Most recently used committees stay at the front
+    m_entries.splice(m_entries.begin(), m_entries, found->second);
+    m_committeeHits++;
+    return &m_entries.front();
+  }
+
+  m_committeeMisses++;
+
+  Entry entry;
+  entry.m_hash = committeeHash;
+  entry.m_keys.reserve(committee.size());
+  for (const auto& key : committee) {
+    entry.m_keys.emplace_back(*key);
+  }
+  entry.m_fullAggregate = MultiSig::AggregatePubKeys(entry.m_keys);
+  if (entry.m_fullAggregate == nullptr) {
+    LOG_GENERAL(WARNING, "Committee key aggregation failed");
+    return nullptr;
+  }
+
+  m_entries.emplace_front(move(entry));
+  m_index[committeeHash] = m_entries.begin();
+  if (m_entries.size() > MAX_COMMITTEES) {
+    m_index.erase(m_entries.back().m_hash);
+    m_entries.pop_back();
+  }
+
+  return &m_entries.front();
+}
+
+shared_ptr<const PubKey> AggregateKeyCache::AggregateKeys(
+    const vector<const PubKey*>& committee, const vector<bool>& bitmap) {
+  return AggregateKeys(HashCommittee(committee), committee, bitmap);
+}
+
+shared_ptr<const PubKey> AggregateKeyCache::AggregateKeys(
+    const CommitteeHash& committeeHash, const vector<const PubKey*>& committee,
+    const vector<bool>& bitmap) {
+  if (committee.empty() || committee.size() != bitmap.size()) {
+    LOG_GENERAL(WARNING, "Mismatch: committee size = "
+                             << committee.size()
+                             << ", bitmap size = " << bitmap.size());
+    return nullptr;
+  }
+
+  lock_guard<mutex> g(m_mutex);
+
+  Entry* entry = FindOrAddEntry(committeeHash, committee);
+  if (entry == nullptr) {
+    return nullptr;
+  }
+
+  auto& bitmaps = entry->m_bitmaps;
+  for (auto it = bitmaps.begin(); it != bitmaps.end(); ++it) {
+    if (it->first == bitmap) {
+      bitmaps.splice(bitmaps.begin(), bitmaps, it);
+      m_bitmapHits++;
+      return bitmaps.front().second;
+    }
+  }
+
+  m_bitmapMisses++;
+
+  const size_t numSigners = count(bitmap.begin(), bitmap.end(), true);
+  const size_t numNonSigners = bitmap.size() - numSigners;
+
+  // Cheaper to remove the few members that did not sign than to add up the
+  // ones that did
+  const bool subtract = numNonSigners < numSigners;
+  vector<PubKey> keys;
+  keys.reserve(subtract ? numNonSigners : numSigners);
+  for (unsigned int i = 0; i < bitmap.size(); i++) {
+    if (bitmap[i] != subtract) {
+      keys.emplace_back(entry->m_keys[i]);
+    }
+  }
+
+  shared_ptr<const PubKey> result;
+  if (numNonSigners == 0) {
+    result = entry->m_fullAggregate;
+  } else if (numSigners == 0) {
+    LOG_GENERAL(WARNING, "Bitmap has no signers");
+    return nullptr;
+  } else if (subtract) {
+    shared_ptr<PubKey> removed = MultiSig::AggregatePubKeys(keys);
+    if (removed == nullptr) {
+      LOG_GENERAL(WARNING, "Non-signer key aggregation failed");
+      return nullptr;
+    }
+    result = SubtractKey(*entry->m_fullAggregate, *removed);
+  } else {
+    result = MultiSig::AggregatePubKeys(keys);
+  }
+
+  if (result == nullptr) {
+    LOG_GENERAL(WARNING, "Aggregated key generation failed");
+    return nullptr;
+  }
+
+  bitmaps.emplace_front(bitmap, result);
+  if (bitmaps.size() > MAX_BITMAPS_PER_COMMITTEE) {
+    bitmaps.pop_back();
+  }
+
+  return result;
+}
+
+AggregateKeyCache::Stats AggregateKeyCache::GetStats() const {
+  return {m_committeeHits, m_committeeMisses, m_bitmapHits, m_bitmapMisses};
+}
+
+void AggregateKeyCache::Clear() {
+  lock_guard<mutex> g(m_mutex);
+  m_index.clear();
+  m_entries.clear();
+}
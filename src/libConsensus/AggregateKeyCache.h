@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef ZILLIQA_SRC_LIBCONSENSUS_AGGREGATEKEYCACHE_H_
+#define ZILLIQA_SRC_LIBCONSENSUS_AGGREGATEKEYCACHE_H_
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Schnorr.h>
+#include "depends/common/FixedHash.h"
+
+/// Caches the aggregate public key of each recently seen committee.
+///
+/// Committee membership only changes once per DS epoch, and cosignature
+/// bitmaps usually leave out just a few members. The aggregate for a bitmap
+/// is therefore derived from the full-committee aggregate minus the keys of
+/// the non-signers, and the result is remembered per bitmap.
+///
+/// Committees are looked up by a SHA-256 over their keys. Callers that check
+/// many cosignatures against one committee compute it once with
+/// HashCommittee and pass it in.
+class AggregateKeyCache {
+ public:
+  typedef dev::h256 CommitteeHash;
+
+  struct Stats {
+    uint64_t m_committeeHits;
+    uint64_t m_committeeMisses;
+    uint64_t m_bitmapHits;
+    uint64_t m_bitmapMisses;
+  };
+
+ private:
+  struct Entry {
+    CommitteeHash m_hash;
+    std::vector<PubKey> m_keys;
+    std::shared_ptr<const PubKey> m_fullAggregate;
+    std::list<std::pair<std::vector<bool>, std::shared_ptr<const PubKey>>>
+        m_bitmaps;
+  };
+
+  std::mutex m_mutex;
+  std::list<Entry> m_entries;
+  std::unordered_map<CommitteeHash, std::list<Entry>::iterator> m_index;
+
+  std::atomic<uint64_t> m_committeeHits{0};
+  std::atomic<uint64_t> m_committeeMisses{0};
+  std::atomic<uint64_t> m_bitmapHits{0};
+  std::atomic<uint64_t> m_bitmapMisses{0};
+
+  AggregateKeyCache() = default;
+  ~AggregateKeyCache() = default;
+
+  // Singleton should not implement these
+  AggregateKeyCache(AggregateKeyCache const&) = delete;
+  void operator=(AggregateKeyCache const&) = delete;
+
+  /// Returns the entry for the committee, creating it if needed. Must be
+  /// called with m_mutex held.
+  Entry* FindOrAddEntry(const CommitteeHash& committeeHash,
+                        const std::vector<const PubKey*>& committee);
+
+ public:
+  /// Returns the singleton AggregateKeyCache instance.
+  static AggregateKeyCache& GetInstance();
+
+  /// Returns the key under which the committee is cached.
+  static CommitteeHash HashCommittee(
+      const std::vector<const PubKey*>& committee);
+
+  /// Returns the aggregate of the committee keys whose bit is set, or nullptr
+  /// on failure. committee and bitmap must have the same size and order.
+  std::shared_ptr<const PubKey> AggregateKeys(
+      const std::vector<const PubKey*>& committee,
+      const std::vector<bool>& bitmap);
+
+  /// Same as above, with committeeHash = HashCommittee(committee) computed by
+  /// the caller.
+  std::shared_ptr<const PubKey> AggregateKeys(
+      const CommitteeHash& committeeHash,
+      const std::vector<const PubKey*>& committee,
+      const std::vector<bool>& bitmap);
+
+  Stats GetStats() const;
+
+  void Clear();
+};
+
+#endif  // ZILLIQA_SRC_LIBCONSENSUS_AGGREGATEKEYCACHE_H_
@@ -453,6 +453,8 @@ bool ConsensusBackup::ProcessMessage(const bytes& message, unsigned int offset,
                   "Unknown msg type " << (unsigned int)message.at(offset));
   }
 
+  RecordStateChange(false);
+
   return result;
 }
 
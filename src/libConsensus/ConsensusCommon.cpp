@@ -15,6 +15,8 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <array>
+
 #include "ConsensusCommon.h"
 #include "common/Constants.h"
 #include "common/Messages.h"
@@ -27,6 +29,7 @@
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/Logger.h"
+#include "libUtils/Metrics.h"
 
 #define MAKE_LITERAL_PAIR(s) \
   { s, #s }
@@ -80,7 +83,15 @@ ConsensusCommon::ConsensusCommon(uint32_t consensus_id, uint64_t block_number,
       m_committee(committee),
       m_classByte(class_byte),
       m_insByte(ins_byte),
-      m_responseMap(committee.size(), false) {}
+      m_responseMap(committee.size(), false) {
+  m_timedStateStart = chrono::steady_clock::now();
+
+  m_committeeKeys.reserve(m_committee.size());
+  for (const auto& member : m_committee) {
+    m_committeeKeys.emplace_back(&member.first);
+  }
+  m_committeeHash = AggregateKeyCache::HashCommittee(m_committeeKeys);
+}
 
 ConsensusCommon::~ConsensusCommon() {}
 
@@ -117,14 +128,9 @@ bool ConsensusCommon::VerifyMessage(const bytes& msg, unsigned int offset,
 PubKey ConsensusCommon::AggregateKeys(const vector<bool>& peer_map) {
   LOG_MARKER();
 
-  vector<PubKey> keys;
-  DequeOfNode::const_iterator j = m_committee.begin();
-  for (unsigned int i = 0; i < peer_map.size(); ++i, ++j) {
-    if (peer_map.at(i)) {
-      keys.emplace_back(j->first);
-    }
-  }
-  shared_ptr<PubKey> result = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<const PubKey> result =
+      AggregateKeyCache::GetInstance().AggregateKeys(
+          m_committeeHash, m_committeeKeys, peer_map);
   if (result == nullptr) {
     return PubKey();
   }
@@ -264,6 +270,40 @@ void ConsensusCommon::SetConsensusErrorCode(
   m_consensusErrorCode = ErrorCode;
 }
 
+void ConsensusCommon::RecordStateChange(const bool isLeader) {
+  // One histogram per role and phase, looked up once
+  using PhaseHistograms = array<Metrics::Histogram*, ERROR + 1>;
+  auto getHistograms = [](const string& role) {
+    PhaseHistograms histograms{};
+    for (unsigned int i = INITIAL; i <= ERROR; i++) {
+      const auto it = ConsensusStateStrings.find(static_cast<State>(i));
+      const string phase =
+          it == ConsensusStateStrings.end() ? "UNKNOWN" : it->second;
+      histograms[i] = &Metrics::GetInstance().GetHistogram(
+          "zilliqa_consensus_phase_us",
+          "role=\"" + role + "\",phase=\"" + phase + "\"");
+    }
+    return histograms;
+  };
+  static const PhaseHistograms leaderHistograms = getHistograms("leader");
+  static const PhaseHistograms backupHistograms = getHistograms("backup");
+
+  const State state = m_state;
+
+  lock_guard<mutex> g(m_mutexStateTiming);
+  if (state == m_timedState) {
+    return;
+  }
+
+  const auto now = chrono::steady_clock::now();
+  const auto elapsed =
+      chrono::duration_cast<chrono::microseconds>(now - m_timedStateStart);
+  const auto& histograms = isLeader ? leaderHistograms : backupHistograms;
+  histograms[m_timedState]->Record(elapsed.count());
+  m_timedState = state;
+  m_timedStateStart = now;
+}
+
 void ConsensusCommon::RecoveryAndProcessFromANewState(State newState) {
   m_state = newState;
 }
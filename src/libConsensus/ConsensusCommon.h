@@ -18,6 +18,7 @@
 #ifndef ZILLIQA_SRC_LIBCONSENSUS_CONSENSUSCOMMON_H_
 #define ZILLIQA_SRC_LIBCONSENSUS_CONSENSUSCOMMON_H_
 
+#include <chrono>
 #include <deque>
 #include <functional>
 #include <memory>
@@ -26,6 +27,7 @@
 #include <vector>
 
 #include <MultiSig.h>
+#include "AggregateKeyCache.h"
 #include "libNetwork/ShardStruct.h"
 #include "libUtils/TimeLockedFunction.h"
 
@@ -110,6 +112,11 @@ class ConsensusCommon {
   /// State of the active consensus session.
   std::atomic<State> m_state{};
 
+  /// State last seen by RecordStateChange, and when it was entered.
+  std::mutex m_mutexStateTiming;
+  State m_timedState{INITIAL};
+  std::chrono::steady_clock::time_point m_timedStateStart;
+
   /// State of the active consensus session.
   ConsensusErrorCode m_consensusErrorCode;
 
@@ -131,6 +138,10 @@ class ConsensusCommon {
   /// List of <public keys, peers> for the committee.
   DequeOfNode m_committee;
 
+  /// Keys of m_committee in order, and their hash for AggregateKeyCache.
+  std::vector<const PubKey*> m_committeeKeys;
+  AggregateKeyCache::CommitteeHash m_committeeHash;
+
   /// The payload segment to be co-signed by the committee.
   bytes m_messageToCosign;
 
@@ -200,6 +211,10 @@ class ConsensusCommon {
 
   PairOfNode GetCommitteeMember(const unsigned int index);
 
+  /// Records how long the previous state lasted, if the state has changed
+  /// since the last call.
+  void RecordStateChange(const bool isLeader);
+
  public:
   /// Consensus message processing function
   virtual bool ProcessMessage([[gnu::unused]] const bytes& message,
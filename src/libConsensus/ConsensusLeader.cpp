@@ -957,6 +957,7 @@ bool ConsensusLeader::StartConsensus(
   m_state = ANNOUNCE_DONE;
   m_commitRedundantCounter = 0;
   m_commitFailureCounter = 0;
+  RecordStateChange(true);
 
   // Multicast to all nodes in the committee
   // =======================================
@@ -1038,6 +1039,8 @@ bool ConsensusLeader::ProcessMessage(const bytes& message, unsigned int offset,
                   "Unknown msg type " << (unsigned int)message.at(offset));
   }
 
+  RecordStateChange(true);
+
   return result;
 }
 
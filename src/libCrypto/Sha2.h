@@ -19,6 +19,7 @@
 #define ZILLIQA_SRC_LIBCRYPTO_SHA2_H_
 
 #include <openssl/sha.h>
+#include <array>
 #include <vector>
 #include "libUtils/Logger.h"
 
@@ -32,13 +33,13 @@ class HashType {
 /// Implements SHA2 hash algorithm.
 template <unsigned int SIZE>
 class SHA2 {
-  static const unsigned int HASH_OUTPUT_SIZE = SIZE / 8;
   SHA256_CTX m_context{};
-  bytes output;
 
  public:
+  static const unsigned int HASH_OUTPUT_SIZE = SIZE / 8;
+
   /// Constructor.
-  SHA2() : output(HASH_OUTPUT_SIZE) {
+  SHA2() {
     if (SIZE != HashType::HASH_VARIANT_256) {
       LOG_GENERAL(FATAL, "assertion failed (" << __FILE__ << ":" << __LINE__
                                               << ": " << __FUNCTION__ << ")");
@@ -51,14 +52,7 @@ class SHA2 {
   ~SHA2() {}
 
   /// Hash update function.
-  void Update(const bytes& input) {
-    if (input.size() == 0) {
-      LOG_GENERAL(WARNING, "Nothing to update");
-      return;
-    }
-
-    SHA256_Update(&m_context, input.data(), input.size());
-  }
+  void Update(const bytes& input) { Update(input.data(), input.size()); }
 
   /// Hash update function.
   void Update(const bytes& input, unsigned int offset, unsigned int size) {
@@ -70,18 +64,24 @@ class SHA2 {
     SHA256_Update(&m_context, input.data() + offset, size);
   }
 
+  /// Hash update function for data that is not held in a byte vector (e.g.,
+  /// a FixedHash). An empty input leaves the hash unchanged.
+  void Update(const uint8_t* input, size_t size) {
+    SHA256_Update(&m_context, input, size);
+  }
+
   /// Resets the algorithm.
   void Reset() { SHA256_Init(&m_context); }
 
+  /// Hash finalize function that writes into a caller-provided array.
+  void Finalize(std::array<uint8_t, HASH_OUTPUT_SIZE>& digest) {
+    SHA256_Final(digest.data(), &m_context);
+  }
+
   /// Hash finalize function.
   bytes Finalize() {
-    switch (SIZE) {
-      case 256:
-        SHA256_Final(output.data(), &m_context);
-        break;
-      default:
-        break;
-    }
+    bytes output(HASH_OUTPUT_SIZE);
+    SHA256_Final(output.data(), &m_context);
     return output;
   }
 };
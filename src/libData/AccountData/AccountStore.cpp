@@ -27,6 +27,7 @@
 #include "libPersistence/ScillaMessage.pb.h"
 #pragma GCC diagnostic pop
 #include "libServer/ScillaIPCServer.h"
+#include "libUtils/Metrics.h"
 #include "libUtils/SysCommand.h"
 
 using namespace std;
@@ -34,6 +35,22 @@ using namespace dev;
 using namespace boost::multiprecision;
 using namespace Contract;
 
+namespace {
+Metrics::Histogram& GetTxnProcessingHistogram(
+    Transaction::ContractType type) {
+  static Metrics::Histogram* histograms[] = {
+      &Metrics::GetInstance().GetHistogram("zilliqa_txn_processing_us",
+                                           "type=\"non_contract\""),
+      &Metrics::GetInstance().GetHistogram("zilliqa_txn_processing_us",
+                                           "type=\"contract_creation\""),
+      &Metrics::GetInstance().GetHistogram("zilliqa_txn_processing_us",
+                                           "type=\"contract_call\""),
+      &Metrics::GetInstance().GetHistogram("zilliqa_txn_processing_us",
+                                           "type=\"error\"")};
+  return *histograms[type];
+}
+}  // namespace
+
 AccountStore::AccountStore() {
   m_accountStoreTemp = make_unique<AccountStoreTemp>(*this);
 
@@ -393,6 +410,9 @@ bool AccountStore::UpdateAccountsTemp(const uint64_t& blockNum,
   unique_lock<mutex> g2(m_mutexDelta, defer_lock);
   lock(g, g2);
 
+  Metrics::ScopedTimer timer(
+      GetTxnProcessingHistogram(Transaction::GetTransactionType(transaction)));
+
   return m_accountStoreTemp->UpdateAccounts(blockNum, numShards, isDS,
                                             transaction, receipt, error_code);
 }
@@ -411,6 +431,66 @@ bool AccountStore::UpdateCoinbaseTemp(const Address& rewardee,
   // Should the nonce increase ??
 }
 
+void AccountStore::UpdateCoinbaseBatchTemp(
+    const Address& genesisAddress,
+    const vector<pair<Address, uint128_t>>& rewards, vector<bool>& succeeded) {
+  LOG_MARKER();
+
+  lock_guard<mutex> g(m_mutexDelta);
+
+  // Balances are tracked here and written back once per account
+  struct Touched {
+    Account* m_account;
+    uint128_t m_balance;
+  };
+  unordered_map<Address, Touched> touched;
+  auto touch = [this, &touched](const Address& address,
+                                bool create) -> Touched& {
+    auto it = touched.find(address);
+    if (it == touched.end()) {
+      Account* account = m_accountStoreTemp->GetAccount(address);
+      it = touched
+               .emplace(address, Touched{account, account != nullptr
+                                                      ? account->GetBalance()
+                                                      : 0})
+               .first;
+    }
+    if (it->second.m_account == nullptr && create) {
+      m_accountStoreTemp->AddAccount(address, {0, 0});
+      it->second.m_account = m_accountStoreTemp->GetAccount(address);
+    }
+    return it->second;
+  };
+
+  // Mirrors TransferBalance, including its handling of a failed credit
+  succeeded.assign(rewards.size(), false);
+  for (size_t i = 0; i < rewards.size(); i++) {
+    const auto& amount = rewards[i].second;
+    Touched& rewardee = touch(rewards[i].first, true);
+    if (amount == 0) {
+      succeeded[i] = true;
+      continue;
+    }
+    Touched& genesis = touch(genesisAddress, false);
+    if (genesis.m_account == nullptr || genesis.m_balance < amount) {
+      continue;
+    }
+    genesis.m_balance -= amount;
+    if (!SafeMath<uint128_t>::add(rewardee.m_balance, amount,
+                                  rewardee.m_balance)) {
+      SafeMath<uint128_t>::add(genesis.m_balance, amount, genesis.m_balance);
+      continue;
+    }
+    succeeded[i] = true;
+  }
+
+  for (const auto& entry : touched) {
+    if (entry.second.m_account != nullptr) {
+      entry.second.m_account->SetBalance(entry.second.m_balance);
+    }
+  }
+}
+
 uint128_t AccountStore::GetNonceTemp(const Address& address) {
   lock_guard<mutex> g(m_mutexDelta);
 
@@ -171,6 +171,14 @@ class AccountStore
                           const Address& genesisAddress,
                           const uint128_t& amount);
 
+  /// Same as calling UpdateCoinbaseTemp on each reward in order, but reads
+  /// and writes each account once. succeeded tells which rewards went
+  /// through.
+  void UpdateCoinbaseBatchTemp(
+      const Address& genesisAddress,
+      const std::vector<std::pair<Address, uint128_t>>& rewards,
+      std::vector<bool>& succeeded);
+
   /// Call ProcessStorageRootUpdateBuffer in AccountStoreTemp
   void ProcessStorageRootUpdateBufferTemp() {
     std::lock_guard<std::mutex> g(m_mutexDelta);
@@ -20,6 +20,7 @@
 
 #include <json/json.h>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <mutex>
@@ -92,6 +93,9 @@ class AccountStoreSC : public AccountStoreBase<MAP> {
   std::mutex m_MutexCVCallContract;
   std::condition_variable cv_callContract;
   std::atomic<bool> m_txnProcessTimeout;
+  /// operates under m_MutexCVCallContract
+  std::chrono::steady_clock::time_point m_txnProcessDeadline{
+      std::chrono::steady_clock::time_point::max()};
 
   /// Scilla IPC server
   std::shared_ptr<ScillaIPCServer> m_scillaIPCServer;
@@ -216,6 +220,11 @@ class AccountStoreSC : public AccountStoreBase<MAP> {
   /// external interface for calling timeout for txn processing
   void NotifyTimeout();
 
+  /// contract calls still running at the deadline time out, until cleared
+  void SetTxnProcessDeadline(
+      const std::chrono::steady_clock::time_point& deadline);
+  void ClearTxnProcessDeadline();
+
   /// public interface to setup scilla ipc server
   void SetScillaIPCServer(std::shared_ptr<ScillaIPCServer> scillaIPCServer);
 
@@ -94,7 +94,12 @@ void AccountStoreSC<MAP>::InvokeInterpreter(
 
   {
     std::unique_lock<std::mutex> lk(m_MutexCVCallContract);
-    cv_callContract.wait(lk);
+    if (m_txnProcessDeadline == std::chrono::steady_clock::time_point::max()) {
+      cv_callContract.wait(lk);
+    } else if (cv_callContract.wait_until(lk, m_txnProcessDeadline) ==
+               std::cv_status::timeout) {
+      m_txnProcessTimeout = true;
+    }
   }
 
   if (m_txnProcessTimeout) {
@@ -1529,6 +1534,19 @@ void AccountStoreSC<MAP>::NotifyTimeout() {
   cv_callContract.notify_all();
 }
 
+template <class MAP>
+void AccountStoreSC<MAP>::SetTxnProcessDeadline(
+    const std::chrono::steady_clock::time_point& deadline) {
+  std::lock_guard<std::mutex> g(m_MutexCVCallContract);
+  m_txnProcessDeadline = deadline;
+}
+
+template <class MAP>
+void AccountStoreSC<MAP>::ClearTxnProcessDeadline() {
+  std::lock_guard<std::mutex> g(m_MutexCVCallContract);
+  m_txnProcessDeadline = std::chrono::steady_clock::time_point::max();
+}
+
 template <class MAP>
 void AccountStoreSC<MAP>::SetScillaIPCServer(
     std::shared_ptr<ScillaIPCServer> scillaIPCServer) {
@@ -31,11 +31,61 @@ unsigned char ACC_COND = 0x1;
 unsigned char TX_COND = 0x2;
 
 bool Transaction::SerializeCoreFields(bytes& dst, unsigned int offset) const {
-  return Messenger::SetTransactionCoreInfo(dst, offset, m_coreInfo);
+  const bytes& coreFields = GetSerializedCoreFields();
+  if (coreFields.empty()) {
+    return false;
+  }
+
+  if (dst.size() < offset + coreFields.size()) {
+    dst.resize(offset + coreFields.size());
+  }
+  copy(coreFields.begin(), coreFields.end(), dst.begin() + offset);
+
+  return true;
+}
+
+const bytes& Transaction::GetSerializedCoreFields() const {
+  auto coreFields = atomic_load(&m_coreFields);
+  if (coreFields == nullptr) {
+    bytes serialized;
+    if (!Messenger::SetTransactionCoreInfo(serialized, 0, m_coreInfo)) {
+      LOG_GENERAL(WARNING, "Messenger::SetTransactionCoreInfo failed.");
+      serialized.clear();
+    }
+    coreFields = make_shared<const bytes>(move(serialized));
+
+    // If another thread got there first, keep its copy
+    shared_ptr<const bytes> expected;
+    if (!atomic_compare_exchange_strong(&m_coreFields, &expected,
+                                        coreFields)) {
+      coreFields = expected;
+    }
+  }
+
+  return *coreFields;
 }
 
 Transaction::Transaction() {}
 
+Transaction::Transaction(const Transaction& src)
+    : SerializableDataBlock(src),
+      m_tranID(src.m_tranID),
+      m_coreInfo(src.m_coreInfo),
+      m_signature(src.m_signature),
+      m_senderAddr(atomic_load(&src.m_senderAddr)),
+      m_coreFields(atomic_load(&src.m_coreFields)) {}
+
+Transaction& Transaction::operator=(const Transaction& src) {
+  if (this != &src) {
+    m_tranID = src.m_tranID;
+    m_coreInfo = src.m_coreInfo;
+    m_signature = src.m_signature;
+    m_senderAddr = atomic_load(&src.m_senderAddr);
+    m_coreFields = atomic_load(&src.m_coreFields);
+  }
+  return *this;
+}
+
 Transaction::Transaction(const bytes& src, unsigned int offset) {
   Deserialize(src, offset);
 }
@@ -65,6 +115,8 @@ Transaction::Transaction(const uint32_t& version, const uint64_t& nonce,
                      m_signature)) {
     LOG_GENERAL(WARNING, "We failed to generate m_signature.");
   }
+
+  m_coreFields = make_shared<const bytes>(move(txnData));
 }
 
 Transaction::Transaction(const TxnHash& tranID, const uint32_t& version,
@@ -103,6 +155,8 @@ Transaction::Transaction(const uint32_t& version, const uint64_t& nonce,
   if (!Schnorr::Verify(txnData, m_signature, m_coreInfo.senderPubKey)) {
     LOG_GENERAL(WARNING, "We failed to verify the input signature.");
   }
+
+  m_coreFields = make_shared<const bytes>(move(txnData));
 }
 
 Transaction::Transaction(const TxnHash& tranID,
@@ -145,7 +199,19 @@ const PubKey& Transaction::GetSenderPubKey() const {
 }
 
 Address Transaction::GetSenderAddr() const {
-  return Account::GetAddressFromPublicKey(GetSenderPubKey());
+  auto senderAddr = atomic_load(&m_senderAddr);
+  if (senderAddr == nullptr) {
+    senderAddr = make_shared<const Address>(
+        Account::GetAddressFromPublicKey(GetSenderPubKey()));
+
+    shared_ptr<const Address> expected;
+    if (!atomic_compare_exchange_strong(&m_senderAddr, &expected,
+                                        senderAddr)) {
+      senderAddr = expected;
+    }
+  }
+
+  return *senderAddr;
 }
 
 const uint128_t& Transaction::GetAmount() const { return m_coreInfo.amount; }
@@ -19,6 +19,7 @@
 #define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_TRANSACTION_H_
 
 #include <array>
+#include <memory>
 
 #include <Schnorr.h>
 #include "Address.h"
@@ -64,10 +65,21 @@ class Transaction : public SerializableDataBlock {
   TransactionCoreInfo m_coreInfo;
   Signature m_signature;
 
+  // Derived from m_coreInfo on first use. m_coreInfo does not change after
+  // construction, so copies share these. Once set they are never replaced,
+  // and they are only accessed through std::atomic_load / compare_exchange.
+  mutable std::shared_ptr<const Address> m_senderAddr;
+  mutable std::shared_ptr<const bytes> m_coreFields;
+
  public:
   /// Default constructor.
   Transaction();
 
+  Transaction(const Transaction& src);
+  Transaction(Transaction&& src) = default;
+  Transaction& operator=(const Transaction& src);
+  Transaction& operator=(Transaction&& src) = default;
+
   /// Constructor with specified transaction fields.
   Transaction(const uint32_t& version, const uint64_t& nonce,
               const Address& toAddr, const PairOfKey& senderKeyPair,
@@ -101,6 +113,9 @@ class Transaction : public SerializableDataBlock {
 
   bool SerializeCoreFields(bytes& dst, unsigned int offset) const;
 
+  /// Returns the serialized core fields (the signed part of the transaction).
+  const bytes& GetSerializedCoreFields() const;
+
   /// Implements the Deserialize function inherited from Serializable.
   bool Deserialize(const bytes& src, unsigned int offset) override;
 
@@ -21,6 +21,7 @@
 #include <functional>
 #include <map>
 #include <unordered_map>
+#include <utility>
 
 #include "Account.h"
 #include "Transaction.h"
@@ -66,6 +67,26 @@ struct TxnPool {
     return true;
   }
 
+  /// Removes the txn from the pool and returns it in t.
+  bool take(const TxnHash& th, Transaction& t) {
+    auto searchHash = HashIndex.find(th);
+    if (searchHash == HashIndex.end()) {
+      return false;
+    }
+    t = std::move(searchHash->second);
+    HashIndex.erase(searchHash);
+
+    NonceIndex.erase({t.GetSenderPubKey(), t.GetNonce()});
+    auto searchGas = GasIndex.find(t.GetGasPrice());
+    if (searchGas != GasIndex.end()) {
+      searchGas->second.erase(th);
+      if (searchGas->second.empty()) {
+        GasIndex.erase(searchGas);
+      }
+    }
+    return true;
+  }
+
   bool insert(const Transaction& t, MempoolInsertionStatus& status) {
     if (exist(t.GetTranID())) {
       status = {TxnStatus::MEMPOOL_ALREADY_PRESENT, t.GetTranID()};
@@ -91,6 +112,10 @@ struct TxnPool {
           if (searchGasHash != searchGas->second.end()) {
             searchGas->second.erase(searchGasHash);
           }
+          // findOne stops at an empty price level
+          if (searchGas->second.empty()) {
+            GasIndex.erase(searchGas);
+          }
         }
         HashIndex[t.GetTranID()] = t;
         GasIndex[t.GetGasPrice()][t.GetTranID()] = t;
@@ -132,6 +157,20 @@ struct TxnPool {
     }
   }
 
+  /// Inserts the txns of other, which is left empty. Same nonce conflicts are
+  /// resolved as by insert, so the result does not depend on which pool a txn
+  /// came from. Costs O(size of the smaller pool).
+  void merge(TxnPool& other) {
+    if (other.size() > size()) {
+      std::swap(*this, other);
+    }
+    MempoolInsertionStatus status;
+    for (const auto& entry : other.HashIndex) {
+      insert(entry.second, status);
+    }
+    other.clear();
+  }
+
   bool findOne(Transaction& t) {
     if (GasIndex.empty()) {
       return false;
@@ -18,6 +18,7 @@
 #ifndef ZILLIQA_SRC_LIBDATA_BLOCKDATA_BLOCK_H_
 #define ZILLIQA_SRC_LIBDATA_BLOCKDATA_BLOCK_H_
 
+#include "Block/CompactTxnHashes.h"
 #include "Block/DSBlock.h"
 #include "Block/FallbackBlock.h"
 #include "Block/MicroBlock.h"
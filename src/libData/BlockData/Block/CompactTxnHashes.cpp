@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <array>
+
+#include "CompactTxnHashes.h"
+#include "common/Serializable.h"
+#include "libCrypto/Sha2.h"
+
+using namespace std;
+
+namespace {
+const uint64_t SHORT_ID_MASK = (uint64_t(1) << (8 * 6)) - 1;
+
+uint64_t Mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+uint64_t ReadWord(const uint8_t* data) {
+  uint64_t word = 0;
+  for (unsigned int i = 0; i < sizeof(uint64_t); i++) {
+    word = (word << 8) | data[i];
+  }
+  return word;
+}
+}  // namespace
+
+CompactTxnHashes::CompactTxnHashes(uint64_t salt,
+                                   const vector<TxnHash>& txnHashes)
+    : m_salt(salt) {
+  static_assert(SHORT_ID_SIZE == 6, "SHORT_ID_MASK assumes 6-byte short IDs");
+  DeriveKeys();
+  m_shortIds.reserve(txnHashes.size() * SHORT_ID_SIZE);
+  for (const auto& txnHash : txnHashes) {
+    Serializable::SetNumber<uint64_t>(m_shortIds, m_shortIds.size(),
+                                      GetShortId(txnHash), SHORT_ID_SIZE);
+  }
+}
+
+CompactTxnHashes::CompactTxnHashes(uint64_t salt, bytes shortIds)
+    : m_salt(salt), m_shortIds(move(shortIds)) {
+  DeriveKeys();
+}
+
+void CompactTxnHashes::DeriveKeys() {
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  bytes salt;
+  Serializable::SetNumber<uint64_t>(salt, 0, m_salt, sizeof(uint64_t));
+  sha2.Update(salt);
+  array<uint8_t, SHA2<HashType::HASH_VARIANT_256>::HASH_OUTPUT_SIZE> digest;
+  sha2.Finalize(digest);
+  m_keys[0] = ReadWord(digest.data());
+  m_keys[1] = ReadWord(digest.data() + sizeof(uint64_t));
+}
+
+uint64_t CompactTxnHashes::GetShortId(const TxnHash& txnHash) const {
+  uint64_t h = m_keys[0];
+  for (unsigned int i = 0; i < TxnHash::size; i += sizeof(uint64_t)) {
+    h = Mix(h ^ ReadWord(txnHash.data() + i));
+  }
+  return Mix(h ^ m_keys[1]) & SHORT_ID_MASK;
+}
+
+uint64_t CompactTxnHashes::GetShortId(size_t index) const {
+  return Serializable::GetNumber<uint64_t>(m_shortIds, index * SHORT_ID_SIZE,
+                                           SHORT_ID_SIZE);
+}
+
+CompactTxnHashesResolver::CompactTxnHashesResolver(
+    const CompactTxnHashes& compact)
+    : m_compact(compact) {
+  m_matches.reserve(compact.GetNumTxns());
+  for (size_t i = 0; i < compact.GetNumTxns(); i++) {
+    m_matches.emplace(compact.GetShortId(i), Match());
+  }
+}
+
+void CompactTxnHashesResolver::Offer(const TxnHash& txnHash) {
+  const auto it = m_matches.find(m_compact.GetShortId(txnHash));
+  if (it == m_matches.end()) {
+    return;
+  }
+  Match& match = it->second;
+  if (!match.m_found) {
+    match.m_txnHash = txnHash;
+    match.m_found = true;
+  } else if (match.m_txnHash != txnHash) {
+    match.m_ambiguous = true;
+  }
+}
+
+size_t CompactTxnHashesResolver::Resolve(
+    vector<TxnHash>& txnHashes, vector<uint32_t>& missingIndices) const {
+  txnHashes.assign(m_compact.GetNumTxns(), TxnHash());
+  missingIndices.clear();
+  for (size_t i = 0; i < txnHashes.size(); i++) {
+    const Match& match = m_matches.at(m_compact.GetShortId(i));
+    if (match.m_found && !match.m_ambiguous) {
+      txnHashes[i] = match.m_txnHash;
+    } else {
+      missingIndices.emplace_back(i);
+    }
+  }
+  return missingIndices.size();
+}
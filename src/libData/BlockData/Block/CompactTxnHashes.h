@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDATA_BLOCKDATA_BLOCK_COMPACTTXNHASHES_H_
+#define ZILLIQA_SRC_LIBDATA_BLOCKDATA_BLOCK_COMPACTTXNHASHES_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "common/BaseType.h"
+#include "libData/AccountData/Transaction.h"
+
+/// The txn list of a block sent as short salted txn IDs, for receivers that
+/// already hold most of the txns. The short ID is a keyed mix of the txn hash
+/// rather than a cryptographic hash; a wrong reconstruction is caught by the
+/// txn root hash in the block header. The salt is picked per announcement so
+/// that IDs colliding in one announcement do not collide again.
+class CompactTxnHashes {
+ public:
+  static const unsigned int SHORT_ID_SIZE = 6;
+
+  CompactTxnHashes() = default;
+  CompactTxnHashes(uint64_t salt, const std::vector<TxnHash>& txnHashes);
+  CompactTxnHashes(uint64_t salt, bytes shortIds);
+
+  /// An empty instance stands for a txn list that was sent in full.
+  bool IsEmpty() const { return m_shortIds.empty(); }
+  uint64_t GetSalt() const { return m_salt; }
+  const bytes& GetShortIds() const { return m_shortIds; }
+  size_t GetNumTxns() const { return m_shortIds.size() / SHORT_ID_SIZE; }
+
+  uint64_t GetShortId(const TxnHash& txnHash) const;
+  uint64_t GetShortId(size_t index) const;
+
+ private:
+  uint64_t m_salt{0};
+  uint64_t m_keys[2]{};
+  bytes m_shortIds;
+
+  void DeriveKeys();
+};
+
+/// Rebuilds the txn list of a CompactTxnHashes from the txn hashes a node
+/// holds.
+class CompactTxnHashesResolver {
+ public:
+  explicit CompactTxnHashesResolver(const CompactTxnHashes& compact);
+
+  /// Offers a txn hash held locally.
+  void Offer(const TxnHash& txnHash);
+
+  /// Fills in the txn list, with a zero hash at each position that no
+  /// offered hash matched, or that more than one offered hash matched.
+  /// Returns the number of such positions.
+  size_t Resolve(std::vector<TxnHash>& txnHashes,
+                 std::vector<uint32_t>& missingIndices) const;
+
+ private:
+  struct Match {
+    TxnHash m_txnHash;
+    bool m_found{false};
+    bool m_ambiguous{false};
+  };
+
+  const CompactTxnHashes& m_compact;
+  std::unordered_map<uint64_t, Match> m_matches;
+};
+
+#endif  // ZILLIQA_SRC_LIBDATA_BLOCKDATA_BLOCK_COMPACTTXNHASHES_H_
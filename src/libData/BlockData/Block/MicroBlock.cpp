@@ -87,6 +87,10 @@ const vector<TxnHash>& MicroBlock::GetTranHashes() const {
   return m_tranHashes;
 }
 
+void MicroBlock::SetTranHashes(vector<TxnHash>&& tranHashes) {
+  m_tranHashes = move(tranHashes);
+}
+
 bool MicroBlock::operator==(const MicroBlock& block) const {
   return ((m_header == block.m_header) && (m_tranHashes == block.m_tranHashes));
 }
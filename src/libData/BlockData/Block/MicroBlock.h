@@ -57,6 +57,9 @@ class MicroBlock : public BlockBase {
   /// Returns the list of transaction hashes.
   const std::vector<TxnHash>& GetTranHashes() const;
 
+  /// Sets the list of transaction hashes rebuilt from short txn IDs.
+  void SetTranHashes(std::vector<TxnHash>&& tranHashes);
+
   /// Equality operator.
   bool operator==(const MicroBlock& block) const;
 
@@ -14,8 +14,11 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
+#include <future>
 #include <map>
 #include <queue>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "DirectoryService.h"
@@ -28,6 +31,53 @@
 using namespace std;
 using namespace boost::multiprecision;
 
+namespace {
+// Below this number of keys, deriving addresses in parallel costs more than
+// it saves
+const size_t COINBASE_PARALLEL_MIN_KEYS = 256;
+
+struct PendingReward {
+  enum Type { BASE, LOOKUP, COSIG } m_type;
+  const PubKey* m_pubKey;
+  uint64_t m_epochNum;
+};
+
+// Fills in the address of every key, spreading the hashing across threads
+void DeriveAddresses(unordered_map<PubKey, Address>& addresses) {
+  vector<pair<const PubKey, Address>*> entries;
+  entries.reserve(addresses.size());
+  for (auto& entry : addresses) {
+    entries.emplace_back(&entry);
+  }
+
+  auto deriveRange = [&entries](size_t from, size_t to) {
+    for (size_t i = from; i < to; i++) {
+      entries[i]->second = Account::GetAddressFromPublicKey(entries[i]->first);
+    }
+  };
+
+  const size_t count = entries.size();
+  const size_t numThreads =
+      count < COINBASE_PARALLEL_MIN_KEYS
+          ? 1
+          : min<size_t>(max(1u, thread::hardware_concurrency()), count);
+  if (numThreads <= 1) {
+    deriveRange(0, count);
+    return;
+  }
+
+  vector<future<void>> results;
+  const size_t step = (count + numThreads - 1) / numThreads;
+  for (size_t from = 0; from < count; from += step) {
+    results.emplace_back(
+        async(launch::async, deriveRange, from, min(from + step, count)));
+  }
+  for (auto& result : results) {
+    result.get();
+  }
+}
+}  // namespace
+
 template <class Container>
 bool DirectoryService::SaveCoinbaseCore(const vector<bool>& b1,
                                         const vector<bool>& b2,
@@ -256,6 +306,30 @@ void DirectoryService::InitCoinbase() {
   const auto& myAddr =
       Account::GetAddressFromPublicKey(m_mediator.m_selfKey.second);
 
+  // Each rewardee's address is derived once for the whole DS epoch
+  unordered_map<PubKey, Address> addresses;
+  for (const auto& ds : *m_mediator.m_DSCommittee) {
+    addresses.emplace(ds.first, Address());
+  }
+  for (const auto& shard : m_shards) {
+    for (const auto& node : shard) {
+      addresses.emplace(std::get<SHARD_NODE_PUBKEY>(node), Address());
+    }
+  }
+  for (const auto& epochNumShardRewardee : m_coinbaseRewardees) {
+    for (const auto& shardIdRewardee : epochNumShardRewardee.second) {
+      for (const auto& pk : shardIdRewardee.second) {
+        addresses.emplace(pk, Address());
+      }
+    }
+  }
+  DeriveAddresses(addresses);
+
+  // Rewards are collected in the order they used to be paid out, then
+  // applied as one batch
+  vector<pair<Address, uint128_t>> rewards;
+  vector<PendingReward> pending;
+
   // This list is for lucky draw candidates
   vector<Address> nonGuard;
 
@@ -266,10 +340,9 @@ void DirectoryService::InitCoinbase() {
   unordered_map<PubKey, bool> pubKeyAndIsGuard;
 
   // DS nodes
-  LOG_GENERAL(INFO, "[CNBSE] Rewarding base reward to DS nodes...");
   for (const auto& ds : *m_mediator.m_DSCommittee) {
     const auto& pk = ds.first;
-    Address addr = Account::GetAddressFromPublicKey(pk);
+    const Address& addr = addresses.at(pk);
     if (GUARD_MODE) {
       auto& isGuard = pubKeyAndIsGuard[pk];
       if (Guard::GetInstance().IsNodeInDSGuardList(pk)) {
@@ -282,24 +355,11 @@ void DirectoryService::InitCoinbase() {
       isGuard = false;
     }
     nonGuard.emplace_back(addr);
-
-    if (!AccountStore::GetInstance().UpdateCoinbaseTemp(addr, coinbaseAddress,
-                                                        base_reward_each)) {
-      LOG_GENERAL(WARNING, "Could not reward base reward  " << addr);
-    } else {
-      if (addr == myAddr) {
-        LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-                  "[REWARD] Rewarded base reward " << base_reward_each);
-        LOG_STATE("[REWARD][" << setw(15) << left
-                              << m_mediator.m_selfPeer.GetPrintableIPAddress()
-                              << "][" << m_mediator.m_currentEpochNum << "]["
-                              << base_reward_each << "] base reward");
-      }
-    }
+    rewards.emplace_back(addr, base_reward_each);
+    pending.push_back({PendingReward::BASE, &pk, 0});
   }
 
   // Shard nodes
-  LOG_GENERAL(INFO, "[CNBSE] Rewarding base reward to shard nodes...");
   for (const auto& shard : m_shards) {
     for (const auto& node : shard) {
       const auto& pk = std::get<SHARD_NODE_PUBKEY>(node);
@@ -311,14 +371,10 @@ void DirectoryService::InitCoinbase() {
         }
         isGuard = false;
       }
-      Address addr = Account::GetAddressFromPublicKey(pk);
+      const Address& addr = addresses.at(pk);
       nonGuard.emplace_back(addr);
-
-      if (!AccountStore::GetInstance().UpdateCoinbaseTemp(addr, coinbaseAddress,
-                                                          base_reward_each)) {
-        LOG_GENERAL(WARNING, "Could not reward base reward  " << addr);
-      }
-      // No need to log as shard node won't call InitCoinbase
+      rewards.emplace_back(addr, base_reward_each);
+      pending.push_back({PendingReward::BASE, &pk, 0});
     }
   }
 
@@ -327,57 +383,73 @@ void DirectoryService::InitCoinbase() {
   uint128_t suc_counter = 0;
   uint128_t suc_lookup_counter = 0;
 
-  LOG_GENERAL(
-      INFO,
-      "[CNBSE] Rewarding cosig rewards to lookup, DS, and shard nodes...");
-
   for (const auto& epochNumShardRewardee : m_coinbaseRewardees) {
     const auto& epochNum = epochNumShardRewardee.first;
-    const auto& shards = epochNumShardRewardee.second;
-    LOG_GENERAL(INFO, "[CNBSE] Rewarding epoch " << epochNum);
-    for (const auto& shardIdRewardee : shards) {
+    for (const auto& shardIdRewardee : epochNumShardRewardee.second) {
       const auto& shardId = shardIdRewardee.first;
-      const auto& rewardees = shardIdRewardee.second;
-      LOG_GENERAL(INFO, "[CNBSE] Rewarding shard " << shardId);
-      if (shardId == CoinbaseReward::LOOKUP_REWARD) {
-        for (const auto& pk : rewardees) {
-          const auto& addr = Account::GetAddressFromPublicKey(pk);
-          if (!AccountStore::GetInstance().UpdateCoinbaseTemp(
-                  addr, coinbaseAddress, reward_each_lookup)) {
-            LOG_GENERAL(WARNING, "Could not reward " << addr << " - " << pk);
-          } else {
-            nonGuard.emplace_back(addr);
-            suc_lookup_counter++;
-          }
-        }
-      } else {
-        for (const auto& pk : rewardees) {
-          if (GUARD_MODE && pubKeyAndIsGuard[pk]) {
-            suc_counter++;
-          } else {
-            const auto& addr = Account::GetAddressFromPublicKey(pk);
-            if (!AccountStore::GetInstance().UpdateCoinbaseTemp(
-                    addr, coinbaseAddress, reward_each)) {
-              LOG_GENERAL(WARNING, "Could not reward " << addr << " - " << pk);
-            } else {
-              if (addr == myAddr) {
-                LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-                          "[REWARD] Rewarded " << reward_each << " for blk "
-                                               << epochNum);
-                LOG_STATE("[REWARD]["
-                          << setw(15) << left
-                          << m_mediator.m_selfPeer.GetPrintableIPAddress()
-                          << "][" << m_mediator.m_currentEpochNum << "]["
-                          << reward_each << "] for blk " << epochNum);
-              }
-              suc_counter++;
-            }
-          }
+      for (const auto& pk : shardIdRewardee.second) {
+        if (shardId == CoinbaseReward::LOOKUP_REWARD) {
+          rewards.emplace_back(addresses.at(pk), reward_each_lookup);
+          pending.push_back({PendingReward::LOOKUP, &pk, epochNum});
+        } else if (GUARD_MODE && pubKeyAndIsGuard[pk]) {
+          suc_counter++;
+        } else {
+          rewards.emplace_back(addresses.at(pk), reward_each);
+          pending.push_back({PendingReward::COSIG, &pk, epochNum});
         }
       }
     }
   }
 
+  LOG_GENERAL(INFO, "[CNBSE] Rewarding "
+                        << rewards.size()
+                        << " base and cosig rewards to lookup, DS, and shard "
+                           "nodes...");
+
+  vector<bool> succeeded;
+  AccountStore::GetInstance().UpdateCoinbaseBatchTemp(coinbaseAddress,
+                                                      rewards, succeeded);
+
+  for (size_t i = 0; i < rewards.size(); i++) {
+    const auto& addr = rewards[i].first;
+    const auto& reward = pending[i];
+    if (!succeeded[i]) {
+      LOG_GENERAL(WARNING,
+                  "Could not reward " << addr << " - " << *reward.m_pubKey);
+      continue;
+    }
+    switch (reward.m_type) {
+      case PendingReward::BASE:
+        if (addr == myAddr) {
+          LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+                    "[REWARD] Rewarded base reward " << base_reward_each);
+          LOG_STATE("[REWARD]["
+                    << setw(15) << left
+                    << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
+                    << m_mediator.m_currentEpochNum << "]["
+                    << base_reward_each << "] base reward");
+        }
+        break;
+      case PendingReward::LOOKUP:
+        nonGuard.emplace_back(addr);
+        suc_lookup_counter++;
+        break;
+      case PendingReward::COSIG:
+        if (addr == myAddr) {
+          LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+                    "[REWARD] Rewarded " << reward_each << " for blk "
+                                         << reward.m_epochNum);
+          LOG_STATE("[REWARD]["
+                    << setw(15) << left
+                    << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
+                    << m_mediator.m_currentEpochNum << "][" << reward_each
+                    << "] for blk " << reward.m_epochNum);
+        }
+        suc_counter++;
+        break;
+    }
+  }
+
   uint128_t balance_left = total_reward - (suc_counter * reward_each) -
                            (suc_lookup_counter * reward_each_lookup) -
                            (node_count * base_reward_each);
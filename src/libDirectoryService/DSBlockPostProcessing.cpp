@@ -68,6 +68,9 @@ bool DirectoryService::StoreDSBlockToStorage() {
     // throw exception();
     return false;
   }
+  m_gasPriceTracker.AddDSBlock(m_pendingDSBlock->GetHeader().GetBlockNum(),
+                               m_pendingDSBlock->GetHeader().GetEpochNum(),
+                               m_pendingDSBlock->GetHeader().GetGasPrice());
 
   // Store DS Block to disk
   bytes serializedDSBlock;
@@ -943,7 +946,8 @@ bool DirectoryService::ProcessDSBlockConsensus(
 
   if (state == ConsensusCommon::State::DONE) {
     m_viewChangeCounter = 0;
-    cv_viewChangeDSBlock.notify_all();
+    Scheduler::GetInstance().Cancel(
+        m_viewChangeDSBlockTimer.exchange(Scheduler::INVALID_TIMER));
     ProcessDSBlockConsensusWhenDone();
   } else if (state == ConsensusCommon::State::ERROR) {
     LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
@@ -1130,6 +1130,9 @@ bool DirectoryService::DSBlockValidator(
     return true;
   }
 
+  // The leader's PoWs are checked against the ones this node has accepted
+  WaitForPoWVerifications();
+
   m_tempShards.clear();
 
   lock(m_mutexPendingDSBlock, m_mutexAllPoWConns);
@@ -1571,6 +1574,8 @@ void DirectoryService::RunConsensusOnDSBlock() {
 
   LOG_MARKER();
 
+  WaitForPoWVerifications();
+
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
             "Number of PoW recvd: " << m_allPoWs.size() << ", DS PoW recvd: "
                                     << m_allDSPoWs.size());
@@ -1595,6 +1600,28 @@ void DirectoryService::RunConsensusOnDSBlock() {
     m_coinbaseRewardees.clear();
   }
 
+  // View change will trigger on timeout, unless the timer is cancelled once
+  // the consensus is done. It is armed before the consensus starts, so that
+  // a consensus done early cannot be missed.
+  auto viewChange = [this]() -> void {
+    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+              "Initiated DS block view change. ");
+
+    if (m_mode == PRIMARY_DS) {
+      ConsensusLeader* cl =
+          dynamic_cast<ConsensusLeader*>(m_consensusObject.get());
+      if (cl != nullptr) {
+        cl->Audit();
+      }
+    }
+
+    auto func = [this]() -> void { RunConsensusOnViewChange(); };
+    DetachedFunction(1, func);
+  };
+  Scheduler::GetInstance().Cancel(m_viewChangeDSBlockTimer.exchange(
+      Scheduler::GetInstance().ScheduleAfter(viewChange,
+                                             VIEWCHANGE_TIME * 1000)));
+
   // Upon consensus object creation failure, one should not return from the
   // function, but rather wait for view change.
   bool ConsensusObjCreation = true;
@@ -1614,25 +1641,4 @@ void DirectoryService::RunConsensusOnDSBlock() {
     SetState(DSBLOCK_CONSENSUS);
     cv_DSBlockConsensusObject.notify_all();
   }
-
-  // View change will wait for timeout. If conditional variable is notified
-  // before timeout, the thread will return without triggering view change.
-  std::unique_lock<std::mutex> cv_lk(m_MutexCVViewChangeDSBlock);
-  if (cv_viewChangeDSBlock.wait_for(cv_lk,
-                                    std::chrono::seconds(VIEWCHANGE_TIME)) ==
-      std::cv_status::timeout) {
-    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-              "Initiated DS block view change. ");
-
-    if (m_mode == PRIMARY_DS) {
-      ConsensusLeader* cl =
-          dynamic_cast<ConsensusLeader*>(m_consensusObject.get());
-      if (cl != nullptr) {
-        cl->Audit();
-      }
-    }
-
-    auto func = [this]() -> void { RunConsensusOnViewChange(); };
-    DetachedFunction(1, func);
-  }
 }
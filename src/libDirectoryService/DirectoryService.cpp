@@ -48,6 +48,8 @@ DirectoryService::DirectoryService(Mediator& mediator) : m_mediator(mediator) {
   if (!LOOKUP_NODE_MODE) {
     SetState(POW_SUBMISSION);
     cv_POWSubmission.notify_all();
+    m_powVerifier =
+        make_unique<PoWVerifier>(POW_VERIFY_THREADS, POW_VERIFY_QUEUE_SIZE);
   }
   m_mode = IDLE;
   SetConsensusLeaderID(0);
@@ -21,8 +21,10 @@
 #include <array>
 #include <condition_variable>
 #include <deque>
+#include <functional>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <shared_mutex>
 
@@ -33,11 +35,14 @@
 #include "libData/BlockData/Block.h"
 #include "libData/BlockData/BlockHeader/BlockHashSet.h"
 #include "libData/MiningData/DSPowSolution.h"
+#include "libDirectoryService/GasPriceTracker.h"
+#include "libDirectoryService/PoWVerifier.h"
 #include "libLookup/Synchronizer.h"
 #include "libNetwork/DataSender.h"
 #include "libNetwork/P2PComm.h"
 #include "libNetwork/ShardStruct.h"
 #include "libPersistence/BlockStorage.h"
+#include "libUtils/Scheduler.h"
 #include "libUtils/TimeUtils.h"
 
 class Mediator;
@@ -180,12 +185,13 @@ class DirectoryService : public Executable {
   std::condition_variable cv_ViewChangeConsensusObj;
   std::mutex m_MutexCVViewChangeConsensusObj;
 
-  std::condition_variable cv_viewChangeDSBlock;
-  std::mutex m_MutexCVViewChangeDSBlock;
-  std::condition_variable cv_viewChangeFinalBlock;
-  std::mutex m_MutexCVViewChangeFinalBlock;
-  std::condition_variable cv_ViewChangeVCBlock;
-  std::mutex m_MutexCVViewChangeVCBlock;
+  // View change timeouts, cancelled once the consensus they guard is done
+  std::atomic<Scheduler::TimerId> m_viewChangeDSBlockTimer{
+      Scheduler::INVALID_TIMER};
+  std::atomic<Scheduler::TimerId> m_viewChangeFinalBlockTimer{
+      Scheduler::INVALID_TIMER};
+  std::atomic<Scheduler::TimerId> m_viewChangeVCBlockTimer{
+      Scheduler::INVALID_TIMER};
 
   // To be used to store vc block (ds block consensus) for "normal nodes"
   std::mutex m_mutexVCBlockVector;
@@ -224,6 +230,9 @@ class DirectoryService : public Executable {
   std::vector<DSPowSolution> m_powSolutions;
   std::mutex m_mutexPowSolution;
 
+  // ethash checks of pow submissions (not used on lookups)
+  std::unique_ptr<PoWVerifier> m_powVerifier;
+
   const uint32_t RESHUFFLE_INTERVAL = 500;
 
   // Message handlers
@@ -233,7 +242,15 @@ class DirectoryService : public Executable {
                             const Peer& from);
   bool ProcessPoWPacketSubmission(const bytes& message, unsigned int offset,
                                   const Peer& from);
-  bool VerifyPoWSubmission(const DSPowSolution& sol);
+  /// Runs the cheap checks on the calling thread and queues the ethash check
+  /// on m_powVerifier. onDone gets the ethash result once it is known.
+  /// Returns false if the solution was rejected or dropped before that point.
+  bool VerifyPoWSubmission(const DSPowSolution& sol,
+                           std::function<void(bool)> onDone = nullptr);
+  void AcceptVerifiedPoWSubmission(const DSPowSolution& sol);
+  /// Lets queued verifications land before the PoW maps are read to send,
+  /// compose or validate from them
+  void WaitForPoWVerifications();
 
   bool ProcessDSBlockConsensus(const bytes& message, unsigned int offset,
                                const Peer& from);
@@ -267,8 +284,10 @@ class DirectoryService : public Executable {
                                    const Peer& submitterPeer);
 
   // For PoW submission counter
-  bool CheckPoWSubmissionExceedsLimitsForNode(const PubKey& key);
-  void UpdatePoWSubmissionCounterforNode(const PubKey& key);
+  /// Counts a submission against the node's limit, or returns false if the
+  /// node has reached it
+  bool ReservePoWSubmissionSlotForNode(const PubKey& key);
+  void ReleasePoWSubmissionSlotForNode(const PubKey& key);
   void ResetPoWSubmissionCounter();
   void ClearReputationOfNodeWithoutPoW();
   static void ClearReputationOfNodeFailToJoin(
@@ -493,6 +512,10 @@ class DirectoryService : public Executable {
   DequeOfShard m_shards;
   std::map<PubKey, uint32_t> m_publicKeyToshardIdMap;
 
+  // Rolling inputs of GetNewGasPrice, fed as blocks are added to the chains
+  GasPriceTracker m_gasPriceTracker{GAS_CONGESTION_PERCENT,
+                                    MEAN_GAS_PRICE_DS_NUM + 1};
+
   // Proof of Reputation(PoR) variables.
   std::map<PubKey, uint16_t> m_mapNodeReputation;
 
@@ -36,6 +36,7 @@
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
 #include "libUtils/SanityChecks.h"
+#include "libUtils/Scheduler.h"
 
 using namespace std;
 using namespace boost::multiprecision;
@@ -168,12 +169,9 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
 
   // StoreMicroBlocksToDisk();
 
-  auto resumeBlackList = []() mutable -> void {
-    this_thread::sleep_for(chrono::seconds(RESUME_BLACKLIST_DELAY_IN_SECONDS));
-    Blacklist::GetInstance().Enable(true);
-  };
-
-  DetachedFunction(1, resumeBlackList);
+  Scheduler::GetInstance().ScheduleAfter(
+      []() { Blacklist::GetInstance().Enable(true); },
+      RESUME_BLACKLIST_DELAY_IN_SECONDS * 1000);
 
   if (!StoreFinalBlockToDisk()) {
     LOG_GENERAL(WARNING, "StoreFinalBlockToDisk failed!");
@@ -554,7 +552,8 @@ bool DirectoryService::ProcessFinalBlockConsensusCore(
   ConsensusCommon::State state = m_consensusObject->GetState();
 
   if (state == ConsensusCommon::State::DONE) {
-    cv_viewChangeFinalBlock.notify_all();
+    Scheduler::GetInstance().Cancel(
+        m_viewChangeFinalBlockTimer.exchange(Scheduler::INVALID_TIMER));
     m_viewChangeCounter = 0;
     ProcessFinalBlockConsensusWhenDone();
   } else if (state == ConsensusCommon::State::ERROR) {
@@ -297,7 +297,8 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSPrimary() {
              bytes& messageToCosign) mutable -> bool {
     return Messenger::SetDSFinalBlockAnnouncement(
         dst, offset, consensusID, blockNumber, blockHash, leaderID, leaderKey,
-        *m_finalBlock, m_mediator.m_node->m_microblock, messageToCosign);
+        *m_finalBlock, m_mediator.m_node->m_microblock,
+        m_mediator.m_node->GetMicroBlockCompactTxnHashes(), messageToCosign);
   };
 
   cl->StartConsensus(announcementGeneratorFunc, BROADCAST_GOSSIP_MODE);
@@ -955,7 +956,7 @@ bool DirectoryService::FinalBlockValidator(
   if (!Messenger::GetDSFinalBlockAnnouncement(
           message, offset, consensusID, blockNumber, blockHash, leaderID,
           leaderKey, *m_finalBlock, m_mediator.m_node->m_microblock,
-          messageToCosign)) {
+          m_mediator.m_node->m_microblockCompactTxnHashes, messageToCosign)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::GetDSFinalBlockAnnouncement failed");
     m_mediator.m_node->m_microblock = nullptr;
@@ -1231,34 +1232,30 @@ void DirectoryService::RunConsensusOnFinalBlock() {
     DetachedFunction(1, func1);
   }
 
-  auto func1 = [this]() -> void {
-    // View change will wait for timeout. If conditional variable is notified
-    // before timeout, the thread will return without triggering view change.
-    std::unique_lock<std::mutex> cv_lk(m_MutexCVViewChangeFinalBlock);
-    if (cv_viewChangeFinalBlock.wait_for(
-            cv_lk, std::chrono::seconds(VIEWCHANGE_TIME)) ==
-        std::cv_status::timeout) {
-      LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-                "Initiated final block view change");
-
-      if (m_mode == PRIMARY_DS) {
-        ConsensusLeader* cl =
-            dynamic_cast<ConsensusLeader*>(m_consensusObject.get());
-        if (cl != nullptr) {
-          cl->Audit();
-        }
-      }
+  // View change will trigger on timeout, unless the timer is cancelled once
+  // the consensus is done.
+  auto viewChange = [this]() -> void {
+    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+              "Initiated final block view change");
 
-      auto func2 = [this]() -> void {
-        RemoveDSMicroBlock();  // Remove DS microblock from my list of
-                               // microblocks
-        RunConsensusOnViewChange();
-      };
-      DetachedFunction(1, func2);
+    if (m_mode == PRIMARY_DS) {
+      ConsensusLeader* cl =
+          dynamic_cast<ConsensusLeader*>(m_consensusObject.get());
+      if (cl != nullptr) {
+        cl->Audit();
+      }
     }
-  };
 
-  DetachedFunction(1, func1);
+    auto func2 = [this]() -> void {
+      RemoveDSMicroBlock();  // Remove DS microblock from my list of
+                             // microblocks
+      RunConsensusOnViewChange();
+    };
+    DetachedFunction(1, func2);
+  };
+  Scheduler::GetInstance().Cancel(m_viewChangeFinalBlockTimer.exchange(
+      Scheduler::GetInstance().ScheduleAfter(viewChange,
+                                             VIEWCHANGE_TIME * 1000)));
 }
 
 void DirectoryService::RemoveDSMicroBlock() {
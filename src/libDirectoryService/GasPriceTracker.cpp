@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "GasPriceTracker.h"
+
+using namespace std;
+
+const uint8_t GasPriceTracker::UNKNOWN;
+
+GasPriceTracker::GasPriceTracker(unsigned int congestionPercent,
+                                 uint64_t dsWindowSize)
+    : m_congestionPercent(congestionPercent), m_dsWindowSize(dsWindowSize) {}
+
+bool GasPriceTracker::IsCongested(const uint128_t& gasUsed,
+                                  const uint128_t& gasLimit) const {
+  return gasUsed >= gasLimit * m_congestionPercent / 100;
+}
+
+void GasPriceTracker::PopFrontTxBlock() {
+  if (m_congested.front() == UNKNOWN) {
+    m_numUnknown--;
+  } else {
+    m_numCongested -= m_congested.front();
+  }
+  m_congested.pop_front();
+  m_firstTxBlockNum++;
+}
+
+void GasPriceTracker::PopBackTxBlock() {
+  if (m_congested.back() == UNKNOWN) {
+    m_numUnknown--;
+  } else {
+    m_numCongested -= m_congested.back();
+  }
+  m_congested.pop_back();
+}
+
+void GasPriceTracker::AddTxBlock(uint64_t blockNum, const uint128_t& gasUsed,
+                                 const uint128_t& gasLimit) {
+  const uint8_t congested = IsCongested(gasUsed, gasLimit);
+
+  lock_guard<mutex> g(m_mutex);
+
+  if (m_congested.empty()) {
+    m_firstTxBlockNum = blockNum;
+  } else if (blockNum < m_firstTxBlockNum) {
+    return;
+  }
+
+  // Blocks in between are fetched when a window needs them
+  while (m_firstTxBlockNum + m_congested.size() < blockNum) {
+    m_congested.push_back(UNKNOWN);
+    m_numUnknown++;
+  }
+  if (m_firstTxBlockNum + m_congested.size() == blockNum) {
+    m_congested.push_back(congested);
+    m_numCongested += congested;
+    return;
+  }
+
+  uint8_t& slot = m_congested[blockNum - m_firstTxBlockNum];
+  if (slot == UNKNOWN) {
+    m_numUnknown--;
+  } else {
+    m_numCongested -= slot;
+  }
+  slot = congested;
+  m_numCongested += congested;
+}
+
+void GasPriceTracker::CountCongested(uint64_t loBlockNum, uint64_t hiBlockNum,
+                                     const TxBlockFetcher& fetch,
+                                     uint64_t& total, uint64_t& congested) {
+  total = 0;
+  congested = 0;
+  if (loBlockNum > hiBlockNum) {
+    return;
+  }
+
+  lock_guard<mutex> g(m_mutex);
+
+  // Fit the tracked blocks to the window
+  if (m_congested.empty() ||
+      loBlockNum > m_firstTxBlockNum + m_congested.size()) {
+    m_firstTxBlockNum = loBlockNum;
+    m_congested.clear();
+    m_numCongested = 0;
+    m_numUnknown = 0;
+  }
+  while (m_firstTxBlockNum < loBlockNum) {
+    PopFrontTxBlock();
+  }
+  while (m_firstTxBlockNum > loBlockNum) {
+    m_congested.push_front(UNKNOWN);
+    m_numUnknown++;
+    m_firstTxBlockNum--;
+  }
+  while (!m_congested.empty() &&
+         m_firstTxBlockNum + m_congested.size() - 1 > hiBlockNum) {
+    PopBackTxBlock();
+  }
+  while (m_firstTxBlockNum + m_congested.size() <= hiBlockNum) {
+    m_congested.push_back(UNKNOWN);
+    m_numUnknown++;
+  }
+
+  for (size_t i = 0; m_numUnknown > 0 && i < m_congested.size(); i++) {
+    if (m_congested[i] == UNKNOWN) {
+      m_congested[i] = fetch(m_firstTxBlockNum + i);
+      m_numCongested += m_congested[i];
+      m_numUnknown--;
+    }
+  }
+
+  total = m_congested.size();
+  congested = m_numCongested;
+}
+
+void GasPriceTracker::AddDSBlock(uint64_t blockNum, uint64_t epochNum,
+                                 const uint128_t& gasPrice) {
+  lock_guard<mutex> g(m_mutex);
+
+  while (!m_congested.empty() && m_firstTxBlockNum < epochNum) {
+    PopFrontTxBlock();
+  }
+
+  const uint64_t endBlockNum = m_firstDSBlockNum + m_dsGasPrices.size();
+  if (m_dsGasPrices.empty() || blockNum > endBlockNum) {
+    m_firstDSBlockNum = blockNum;
+    m_dsGasPrices.assign(1, gasPrice);
+  } else if (blockNum == endBlockNum) {
+    m_dsGasPrices.push_back(gasPrice);
+  } else if (blockNum >= m_firstDSBlockNum) {
+    m_dsGasPrices[blockNum - m_firstDSBlockNum] = gasPrice;
+  }
+  while (m_dsGasPrices.size() > m_dsWindowSize) {
+    m_dsGasPrices.pop_front();
+    m_firstDSBlockNum++;
+  }
+}
+
+vector<uint128_t> GasPriceTracker::GetDSGasPrices(uint64_t loBlockNum,
+                                                  uint64_t hiBlockNum,
+                                                  const DSBlockFetcher& fetch) {
+  if (loBlockNum > hiBlockNum) {
+    return {};
+  }
+
+  lock_guard<mutex> g(m_mutex);
+
+  if (loBlockNum < m_firstDSBlockNum ||
+      loBlockNum > m_firstDSBlockNum + m_dsGasPrices.size()) {
+    m_firstDSBlockNum = loBlockNum;
+    m_dsGasPrices.clear();
+  }
+  while (m_firstDSBlockNum < loBlockNum) {
+    m_dsGasPrices.pop_front();
+    m_firstDSBlockNum++;
+  }
+  while (!m_dsGasPrices.empty() &&
+         m_firstDSBlockNum + m_dsGasPrices.size() - 1 > hiBlockNum) {
+    m_dsGasPrices.pop_back();
+  }
+  while (m_firstDSBlockNum + m_dsGasPrices.size() <= hiBlockNum) {
+    m_dsGasPrices.push_back(fetch(m_firstDSBlockNum + m_dsGasPrices.size()));
+  }
+
+  return {m_dsGasPrices.begin(), m_dsGasPrices.end()};
+}
+
+void GasPriceTracker::AddProposal(const uint128_t& gasPrice) {
+  lock_guard<mutex> g(m_mutex);
+
+  // Equal values go after the ones already there, so after the median too
+  m_proposals.insert(gasPrice);
+  const size_t n = m_proposals.size();
+  if (n == 1) {
+    m_median = m_proposals.begin();
+  } else if (gasPrice < *m_median) {
+    if (n % 2 == 0) {
+      --m_median;
+    }
+  } else if (n % 2 == 1) {
+    ++m_median;
+  }
+}
+
+void GasPriceTracker::RemoveProposal(const uint128_t& gasPrice) {
+  lock_guard<mutex> g(m_mutex);
+
+  const auto it = m_proposals.find(gasPrice);
+  if (it == m_proposals.end()) {
+    return;
+  }
+
+  const size_t n = m_proposals.size();
+  if (gasPrice < *m_median) {
+    m_proposals.erase(it);
+    if (n % 2 == 0) {
+      ++m_median;
+    }
+  } else if (*m_median < gasPrice) {
+    m_proposals.erase(it);
+    if (n % 2 == 1) {
+      --m_median;
+    }
+  } else {
+    // Remove the median itself, its neighbour takes over its rank
+    const auto removed = m_median;
+    if (n == 1) {
+      m_median = m_proposals.end();
+    } else if (n % 2 == 0) {
+      ++m_median;
+    } else {
+      --m_median;
+    }
+    m_proposals.erase(removed);
+  }
+}
+
+void GasPriceTracker::ClearProposals() {
+  lock_guard<mutex> g(m_mutex);
+  m_proposals.clear();
+  m_median = m_proposals.end();
+}
+
+size_t GasPriceTracker::GetNumProposals() {
+  lock_guard<mutex> g(m_mutex);
+  return m_proposals.size();
+}
+
+bool GasPriceTracker::GetMedianProposal(const uint128_t& upperbound,
+                                        uint128_t& median) {
+  lock_guard<mutex> g(m_mutex);
+
+  if (m_proposals.empty()) {
+    return false;
+  }
+
+  // Walk back from the median of all proposals by half the ones excluded
+  const size_t numAbove = distance(m_proposals.upper_bound(upperbound),
+                                   m_proposals.end());
+  const size_t n = m_proposals.size() - numAbove;
+  if (n == 0) {
+    return false;
+  }
+
+  auto lower = m_median;
+  for (size_t steps = (m_proposals.size() - 1) / 2 - (n - 1) / 2; steps > 0;
+       steps--) {
+    --lower;
+  }
+
+  if (n % 2 == 0) {
+    median = (*lower + *next(lower)) / 2;
+  } else {
+    median = *lower;
+  }
+  return true;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDIRECTORYSERVICE_GASPRICETRACKER_H_
+#define ZILLIQA_SRC_LIBDIRECTORYSERVICE_GASPRICETRACKER_H_
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "common/BaseType.h"
+
+/// Rolling inputs of the DS gas price: congestion of the Tx blocks since the
+/// last DS block, gas prices of the recent DS blocks, and the gas prices
+/// proposed in the DS PoW submissions kept ordered around their median.
+///
+/// Blocks are recorded as they are added to the chain. A block that was not
+/// recorded (e.g. after a rejoin) is fetched once, the first time a window
+/// needs it, so the results always match a walk over the chain. Recording a
+/// DS block drops what the next windows no longer cover.
+class GasPriceTracker {
+ public:
+  typedef std::function<bool(uint64_t)> TxBlockFetcher;
+  typedef std::function<uint128_t(uint64_t)> DSBlockFetcher;
+
+  /// dsWindowSize is the most DS blocks GetDSGasPrices is asked for.
+  GasPriceTracker(unsigned int congestionPercent, uint64_t dsWindowSize);
+
+  GasPriceTracker(const GasPriceTracker&) = delete;
+  GasPriceTracker& operator=(const GasPriceTracker&) = delete;
+
+  bool IsCongested(const uint128_t& gasUsed, const uint128_t& gasLimit) const;
+
+  void AddTxBlock(uint64_t blockNum, const uint128_t& gasUsed,
+                  const uint128_t& gasLimit);
+
+  /// Counts the Tx blocks in [loBlockNum, hiBlockNum] and the congested ones.
+  /// fetch tells whether an unrecorded block is congested.
+  void CountCongested(uint64_t loBlockNum, uint64_t hiBlockNum,
+                      const TxBlockFetcher& fetch, uint64_t& total,
+                      uint64_t& congested);
+
+  /// epochNum is the Tx block number the DS block was mined at, where the
+  /// next congestion window starts.
+  void AddDSBlock(uint64_t blockNum, uint64_t epochNum,
+                  const uint128_t& gasPrice);
+
+  /// Gas prices of the DS blocks in [loBlockNum, hiBlockNum], in block order.
+  /// fetch returns the gas price of an unrecorded block.
+  std::vector<uint128_t> GetDSGasPrices(uint64_t loBlockNum,
+                                        uint64_t hiBlockNum,
+                                        const DSBlockFetcher& fetch);
+
+  void AddProposal(const uint128_t& gasPrice);
+  void RemoveProposal(const uint128_t& gasPrice);
+  void ClearProposals();
+  size_t GetNumProposals();
+
+  /// Median of the proposals not above upperbound, the mean of the middle two
+  /// for an even count. Returns false if there is no such proposal.
+  bool GetMedianProposal(const uint128_t& upperbound, uint128_t& median);
+
+ private:
+  const unsigned int m_congestionPercent;
+  const uint64_t m_dsWindowSize;
+
+  std::mutex m_mutex;
+
+  // Congestion of the Tx blocks from m_firstTxBlockNum on, UNKNOWN for
+  // those skipped by AddTxBlock
+  static const uint8_t UNKNOWN = 2;
+  uint64_t m_firstTxBlockNum{0};
+  std::deque<uint8_t> m_congested;
+  uint64_t m_numCongested{0};
+  uint64_t m_numUnknown{0};
+
+  void PopFrontTxBlock();
+  void PopBackTxBlock();
+
+  // Gas prices of the DS blocks from m_firstDSBlockNum on
+  uint64_t m_firstDSBlockNum{0};
+  std::deque<uint128_t> m_dsGasPrices;
+
+  // Ordered, with m_median at rank (size - 1) / 2, so adding or removing a
+  // proposal is O(log n) and the median under an upper bound is only as far
+  // from m_median as half the proposals above the bound
+  std::multiset<uint128_t> m_proposals;
+  std::multiset<uint128_t>::iterator m_median{m_proposals.end()};
+};
+
+#endif  // ZILLIQA_SRC_LIBDIRECTORYSERVICE_GASPRICETRACKER_H_
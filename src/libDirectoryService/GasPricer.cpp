@@ -34,16 +34,14 @@ uint128_t DirectoryService::GetNewGasPrice() {
 
   const uint128_t& minGasPrice = GAS_PRICE_MIN_VALUE;
 
-  for (uint64_t i = loBlockNum; i <= hiBlockNum; ++i) {
-    uint128_t gasUsed =
-        m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetGasUsed();
-    uint128_t gasLimit =
-        m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetGasLimit();
-    if (gasUsed >= gasLimit * GAS_CONGESTION_PERCENT / 100) {
-      fullBlockNum++;
-    }
-    totalBlockNum++;
-  }
+  m_gasPriceTracker.CountCongested(
+      loBlockNum, hiBlockNum,
+      [this](uint64_t blockNum) {
+        const TxBlock block = m_mediator.m_txBlockChain.GetBlock(blockNum);
+        return m_gasPriceTracker.IsCongested(block.GetHeader().GetGasUsed(),
+                                             block.GetHeader().GetGasLimit());
+      },
+      totalBlockNum, fullBlockNum);
 
   if (fullBlockNum < totalBlockNum * UNFILLED_PERCENT_LOW / 100) {
     return GetDecreasedGasPrice();
@@ -60,16 +58,19 @@ uint128_t DirectoryService::GetHistoricalMeanGasPrice() {
   uint64_t lowDSBlockNum = (curDSBlockNum > MEAN_GAS_PRICE_DS_NUM)
                                ? (curDSBlockNum - MEAN_GAS_PRICE_DS_NUM)
                                : 0;
+  // DS block 0 is left out
+  const auto gasPrices = m_gasPriceTracker.GetDSGasPrices(
+      max<uint64_t>(lowDSBlockNum, 1), curDSBlockNum,
+      [this](uint64_t blockNum) {
+        return m_mediator.m_dsBlockChain.GetBlock(blockNum)
+            .GetHeader()
+            .GetGasPrice();
+      });
+
   uint64_t totalBlockNum = 0;
   uint128_t totalGasPrice = 0;
-  for (uint64_t i = curDSBlockNum; i >= lowDSBlockNum; --i) {
-    if (i == 0) {
-      break;
-    }
-    if (!SafeMath<uint128_t>::add(
-            totalGasPrice,
-            m_mediator.m_dsBlockChain.GetBlock(i).GetHeader().GetGasPrice(),
-            totalGasPrice)) {
+  for (auto it = gasPrices.rbegin(); it != gasPrices.rend(); ++it) {
+    if (!SafeMath<uint128_t>::add(totalGasPrice, *it, totalGasPrice)) {
       continue;
     }
     totalBlockNum++;
@@ -111,28 +112,19 @@ uint128_t DirectoryService::GetIncreasedGasPrice() {
                  PRECISION_MIN_VALUE * mean_val;
   }
 
-  multiset<uint128_t> gasProposals;
-  for (const auto& soln : m_allDSPoWs) {
-    if (soln.second.m_gasPrice <= upperbound) {
-      gasProposals.emplace(soln.second.m_gasPrice);
-    }
-  }
-  if (gasProposals.empty()) {
-    return GetHistoricalMeanGasPrice();
-  }
-
-  // Get median value
-  const size_t n = gasProposals.size();
-  auto iter = gasProposals.cbegin();
-  std::advance(iter, n / 2);
-
   uint128_t median_val;
-
-  if (n % 2 == 0) {
-    const auto iter2 = iter--;
-    median_val = (*iter + *iter2) / 2;
-  } else {
-    median_val = *iter;
+  {
+    lock_guard<mutex> g(m_mutexAllDSPOWs);
+    // Rebuild if m_allDSPoWs was changed other than through AddDSPoWs
+    if (m_gasPriceTracker.GetNumProposals() != m_allDSPoWs.size()) {
+      m_gasPriceTracker.ClearProposals();
+      for (const auto& soln : m_allDSPoWs) {
+        m_gasPriceTracker.AddProposal(soln.second.m_gasPrice);
+      }
+    }
+    if (!m_gasPriceTracker.GetMedianProposal(upperbound, median_val)) {
+      return mean_val;
+    }
   }
 
   const uint128_t& minGasPrice = GAS_PRICE_MIN_VALUE;
@@ -26,6 +26,7 @@
 #include "depends/common/RLP.h"
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
+#include "libConsensus/AggregateKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
@@ -45,7 +46,7 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
   LOG_MARKER();
 
   const vector<bool>& B2 = microBlock.GetB2();
-  vector<PubKey> keys;
+  vector<const PubKey*> committee;
   unsigned int index = 0;
   unsigned int count = 0;
 
@@ -58,8 +59,8 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
     }
 
     for (const auto& ds : *m_mediator.m_DSCommittee) {
+      committee.emplace_back(&ds.first);
       if (B2.at(index)) {
-        keys.emplace_back(ds.first);
         count++;
       }
       index++;
@@ -76,8 +77,8 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
 
     // Generate the aggregated key
     for (const auto& kv : shard) {
+      committee.emplace_back(&std::get<SHARD_NODE_PUBKEY>(kv));
       if (B2.at(index)) {
-        keys.emplace_back(std::get<SHARD_NODE_PUBKEY>(kv));
         count++;
       }
       index++;
@@ -92,7 +93,8 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<const PubKey> aggregatedKey =
+      AggregateKeyCache::GetInstance().AggregateKeys(committee, B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -109,8 +111,10 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
   if (!MultiSig::MultiSigVerify(message, 0, message.size(), microBlock.GetCS2(),
                                 *aggregatedKey)) {
     LOG_GENERAL(WARNING, "Cosig verification failed");
-    for (auto& kv : keys) {
-      LOG_GENERAL(WARNING, kv);
+    for (unsigned int i = 0; i < committee.size(); i++) {
+      if (B2.at(i)) {
+        LOG_GENERAL(WARNING, *committee.at(i));
+      }
     }
     return false;
   }
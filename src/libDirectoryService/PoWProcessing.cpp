@@ -40,9 +40,16 @@
 using namespace std;
 using namespace boost::multiprecision;
 
+namespace {
+// Upper bound on how long the end of the PoW window waits for queued checks
+const chrono::milliseconds POW_VERIFY_DRAIN_TIMEOUT{3000};
+}  // namespace
+
 bool DirectoryService::SendPoWPacketSubmissionToOtherDSComm() {
   LOG_MARKER();
 
+  WaitForPoWVerifications();
+
   bytes powpacketmessage = {MessageType::DIRECTORY,
                             DSInstructionType::POWPACKETSUBMISSION};
 
@@ -210,26 +217,31 @@ bool DirectoryService::ProcessPoWSubmission(const bytes& message,
                         gasPrice, std::make_pair(govProposalId, govVoteValue),
                         signature);
 
-  if (VerifyPoWSubmission(powSoln)) {
+  // The solution is forwarded to the other DS members once it checks out
+  return VerifyPoWSubmission(powSoln, [this, powSoln](bool valid) {
+    const PubKey& key = powSoln.GetSubmitterKey();
+    if (!valid) {
+      LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+                "PoW submission from " << key << " failed verification");
+      return;
+    }
     std::unique_lock<std::mutex> lk(m_mutexPowSolution);
     auto submittedNumber =
         std::count_if(m_powSolutions.begin(), m_powSolutions.end(),
-                      [&submitterKey](const DSPowSolution& soln) {
-                        return submitterKey == soln.GetSubmitterKey();
+                      [&key](const DSPowSolution& soln) {
+                        return key == soln.GetSubmitterKey();
                       });
     if (submittedNumber >= POW_SUBMISSION_LIMIT) {
       LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
-                "Node " << submitterKey
-                        << " submitted pow count already reach limit");
-      return false;
+                "Node " << key << " submitted pow count already reach limit");
+      return;
     }
     m_powSolutions.emplace_back(powSoln);
-  }
-
-  return true;
+  });
 }
 
-bool DirectoryService::VerifyPoWSubmission(const DSPowSolution& sol) {
+bool DirectoryService::VerifyPoWSubmission(const DSPowSolution& sol,
+                                           std::function<void(bool)> onDone) {
   LOG_MARKER();
 
   if (LOOKUP_NODE_MODE) {
@@ -278,6 +290,9 @@ bool DirectoryService::VerifyPoWSubmission(const DSPowSolution& sol) {
   }
 
   if (!CheckState(VERIFYPOW)) {
+    if (onDone) {
+      onDone(true);
+    }
     return true;
   }
 
@@ -294,11 +309,6 @@ bool DirectoryService::VerifyPoWSubmission(const DSPowSolution& sol) {
   LOG_GENERAL(INFO, "GovProposalId  = " << to_string(govProposalId));
   LOG_GENERAL(INFO, "GovVoteValue   = " << to_string(govVoteValue));
 
-  if (CheckPoWSubmissionExceedsLimitsForNode(submitterPubKey)) {
-    LOG_GENERAL(WARNING, "Max PoW sent");
-    return false;
-  }
-
   // Define the PoW parameters
   array<unsigned char, 32> rand1 = m_mediator.m_dsBlockRand;
   array<unsigned char, 32> rand2 = m_mediator.m_txBlockRand;
@@ -346,73 +356,119 @@ bool DirectoryService::VerifyPoWSubmission(const DSPowSolution& sol) {
     }
   }
 
-  // m_timespec = r_timer_start();
-
-  auto headerHash = POW::GenHeaderHash(rand1, rand2, submitterPeer,
-                                       submitterPubKey, lookupId, gasPrice);
-  bool result = POW::GetInstance().PoWVerify(
-      blockNumber, difficultyLevel, headerHash, nonce, resultingHash, mixHash);
-
-  // LOG_GENERAL(INFO, "[POWSTAT] " << r_timer_end(m_timespec));
-
-  if (result) {
-    // Do another check on the state before accessing m_allPoWs
-    // Accept slightly late entries as we need to multicast the DSBLOCK to
-    // everyone if ((m_state != POW_SUBMISSION) && (m_state !=
-    // DSBLOCK_CONSENSUS_PREP))
-    if (CheckState(VERIFYPOW)) {
-      // LOG_GENERAL(INFO, "Verified OK");
-      lock(m_mutexAllPOW, m_mutexAllPoWConns);
-      lock_guard<mutex> g(m_mutexAllPOW, adopt_lock);
-      lock_guard<mutex> g2(m_mutexAllPoWConns, adopt_lock);
-
-      array<uint8_t, 32> resultingHashArr{}, mixHashArr{};
-      DataConversion::HexStrToStdArray(resultingHash, resultingHashArr);
-      DataConversion::HexStrToStdArray(mixHash, mixHashArr);
-      PoWSolution soln(nonce, resultingHashArr, mixHashArr, lookupId, gasPrice,
-                       std::make_pair(govProposalId, govVoteValue));
-
-      m_allPoWConns.emplace(submitterPubKey, submitterPeer);
-      if (m_allPoWs.find(submitterPubKey) == m_allPoWs.end()) {
-        m_allPoWs[submitterPubKey] = soln;
-      } else if (m_allPoWs[submitterPubKey].m_result > soln.m_result) {
-        // string harderSolnStr, oldSolnStr;
-        // DataConversion::charArrToHexStr(soln.result, harderSolnStr);
-        // DataConversion::charArrToHexStr(m_allPoWs[submitterPubKey].result,
-        // oldSolnStr);
-        LOG_GENERAL(INFO, "Replaced");
-        m_allPoWs[submitterPubKey] = soln;
-      } else if (m_allPoWs[submitterPubKey].m_result == soln.m_result) {
-        LOG_GENERAL(INFO, "Duplicated");
-        return true;
-      }
+  PoWVerifier::Request request;
+  request.m_blockNum = blockNumber;
+  request.m_difficulty = difficultyLevel;
+  request.m_headerHash =
+      POW::GenHeaderHash(rand1, rand2, submitterPeer, submitterPubKey,
+                         lookupId, gasPrice);
+  request.m_nonce = nonce;
+  request.m_resultingHash = resultingHash;
+  request.m_mixHash = mixHash;
 
-      uint8_t expectedDSDiff = DS_POW_DIFFICULTY;
-      if (blockNumber > 1) {
-        expectedDSDiff = m_mediator.m_dsBlockChain.GetLastBlock()
-                             .GetHeader()
-                             .GetDSDifficulty();
-      }
+  // The slot is taken before queueing so that submissions still being
+  // verified count against the limit, and is given back if they fail
+  if (!ReservePoWSubmissionSlotForNode(submitterPubKey)) {
+    LOG_GENERAL(WARNING, "Max PoW sent");
+    return false;
+  }
 
-      // Push the same solution into the DS PoW list if it qualifies
-      if (difficultyLevel >= expectedDSDiff) {
-        AddDSPoWs(submitterPubKey, soln);
-      }
+  return m_powVerifier->Verify(
+      move(request), [this, sol, rand1, rand2, onDone](bool result) {
+        if (!result) {
+          ReleasePoWSubmissionSlotForNode(sol.GetSubmitterKey());
+          string rand1Str, rand2Str;
+          DataConversion::charArrToHexStr(rand1, rand1Str);
+          DataConversion::charArrToHexStr(rand2, rand2Str);
+          LOG_GENERAL(INFO, "[Invalid PoW] Block: "
+                                << sol.GetBlockNumber() << " Diff: "
+                                << to_string(sol.GetDifficultyLevel())
+                                << " Nonce: " << sol.GetNonce()
+                                << " IP: " << sol.GetSubmitterPeer()
+                                << " Rand1: " << rand1Str
+                                << " Rand2: " << rand2Str);
+        } else {
+          AcceptVerifiedPoWSubmission(sol);
+        }
+
+        if (onDone) {
+          onDone(result);
+        }
+      });
+}
 
-      UpdatePoWSubmissionCounterforNode(submitterPubKey);
-    }
-  } else {
-    string rand1Str, rand2Str;
-    DataConversion::charArrToHexStr(rand1, rand1Str);
-    DataConversion::charArrToHexStr(rand2, rand2Str);
-    LOG_GENERAL(INFO, "[Invalid PoW] Block: "
-                          << blockNumber
-                          << " Diff: " << to_string(difficultyLevel)
-                          << " Nonce: " << nonce << " IP: " << submitterPeer
-                          << " Rand1: " << rand1Str << " Rand2: " << rand2Str);
+void DirectoryService::AcceptVerifiedPoWSubmission(const DSPowSolution& sol) {
+  // Do another check on the state before accessing m_allPoWs
+  // Accept slightly late entries as we need to multicast the DSBLOCK to
+  // everyone if ((m_state != POW_SUBMISSION) && (m_state !=
+  // DSBLOCK_CONSENSUS_PREP))
+  if (!CheckState(VERIFYPOW)) {
+    return;
+  }
+
+  const PubKey& submitterPubKey = sol.GetSubmitterKey();
+  const uint64_t blockNumber = sol.GetBlockNumber();
+
+  lock(m_mutexAllPOW, m_mutexAllPoWConns);
+  lock_guard<mutex> g(m_mutexAllPOW, adopt_lock);
+  lock_guard<mutex> g2(m_mutexAllPoWConns, adopt_lock);
+
+  array<uint8_t, 32> resultingHashArr{}, mixHashArr{};
+  DataConversion::HexStrToStdArray(sol.GetResultingHash(), resultingHashArr);
+  DataConversion::HexStrToStdArray(sol.GetMixHash(), mixHashArr);
+  PoWSolution soln(
+      sol.GetNonce(), resultingHashArr, mixHashArr, sol.GetLookupId(),
+      sol.GetGasPrice(),
+      std::make_pair(sol.GetGovProposalId(), sol.GetGovVoteValue()));
+
+  m_allPoWConns.emplace(submitterPubKey, sol.GetSubmitterPeer());
+  if (m_allPoWs.find(submitterPubKey) == m_allPoWs.end()) {
+    m_allPoWs[submitterPubKey] = soln;
+  } else if (m_allPoWs[submitterPubKey].m_result > soln.m_result) {
+    LOG_GENERAL(INFO, "Replaced");
+    m_allPoWs[submitterPubKey] = soln;
+  } else if (m_allPoWs[submitterPubKey].m_result == soln.m_result) {
+    LOG_GENERAL(INFO, "Duplicated");
+    return;
+  }
+
+  uint8_t expectedDSDiff = DS_POW_DIFFICULTY;
+  if (blockNumber > 1) {
+    expectedDSDiff =
+        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty();
   }
 
-  return result;
+  // Push the same solution into the DS PoW list if it qualifies
+  if (sol.GetDifficultyLevel() >= expectedDSDiff) {
+    AddDSPoWs(submitterPubKey, soln);
+  }
+}
+
+void DirectoryService::WaitForPoWVerifications() {
+  if (!m_powVerifier) {
+    return;
+  }
+
+  if (!m_powVerifier->WaitUntilIdle(POW_VERIFY_DRAIN_TIMEOUT)) {
+    LOG_GENERAL(WARNING, "PoW verifications still pending after "
+                             << POW_VERIFY_DRAIN_TIMEOUT.count() << " ms");
+  }
+
+  const auto stats = m_powVerifier->GetStats();
+  const uint64_t handled = stats.m_valid + stats.m_invalid;
+  LOG_GENERAL(INFO, "[POWSTAT] Valid: "
+                        << stats.m_valid << " Invalid: " << stats.m_invalid
+                        << " Queued: " << stats.m_queued
+                        << " Inline (queue full): " << stats.m_inline
+                        << " Dropped: " << stats.m_dropped
+                        << " Pending: " << stats.m_queueDepth
+                        << " Max queue: " << stats.m_maxQueueDepth
+                        << " Avg verify (us): "
+                        << (handled ? stats.m_totalVerifyMicrosec / handled : 0)
+                        << " Avg wait (us): "
+                        << (stats.m_queued
+                                ? stats.m_totalWaitMicrosec / stats.m_queued
+                                : 0));
 }
 
 bool DirectoryService::CheckSolnFromNonDSCommittee(
@@ -438,24 +494,22 @@ bool DirectoryService::CheckSolnFromNonDSCommittee(
   return true;
 }
 
-bool DirectoryService::CheckPoWSubmissionExceedsLimitsForNode(
-    const PubKey& key) {
+bool DirectoryService::ReservePoWSubmissionSlotForNode(const PubKey& key) {
   lock_guard<mutex> g(m_mutexAllPoWCounter);
-  if (m_AllPoWCounter.find(key) == m_AllPoWCounter.end()) {
-    return false;
-  } else if (m_AllPoWCounter[key] < POW_SUBMISSION_LIMIT) {
+  auto& counter = m_AllPoWCounter[key];
+  if (counter >= POW_SUBMISSION_LIMIT) {
     return false;
   }
+  counter++;
   return true;
 }
 
-void DirectoryService::UpdatePoWSubmissionCounterforNode(const PubKey& key) {
+void DirectoryService::ReleasePoWSubmissionSlotForNode(const PubKey& key) {
   lock_guard<mutex> g(m_mutexAllPoWCounter);
-
-  if (m_AllPoWCounter.find(key) == m_AllPoWCounter.end()) {
-    m_AllPoWCounter.emplace(key, 1);
-  } else {
-    m_AllPoWCounter[key] = m_AllPoWCounter[key] + 1;
+  // The counters may have been reset while the submission was verified
+  const auto it = m_AllPoWCounter.find(key);
+  if (it != m_AllPoWCounter.end() && it->second > 0) {
+    it->second--;
   }
 }
 
@@ -467,6 +521,11 @@ void DirectoryService::ResetPoWSubmissionCounter() {
 void DirectoryService::AddDSPoWs(const PubKey& Pubk,
                                  const PoWSolution& DSPOWSoln) {
   lock_guard<mutex> g(m_mutexAllDSPOWs);
+  const auto it = m_allDSPoWs.find(Pubk);
+  if (it != m_allDSPoWs.end()) {
+    m_gasPriceTracker.RemoveProposal(it->second.m_gasPrice);
+  }
+  m_gasPriceTracker.AddProposal(DSPOWSoln.m_gasPrice);
   m_allDSPoWs[Pubk] = DSPOWSoln;
 }
 
@@ -478,6 +537,7 @@ MapOfPubKeyPoW DirectoryService::GetAllDSPoWs() {
 void DirectoryService::ClearDSPoWSolns() {
   lock_guard<mutex> g(m_mutexAllDSPOWs);
   m_allDSPoWs.clear();
+  m_gasPriceTracker.ClearProposals();
 }
 
 std::array<unsigned char, 32> DirectoryService::GetDSPoWSoln(
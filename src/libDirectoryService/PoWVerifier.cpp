@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PoWVerifier.h"
+#include "libPOW/pow.h"
+#include "libUtils/Logger.h"
+#include "libUtils/TimeUtils.h"
+
+using namespace std;
+
+PoWVerifier::PoWVerifier(unsigned int numThreads, unsigned int maxQueued)
+    : m_maxQueued(maxQueued) {
+  if (numThreads == 0) {
+    numThreads = max(1U, thread::hardware_concurrency());
+  }
+
+  m_workers.reserve(numThreads);
+  for (unsigned int i = 0; i < numThreads; i++) {
+    m_workers.emplace_back([this]() { WorkerLoop(); });
+  }
+
+  LOG_GENERAL(INFO, "PoW verification threads = " << numThreads
+                                                  << " queue = " << maxQueued);
+}
+
+PoWVerifier::~PoWVerifier() {
+  {
+    lock_guard<mutex> g(m_mutex);
+    m_stop = true;
+  }
+  m_jobAvailable.notify_all();
+
+  for (auto& worker : m_workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+  // Let the submitters of anything still queued know it was not verified
+  for (const auto& job : m_jobs) {
+    Drop(job.m_onDone);
+  }
+}
+
+bool PoWVerifier::Verify(Request request, Callback onDone) {
+  bool stopping = false;
+  {
+    lock_guard<mutex> g(m_mutex);
+    stopping = m_stop;
+    if (!stopping && m_jobs.size() < m_maxQueued) {
+      m_jobs.push_back({move(request), move(onDone), r_timer_start()});
+      m_queued++;
+
+      const uint64_t depth = m_jobs.size();
+      if (depth > m_maxQueueDepth) {
+        m_maxQueueDepth = depth;
+      }
+
+      m_jobAvailable.notify_one();
+      return true;
+    }
+  }
+
+  if (stopping) {
+    LOG_GENERAL(WARNING, "PoW verifier stopping, request dropped");
+    Drop(onDone);
+    return false;
+  }
+
+  m_inline++;
+  return Run(request, onDone);
+}
+
+bool PoWVerifier::WaitUntilIdle(const chrono::milliseconds& timeout) {
+  unique_lock<mutex> lk(m_mutex);
+  return m_idle.wait_for(lk, timeout,
+                         [this]() { return m_jobs.empty() && m_busy == 0; });
+}
+
+PoWVerifier::Stats PoWVerifier::GetStats() const {
+  Stats stats;
+  {
+    lock_guard<mutex> g(m_mutex);
+    stats.m_queueDepth = m_jobs.size();
+  }
+  stats.m_queued = m_queued;
+  stats.m_inline = m_inline;
+  stats.m_dropped = m_dropped;
+  stats.m_valid = m_valid;
+  stats.m_invalid = m_invalid;
+  stats.m_maxQueueDepth = m_maxQueueDepth;
+  stats.m_totalWaitMicrosec = m_totalWaitMicrosec;
+  stats.m_totalVerifyMicrosec = m_totalVerifyMicrosec;
+  return stats;
+}
+
+void PoWVerifier::WorkerLoop() {
+  while (true) {
+    Job job;
+    {
+      unique_lock<mutex> lk(m_mutex);
+      m_jobAvailable.wait(lk, [this]() { return m_stop || !m_jobs.empty(); });
+      if (m_stop) {
+        return;
+      }
+      job = move(m_jobs.front());
+      m_jobs.pop_front();
+      m_busy++;
+    }
+
+    m_totalWaitMicrosec += static_cast<uint64_t>(r_timer_end(job.m_queuedAt));
+    Run(job.m_request, job.m_onDone);
+
+    {
+      lock_guard<mutex> g(m_mutex);
+      m_busy--;
+      if (m_jobs.empty() && m_busy == 0) {
+        m_idle.notify_all();
+      }
+    }
+  }
+}
+
+bool PoWVerifier::Run(const Request& request, const Callback& onDone) {
+  const auto startTime = r_timer_start();
+  const bool result = POW::GetInstance().PoWVerify(
+      request.m_blockNum, request.m_difficulty, request.m_headerHash,
+      request.m_nonce, request.m_resultingHash, request.m_mixHash);
+  m_totalVerifyMicrosec += static_cast<uint64_t>(r_timer_end(startTime));
+
+  if (result) {
+    m_valid++;
+  } else {
+    m_invalid++;
+  }
+
+  if (onDone) {
+    try {
+      onDone(result);
+    } catch (const exception& e) {
+      LOG_GENERAL(WARNING, "PoW verification callback failed: " << e.what());
+    }
+  }
+
+  return result;
+}
+
+void PoWVerifier::Drop(const Callback& onDone) {
+  m_dropped++;
+
+  if (onDone) {
+    try {
+      onDone(false);
+    } catch (const exception& e) {
+      LOG_GENERAL(WARNING, "PoW verification callback failed: " << e.what());
+    }
+  }
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDIRECTORYSERVICE_POWVERIFIER_H_
+#define ZILLIQA_SRC_LIBDIRECTORYSERVICE_POWVERIFIER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "depends/libethash/include/ethash/ethash.hpp"
+
+/// Bounded worker pool for the ethash check of PoW submissions, so a burst of
+/// submissions near the end of the PoW window does not tie up the message
+/// handler threads. All workers share the light epoch context held by POW.
+class PoWVerifier {
+ public:
+  struct Request {
+    uint64_t m_blockNum{};
+    uint8_t m_difficulty{};
+    ethash_hash256 m_headerHash{};
+    uint64_t m_nonce{};
+    std::string m_resultingHash;
+    std::string m_mixHash;
+  };
+
+  /// Receives the verification result on the thread that ran the check, or
+  /// false if the request was dropped.
+  typedef std::function<void(bool)> Callback;
+
+  struct Stats {
+    uint64_t m_queued{};    // handed to the workers
+    uint64_t m_inline{};    // verified by the caller because the queue was full
+    uint64_t m_dropped{};   // never verified because the pool was stopping
+    uint64_t m_valid{};
+    uint64_t m_invalid{};
+    uint64_t m_queueDepth{};
+    uint64_t m_maxQueueDepth{};
+    uint64_t m_totalWaitMicrosec{};    // time spent queued
+    uint64_t m_totalVerifyMicrosec{};  // time spent in ethash
+  };
+
+  /// numThreads == 0 means one worker per core.
+  PoWVerifier(unsigned int numThreads, unsigned int maxQueued);
+  ~PoWVerifier();
+
+  PoWVerifier(PoWVerifier const&) = delete;
+  void operator=(PoWVerifier const&) = delete;
+
+  /// Queues the request. If the queue is full the request is verified on the
+  /// calling thread instead, which slows intake down rather than dropping a
+  /// valid solution. onDone runs exactly once either way. Returns false if
+  /// the request was verified inline and failed, or was dropped because the
+  /// pool is stopping; a queued request returns true.
+  bool Verify(Request request, Callback onDone);
+
+  /// Blocks until every queued request has been handled or the timeout
+  /// expires. Returns false on timeout.
+  bool WaitUntilIdle(const std::chrono::milliseconds& timeout);
+
+  Stats GetStats() const;
+
+ private:
+  struct Job {
+    Request m_request;
+    Callback m_onDone;
+    std::chrono::system_clock::time_point m_queuedAt;
+  };
+
+  void WorkerLoop();
+  bool Run(const Request& request, const Callback& onDone);
+  void Drop(const Callback& onDone);
+
+  const unsigned int m_maxQueued;
+  std::vector<std::thread> m_workers;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_jobAvailable;
+  std::condition_variable m_idle;
+  std::deque<Job> m_jobs;
+  unsigned int m_busy{0};
+  bool m_stop{false};
+
+  std::atomic<uint64_t> m_queued{0};
+  std::atomic<uint64_t> m_inline{0};
+  std::atomic<uint64_t> m_dropped{0};
+  std::atomic<uint64_t> m_valid{0};
+  std::atomic<uint64_t> m_invalid{0};
+  std::atomic<uint64_t> m_maxQueueDepth{0};
+  std::atomic<uint64_t> m_totalWaitMicrosec{0};
+  std::atomic<uint64_t> m_totalVerifyMicrosec{0};
+};
+
+#endif  // ZILLIQA_SRC_LIBDIRECTORYSERVICE_POWVERIFIER_H_
@@ -63,7 +63,8 @@ bool DirectoryService::ComposeVCBlockForSender(bytes& vcblock_message) {
 
 void DirectoryService::CleanUpViewChange(bool isPrecheckFail) {
   LOG_MARKER();
-  cv_ViewChangeVCBlock.notify_all();
+  Scheduler::GetInstance().Cancel(
+      m_viewChangeVCBlockTimer.exchange(Scheduler::INVALID_TIMER));
   m_candidateLeaderIndex = 0;
   m_cumulativeFaultyLeaders.clear();
 
@@ -350,8 +350,7 @@ void DirectoryService::RunConsensusOnViewChange() {
     cv_ViewChangeConsensusObj.notify_all();
   }
 
-  auto func = [this]() -> void { ScheduleViewChangeTimeout(); };
-  DetachedFunction(1, func);
+  ScheduleViewChangeTimeout();
 }
 
 void DirectoryService::ScheduleViewChangeTimeout() {
@@ -362,10 +361,7 @@ void DirectoryService::ScheduleViewChangeTimeout() {
     return;
   }
 
-  std::unique_lock<std::mutex> cv_lk(m_MutexCVViewChangeVCBlock);
-  if (cv_ViewChangeVCBlock.wait_for(cv_lk,
-                                    std::chrono::seconds(VIEWCHANGE_TIME)) ==
-      std::cv_status::timeout) {
+  auto viewChange = [this]() -> void {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Initiated view change again");
 
@@ -379,7 +375,10 @@ void DirectoryService::ScheduleViewChangeTimeout() {
 
     auto func = [this]() -> void { RunConsensusOnViewChange(); };
     DetachedFunction(1, func);
-  }
+  };
+  Scheduler::GetInstance().Cancel(m_viewChangeVCBlockTimer.exchange(
+      Scheduler::GetInstance().ScheduleAfter(viewChange,
+                                             VIEWCHANGE_TIME * 1000)));
 }
 
 bool DirectoryService::ComputeNewCandidateLeader(
@@ -25,6 +25,7 @@
 #include <exception>
 #include <fstream>
 #include <random>
+#include <thread>
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
@@ -55,6 +56,7 @@
 #include "libUtils/RandomGenerator.h"
 #include "libUtils/SanityChecks.h"
 #include "libUtils/SysCommand.h"
+#include "libUtils/TimeUtils.h"
 
 using namespace std;
 using namespace boost::multiprecision;
@@ -2971,9 +2973,17 @@ bool Lookup::ProcessSetTxBlockFromSeed(const bytes& message,
                   << latestSynBlockNum << " highBlockNum=" << highBlockNum);
     return false;
   } else {
+    // Fetch the state deltas while the blocks are being verified
+    if (m_syncType != SyncType::RECOVERY_ALL_SYNC) {
+      RequestStateDeltas(txBlocks.front().GetHeader().GetBlockNum(),
+                         txBlocks.back().GetHeader().GetBlockNum());
+    }
+
+    const auto verifyStart = r_timer_start();
     auto res = m_mediator.m_validator->CheckTxBlocks(
         txBlocks, m_mediator.m_blocklinkchain.GetBuiltDSComm(),
         m_mediator.m_blocklinkchain.GetLatestBlockLink());
+    RecordSyncStage(SYNC_VERIFY, txBlocks.size(), r_timer_end(verifyStart));
     switch (res) {
       case Validator::TxBlockValidationMsg::VALID:
 #ifdef SJ_TEST_SJ_TXNBLKS_PROCESS_SLOW
@@ -3077,24 +3087,9 @@ void Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
   uint64_t highBlockNum = txBlocks.back().GetHeader().GetBlockNum();
   bool placeholder = false;
   if (m_syncType != SyncType::RECOVERY_ALL_SYNC) {
-    unsigned int retry = 1;
-    while (retry <= RETRY_GETSTATEDELTAS_COUNT) {
-      // Get the state-delta for all txBlocks from random lookup nodes
-      GetStateDeltasFromSeedNodes(lowBlockNum, highBlockNum);
-      std::unique_lock<std::mutex> cv_lk(m_mutexSetStateDeltasFromSeed);
-      if (cv_setStateDeltasFromSeed.wait_for(
-              cv_lk, std::chrono::seconds(GETSTATEDELTAS_TIMEOUT_IN_SECONDS)) ==
-          std::cv_status::timeout) {
-        LOG_GENERAL(
-            WARNING,
-            "[Retry: " << retry
-                       << "] Didn't receive statedeltas! Will try again");
-        retry++;
-      } else {
-        break;
-      }
-    }
-    if (retry > RETRY_GETSTATEDELTAS_COUNT) {
+    // Normally already requested when the blocks arrived
+    RequestStateDeltas(lowBlockNum, highBlockNum);
+    if (!WaitForStateDeltas(lowBlockNum, highBlockNum)) {
       LOG_GENERAL(WARNING, "Failed to receive state-deltas for txBlks: "
                                << lowBlockNum << "-" << highBlockNum);
       cv_setTxBlockFromSeed.notify_all();
@@ -3102,6 +3097,14 @@ void Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
       return;
     }
 
+    if (!ApplyStateDeltas(lowBlockNum, highBlockNum)) {
+      LOG_GENERAL(WARNING, "Failed to apply state-deltas for txBlks: "
+                               << lowBlockNum << "-" << highBlockNum);
+      cv_setTxBlockFromSeed.notify_all();
+      cv_waitJoined.notify_all();
+      return;
+    }
+
     // Check StateRootHash and One in last TxBlk
     if (m_prevStateRootHashTemp !=
         txBlocks.back().GetHeader().GetStateRootHash()) {
@@ -3112,21 +3115,31 @@ void Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
     }
   }
 
+  const auto commitStart = r_timer_start();
+
+  // Store all Tx Blocks to disk in one batch
+  vector<pair<uint64_t, bytes>> serializedTxBlocks;
+  serializedTxBlocks.reserve(txBlocks.size());
+  for (const auto& txBlock : txBlocks) {
+    serializedTxBlocks.emplace_back(txBlock.GetHeader().GetBlockNum(),
+                                    bytes());
+    txBlock.Serialize(serializedTxBlocks.back().second, 0);
+  }
+
+  if (!BlockStorage::GetBlockStorage().PutTxBlocks(serializedTxBlocks)) {
+    LOG_GENERAL(WARNING, "BlockStorage::PutTxBlocks failed for txBlks: "
+                             << lowBlockNum << "-" << highBlockNum);
+    cv_setTxBlockFromSeed.notify_all();
+    cv_waitJoined.notify_all();
+    return;
+  }
+
   for (const auto& txBlock : txBlocks) {
     LOG_EPOCH(INFO, m_mediator.m_currentEpochNum, txBlock);
 
     m_mediator.m_node->AddBlock(txBlock);
-    // Store Tx Block to disk
-    bytes serializedTxBlock;
-    txBlock.Serialize(serializedTxBlock, 0);
     uint64_t blockNum = txBlock.GetHeader().GetBlockNum();
 
-    if (!BlockStorage::GetBlockStorage().PutTxBlock(blockNum,
-                                                    serializedTxBlock)) {
-      LOG_GENERAL(WARNING, "BlockStorage::PutTxBlock failed " << txBlock);
-      return;
-    }
-
     // If txblk not from vacaous epoch and is rejoining as ds node
     if ((blockNum + 1) % NUM_FINAL_BLOCK_PER_POW != 0 &&
         (m_syncType == SyncType::DS_SYNC ||
@@ -3162,6 +3175,8 @@ void Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
     }
   }
 
+  RecordSyncStage(SYNC_COMMIT, txBlocks.size(), r_timer_end(commitStart));
+
   m_mediator.m_currentEpochNum =
       m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
   // To trigger m_isVacuousEpoch calculation
@@ -3481,20 +3496,149 @@ bool Lookup::ProcessSetStateDeltasFromSeed(const bytes& message,
     return false;
   }
 
-  int txBlkNum = lowBlockNum;
-  bytes tmp;
-  for (const auto& delta : stateDeltas) {
-    // TBD - To verify state delta hash against one from TxBlk.
-    // But not crucial right now since we do verify sender i.e lookup and
-    // trust it.
+  // TBD - To verify state delta hash against one from TxBlk.
+  // But not crucial right now since we do verify sender i.e lookup and
+  // trust it.
+  // Only keep deltas that are still wanted, so replies to stale requests
+  // cannot grow the buffer
+  uint64_t txBlkNum = lowBlockNum;
+  for (auto& delta : stateDeltas) {
+    if (m_stateDeltasRequested.first <= txBlkNum &&
+        txBlkNum <= m_stateDeltasRequested.second) {
+      m_stateDeltasBuffer[txBlkNum] = move(delta);
+    }
+    txBlkNum++;
+  }
+
+  RecordSyncStage(SYNC_FETCH_DELTAS, stateDeltas.size(),
+                  r_timer_end(m_stateDeltasRequestTime));
+
+  cv_setStateDeltasFromSeed.notify_all();
+  return true;
+}
+
+namespace {
+bool IsStateDeltaPersisted(const uint64_t blockNum) {
+  bytes stateDelta;
+  return BlockStorage::GetBlockStorage().GetStateDelta(blockNum, stateDelta);
+}
+}  // namespace
+
+void Lookup::RequestStateDeltas(const uint64_t lowBlockNum,
+                                const uint64_t highBlockNum,
+                                const bool resend) {
+  uint64_t fromBlockNum = lowBlockNum;
+  uint64_t toBlockNum = highBlockNum;
+  {
+    lock_guard<mutex> g(m_mutexSetStateDeltasFromSeed);
+
+    if (!resend && m_stateDeltasRequested.first <= lowBlockNum &&
+        highBlockNum <= m_stateDeltasRequested.second) {
+      return;
+    }
+
+    // Only one range is synced at a time, so anything buffered outside it
+    // was left by an abandoned attempt
+    m_stateDeltasBuffer.erase(m_stateDeltasBuffer.begin(),
+                              m_stateDeltasBuffer.lower_bound(lowBlockNum));
+    m_stateDeltasBuffer.erase(m_stateDeltasBuffer.upper_bound(highBlockNum),
+                              m_stateDeltasBuffer.end());
+
+    // Skip the ends of the range that are already buffered or were persisted
+    // before a restart
+    auto have = [this](const uint64_t blockNum) {
+      return m_stateDeltasBuffer.count(blockNum) > 0 ||
+             IsStateDeltaPersisted(blockNum);
+    };
+    while (fromBlockNum <= toBlockNum && have(fromBlockNum)) {
+      fromBlockNum++;
+    }
+    if (fromBlockNum > toBlockNum) {
+      return;
+    }
+    while (toBlockNum > fromBlockNum && have(toBlockNum)) {
+      toBlockNum--;
+    }
+
+    m_stateDeltasRequested = make_pair(fromBlockNum, toBlockNum);
+    m_stateDeltasRequestTime = r_timer_start();
+  }
+
+  // Get the state-delta for all txBlocks from random lookup nodes
+  GetStateDeltasFromSeedNodes(fromBlockNum, toBlockNum);
+}
 
+bool Lookup::WaitForStateDeltas(const uint64_t lowBlockNum,
+                                const uint64_t highBlockNum) {
+  // Deltas already persisted are not requested, so do not wait for them
+  vector<uint64_t> pending;
+  for (uint64_t blockNum = lowBlockNum; blockNum <= highBlockNum; blockNum++) {
+    if (!IsStateDeltaPersisted(blockNum)) {
+      pending.emplace_back(blockNum);
+    }
+  }
+
+  auto received = [this, &pending]() -> bool {
+    for (const auto& blockNum : pending) {
+      if (m_stateDeltasBuffer.count(blockNum) == 0) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  unique_lock<mutex> lock(m_mutexSetStateDeltasFromSeed);
+  for (unsigned int retry = 1; retry <= RETRY_GETSTATEDELTAS_COUNT; retry++) {
+    if (cv_setStateDeltasFromSeed.wait_for(
+            lock, chrono::seconds(GETSTATEDELTAS_TIMEOUT_IN_SECONDS),
+            received)) {
+      return true;
+    }
+
+    LOG_GENERAL(WARNING, "[Retry: " << retry
+                                    << "] Didn't receive statedeltas! Will "
+                                       "try again");
+    lock.unlock();
+    RequestStateDeltas(lowBlockNum, highBlockNum, true);
+    lock.lock();
+  }
+
+  return false;
+}
+
+bool Lookup::ApplyStateDeltas(const uint64_t lowBlockNum,
+                              const uint64_t highBlockNum) {
+  map<uint64_t, bytes> stateDeltas;
+  {
+    lock_guard<mutex> g(m_mutexSetStateDeltasFromSeed);
+    // Anything below this range is left over from earlier attempts
+    m_stateDeltasBuffer.erase(m_stateDeltasBuffer.begin(),
+                              m_stateDeltasBuffer.lower_bound(lowBlockNum));
+    auto end = m_stateDeltasBuffer.upper_bound(highBlockNum);
+    stateDeltas.insert(make_move_iterator(m_stateDeltasBuffer.begin()),
+                       make_move_iterator(end));
+    m_stateDeltasBuffer.erase(m_stateDeltasBuffer.begin(), end);
+    m_stateDeltasRequested = make_pair(INIT_BLOCK_NUMBER, INIT_BLOCK_NUMBER);
+  }
+
+  const auto applyStart = r_timer_start();
+
+  bytes tmp;
+  for (uint64_t txBlkNum = lowBlockNum; txBlkNum <= highBlockNum;
+       txBlkNum++) {
     if (!BlockStorage::GetBlockStorage().GetStateDelta(txBlkNum, tmp)) {
-      if (!AccountStore::GetInstance().DeserializeDelta(delta, 0)) {
+      const auto it = stateDeltas.find(txBlkNum);
+      if (it == stateDeltas.end()) {
+        LOG_GENERAL(WARNING, "Missing state-delta for txBlk: " << txBlkNum);
+        return false;
+      }
+      if (!AccountStore::GetInstance().DeserializeDelta(it->second, 0)) {
         LOG_GENERAL(WARNING,
                     "AccountStore::GetInstance().DeserializeDelta failed");
         return false;
       }
-      if (!BlockStorage::GetBlockStorage().PutStateDelta(txBlkNum, delta)) {
+      if (!BlockStorage::GetBlockStorage().PutStateDelta(txBlkNum,
+                                                         it->second)) {
         LOG_GENERAL(WARNING, "BlockStorage::PutStateDelta failed");
         return false;
       }
@@ -3509,13 +3653,37 @@ bool Lookup::ProcessSetStateDeltasFromSeed(const bytes& message,
         }
       }
     }
-    txBlkNum++;
   }
 
-  cv_setStateDeltasFromSeed.notify_all();
+  RecordSyncStage(SYNC_APPLY_DELTAS, highBlockNum - lowBlockNum + 1,
+                  r_timer_end(applyStart));
   return true;
 }
 
+void Lookup::RecordSyncStage(const SyncStage stage, const uint64_t numBlocks,
+                             const double microseconds) {
+  static const array<string, NUM_SYNC_STAGES> stageNames = {
+      {"FetchDeltas", "Verify", "ApplyDeltas", "Commit"}};
+
+  lock_guard<mutex> g(m_mutexSyncStats);
+  auto& stats = m_syncStats.at(stage);
+  stats.m_blocks += numBlocks;
+  stats.m_seconds += microseconds / 1000000;
+
+  LOG_GENERAL(INFO, "[SYNC] " << stageNames.at(stage) << " " << numBlocks
+                              << " blks in " << microseconds / 1000
+                              << " ms, overall "
+                              << (stats.m_seconds > 0
+                                      ? stats.m_blocks / stats.m_seconds
+                                      : 0)
+                              << " blks/s");
+}
+
+array<SyncStageStats, NUM_SYNC_STAGES> Lookup::GetSyncStats() const {
+  lock_guard<mutex> g(m_mutexSyncStats);
+  return m_syncStats;
+}
+
 bool Lookup::ProcessSetStateFromSeed(const bytes& message, unsigned int offset,
                                      [[gnu::unused]] const Peer& from) {
   LOG_MARKER();
@@ -3848,12 +4016,18 @@ bool Lookup::ProcessSetTxnsFromLookup(const bytes& message, unsigned int offset,
   LOG_GENERAL(INFO,
               "Received " << txns.size() << " txns for microblock :" << mbHash);
 
+  uint64_t epochNum = m_mediator.m_currentEpochNum;
+  MicroBlockSharedPtr microBlock;
+  if (BlockStorage::GetBlockStorage().GetMicroBlock(mbHash, microBlock)) {
+    epochNum = microBlock->GetHeader().GetEpochNum();
+  }
+
   for (const auto& txn : txns) {
     bytes serializedTxBody;
     txn.Serialize(serializedTxBody, 0);
 
     if (!BlockStorage::GetBlockStorage().PutTxBody(
-            txn.GetTransaction().GetTranID(), serializedTxBody)) {
+            epochNum, txn.GetTransaction().GetTranID(), serializedTxBody)) {
       LOG_GENERAL(WARNING, "BlockStorage::PutTxBody failed "
                                << txn.GetTransaction().GetTranID());
       continue;  // Transaction already existed locally. Move on so as to delete
@@ -5504,110 +5678,198 @@ void Lookup::SendTxnPacketToNodes(const uint32_t oldNumShards,
   this_thread::sleep_for(
       chrono::milliseconds(LOOKUP_DELAY_SEND_TXNPACKET_IN_MS));
 
-  for (unsigned int i = 0; i < numShards + 1; i++) {
-    bytes msg = {MessageType::NODE, NodeInstructionType::FORWARDTXNPACKET};
-    bool result = false;
+  // Take all queued txns out at once, so that CreateTransaction callers are
+  // not blocked while the packets are serialized and signed
+  TxnShardMap queuedTxns;
+  {
+    lock_guard<mutex> g(m_txnShardMapMutex);
+    for (uint32_t i = 0; i <= numShards; i++) {
+      auto it = m_txnShardMap.find(i);
+      if (it != m_txnShardMap.end()) {
+        queuedTxns[i].swap(it->second);
+      }
+    }
+  }
 
-    {
-      lock_guard<mutex> g(m_txnShardMapMutex);
-      auto transactionNumber = mp[i].size();
+  const uint64_t epochNum = m_mediator.m_currentEpochNum;
+  const uint64_t dsBlockNum =
+      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+  const uint16_t lastBlockHash = DataConversion::charArrTo16Bits(
+      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
 
-      LOG_GENERAL(INFO, "Txn number generated: " << transactionNumber);
+  vector<uint32_t> shardsToSend;
+  for (uint32_t i = 0; i <= numShards; i++) {
+    // Creates the entries up front, so that workers only read the maps
+    const auto& queued = queuedTxns[i];
+    const auto& generated = mp[i];
 
-      if (LOG_PARAMETERS) {
-        LOG_STATE("[TXNPKT][" << m_mediator.m_currentEpochNum << "] Shard=" << i
-                              << " NumTx="
-                              << (GetTxnFromShardMap(i).size() + mp[i].size()));
-      }
+    if (LOG_PARAMETERS) {
+      LOG_STATE("[TXNPKT][" << epochNum << "] Shard=" << i << " NumTx="
+                            << (queued.size() + generated.size()));
+    }
 
-      if (GetTxnFromShardMap(i).empty() && mp[i].empty()) {
-        LOG_GENERAL(INFO, "No txns to send to shard " << i);
+    if (queued.empty() && generated.empty()) {
+      LOG_GENERAL(INFO, "No txns to send to shard " << i);
+      continue;
+    }
+
+    shardsToSend.emplace_back(i);
+  }
+
+  if (shardsToSend.empty()) {
+    return;
+  }
+
+  const auto dispatchStart = r_timer_start();
+  atomic<unsigned int> nextShard{0};
+
+  auto worker = [&]() -> void {
+    for (unsigned int n = nextShard++; n < shardsToSend.size();
+         n = nextShard++) {
+      const uint32_t shardId = shardsToSend[n];
+      auto& queued = queuedTxns.at(shardId);
+
+      if (!SendTxnPacketToShard(shardId, numShards, epochNum, dsBlockNum,
+                                lastBlockHash, queued, mp.at(shardId))) {
+        RestoreTxnShardMap(shardId, move(queued));
         continue;
       }
 
-      result = Messenger::SetNodeForwardTxnBlock(
-          msg, MessageOffset::BODY, m_mediator.m_currentEpochNum,
-          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum(), i,
-          m_mediator.m_selfKey, GetTxnFromShardMap(i), mp[i]);
+      LOG_GENERAL(INFO, "[TXNPKT] Shard " << shardId << " dispatched in "
+                                          << r_timer_end(dispatchStart) / 1000
+                                          << " ms");
     }
+  };
 
-    if (!result) {
-      LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
-                "Messenger::SetNodeForwardTxnBlock failed.");
-      LOG_GENERAL(WARNING, "Cannot create packet for " << i << " shard");
-      continue;
+  const unsigned int numThreads =
+      max(1U, min<unsigned int>(thread::hardware_concurrency(),
+                                shardsToSend.size()));
+  vector<thread> workers;
+  for (unsigned int i = 1; i < numThreads; i++) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : workers) {
+    t.join();
+  }
+
+  LOG_GENERAL(INFO, "Dispatched txn packets to " << shardsToSend.size()
+                                                 << " shards in "
+                                                 << r_timer_end(dispatchStart) /
+                                                        1000
+                                                 << " ms");
+}
+
+bool Lookup::SendTxnPacketToShard(const uint32_t shardId,
+                                  const uint32_t numShards,
+                                  const uint64_t epochNum,
+                                  const uint64_t dsBlockNum,
+                                  const uint16_t lastBlockHash,
+                                  const vector<Transaction>& queuedTxns,
+                                  const vector<Transaction>& generatedTxns) {
+  vector<Peer> toSend;
+  if (shardId < numShards) {
+    lock_guard<mutex> g(m_mediator.m_ds->m_mutexShards);
+    const auto& shard = m_mediator.m_ds->m_shards.at(shardId);
+    if (shard.empty()) {
+      return false;
     }
-    vector<Peer> toSend;
-    if (i < numShards) {
-      {
-        lock_guard<mutex> g(m_mediator.m_ds->m_mutexShards);
-        uint16_t lastBlockHash = DataConversion::charArrTo16Bits(
-            m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
-        uint32_t leader_id = m_mediator.m_node->CalculateShardLeaderFromShard(
-            lastBlockHash, m_mediator.m_ds->m_shards.at(i).size(),
-            m_mediator.m_ds->m_shards.at(i));
-        LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-                  "Shard leader id " << leader_id);
-
-        auto it = m_mediator.m_ds->m_shards.at(i).begin();
-        // Lookup sends to NUM_NODES_TO_SEND_LOOKUP + Leader
-        unsigned int num_node_to_send = NUM_NODES_TO_SEND_LOOKUP;
-        for (unsigned int j = 0; j < num_node_to_send &&
-                                 it != m_mediator.m_ds->m_shards.at(i).end();
-             j++, it++) {
-          if (distance(m_mediator.m_ds->m_shards.at(i).begin(), it) ==
-              leader_id) {
-            num_node_to_send++;
-          } else {
-            toSend.push_back(std::get<SHARD_NODE_PEER>(*it));
-            LOG_GENERAL(INFO, "Sent to node " << get<SHARD_NODE_PEER>(*it));
-          }
-        }
-        if (m_mediator.m_ds->m_shards.at(i).empty()) {
-          continue;
-        }
-      }
 
-      P2PComm::GetInstance().SendBroadcastMessage(toSend, msg);
+    uint32_t leader_id = m_mediator.m_node->CalculateShardLeaderFromShard(
+        lastBlockHash, shard.size(), shard);
+    LOG_EPOCH(INFO, epochNum, "Shard leader id " << leader_id);
 
-      DeleteTxnShardMap(i);
-    } else if (i == numShards) {
-      // To send DS
-      {
-        lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
+    auto it = shard.begin();
+    // Lookup sends to NUM_NODES_TO_SEND_LOOKUP + Leader
+    unsigned int num_node_to_send = NUM_NODES_TO_SEND_LOOKUP;
+    for (unsigned int j = 0; j < num_node_to_send && it != shard.end();
+         j++, it++) {
+      if (distance(shard.begin(), it) == leader_id) {
+        num_node_to_send++;
+      } else {
+        toSend.push_back(std::get<SHARD_NODE_PEER>(*it));
+        LOG_GENERAL(INFO, "Sent to node " << get<SHARD_NODE_PEER>(*it));
+      }
+    }
+  } else {
+    // To send DS
+    lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
 
-        if (m_mediator.m_DSCommittee->empty()) {
-          continue;
-        }
+    if (m_mediator.m_DSCommittee->empty()) {
+      return false;
+    }
 
-        // Send to NUM_NODES_TO_SEND_LOOKUP which including DS leader
-        PairOfNode dsLeader;
-        if (Node::GetDSLeader(m_mediator.m_blocklinkchain.GetLatestBlockLink(),
-                              m_mediator.m_dsBlockChain.GetLastBlock(),
-                              *m_mediator.m_DSCommittee, dsLeader)) {
-          toSend.push_back(dsLeader.second);
-        }
+    // Send to NUM_NODES_TO_SEND_LOOKUP which including DS leader
+    PairOfNode dsLeader;
+    if (Node::GetDSLeader(m_mediator.m_blocklinkchain.GetLatestBlockLink(),
+                          m_mediator.m_dsBlockChain.GetLastBlock(),
+                          *m_mediator.m_DSCommittee, dsLeader)) {
+      toSend.push_back(dsLeader.second);
+    }
 
-        for (auto const& i : *m_mediator.m_DSCommittee) {
-          if (toSend.size() < NUM_NODES_TO_SEND_LOOKUP &&
-              i.second != dsLeader.second) {
-            toSend.push_back(i.second);
-          }
+    for (auto const& member : *m_mediator.m_DSCommittee) {
+      if (toSend.size() >= NUM_NODES_TO_SEND_LOOKUP) {
+        break;
+      }
 
-          if (toSend.size() >= NUM_NODES_TO_SEND_LOOKUP) {
-            break;
-          }
-        }
+      if (member.second != dsLeader.second) {
+        toSend.push_back(member.second);
       }
+    }
+  }
+
+  LOG_GENERAL(INFO, "Txn number generated: " << generatedTxns.size());
+
+  const auto composeStart = r_timer_start();
+  bytes msg = {MessageType::NODE, NodeInstructionType::FORWARDTXNPACKET};
+  if (!Messenger::SetNodeForwardTxnBlock(msg, MessageOffset::BODY, epochNum,
+                                         dsBlockNum, shardId,
+                                         m_mediator.m_selfKey, queuedTxns,
+                                         generatedTxns)) {
+    LOG_EPOCH(WARNING, epochNum, "Messenger::SetNodeForwardTxnBlock failed.");
+    LOG_GENERAL(WARNING, "Cannot create packet for " << shardId << " shard");
+    return false;
+  }
+  const double composeMs = r_timer_end(composeStart) / 1000;
 
-      P2PComm::GetInstance().SendBroadcastMessage(toSend, msg);
+  P2PComm::GetInstance().SendBroadcastMessage(toSend, msg);
 
-      LOG_GENERAL(INFO, "[DSMB]"
-                            << " Sent DS the txns");
+  if (shardId == numShards) {
+    LOG_GENERAL(INFO, "[DSMB]"
+                          << " Sent DS the txns");
+  }
+
+  LOG_GENERAL(INFO, "Shard " << shardId << " packet of "
+                             << (queuedTxns.size() + generatedTxns.size())
+                             << " txns composed in " << composeMs << " ms");
+
+  return true;
+}
 
-      DeleteTxnShardMap(i);
+void Lookup::RestoreTxnShardMap(const uint32_t shardId,
+                                vector<Transaction>&& txns) {
+  if (txns.empty()) {
+    return;
+  }
+
+  lock_guard<mutex> g(m_txnShardMapMutex);
+
+  unordered_set<TxnHash> kept;
+  kept.reserve(txns.size());
+  for (const auto& txn : txns) {
+    kept.emplace(txn.GetTranID());
+  }
+
+  // Txns that arrived meanwhile go after the older ones, unless resubmitted
+  auto& queue = m_txnShardMap[shardId];
+  for (auto& tx : queue) {
+    if (kept.emplace(tx.GetTranID()).second) {
+      txns.emplace_back(move(tx));
     }
   }
+  queue = move(txns);
+
+  LOG_GENERAL(INFO, "Kept " << queue.size() << " txns for shard " << shardId);
 }
 
 void Lookup::SetServerTrue() {
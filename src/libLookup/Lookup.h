@@ -18,6 +18,7 @@
 #ifndef ZILLIQA_SRC_LIBLOOKUP_LOOKUP_H_
 #define ZILLIQA_SRC_LIBLOOKUP_LOOKUP_H_
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -58,6 +59,21 @@ using TxnShardMap = std::map<uint32_t, std::vector<Transaction>>;
 // Enum used to tell send type to seed node
 enum SEND_TYPE { ARCHIVAL_SEND_SHARD = 0, ARCHIVAL_SEND_DS };
 
+// Stages of tx block sync. State deltas for a range are fetched while its
+// blocks are verified, and applied before the blocks are committed.
+enum SyncStage : unsigned int {
+  SYNC_FETCH_DELTAS = 0,
+  SYNC_VERIFY,
+  SYNC_APPLY_DELTAS,
+  SYNC_COMMIT,
+  NUM_SYNC_STAGES
+};
+
+struct SyncStageStats {
+  uint64_t m_blocks{0};
+  double m_seconds{0};
+};
+
 /// Processes requests pertaining to network, transaction, or block information
 class Lookup : public Executable {
   Mediator& m_mediator;
@@ -106,6 +122,10 @@ class Lookup : public Executable {
   // Store the StateRootHash of latest txBlock before States are repopulated.
   StateHash m_prevStateRootHashTemp;
 
+  // Throughput of each tx block sync stage
+  mutable std::mutex m_mutexSyncStats;
+  std::array<SyncStageStats, NUM_SYNC_STAGES> m_syncStats;
+
   /// To indicate which type of synchronization is using
   std::atomic<SyncType> m_syncType{};  // = SyncType::NO_SYNC;
 
@@ -131,6 +151,13 @@ class Lookup : public Executable {
   // Get StateDeltas from seed
   std::mutex m_mutexSetStateDeltasFromSeed;
   std::condition_variable cv_setStateDeltasFromSeed;
+  // State deltas received ahead of committing their tx blocks, and when they
+  // were requested. Only the requested range is buffered. Use
+  // m_mutexSetStateDeltasFromSeed with these.
+  std::map<uint64_t, bytes> m_stateDeltasBuffer;
+  std::pair<uint64_t, uint64_t> m_stateDeltasRequested{INIT_BLOCK_NUMBER,
+                                                      INIT_BLOCK_NUMBER};
+  std::chrono::system_clock::time_point m_stateDeltasRequestTime;
 
   // TxBlockBuffer
   std::vector<TxBlock> m_txBlockBuffer;
@@ -310,6 +337,16 @@ class Lookup : public Executable {
   void SenderTxnBatchThread(const uint32_t);
 
   void SendTxnPacketToNodes(const uint32_t, const uint32_t);
+  // Composes, signs and sends the txn packet of one shard (DS if shardId ==
+  // numShards). Returns false if the packet was not sent.
+  bool SendTxnPacketToShard(const uint32_t shardId, const uint32_t numShards,
+                            const uint64_t epochNum, const uint64_t dsBlockNum,
+                            const uint16_t lastBlockHash,
+                            const std::vector<Transaction>& queuedTxns,
+                            const std::vector<Transaction>& generatedTxns);
+  // Puts txns that could not be sent back in front of the shard's queue
+  void RestoreTxnShardMap(const uint32_t shardId,
+                          std::vector<Transaction>&& txns);
   bool ProcessEntireShardingStructure();
   bool ProcessGetDSInfoFromSeed(const bytes& message, unsigned int offset,
                                 const Peer& from);
@@ -366,6 +403,22 @@ class Lookup : public Executable {
   bool ProcessSetTxBlockFromSeed(const bytes& message, unsigned int offset,
                                  const Peer& from);
   void CommitTxBlocks(const std::vector<TxBlock>& txBlocks);
+
+  std::array<SyncStageStats, NUM_SYNC_STAGES> GetSyncStats() const;
+
+  // Requests the state deltas of a tx block range that are not already
+  // buffered, persisted or requested, and drops buffered deltas outside it
+  void RequestStateDeltas(const uint64_t lowBlockNum,
+                          const uint64_t highBlockNum,
+                          const bool resend = false);
+  // Waits until the state deltas of a tx block range are received
+  bool WaitForStateDeltas(const uint64_t lowBlockNum,
+                          const uint64_t highBlockNum);
+  // Applies the received state deltas of a tx block range to the state
+  bool ApplyStateDeltas(const uint64_t lowBlockNum,
+                        const uint64_t highBlockNum);
+  void RecordSyncStage(const SyncStage stage, const uint64_t numBlocks,
+                       const double microseconds);
   void PrepareForStartPow();
   bool GetDSInfo();
   bool ProcessSetStateDeltaFromSeed(const bytes& message, unsigned int offset,
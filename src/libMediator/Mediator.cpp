@@ -23,6 +23,7 @@
 #include "libServer/GetWorkServer.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/Metrics.h"
 #include "libUtils/ShardSizeCalculator.h"
 #include "libValidator/Validator.h"
 
@@ -150,6 +151,22 @@ void Mediator::IncreaseEpochNum() {
     GetWorkServer::GetInstance().SetNextPoWTime(now + wait_seconds);
   }
 
+  static auto& detachedThreads =
+      Metrics::GetInstance().GetCounter("zilliqa_detached_threads_total");
+  static auto& timersFired =
+      Metrics::GetInstance().GetCounter("zilliqa_timers_fired_total");
+  static auto& threadsPerEpoch = Metrics::GetInstance().GetHistogram(
+      "zilliqa_detached_threads_per_epoch");
+  const uint64_t threads = detachedThreads.Get();
+  const uint64_t timers = timersFired.Get();
+  threadsPerEpoch.Record(threads - m_detachedThreadsAtEpochStart);
+  LOG_GENERAL(INFO, "Last epoch launched "
+                        << threads - m_detachedThreadsAtEpochStart
+                        << " detached threads and fired "
+                        << timers - m_timersFiredAtEpochStart << " timers");
+  m_detachedThreadsAtEpochStart = threads;
+  m_timersFiredAtEpochStart = timers;
+
   LOG_GENERAL(INFO, "Epoch number is now " << m_currentEpochNum);
 
   LOG_STATE("Epoch = " << m_currentEpochNum);
@@ -91,6 +91,10 @@ class Mediator {
   bool m_isVacuousEpoch;
   std::mutex m_mutexVacuousEpoch;
 
+  /// Detached threads launched and timers fired before the current epoch
+  uint64_t m_detachedThreadsAtEpochStart = 0;
+  uint64_t m_timersFiredAtEpochStart = 0;
+
   /// Record current software information which already downloaded to this node
   SWInfo m_curSWInfo;
 
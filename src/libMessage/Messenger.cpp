@@ -20,14 +20,17 @@
 #include "libData/AccountData/Transaction.h"
 #include "libData/BlockChainData/BlockLinkChain.h"
 #include "libDirectoryService/DirectoryService.h"
+#include "libMessage/StateDeltaStream.h"
 #include "libMessage/ZilliqaMessage.pb.h"
 #include "libUtils/Logger.h"
 
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <algorithm>
+#include <future>
 #include <map>
 #include <random>
+#include <thread>
 #include <unordered_set>
 
 using namespace boost::multiprecision;
@@ -1783,6 +1786,33 @@ bool ProtobufToMicroBlock(const ProtoMicroBlock& protoMicroBlock,
   return ProtobufToBlockBase(protoBlockBase, microBlock);
 }
 
+void CompactTxnHashesToProtobuf(const CompactTxnHashes& compactTxnHashes,
+                                ProtoMicroBlock& protoMicroBlock,
+                                ProtoCompactTxnHashes& protoCompactTxnHashes) {
+  protoMicroBlock.clear_tranhashes();
+  protoCompactTxnHashes.set_salt(compactTxnHashes.GetSalt());
+  protoCompactTxnHashes.set_shortids(compactTxnHashes.GetShortIds().data(),
+                                     compactTxnHashes.GetShortIds().size());
+}
+
+bool ProtobufToCompactTxnHashes(
+    const ProtoCompactTxnHashes& protoCompactTxnHashes,
+    const MicroBlock& microBlock, CompactTxnHashes& compactTxnHashes) {
+  const string& shortIds = protoCompactTxnHashes.shortids();
+  if (shortIds.size() % CompactTxnHashes::SHORT_ID_SIZE != 0 ||
+      shortIds.size() / CompactTxnHashes::SHORT_ID_SIZE !=
+          microBlock.GetHeader().GetNumTxs()) {
+    LOG_GENERAL(WARNING, "Short txn IDs size " << shortIds.size()
+                                               << " does not match numtxs "
+                                               << microBlock.GetHeader()
+                                                      .GetNumTxs());
+    return false;
+  }
+  compactTxnHashes = CompactTxnHashes(protoCompactTxnHashes.salt(),
+                                      bytes(shortIds.begin(), shortIds.end()));
+  return true;
+}
+
 void MbInfoToProtobuf(const MicroBlockInfo& mbInfo, ProtoMbInfo& ProtoMbInfo) {
   ProtoMbInfo.set_mbhash(mbInfo.m_microBlockHash.data(),
                          mbInfo.m_microBlockHash.size);
@@ -2683,9 +2713,220 @@ bool Messenger::GetAccountStore(const bytes& src, const unsigned int offset,
   return true;
 }
 
+namespace {
+
+// Records are parsed in windows of this size so that memory stays bounded by
+// the window rather than by the whole delta
+const unsigned int STATE_DELTA_APPLY_WINDOW = 4096;
+// Below this number of records, parsing in parallel costs more than it saves
+const unsigned int STATE_DELTA_PARALLEL_MIN_RECORDS = 256;
+
+unsigned int GetStateDeltaParseThreads(const size_t numRecords) {
+  if (numRecords < STATE_DELTA_PARALLEL_MIN_RECORDS) {
+    return 1;
+  }
+  return max(1u, thread::hardware_concurrency());
+}
+
+// Parses payloads [begin, end) of a stream-format delta into protoAccounts,
+// spreading contiguous address ranges across worker threads
+bool ParseStateDeltaRecords(const bytes& src,
+                            const vector<StateDeltaStream::RecordRef>& index,
+                            const size_t begin, const size_t end,
+                            vector<ProtoAccount>& protoAccounts) {
+  protoAccounts.clear();
+  protoAccounts.resize(end - begin);
+
+  auto parseRange = [&src, &index, &protoAccounts, begin](
+                        const size_t from, const size_t to) -> bool {
+    for (size_t i = from; i < to; i++) {
+      const auto& ref = index.at(i);
+      if (!protoAccounts.at(i - begin).ParseFromArray(src.data() + ref.m_offset,
+                                                      ref.m_size)) {
+        LOG_GENERAL(WARNING, "ProtoAccount parsing failed for account at "
+                                 << ref.m_address);
+        return false;
+      }
+    }
+    return true;
+  };
+
+  const size_t count = end - begin;
+  const size_t numThreads =
+      min<size_t>(GetStateDeltaParseThreads(count), count);
+  if (numThreads <= 1) {
+    return parseRange(begin, end);
+  }
+
+  vector<future<bool>> results;
+  const size_t step = (count + numThreads - 1) / numThreads;
+  for (size_t from = begin; from < end; from += step) {
+    results.emplace_back(
+        async(launch::async, parseRange, from, min(from + step, end)));
+  }
+
+  bool ret = true;
+  for (auto& result : results) {
+    ret = result.get() && ret;
+  }
+  return ret;
+}
+
+bool ApplyAccountDelta(const ProtoAccount& protoAccount, const Address& address,
+                       AccountStore& accountStore, const bool revertible,
+                       bool temp) {
+  const Account* oriAccount = accountStore.GetAccount(address);
+  bool fullCopy = false;
+  if (oriAccount == nullptr) {
+    Account acc(0, 0);
+    accountStore.AddAccount(address, acc);
+    oriAccount = accountStore.GetAccount(address);
+    fullCopy = true;
+
+    if (oriAccount == nullptr) {
+      LOG_GENERAL(WARNING, "Failed to create account for " << address);
+      return false;
+    }
+  }
+
+  Account account(*oriAccount);
+  if (!ProtobufToAccountDelta(protoAccount, account, address, fullCopy, temp,
+                              revertible)) {
+    LOG_GENERAL(WARNING,
+                "ProtobufToAccountDelta failed for account at address "
+                    << address.hex());
+    return false;
+  }
+
+  // The original is only read back when reverting a changed account, and it
+  // has to be copied because the store overwrites it in place
+  if (revertible && !fullCopy) {
+    const Account t_account(*oriAccount);
+    accountStore.AddAccountDuringDeserialization(address, account, t_account,
+                                                 fullCopy, revertible);
+  } else {
+    accountStore.AddAccountDuringDeserialization(address, account, *oriAccount,
+                                                 fullCopy, revertible);
+  }
+
+  return true;
+}
+
+bool ApplyAccountDelta(const ProtoAccount& protoAccount, const Address& address,
+                       AccountStoreTemp& accountStoreTemp, bool temp) {
+  const Account* oriAccount = accountStoreTemp.GetAccount(address);
+  bool fullCopy = false;
+  if (oriAccount == nullptr) {
+    Account acc(0, 0);
+    LOG_GENERAL(INFO, "Creating new account: " << address);
+    accountStoreTemp.AddAccount(address, acc);
+    fullCopy = true;
+  }
+
+  oriAccount = accountStoreTemp.GetAccount(address);
+
+  if (oriAccount == nullptr) {
+    LOG_GENERAL(WARNING, "Failed to create account for " << address);
+    return false;
+  }
+
+  Account account(*oriAccount);
+
+  if (!ProtobufToAccountDelta(protoAccount, account, address, fullCopy, temp)) {
+    LOG_GENERAL(WARNING,
+                "ProtobufToAccountDelta failed for account at address "
+                    << address.hex());
+    return false;
+  }
+
+  accountStoreTemp.AddAccountDuringDeserialization(address, account);
+
+  return true;
+}
+
+template <class STORE, class... Args>
+bool ApplyStreamAccountStoreDelta(const bytes& src, const unsigned int offset,
+                                  STORE& store, Args... args) {
+  vector<StateDeltaStream::RecordRef> index;
+  if (!StateDeltaStream::GetIndex(src, offset, index)) {
+    LOG_GENERAL(WARNING, "StateDeltaStream::GetIndex failed");
+    return false;
+  }
+
+  LOG_GENERAL(INFO, "Total Number of Accounts Delta: " << index.size());
+
+  vector<ProtoAccount> protoAccounts;
+  for (size_t begin = 0; begin < index.size();
+       begin += STATE_DELTA_APPLY_WINDOW) {
+    const size_t end =
+        min<size_t>(begin + STATE_DELTA_APPLY_WINDOW, index.size());
+
+    if (!ParseStateDeltaRecords(src, index, begin, end, protoAccounts)) {
+      return false;
+    }
+
+    for (size_t i = begin; i < end; i++) {
+      if (!ApplyAccountDelta(protoAccounts.at(i - begin),
+                             index.at(i).m_address, store, args...)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+}  // namespace
+
 bool Messenger::SetAccountStoreDelta(bytes& dst, const unsigned int offset,
                                      AccountStoreTemp& accountStoreTemp,
-                                     AccountStore& accountStore) {
+                                     AccountStore& accountStore,
+                                     const unsigned int deltaVersion) {
+  if (deltaVersion < STATE_DELTA_VERSION_STREAM) {
+    return SetAccountStoreDeltaProto(dst, offset, accountStoreTemp,
+                                     accountStore);
+  }
+
+  LOG_GENERAL(INFO, "Account deltas to serialize: "
+                        << accountStoreTemp.GetNumOfAccounts());
+
+  // Keep an empty delta empty, as GetStateDeltaHash relies on it
+  if (accountStoreTemp.GetAddressToAccount()->empty()) {
+    return true;
+  }
+
+  StateDeltaStream::Writer writer(dst, offset);
+  ProtoAccount protoAccount;
+
+  for (const auto& entry : *accountStoreTemp.GetAddressToAccount()) {
+    protoAccount.Clear();
+    AccountDeltaToProtobuf(accountStore.GetAccount(entry.first), entry.second,
+                           protoAccount);
+    if (!protoAccount.IsInitialized()) {
+      LOG_GENERAL(WARNING, "ProtoAccount initialization failed");
+      return false;
+    }
+
+    const unsigned int size = protoAccount.ByteSize();
+    unsigned int payloadOffset = 0;
+    if (!writer.BeginRecord(entry.first, size, payloadOffset)) {
+      LOG_GENERAL(WARNING, "StateDeltaStream::Writer::BeginRecord failed");
+      return false;
+    }
+    if (!protoAccount.SerializeToArray(dst.data() + payloadOffset, size)) {
+      LOG_GENERAL(WARNING, "ProtoAccount serialization failed");
+      return false;
+    }
+  }
+
+  writer.Finalize();
+
+  return true;
+}
+
+bool Messenger::SetAccountStoreDeltaProto(bytes& dst, const unsigned int offset,
+                                          AccountStoreTemp& accountStoreTemp,
+                                          AccountStore& accountStore) {
   ProtoAccountStore result;
 
   LOG_GENERAL(INFO, "Account deltas to serialize: "
@@ -2720,6 +2961,63 @@ bool Messenger::StateDeltaToAddressMap(
     return false;
   }
 
+  if (StateDeltaStream::IsStreamFormat(src, offset)) {
+    vector<StateDeltaStream::RecordRef> index;
+    if (!StateDeltaStream::GetIndex(src, offset, index)) {
+      LOG_GENERAL(WARNING, "StateDeltaStream::GetIndex failed");
+      return false;
+    }
+
+    // Only the balance is needed here, so every address range can be parsed
+    // independently and merged at the end
+    const auto parts = StateDeltaStream::PartitionByAddress(
+        index, GetStateDeltaParseThreads(index.size()));
+    vector<vector<pair<Address, int256_t>>> partBalances(parts.size());
+    vector<future<bool>> results;
+    for (size_t p = 0; p < parts.size(); p++) {
+      const auto part = parts[p];
+      auto& balances = partBalances[p];
+      results.emplace_back(async(launch::async, [&src, &index, part,
+                                                 &balances]() {
+        balances.reserve(part.second - part.first);
+        ProtoAccount protoAccount;
+        for (size_t i = part.first; i < part.second; i++) {
+          const auto& ref = index.at(i);
+          if (!protoAccount.ParseFromArray(src.data() + ref.m_offset,
+                                           ref.m_size)) {
+            LOG_GENERAL(WARNING, "ProtoAccount parsing failed for account at "
+                                     << ref.m_address);
+            return false;
+          }
+
+          uint128_t tmpNumber;
+          ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(
+              protoAccount.base().balance(), tmpNumber);
+          balances.emplace_back(ref.m_address,
+                                protoAccount.numbersign()
+                                    ? tmpNumber.convert_to<int256_t>()
+                                    : 0 - tmpNumber.convert_to<int256_t>());
+        }
+        return true;
+      }));
+    }
+
+    // Wait for every part before returning, as they reference src and index
+    bool ok = true;
+    for (auto& result : results) {
+      ok = result.get() && ok;
+    }
+    if (!ok) {
+      return false;
+    }
+
+    for (const auto& balances : partBalances) {
+      accountMap.insert(balances.begin(), balances.end());
+    }
+
+    return true;
+  }
+
   ProtoAccountStore result;
   result.ParseFromArray(src.data() + offset, src.size() - offset);
 
@@ -2756,6 +3054,11 @@ bool Messenger::GetAccountStoreDelta(const bytes& src,
                                      const unsigned int offset,
                                      AccountStore& accountStore,
                                      const bool revertible, bool temp) {
+  if (StateDeltaStream::IsStreamFormat(src, offset)) {
+    return ApplyStreamAccountStoreDelta(src, offset, accountStore, revertible,
+                                        temp);
+  }
+
   ProtoAccountStore result;
   result.ParseFromArray(src.data() + offset, src.size() - offset);
 
@@ -2769,39 +3072,16 @@ bool Messenger::GetAccountStoreDelta(const bytes& src,
 
   for (const auto& entry : result.entries()) {
     Address address;
-    Account account, t_account;
 
     copy(entry.address().begin(),
          entry.address().begin() + min((unsigned int)entry.address().size(),
                                        (unsigned int)address.size),
          address.asArray().begin());
 
-    const Account* oriAccount = accountStore.GetAccount(address);
-    bool fullCopy = false;
-    if (oriAccount == nullptr) {
-      Account acc(0, 0);
-      accountStore.AddAccount(address, acc);
-      oriAccount = accountStore.GetAccount(address);
-      fullCopy = true;
-
-      if (oriAccount == nullptr) {
-        LOG_GENERAL(WARNING, "Failed to create account for " << address);
-        return false;
-      }
-    }
-
-    t_account = *oriAccount;
-    account = *oriAccount;
-    if (!ProtobufToAccountDelta(entry.account(), account, address, fullCopy,
-                                temp, revertible)) {
-      LOG_GENERAL(WARNING,
-                  "ProtobufToAccountDelta failed for account at address "
-                      << address.hex());
+    if (!ApplyAccountDelta(entry.account(), address, accountStore, revertible,
+                           temp)) {
       return false;
     }
-
-    accountStore.AddAccountDuringDeserialization(address, account, t_account,
-                                                 fullCopy, revertible);
   }
 
   return true;
@@ -2811,6 +3091,10 @@ bool Messenger::GetAccountStoreDelta(const bytes& src,
                                      const unsigned int offset,
                                      AccountStoreTemp& accountStoreTemp,
                                      bool temp) {
+  if (StateDeltaStream::IsStreamFormat(src, offset)) {
+    return ApplyStreamAccountStoreDelta(src, offset, accountStoreTemp, temp);
+  }
+
   ProtoAccountStore result;
   result.ParseFromArray(src.data() + offset, src.size() - offset);
 
@@ -2824,40 +3108,15 @@ bool Messenger::GetAccountStoreDelta(const bytes& src,
 
   for (const auto& entry : result.entries()) {
     Address address;
-    Account account;
 
     copy(entry.address().begin(),
          entry.address().begin() + min((unsigned int)entry.address().size(),
                                        (unsigned int)address.size),
          address.asArray().begin());
 
-    const Account* oriAccount = accountStoreTemp.GetAccount(address);
-    bool fullCopy = false;
-    if (oriAccount == nullptr) {
-      Account acc(0, 0);
-      LOG_GENERAL(INFO, "Creating new account: " << address);
-      accountStoreTemp.AddAccount(address, acc);
-      fullCopy = true;
-    }
-
-    oriAccount = accountStoreTemp.GetAccount(address);
-
-    if (oriAccount == nullptr) {
-      LOG_GENERAL(WARNING, "Failed to create account for " << address);
-      return false;
-    }
-
-    account = *oriAccount;
-
-    if (!ProtobufToAccountDelta(entry.account(), account, address, fullCopy,
-                                temp)) {
-      LOG_GENERAL(WARNING,
-                  "ProtobufToAccountDelta failed for account at address "
-                      << address.hex());
+    if (!ApplyAccountDelta(entry.account(), address, accountStoreTemp, temp)) {
       return false;
     }
-
-    accountStoreTemp.AddAccountDuringDeserialization(address, account);
   }
 
   return true;
@@ -4355,7 +4614,8 @@ bool Messenger::SetDSFinalBlockAnnouncement(
     bytes& dst, const unsigned int offset, const uint32_t consensusID,
     const uint64_t blockNumber, const bytes& blockHash, const uint16_t leaderID,
     const PairOfKey& leaderKey, const TxBlock& txBlock,
-    const shared_ptr<MicroBlock>& microBlock, bytes& messageToCosign) {
+    const shared_ptr<MicroBlock>& microBlock,
+    const CompactTxnHashes& compactTxnHashes, bytes& messageToCosign) {
   LOG_MARKER();
 
   ConsensusAnnouncement announcement;
@@ -4366,6 +4626,11 @@ bool Messenger::SetDSFinalBlockAnnouncement(
   TxBlockToProtobuf(txBlock, *finalblock->mutable_txblock());
   if (microBlock != nullptr) {
     MicroBlockToProtobuf(*microBlock, *finalblock->mutable_microblock());
+    if (!compactTxnHashes.IsEmpty()) {
+      CompactTxnHashesToProtobuf(compactTxnHashes,
+                                 *finalblock->mutable_microblock(),
+                                 *finalblock->mutable_compacttxnhashes());
+    }
   } else {
     LOG_GENERAL(WARNING, "microblock is nullptr");
   }
@@ -4401,7 +4666,8 @@ bool Messenger::GetDSFinalBlockAnnouncement(
     const bytes& src, const unsigned int offset, const uint32_t consensusID,
     const uint64_t blockNumber, const bytes& blockHash, const uint16_t leaderID,
     const PubKey& leaderKey, TxBlock& txBlock,
-    shared_ptr<MicroBlock>& microBlock, bytes& messageToCosign) {
+    shared_ptr<MicroBlock>& microBlock, CompactTxnHashes& compactTxnHashes,
+    bytes& messageToCosign) {
   LOG_MARKER();
 
   if (offset >= src.size()) {
@@ -4438,8 +4704,14 @@ bool Messenger::GetDSFinalBlockAnnouncement(
     return false;
   }
 
+  compactTxnHashes = CompactTxnHashes();
   if (finalblock.microblock().IsInitialized()) {
     ProtobufToMicroBlock(finalblock.microblock(), *microBlock);
+    if (finalblock.has_compacttxnhashes() &&
+        !ProtobufToCompactTxnHashes(finalblock.compacttxnhashes(), *microBlock,
+                                    compactTxnHashes)) {
+      return false;
+    }
   } else {
     LOG_GENERAL(WARNING, "Announcement doesn't include ds microblock");
     microBlock = nullptr;
@@ -5171,7 +5443,7 @@ bool Messenger::SetNodeMicroBlockAnnouncement(
     bytes& dst, const unsigned int offset, const uint32_t consensusID,
     const uint64_t blockNumber, const bytes& blockHash, const uint16_t leaderID,
     const PairOfKey& leaderKey, const MicroBlock& microBlock,
-    bytes& messageToCosign) {
+    const CompactTxnHashes& compactTxnHashes, bytes& messageToCosign) {
   LOG_MARKER();
 
   ConsensusAnnouncement announcement;
@@ -5180,6 +5452,11 @@ bool Messenger::SetNodeMicroBlockAnnouncement(
 
   NodeMicroBlockAnnouncement* microblock = announcement.mutable_microblock();
   MicroBlockToProtobuf(microBlock, *microblock->mutable_microblock());
+  if (!compactTxnHashes.IsEmpty()) {
+    CompactTxnHashesToProtobuf(compactTxnHashes,
+                               *microblock->mutable_microblock(),
+                               *microblock->mutable_compacttxnhashes());
+  }
 
   if (!microblock->IsInitialized()) {
     LOG_GENERAL(WARNING, "NodeMicroBlockAnnouncement initialization failed");
@@ -5211,7 +5488,8 @@ bool Messenger::SetNodeMicroBlockAnnouncement(
 bool Messenger::GetNodeMicroBlockAnnouncement(
     const bytes& src, const unsigned int offset, const uint32_t consensusID,
     const uint64_t blockNumber, const bytes& blockHash, const uint16_t leaderID,
-    const PubKey& leaderKey, MicroBlock& microBlock, bytes& messageToCosign) {
+    const PubKey& leaderKey, MicroBlock& microBlock,
+    CompactTxnHashes& compactTxnHashes, bytes& messageToCosign) {
   LOG_MARKER();
 
   if (offset >= src.size()) {
@@ -5246,6 +5524,13 @@ bool Messenger::GetNodeMicroBlockAnnouncement(
   const NodeMicroBlockAnnouncement& microblock = announcement.microblock();
   ProtobufToMicroBlock(microblock.microblock(), microBlock);
 
+  compactTxnHashes = CompactTxnHashes();
+  if (microblock.has_compacttxnhashes() &&
+      !ProtobufToCompactTxnHashes(microblock.compacttxnhashes(), microBlock,
+                                  compactTxnHashes)) {
+    return false;
+  }
+
   // Get the part of the announcement that should be co-signed during the first
   // round of consensus
 
@@ -5429,7 +5714,8 @@ bool Messenger::ArrayToShardStructure(const bytes& src,
 
 bool Messenger::SetNodeMissingTxnsErrorMsg(
     bytes& dst, const unsigned int offset,
-    const vector<TxnHash>& missingTxnHashes, const uint64_t epochNum,
+    const vector<TxnHash>& missingTxnHashes,
+    const vector<uint32_t>& missingTxnIndices, const uint64_t epochNum,
     const uint32_t listenPort) {
   LOG_MARKER();
 
@@ -5440,6 +5726,10 @@ bool Messenger::SetNodeMissingTxnsErrorMsg(
     result.add_txnhashes(hash.data(), hash.size);
   }
 
+  for (const auto& index : missingTxnIndices) {
+    result.add_txnindices(index);
+  }
+
   result.set_epochnum(epochNum);
   result.set_listenport(listenPort);
 
@@ -5451,11 +5741,10 @@ bool Messenger::SetNodeMissingTxnsErrorMsg(
   return SerializeToArray(result, dst, offset);
 }
 
-bool Messenger::GetNodeMissingTxnsErrorMsg(const bytes& src,
-                                           const unsigned int offset,
-                                           vector<TxnHash>& missingTxnHashes,
-                                           uint64_t& epochNum,
-                                           uint32_t& listenPort) {
+bool Messenger::GetNodeMissingTxnsErrorMsg(
+    const bytes& src, const unsigned int offset,
+    vector<TxnHash>& missingTxnHashes, vector<uint32_t>& missingTxnIndices,
+    uint64_t& epochNum, uint32_t& listenPort) {
   LOG_MARKER();
 
   if (offset >= src.size()) {
@@ -5480,12 +5769,96 @@ bool Messenger::GetNodeMissingTxnsErrorMsg(const bytes& src,
          missingTxnHashes.back().asArray().begin());
   }
 
+  missingTxnIndices.assign(result.txnindices().begin(),
+                           result.txnindices().end());
+
   epochNum = result.epochnum();
   listenPort = result.listenport();
 
   return true;
 }
 
+bool Messenger::SetNodeTxnOrder(bytes& dst, const unsigned int offset,
+                                const PairOfKey& leaderKey,
+                                const uint64_t epochNumber,
+                                const uint32_t startIndex,
+                                const vector<TxnHash>& txnHashes,
+                                const bool last) {
+  NodeTxnOrder result;
+
+  result.mutable_data()->set_epochnumber(epochNumber);
+  result.mutable_data()->set_startindex(startIndex);
+  for (const auto& hash : txnHashes) {
+    result.mutable_data()->add_txnhashes(hash.data(), hash.size);
+  }
+  result.mutable_data()->set_last(last);
+
+  SerializableToProtobufByteArray(leaderKey.second, *result.mutable_pubkey());
+
+  if (!result.data().IsInitialized()) {
+    LOG_GENERAL(WARNING, "NodeTxnOrder.Data initialization failed");
+    return false;
+  }
+
+  bytes tmp(result.data().ByteSize());
+  result.data().SerializeToArray(tmp.data(), tmp.size());
+  Signature signature;
+  if (!Schnorr::Sign(tmp, leaderKey.first, leaderKey.second, signature)) {
+    LOG_GENERAL(WARNING, "Failed to sign NodeTxnOrder");
+    return false;
+  }
+  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "NodeTxnOrder initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(result, dst, offset);
+}
+
+bool Messenger::GetNodeTxnOrder(const bytes& src, const unsigned int offset,
+                                PubKey& leaderPubKey, uint64_t& epochNumber,
+                                uint32_t& startIndex,
+                                vector<TxnHash>& txnHashes, bool& last) {
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  NodeTxnOrder result;
+  result.ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "NodeTxnOrder initialization failed");
+    return false;
+  }
+
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), leaderPubKey);
+  Signature signature;
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+  bytes tmp(result.data().ByteSize());
+  result.data().SerializeToArray(tmp.data(), tmp.size());
+  if (!Schnorr::Verify(tmp, 0, tmp.size(), signature, leaderPubKey)) {
+    LOG_GENERAL(WARNING, "NodeTxnOrder signature wrong");
+    return false;
+  }
+
+  epochNumber = result.data().epochnumber();
+  startIndex = result.data().startindex();
+  for (const auto& hash : result.data().txnhashes()) {
+    txnHashes.emplace_back();
+    unsigned int size =
+        min((unsigned int)hash.size(), (unsigned int)txnHashes.back().size);
+    copy(hash.begin(), hash.begin() + size,
+         txnHashes.back().asArray().begin());
+  }
+  last = result.data().last();
+
+  return true;
+}
+
 // ============================================================================
 // Lookup messages
 // ============================================================================
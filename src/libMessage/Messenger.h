@@ -98,9 +98,15 @@ class Messenger {
                               AccountStore& accountStore);
 
   // These are called by AccountStore class
-  static bool SetAccountStoreDelta(bytes& dst, const unsigned int offset,
-                                   AccountStoreTemp& accountStoreTemp,
-                                   AccountStore& accountStore);
+  // deltaVersion selects the on-wire layout; GetAccountStoreDelta and
+  // StateDeltaToAddressMap accept either layout
+  static bool SetAccountStoreDelta(
+      bytes& dst, const unsigned int offset, AccountStoreTemp& accountStoreTemp,
+      AccountStore& accountStore,
+      const unsigned int deltaVersion = STATE_DELTA_VERSION);
+  static bool SetAccountStoreDeltaProto(bytes& dst, const unsigned int offset,
+                                        AccountStoreTemp& accountStoreTemp,
+                                        AccountStore& accountStore);
   static bool GetAccountStoreDelta(const bytes& src, const unsigned int offset,
                                    AccountStore& accountStore,
                                    const bool revertible, bool temp);
@@ -312,13 +318,14 @@ class Messenger {
       const uint64_t blockNumber, const bytes& blockHash,
       const uint16_t leaderID, const PairOfKey& leaderKey,
       const TxBlock& txBlock, const std::shared_ptr<MicroBlock>& microBlock,
-      bytes& messageToCosign);
+      const CompactTxnHashes& compactTxnHashes, bytes& messageToCosign);
 
   static bool GetDSFinalBlockAnnouncement(
       const bytes& src, const unsigned int offset, const uint32_t consensusID,
       const uint64_t blockNumber, const bytes& blockHash,
       const uint16_t leaderID, const PubKey& leaderKey, TxBlock& txBlock,
-      std::shared_ptr<MicroBlock>& microBlock, bytes& messageToCosign);
+      std::shared_ptr<MicroBlock>& microBlock,
+      CompactTxnHashes& compactTxnHashes, bytes& messageToCosign);
 
   static bool SetDSVCBlockAnnouncement(
       bytes& dst, const unsigned int offset, const uint32_t consensusID,
@@ -424,13 +431,16 @@ class Messenger {
       bytes& dst, const unsigned int offset, const uint32_t consensusID,
       const uint64_t blockNumber, const bytes& blockHash,
       const uint16_t leaderID, const PairOfKey& leaderKey,
-      const MicroBlock& microBlock, bytes& messageToCosign);
+      const MicroBlock& microBlock, const CompactTxnHashes& compactTxnHashes,
+      bytes& messageToCosign);
 
+  /// If the txn list was sent as short IDs, microBlock is left without txn
+  /// hashes and compactTxnHashes holds the short IDs.
   static bool GetNodeMicroBlockAnnouncement(
       const bytes& src, const unsigned int offset, const uint32_t consensusID,
       const uint64_t blockNumber, const bytes& blockHash,
       const uint16_t leaderID, const PubKey& leaderKey, MicroBlock& microBlock,
-      bytes& messageToCosign);
+      CompactTxnHashes& compactTxnHashes, bytes& messageToCosign);
 
   static bool SetNodeFallbackBlockAnnouncement(
       bytes& dst, const unsigned int offset, const uint32_t consensusID,
@@ -457,13 +467,25 @@ class Messenger {
 
   static bool SetNodeMissingTxnsErrorMsg(
       bytes& dst, const unsigned int offset,
-      const std::vector<TxnHash>& missingTxnHashes, const uint64_t epochNum,
+      const std::vector<TxnHash>& missingTxnHashes,
+      const std::vector<uint32_t>& missingTxnIndices, const uint64_t epochNum,
       const uint32_t listenPort);
-  static bool GetNodeMissingTxnsErrorMsg(const bytes& src,
-                                         const unsigned int offset,
-                                         std::vector<TxnHash>& missingTxnHashes,
-                                         uint64_t& epochNum,
-                                         uint32_t& listenPort);
+  static bool GetNodeMissingTxnsErrorMsg(
+      const bytes& src, const unsigned int offset,
+      std::vector<TxnHash>& missingTxnHashes,
+      std::vector<uint32_t>& missingTxnIndices, uint64_t& epochNum,
+      uint32_t& listenPort);
+
+  static bool SetNodeTxnOrder(bytes& dst, const unsigned int offset,
+                              const PairOfKey& leaderKey,
+                              const uint64_t epochNumber,
+                              const uint32_t startIndex,
+                              const std::vector<TxnHash>& txnHashes,
+                              const bool last);
+  static bool GetNodeTxnOrder(const bytes& src, const unsigned int offset,
+                              PubKey& leaderPubKey, uint64_t& epochNumber,
+                              uint32_t& startIndex,
+                              std::vector<TxnHash>& txnHashes, bool& last);
 
   // ============================================================================
   // Lookup messages
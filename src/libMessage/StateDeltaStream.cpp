@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "StateDeltaStream.h"
+#include "common/Serializable.h"
+#include "libUtils/Logger.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace StateDeltaStream {
+
+bool IsStreamFormat(const bytes& src, const unsigned int offset) {
+  if (offset + HEADER_SIZE > src.size()) {
+    return false;
+  }
+
+  return equal(MAGIC, MAGIC + MAGIC_SIZE, src.begin() + offset) &&
+         src[offset + MAGIC_SIZE] == VERSION;
+}
+
+Writer::Writer(bytes& dst, const unsigned int offset)
+    : m_dst(dst), m_start(offset), m_cur(offset + HEADER_SIZE) {
+  if (m_dst.size() < m_cur) {
+    m_dst.resize(m_cur);
+  }
+  copy(MAGIC, MAGIC + MAGIC_SIZE, m_dst.begin() + m_start);
+  m_dst[m_start + MAGIC_SIZE] = VERSION;
+}
+
+bool Writer::BeginRecord(const Address& address,
+                         const unsigned int payloadSize,
+                         unsigned int& payloadOffset) {
+  if (m_count > 0 && !(m_lastAddress < address)) {
+    LOG_GENERAL(WARNING, "Records out of order, last "
+                             << m_lastAddress << " current " << address);
+    return false;
+  }
+
+  const unsigned int recordEnd = m_cur + RECORD_HEADER_SIZE + payloadSize;
+  if (m_dst.size() < recordEnd) {
+    m_dst.resize(recordEnd);
+  }
+
+  copy(address.begin(), address.end(), m_dst.begin() + m_cur);
+  Serializable::SetNumber<uint32_t>(m_dst, m_cur + ACC_ADDR_SIZE, payloadSize,
+                                    LENGTH_SIZE);
+
+  payloadOffset = m_cur + RECORD_HEADER_SIZE;
+  m_cur = recordEnd;
+  m_lastAddress = address;
+  m_count++;
+
+  return true;
+}
+
+void Writer::Finalize() {
+  Serializable::SetNumber<uint32_t>(m_dst, m_start + MAGIC_SIZE + 1, m_count,
+                                    COUNT_SIZE);
+  m_dst.resize(m_cur);
+}
+
+bool GetIndex(const bytes& src, const unsigned int offset,
+              vector<RecordRef>& index) {
+  if (!IsStreamFormat(src, offset)) {
+    LOG_GENERAL(WARNING, "Not a stream-format state delta");
+    return false;
+  }
+
+  const uint32_t count = Serializable::GetNumber<uint32_t>(
+      src, offset + MAGIC_SIZE + 1, COUNT_SIZE);
+
+  // Each record takes at least RECORD_HEADER_SIZE bytes, so a bogus count
+  // cannot make us reserve more than the input could hold
+  const size_t maxCount = (src.size() - offset - HEADER_SIZE) /
+                          RECORD_HEADER_SIZE;
+  if (count > maxCount) {
+    LOG_GENERAL(WARNING, "Record count " << count << " exceeds data size "
+                                         << src.size());
+    return false;
+  }
+
+  index.clear();
+  index.reserve(count);
+
+  size_t pos = offset + HEADER_SIZE;
+  for (uint32_t i = 0; i < count; i++) {
+    if (pos + RECORD_HEADER_SIZE > src.size()) {
+      LOG_GENERAL(WARNING, "Truncated record header at " << pos);
+      return false;
+    }
+
+    RecordRef ref;
+    copy(src.begin() + pos, src.begin() + pos + ACC_ADDR_SIZE,
+         ref.m_address.asArray().begin());
+    ref.m_size = Serializable::GetNumber<uint32_t>(src, pos + ACC_ADDR_SIZE,
+                                                   LENGTH_SIZE);
+    ref.m_offset = pos + RECORD_HEADER_SIZE;
+
+    if (ref.m_offset + (size_t)ref.m_size > src.size()) {
+      LOG_GENERAL(WARNING, "Truncated payload for " << ref.m_address);
+      return false;
+    }
+
+    if (!index.empty() && !(index.back().m_address < ref.m_address)) {
+      LOG_GENERAL(WARNING, "Records out of order at " << ref.m_address);
+      return false;
+    }
+
+    pos = ref.m_offset + ref.m_size;
+    index.emplace_back(ref);
+  }
+
+  return true;
+}
+
+vector<pair<size_t, size_t>> PartitionByAddress(
+    const vector<RecordRef>& index, const unsigned int numParts) {
+  vector<pair<size_t, size_t>> parts;
+
+  if (index.empty() || numParts == 0) {
+    return parts;
+  }
+
+  size_t totalBytes = 0;
+  for (const auto& ref : index) {
+    totalBytes += RECORD_HEADER_SIZE + ref.m_size;
+  }
+
+  const size_t target = (totalBytes + numParts - 1) / numParts;
+
+  size_t begin = 0;
+  size_t acc = 0;
+  for (size_t i = 0; i < index.size(); i++) {
+    acc += RECORD_HEADER_SIZE + index[i].m_size;
+    if (acc >= target && parts.size() + 1 < numParts) {
+      parts.emplace_back(begin, i + 1);
+      begin = i + 1;
+      acc = 0;
+    }
+  }
+
+  if (begin < index.size()) {
+    parts.emplace_back(begin, index.size());
+  }
+
+  return parts;
+}
+
+void ChunkReader::Feed(const bytes& chunk) {
+  // Drop the bytes of records already handed out before growing the buffer
+  if (m_pos > 0) {
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + m_pos);
+    m_pos = 0;
+  }
+  m_buffer.insert(m_buffer.end(), chunk.begin(), chunk.end());
+}
+
+bool ChunkReader::Next(Address& address, bytes& payload) {
+  if (m_error) {
+    return false;
+  }
+
+  if (!m_headerDone) {
+    if (m_buffer.size() - m_pos < HEADER_SIZE) {
+      return false;
+    }
+    if (!IsStreamFormat(m_buffer, m_pos)) {
+      LOG_GENERAL(WARNING, "Not a stream-format state delta");
+      m_error = true;
+      return false;
+    }
+    m_expected = Serializable::GetNumber<uint32_t>(
+        m_buffer, m_pos + MAGIC_SIZE + 1, COUNT_SIZE);
+    m_pos += HEADER_SIZE;
+    m_headerDone = true;
+  }
+
+  if (m_consumed == m_expected) {
+    return false;
+  }
+
+  if (m_buffer.size() - m_pos < RECORD_HEADER_SIZE) {
+    return false;
+  }
+
+  const uint32_t size = Serializable::GetNumber<uint32_t>(
+      m_buffer, m_pos + ACC_ADDR_SIZE, LENGTH_SIZE);
+  if (m_buffer.size() - m_pos - RECORD_HEADER_SIZE < size) {
+    return false;
+  }
+
+  copy(m_buffer.begin() + m_pos, m_buffer.begin() + m_pos + ACC_ADDR_SIZE,
+       address.asArray().begin());
+  const auto payloadBegin = m_buffer.begin() + m_pos + RECORD_HEADER_SIZE;
+  payload.assign(payloadBegin, payloadBegin + size);
+
+  m_pos += RECORD_HEADER_SIZE + size;
+  m_consumed++;
+
+  return true;
+}
+
+}  // namespace StateDeltaStream
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef ZILLIQA_SRC_LIBMESSAGE_STATEDELTASTREAM_H_
+#define ZILLIQA_SRC_LIBMESSAGE_STATEDELTASTREAM_H_
+
+#include <utility>
+#include <vector>
+
+#include "common/BaseType.h"
+#include "libData/AccountData/Address.h"
+
+/// Length-prefixed, versioned container for the account and contract-state
+/// sections of a state delta.
+///
+/// Layout (all integers big endian):
+///   header : MAGIC (3 bytes) | VERSION (1 byte) | record count (4 bytes)
+///   record : address (20 bytes) | payload length (4 bytes) | payload
+///
+/// Each payload is a serialized ProtoAccount delta. Records are written in
+/// ascending address order, so a reader can skip through the headers alone,
+/// split the delta into address ranges and parse those ranges independently.
+namespace StateDeltaStream {
+
+const uint8_t MAGIC[] = {'Z', 'S', 'D'};
+const unsigned int MAGIC_SIZE = sizeof(MAGIC);
+const uint8_t VERSION = 1;
+const unsigned int COUNT_SIZE = sizeof(uint32_t);
+const unsigned int LENGTH_SIZE = sizeof(uint32_t);
+const unsigned int HEADER_SIZE = MAGIC_SIZE + 1 + COUNT_SIZE;
+const unsigned int RECORD_HEADER_SIZE = ACC_ADDR_SIZE + LENGTH_SIZE;
+
+/// Location of one record payload inside a serialized delta.
+struct RecordRef {
+  Address m_address;
+  unsigned int m_offset;
+  unsigned int m_size;
+};
+
+/// Returns true if the bytes at offset start with a stream-format header.
+bool IsStreamFormat(const bytes& src, const unsigned int offset);
+
+/// Appends records to dst one at a time, without building the whole delta in
+/// an intermediate message.
+class Writer {
+  bytes& m_dst;
+  const unsigned int m_start;
+  unsigned int m_cur;
+  uint32_t m_count{0};
+  Address m_lastAddress;
+
+ public:
+  Writer(bytes& dst, const unsigned int offset);
+
+  /// Reserves space for a record payload of the given size and returns the
+  /// offset where the caller must write it.
+  bool BeginRecord(const Address& address, const unsigned int payloadSize,
+                   unsigned int& payloadOffset);
+
+  /// Patches the record count into the header and trims dst.
+  void Finalize();
+
+  uint32_t GetCount() const { return m_count; }
+};
+
+/// Walks the record headers and returns the location of every payload.
+bool GetIndex(const bytes& src, const unsigned int offset,
+              std::vector<RecordRef>& index);
+
+/// Splits an index into at most numParts contiguous address ranges of roughly
+/// equal payload volume. Returned pairs are [begin, end) positions in index.
+std::vector<std::pair<std::size_t, std::size_t>> PartitionByAddress(
+    const std::vector<RecordRef>& index, const unsigned int numParts);
+
+/// Incremental reader for deltas arriving in chunks (e.g. from the network or
+/// from disk). Records are handed out as soon as they are complete, and the
+/// bytes they occupied are released.
+class ChunkReader {
+  bytes m_buffer;
+  std::size_t m_pos{0};
+  bool m_headerDone{false};
+  uint32_t m_expected{0};
+  uint32_t m_consumed{0};
+  bool m_error{false};
+
+ public:
+  /// Appends the next chunk of the serialized delta.
+  void Feed(const bytes& chunk);
+
+  /// Extracts the next complete record, if any. Returns false when more data
+  /// is needed, when all records have been read, or on malformed input.
+  bool Next(Address& address, bytes& payload);
+
+  bool IsDone() const { return m_headerDone && m_consumed == m_expected; }
+  bool HasError() const { return m_error; }
+};
+
+}  // namespace StateDeltaStream
+
+#endif  // ZILLIQA_SRC_LIBMESSAGE_STATEDELTASTREAM_H_
@@ -36,17 +36,8 @@ bool Blacklist::Exist(const uint128_t& ip, const bool strict) {
     return false;
   }
 
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  const auto& bl = m_blacklistIP.find(ip);
-  if (bl != m_blacklistIP.end()) {
-    if (strict) {
-      // always return exist when strict, must be checked while sending message
-      return true;
-    }
-
-    return bl->second;
-  }
-  return false;
+  // always return exist when strict, must be checked while sending message
+  return (m_flags.Get(ip) & (strict ? BLACKLISTED : STRICT)) != 0;
 }
 
 /// Reputation Manager may use this function
@@ -56,13 +47,11 @@ void Blacklist::Add(const uint128_t& ip, const bool strict,
     return;
   }
 
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  if (ignoreWhitelist || (m_whitelistedIP.end() == m_whitelistedIP.find(ip))) {
-    const auto& res = m_blacklistIP.emplace(ip, strict);
+  lock_guard<mutex> g(m_mutexIP);
+  if (ignoreWhitelist || !(m_flags.Get(ip) & WHITELISTED)) {
     // already existed, then over-ride strictness
-    if (!res.second) {
-      res.first->second = strict;
-    }
+    m_flags.Update(ip, strict ? BLACKLISTED | STRICT : BLACKLISTED,
+                   strict ? 0 : STRICT);
   } else {
     LOG_GENERAL(INFO,
                 "Whitelisted IP: " << IPConverter::ToStrFromNumericalIP(ip));
@@ -75,14 +64,14 @@ void Blacklist::Remove(const uint128_t& ip) {
     return;
   }
 
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  m_blacklistIP.erase(ip);
+  lock_guard<mutex> g(m_mutexIP);
+  m_flags.Update(ip, 0, BLACKLISTED | STRICT);
 }
 
 /// Reputation Manager may use this function
 void Blacklist::Clear() {
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  m_blacklistIP.clear();
+  lock_guard<mutex> g(m_mutexIP);
+  m_flags.ClearAll(BLACKLISTED | STRICT);
   LOG_GENERAL(INFO, "Blacklist cleared");
 }
 
@@ -91,25 +80,18 @@ void Blacklist::Pop(unsigned int num_to_pop) {
     return;
   }
 
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  LOG_GENERAL(INFO, "Num of nodes in blacklist: " << m_blacklistIP.size());
-
-  unsigned int counter = 0;
-  for (auto it = m_blacklistIP.begin(); it != m_blacklistIP.end();) {
-    if (counter < num_to_pop) {
-      it = m_blacklistIP.erase(it);
-      counter++;
-    } else {
-      break;
-    }
-  }
+  lock_guard<mutex> g(m_mutexIP);
+  LOG_GENERAL(INFO,
+              "Num of nodes in blacklist: " << m_flags.Count(BLACKLISTED));
+
+  const size_t counter = m_flags.ClearAll(BLACKLISTED | STRICT, num_to_pop);
 
   LOG_GENERAL(INFO, "Removed " << counter << " nodes from blacklist");
 }
 
 unsigned int Blacklist::SizeOfBlacklist() {
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  return m_blacklistIP.size();
+  lock_guard<mutex> g(m_mutexIP);
+  return m_flags.Count(BLACKLISTED);
 }
 
 void Blacklist::Enable(const bool enable) {
@@ -126,21 +108,20 @@ bool Blacklist::Whitelist(const uint128_t& ip) {
   if (!m_enabled) {
     return false;
   }
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  return m_whitelistedIP.emplace(ip).second;
+  lock_guard<mutex> g(m_mutexIP);
+  return !(m_flags.Update(ip, WHITELISTED, 0) & WHITELISTED);
 }
 
 bool Blacklist::RemoveFromWhitelist(const uint128_t& ip) {
   if (!m_enabled) {
     return false;
   }
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  return (m_whitelistedIP.erase(ip) > 0);
+  lock_guard<mutex> g(m_mutexIP);
+  return (m_flags.Update(ip, 0, WHITELISTED) & WHITELISTED) != 0;
 }
 
 bool Blacklist::IsWhitelistedIP(const uint128_t& ip) {
-  lock_guard<mutex> g(m_mutexBlacklistIP);
-  return m_whitelistedIP.end() != m_whitelistedIP.find(ip);
+  return (m_flags.Get(ip) & WHITELISTED) != 0;
 }
 
 bool Blacklist::WhitelistSeed(const uint128_t& ip) {
@@ -148,25 +129,20 @@ bool Blacklist::WhitelistSeed(const uint128_t& ip) {
     return false;
   }
 
-  {
-    // Incase it was already blacklisted, remove it.
-    lock_guard<mutex> g(m_mutexBlacklistIP);
-    m_blacklistIP.erase(ip);
-  }
-
-  lock_guard<mutex> g(m_mutexWhitelistedSeedsIP);
-  return m_whitelistedSeedsIP.emplace(ip).second;
+  // Incase it was already blacklisted, remove it.
+  lock_guard<mutex> g(m_mutexIP);
+  return !(m_flags.Update(ip, WHITELISTED_SEED, BLACKLISTED | STRICT) &
+           WHITELISTED_SEED);
 }
 
 bool Blacklist::RemoveFromWhitelistedSeeds(const uint128_t& ip) {
   if (!m_enabled) {
     return false;
   }
-  lock_guard<mutex> g(m_mutexWhitelistedSeedsIP);
-  return (m_whitelistedSeedsIP.erase(ip) > 0);
+  lock_guard<mutex> g(m_mutexIP);
+  return (m_flags.Update(ip, 0, WHITELISTED_SEED) & WHITELISTED_SEED) != 0;
 }
 
 bool Blacklist::IsWhitelistedSeed(const uint128_t& ip) {
-  lock_guard<mutex> g(m_mutexWhitelistedSeedsIP);
-  return m_whitelistedSeedsIP.end() != m_whitelistedSeedsIP.find(ip);
+  return (m_flags.Get(ip) & WHITELISTED_SEED) != 0;
 }
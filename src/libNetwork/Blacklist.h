@@ -20,20 +20,10 @@
 
 #include <atomic>
 #include <mutex>
-#include <set>
-#include <unordered_map>
 
+#include "IPFlagTable.h"
 #include "common/BaseType.h"
 
-namespace std {
-template <>
-struct hash<uint128_t> {
-  std::size_t operator()(const uint128_t& key) const {
-    return std::hash<std::string>()(key.convert_to<std::string>());
-  }
-};
-}  // namespace std
-
 class Blacklist {
   Blacklist();
   ~Blacklist();
@@ -42,15 +32,18 @@ class Blacklist {
   Blacklist(Blacklist const&) = delete;
   void operator=(Blacklist const&) = delete;
 
-  std::mutex m_mutexBlacklistIP;
-  std::unordered_map<uint128_t, bool>
-      m_blacklistIP;  // IP <-> Strict/Relaxed
-                      // Strict -> Blacklisted for both sending and incoming msg
-                      // Relaxed -> Blacklisted for incoming msg only
-  std::set<uint128_t> m_whitelistedIP;
-
-  std::mutex m_mutexWhitelistedSeedsIP;
-  std::set<uint128_t> m_whitelistedSeedsIP;
+  enum Flag : uint8_t {
+    BLACKLISTED = 0x01,
+    // Strict -> Blacklisted for both sending and incoming msg
+    // Relaxed -> Blacklisted for incoming msg only
+    STRICT = 0x02,
+    WHITELISTED = 0x04,
+    WHITELISTED_SEED = 0x08,
+  };
+
+  // Serializes writers only, lookups on the send path take no lock
+  std::mutex m_mutexIP;
+  IPFlagTable m_flags;
   std::atomic<bool> m_enabled;
 
  public:
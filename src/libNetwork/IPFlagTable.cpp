@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <thread>
+#include <tuple>
+
+#include "IPFlagTable.h"
+
+using namespace std;
+
+IPFlagTable::IPFlagTable(size_t initialCapacity) {
+  size_t capacity = 16;
+  while (capacity < initialCapacity) {
+    capacity <<= 1;
+  }
+  m_tables.emplace_back(make_unique<Table>(capacity));
+  m_table.store(m_tables.back().get(), memory_order_release);
+}
+
+void IPFlagTable::Split(const uint128_t& ip, uint64_t& high, uint64_t& low) {
+  const uint128_t mask = numeric_limits<uint64_t>::max();
+  low = static_cast<uint64_t>(ip & mask);
+  high = static_cast<uint64_t>(ip >> 64);
+}
+
+size_t IPFlagTable::Hash(uint64_t high, uint64_t low) {
+  // splitmix64 finalizer
+  uint64_t h = low ^ (high * 0x9E3779B97F4A7C15ULL);
+  h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+  return h ^ (h >> 31);
+}
+
+size_t IPFlagTable::Find(const Table& table, uint64_t high, uint64_t low) {
+  size_t index = Hash(high, low) & table.m_mask;
+  // Bounded, as a torn read may see a table without an empty slot
+  for (size_t probes = 0; probes <= table.m_mask; probes++) {
+    const Slot& slot = table.m_slots[index];
+    if (slot.m_flags.load(memory_order_relaxed) == 0 ||
+        (slot.m_high.load(memory_order_relaxed) == high &&
+         slot.m_low.load(memory_order_relaxed) == low)) {
+      break;
+    }
+    index = (index + 1) & table.m_mask;
+  }
+  return index;
+}
+
+uint8_t IPFlagTable::Get(const uint128_t& ip) const {
+  uint64_t high, low;
+  Split(ip, high, low);
+
+  while (true) {
+    const uint64_t sequence = m_sequence.load(memory_order_acquire);
+    if (sequence & 1) {
+      this_thread::yield();
+      continue;
+    }
+
+    const Table& table = *m_table.load(memory_order_acquire);
+    const Slot& slot = table.m_slots[Find(table, high, low)];
+    uint8_t flags = slot.m_flags.load(memory_order_relaxed);
+    if (slot.m_high.load(memory_order_relaxed) != high ||
+        slot.m_low.load(memory_order_relaxed) != low) {
+      flags = 0;
+    }
+
+    atomic_thread_fence(memory_order_acquire);
+    if (m_sequence.load(memory_order_relaxed) == sequence) {
+      return flags;
+    }
+  }
+}
+
+void IPFlagTable::BeginWrite() {
+  m_sequence.store(m_sequence.load(memory_order_relaxed) + 1,
+                   memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+}
+
+void IPFlagTable::EndWrite() {
+  m_sequence.store(m_sequence.load(memory_order_relaxed) + 1,
+                   memory_order_release);
+}
+
+void IPFlagTable::Grow() {
+  const Table& table = *m_table.load(memory_order_relaxed);
+  auto grown = make_unique<Table>((table.m_mask + 1) * 2);
+
+  for (size_t i = 0; i <= table.m_mask; i++) {
+    const Slot& slot = table.m_slots[i];
+    const uint8_t flags = slot.m_flags.load(memory_order_relaxed);
+    if (flags == 0) {
+      continue;
+    }
+    const uint64_t high = slot.m_high.load(memory_order_relaxed);
+    const uint64_t low = slot.m_low.load(memory_order_relaxed);
+    Slot& target = grown->m_slots[Find(*grown, high, low)];
+    target.m_high.store(high, memory_order_relaxed);
+    target.m_low.store(low, memory_order_relaxed);
+    target.m_flags.store(flags, memory_order_relaxed);
+  }
+
+  m_table.store(grown.get(), memory_order_release);
+  m_tables.emplace_back(move(grown));
+}
+
+void IPFlagTable::Erase(Table& table, size_t index) {
+  // Backward shift deletion keeps every probe chain free of holes
+  size_t next = index;
+  while (true) {
+    next = (next + 1) & table.m_mask;
+    Slot& slot = table.m_slots[next];
+    const uint8_t flags = slot.m_flags.load(memory_order_relaxed);
+    if (flags == 0) {
+      break;
+    }
+    const uint64_t high = slot.m_high.load(memory_order_relaxed);
+    const uint64_t low = slot.m_low.load(memory_order_relaxed);
+    const size_t home = Hash(high, low) & table.m_mask;
+
+    // Move the entry back if its home is not within (index, next]
+    const bool inRange = index <= next ? (index < home && home <= next)
+                                       : (index < home || home <= next);
+    if (inRange) {
+      continue;
+    }
+    Slot& hole = table.m_slots[index];
+    hole.m_high.store(high, memory_order_relaxed);
+    hole.m_low.store(low, memory_order_relaxed);
+    hole.m_flags.store(flags, memory_order_relaxed);
+    index = next;
+  }
+  table.m_slots[index].m_flags.store(0, memory_order_relaxed);
+}
+
+uint8_t IPFlagTable::Update(const uint128_t& ip, uint8_t setMask,
+                            uint8_t clearMask) {
+  uint64_t high, low;
+  Split(ip, high, low);
+
+  Table* table = m_table.load(memory_order_relaxed);
+  size_t index = Find(*table, high, low);
+  const uint8_t previous =
+      table->m_slots[index].m_flags.load(memory_order_relaxed);
+  const uint8_t flags = (previous & ~clearMask) | setMask;
+  if (flags == previous) {
+    return previous;
+  }
+
+  BeginWrite();
+  if (previous == 0) {
+    // Keep the load factor at most one half
+    if ((m_size + 1) * 2 > table->m_mask + 1) {
+      Grow();
+      table = m_table.load(memory_order_relaxed);
+      index = Find(*table, high, low);
+    }
+    Slot& slot = table->m_slots[index];
+    slot.m_high.store(high, memory_order_relaxed);
+    slot.m_low.store(low, memory_order_relaxed);
+    slot.m_flags.store(flags, memory_order_relaxed);
+    m_size++;
+  } else if (flags == 0) {
+    Erase(*table, index);
+    m_size--;
+  } else {
+    table->m_slots[index].m_flags.store(flags, memory_order_relaxed);
+  }
+  EndWrite();
+
+  return previous;
+}
+
+size_t IPFlagTable::ClearAll(uint8_t mask, size_t maxEntries) {
+  Table& table = *m_table.load(memory_order_relaxed);
+
+  vector<tuple<uint64_t, uint64_t, uint8_t>> kept;
+  size_t cleared = 0;
+  for (size_t i = 0; i <= table.m_mask; i++) {
+    const Slot& slot = table.m_slots[i];
+    uint8_t flags = slot.m_flags.load(memory_order_relaxed);
+    if (flags == 0) {
+      continue;
+    }
+    if ((flags & mask) != 0 && cleared < maxEntries) {
+      flags &= ~mask;
+      cleared++;
+    }
+    if (flags != 0) {
+      kept.emplace_back(slot.m_high.load(memory_order_relaxed),
+                        slot.m_low.load(memory_order_relaxed), flags);
+    }
+  }
+  if (cleared == 0) {
+    return 0;
+  }
+
+  // Rebuilt in place, as replaced tables are not freed
+  BeginWrite();
+  for (size_t i = 0; i <= table.m_mask; i++) {
+    table.m_slots[i].m_flags.store(0, memory_order_relaxed);
+  }
+  for (const auto& entry : kept) {
+    Slot& slot =
+        table.m_slots[Find(table, get<0>(entry), get<1>(entry))];
+    slot.m_high.store(get<0>(entry), memory_order_relaxed);
+    slot.m_low.store(get<1>(entry), memory_order_relaxed);
+    slot.m_flags.store(get<2>(entry), memory_order_relaxed);
+  }
+  m_size = kept.size();
+  EndWrite();
+
+  return cleared;
+}
+
+size_t IPFlagTable::Count(uint8_t mask) const {
+  const Table& table = *m_table.load(memory_order_relaxed);
+  size_t count = 0;
+  for (size_t i = 0; i <= table.m_mask; i++) {
+    if ((table.m_slots[i].m_flags.load(memory_order_relaxed) & mask) != 0) {
+      count++;
+    }
+  }
+  return count;
+}
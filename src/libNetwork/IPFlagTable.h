@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_IPFLAGTABLE_H_
+#define ZILLIQA_SRC_LIBNETWORK_IPFLAGTABLE_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/BaseType.h"
+
+/// Flat open-addressing table from raw 128-bit IPs to a byte of flags.
+///
+/// Reads take no lock: they run under a sequence lock and retry if a write
+/// overlapped them. Writes must be serialized by the caller. An IP whose
+/// flags drop to 0 is removed. The table only grows, and a replaced table is
+/// kept alive for readers that may still be probing it; since the capacity
+/// doubles, the replaced tables together are smaller than the live one.
+class IPFlagTable {
+  struct Slot {
+    std::atomic<uint64_t> m_high{0};
+    std::atomic<uint64_t> m_low{0};
+    std::atomic<uint8_t> m_flags{0};
+  };
+
+  struct Table {
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask;
+
+    explicit Table(size_t capacity)
+        : m_slots(new Slot[capacity]), m_mask(capacity - 1) {}
+  };
+
+  std::atomic<uint64_t> m_sequence{0};
+  std::atomic<Table*> m_table;
+  std::vector<std::unique_ptr<Table>> m_tables;
+  size_t m_size{0};
+
+  static void Split(const uint128_t& ip, uint64_t& high, uint64_t& low);
+  static size_t Hash(uint64_t high, uint64_t low);
+
+  /// Index of the IP, or of the empty slot where it would go.
+  static size_t Find(const Table& table, uint64_t high, uint64_t low);
+
+  void BeginWrite();
+  void EndWrite();
+  void Grow();
+  void Erase(Table& table, size_t index);
+
+ public:
+  explicit IPFlagTable(size_t initialCapacity = 1024);
+
+  IPFlagTable(const IPFlagTable&) = delete;
+  IPFlagTable& operator=(const IPFlagTable&) = delete;
+
+  /// Flags of the IP, 0 if absent. Safe to call concurrently with writes.
+  uint8_t Get(const uint128_t& ip) const;
+
+  /// Sets the bits in setMask and clears those in clearMask, and returns the
+  /// previous flags.
+  uint8_t Update(const uint128_t& ip, uint8_t setMask, uint8_t clearMask);
+
+  /// Clears the bits in mask on at most maxEntries IPs that have any of them,
+  /// and returns the number of such IPs.
+  size_t ClearAll(uint8_t mask, size_t maxEntries = SIZE_MAX);
+
+  /// Number of IPs with any of the bits in mask.
+  size_t Count(uint8_t mask) const;
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_IPFLAGTABLE_H_
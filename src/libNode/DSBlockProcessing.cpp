@@ -67,6 +67,11 @@ void Node::StoreDSBlockToDisk(const DSBlock& dsblock) {
         "This block is already added. Skipped re-adding to blocklink again");
     return;
   }
+  if (!LOOKUP_NODE_MODE) {
+    m_mediator.m_ds->m_gasPriceTracker.AddDSBlock(
+        dsblock.GetHeader().GetBlockNum(), dsblock.GetHeader().GetEpochNum(),
+        dsblock.GetHeader().GetGasPrice());
+  }
 
   // Update the rand1 value for next PoW
   m_mediator.UpdateDSBlockRand();
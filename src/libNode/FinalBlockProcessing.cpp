@@ -30,6 +30,7 @@
 #include "depends/libDatabase/MemoryDB.h"
 #include "depends/libTrie/TrieDB.h"
 #include "depends/libTrie/TrieHash.h"
+#include "libConsensus/AggregateKeyCache.h"
 #include "libCrypto/Sha2.h"
 #include "libData/AccountData/Account.h"
 #include "libData/AccountData/AccountStore.h"
@@ -51,6 +52,7 @@
 #include "libUtils/Logger.h"
 #include "libUtils/RootComputation.h"
 #include "libUtils/SanityChecks.h"
+#include "libUtils/Scheduler.h"
 #include "libUtils/TimeLockedFunction.h"
 #include "libUtils/TimeUtils.h"
 #include "libUtils/TimestampVerifier.h"
@@ -235,10 +237,11 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock) {
   }
 
   // Generate the aggregated key
-  vector<PubKey> keys;
+  vector<const PubKey*> committee;
+  committee.reserve(B2.size());
   for (auto const& kv : *m_mediator.m_DSCommittee) {
+    committee.emplace_back(&kv.first);
     if (B2.at(index)) {
-      keys.emplace_back(kv.first);
       count++;
     }
     index++;
@@ -249,7 +252,8 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock) {
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<const PubKey> aggregatedKey =
+      AggregateKeyCache::GetInstance().AggregateKeys(committee, B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -266,8 +270,10 @@ bool Node::VerifyFinalBlockCoSignature(const TxBlock& txblock) {
   if (!MultiSig::MultiSigVerify(message, 0, message.size(), txblock.GetCS2(),
                                 *aggregatedKey)) {
     LOG_GENERAL(WARNING, "Cosig verification failed");
-    for (auto& kv : keys) {
-      LOG_GENERAL(WARNING, kv);
+    for (unsigned int i = 0; i < committee.size(); i++) {
+      if (B2.at(i)) {
+        LOG_GENERAL(WARNING, *committee.at(i));
+      }
     }
     return false;
   }
@@ -920,12 +926,9 @@ bool Node::ProcessFinalBlockCore(uint64_t& dsBlockNumber,
     return false;
   }
 
-  auto resumeBlackList = []() mutable -> void {
-    this_thread::sleep_for(chrono::seconds(RESUME_BLACKLIST_DELAY_IN_SECONDS));
-    Blacklist::GetInstance().Enable(true);
-  };
-
-  DetachedFunction(1, resumeBlackList);
+  Scheduler::GetInstance().ScheduleAfter(
+      []() { Blacklist::GetInstance().Enable(true); },
+      RESUME_BLACKLIST_DELAY_IN_SECONDS * 1000);
 
   if (!LoadUnavailableMicroBlockHashes(txBlock, toSendTxnToLookup)) {
     return false;
@@ -1159,10 +1162,12 @@ void Node::CommitForwardedTransactions(const MBnForwardedTxnEntry& entry) {
     bytes serializedTxBody;
     twr.Serialize(serializedTxBody, 0);
     if (!BlockStorage::GetBlockStorage().PutTxBody(
+            entry.m_microBlock.GetHeader().GetEpochNum(),
             twr.GetTransaction().GetTranID(), serializedTxBody)) {
       LOG_GENERAL(WARNING, "BlockStorage::PutTxBody failed " << txhash);
       return;
     }
+    LookupServer::AddToResponseCache(twr);
   }
   if (REMOTESTORAGE_DB_ENABLE && !ARCHIVAL_LOOKUP) {
     RemoteStorageDB::GetInstance().ExecuteWrite();
@@ -1642,6 +1647,9 @@ bool Node::ProcessMBnForwardTransactionCore(const MBnForwardedTxnEntry& entry) {
         }
       }
 
+      LookupServer::AddToResponseCache(
+          m_mediator.m_txBlockChain.GetLastBlock());
+
       if (ENABLE_WEBSOCKET) {
         // send tx block and attach txhashes
         const TxBlock& txBlock = m_mediator.m_txBlockChain.GetLastBlock();
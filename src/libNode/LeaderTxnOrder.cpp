@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "LeaderTxnOrder.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+void LeaderTxnOrder::ResetLocked(const uint64_t epochNum) {
+  m_epochNum = epochNum;
+  m_order.clear();
+  m_pending.clear();
+  m_size = 0;
+  m_lastSeen = false;
+}
+
+bool LeaderTxnOrder::IsCompleteLocked() const {
+  return m_lastSeen && m_order.size() == m_size;
+}
+
+bool LeaderTxnOrder::AddBatch(const uint64_t epochNum,
+                              const uint32_t startIndex,
+                              vector<TxnHash>&& txnHashes, const bool last) {
+  lock_guard<mutex> g(m_mutex);
+
+  if (epochNum < m_epochNum) {
+    LOG_GENERAL(WARNING, "Txn order batch for old epoch " << epochNum);
+    return false;
+  }
+  if (epochNum != m_epochNum) {
+    ResetLocked(epochNum);
+  }
+
+  const uint64_t endIndex =
+      static_cast<uint64_t>(startIndex) + txnHashes.size();
+
+  // The batch must fit in a gap of what has been received so far
+  bool overlaps = startIndex < m_order.size();
+  const auto after = m_pending.lower_bound(startIndex);
+  if (after != m_pending.end() && after->first < endIndex) {
+    overlaps = true;
+  }
+  if (after != m_pending.begin()) {
+    const auto before = prev(after);
+    overlaps |= before->first + before->second.size() > startIndex;
+  }
+  const bool pastEnd =
+      (m_lastSeen && endIndex > m_size) ||
+      (last && (m_lastSeen || (!m_pending.empty() &&
+                               m_pending.rbegin()->first >= endIndex)));
+  if (overlaps || pastEnd) {
+    LOG_GENERAL(WARNING, "Unexpected txn order batch at " << startIndex);
+    return false;
+  }
+
+  if (last) {
+    m_size = endIndex;
+    m_lastSeen = true;
+  }
+  m_pending.emplace(startIndex, move(txnHashes));
+
+  // Append every batch that now continues the order
+  auto it = m_pending.begin();
+  while (it != m_pending.end() && it->first == m_order.size()) {
+    m_order.insert(m_order.end(), it->second.begin(), it->second.end());
+    it = m_pending.erase(it);
+  }
+
+  m_cv.notify_all();
+  return true;
+}
+
+bool LeaderTxnOrder::WaitForTxns(
+    const uint64_t epochNum, const size_t next,
+    const chrono::steady_clock::time_point& deadline,
+    vector<TxnHash>& txnHashes, bool& complete) {
+  unique_lock<mutex> lock(m_mutex);
+  if (m_epochNum < epochNum) {
+    ResetLocked(epochNum);
+  }
+
+  if (!m_cv.wait_until(lock, deadline, [this, epochNum, next]() {
+        return m_epochNum == epochNum &&
+               (m_order.size() > next || IsCompleteLocked());
+      })) {
+    return false;
+  }
+
+  txnHashes.assign(m_order.begin() + next, m_order.end());
+  complete = IsCompleteLocked();
+  return true;
+}
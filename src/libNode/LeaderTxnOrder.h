@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNODE_LEADERTXNORDER_H_
+#define ZILLIQA_SRC_LIBNODE_LEADERTXNORDER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "libData/AccountData/Transaction.h"
+
+/// Txn order that the shard leader streams to the backups in numbered
+/// batches, assembled on a backup for replay. Batches may arrive out of
+/// order; they are appended once every earlier batch is in.
+class LeaderTxnOrder {
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  uint64_t m_epochNum = 0;
+  std::vector<TxnHash> m_order;
+  // Batches received ahead of an earlier one, by start index
+  std::map<uint32_t, std::vector<TxnHash>> m_pending;
+  uint32_t m_size = 0;
+  bool m_lastSeen = false;
+
+  /// Starts over for another epoch. Caller must hold m_mutex.
+  void ResetLocked(const uint64_t epochNum);
+
+  bool IsCompleteLocked() const;
+
+ public:
+  /// Adds the batch at startIndex of the order for epochNum. An earlier
+  /// epoch's order is dropped. Returns false if the batch overlaps what has
+  /// already been received or runs past the last batch.
+  bool AddBatch(const uint64_t epochNum, const uint32_t startIndex,
+                std::vector<TxnHash>&& txnHashes, const bool last);
+
+  /// Waits until the order for epochNum goes beyond next txns or is
+  /// complete, then returns the txns from next on. Returns false if neither
+  /// happened by the deadline.
+  bool WaitForTxns(const uint64_t epochNum, const size_t next,
+                   const std::chrono::steady_clock::time_point& deadline,
+                   std::vector<TxnHash>& txnHashes, bool& complete);
+};
+
+#endif  // ZILLIQA_SRC_LIBNODE_LEADERTXNORDER_H_
@@ -39,8 +39,9 @@
 #include "libPOW/pow.h"
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
-#include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
+#include "libUtils/Metrics.h"
+#include "libUtils/RandomGenerator.h"
 #include "libUtils/RootComputation.h"
 #include "libUtils/SanityChecks.h"
 #include "libUtils/TimeLockedFunction.h"
@@ -161,15 +162,36 @@ bool Node::OnNodeMissingTxns(const bytes& errorMsg, const unsigned int offset,
   }
 
   vector<TxnHash> missingTransactions;
+  vector<uint32_t> missingTxnIndices;
   uint64_t epochNum = 0;
   uint32_t portNo = 0;
 
-  if (!Messenger::GetNodeMissingTxnsErrorMsg(
-          errorMsg, offset, missingTransactions, epochNum, portNo)) {
+  if (!Messenger::GetNodeMissingTxnsErrorMsg(errorMsg, offset,
+                                             missingTransactions,
+                                             missingTxnIndices, epochNum,
+                                             portNo)) {
     LOG_GENERAL(WARNING, "Messenger::GetNodeMissingTxnsErrorMsg failed");
     return false;
   }
 
+  // Positions in the txn list of the announced microblock that the peer
+  // could not rebuild from short txn IDs
+  if (!missingTxnIndices.empty()) {
+    if (epochNum != m_mediator.m_currentEpochNum || m_microblock == nullptr) {
+      LOG_GENERAL(WARNING, "No microblock to look up "
+                               << missingTxnIndices.size()
+                               << " missing txn indices of epoch "
+                               << epochNum);
+    } else {
+      const auto& tranHashes = m_microblock->GetTranHashes();
+      for (const auto& index : missingTxnIndices) {
+        if (index < tranHashes.size()) {
+          missingTransactions.emplace_back(tranHashes[index]);
+        }
+      }
+    }
+  }
+
   Peer peer(from.m_ipAddress, portNo);
 
   lock_guard<mutex> g(m_mutexProcessedTransactions);
@@ -214,6 +236,94 @@ bool Node::OnNodeMissingTxns(const bytes& errorMsg, const unsigned int offset,
   return true;
 }
 
+bool Node::ProcessGetMissingTxns(const bytes& message, unsigned int offset,
+                                 const Peer& from) {
+  if (LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Node::ProcessGetMissingTxns not expected to be called from "
+                "LookUp node");
+    return true;
+  }
+
+  if (!ENABLE_LEADER_TXN_ORDER_REPLAY || !m_isPrimary) {
+    LOG_GENERAL(WARNING, "Not streaming the txn order, ignore request from "
+                             << from);
+    return false;
+  }
+
+  return OnNodeMissingTxns(message, offset, from);
+}
+
+bool Node::ProcessTxnOrder(const bytes& message, unsigned int offset,
+                           const Peer& from) {
+  if (LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Node::ProcessTxnOrder not expected to be called from "
+                "LookUp node");
+    return true;
+  }
+
+  if (!ENABLE_LEADER_TXN_ORDER_REPLAY) {
+    return false;
+  }
+
+  PubKey leaderPubKey;
+  uint64_t epochNum = 0;
+  uint32_t startIndex = 0;
+  vector<TxnHash> txnHashes;
+  bool last = false;
+
+  if (!Messenger::GetNodeTxnOrder(message, offset, leaderPubKey, epochNum,
+                                  startIndex, txnHashes, last)) {
+    LOG_GENERAL(WARNING, "Messenger::GetNodeTxnOrder failed");
+    return false;
+  }
+
+  if (epochNum != m_mediator.m_currentEpochNum) {
+    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+              "Txn order for epoch " << epochNum << " from " << from
+                                     << " ignored");
+    return false;
+  }
+
+  {
+    lock_guard<mutex> g(m_mutexShardMember);
+    if (m_isPrimary || m_myShardMembers == nullptr ||
+        m_consensusLeaderID >= m_myShardMembers->size() ||
+        (*m_myShardMembers)[m_consensusLeaderID].first != leaderPubKey) {
+      LOG_GENERAL(WARNING, "Txn order not from my shard leader " << from);
+      return false;
+    }
+  }
+
+  return m_leaderTxnOrder.AddBatch(epochNum, startIndex, move(txnHashes), last);
+}
+
+void Node::SendLeaderTxnOrder(const uint32_t startIndex,
+                              const vector<TxnHash>& txnHashes,
+                              const bool last) {
+  bytes message = {MessageType::NODE, NodeInstructionType::TXNORDER};
+  if (!Messenger::SetNodeTxnOrder(message, MessageOffset::BODY,
+                                  m_mediator.m_selfKey,
+                                  m_mediator.m_currentEpochNum, startIndex,
+                                  txnHashes, last)) {
+    LOG_GENERAL(WARNING, "Messenger::SetNodeTxnOrder failed");
+    return;
+  }
+
+  VectorOfPeer peers;
+  {
+    lock_guard<mutex> g(m_mutexShardMember);
+    for (const auto& member : *m_myShardMembers) {
+      if (member.first != m_mediator.m_selfKey.second) {
+        peers.emplace_back(member.second);
+      }
+    }
+  }
+
+  P2PComm::GetInstance().SendMessage(peers, message);
+}
+
 bool Node::OnCommitFailure([
     [gnu::unused]] const std::map<unsigned int, bytes>& commitFailureMap) {
   if (LOOKUP_NODE_MODE) {
@@ -246,7 +356,7 @@ bool Node::OnCommitFailure([
   return true;
 }
 
-void Node::NotifyTimeout(bool& txnProcTimeout) {
+chrono::steady_clock::time_point Node::GetTxnProcDeadline() {
   int timeout_time = std::max(
       0,
       ((int)MICROBLOCK_TIMEOUT -
@@ -254,12 +364,43 @@ void Node::NotifyTimeout(bool& txnProcTimeout) {
        (int)CONSENSUS_OBJECT_TIMEOUT));
   LOG_GENERAL(INFO, "The overall timeout for txn processing will be "
                         << timeout_time << " seconds");
-  unique_lock<mutex> lock(m_mutexCVTxnProcFinished);
-  if (cv_TxnProcFinished.wait_for(lock, chrono::seconds(timeout_time)) ==
-      cv_status::timeout) {
-    txnProcTimeout = true;
-    AccountStore::GetInstance().NotifyTimeout();
+  return chrono::steady_clock::now() + chrono::seconds(timeout_time);
+}
+
+void Node::TakeCreatedTxns() {
+  lock_guard<mutex> g(m_mutexCreatedTransactions);
+
+  // Selected again before the last selection was committed, e.g. after
+  // fetching missing txns, so start over from all the txns
+  if (m_createdTxnsTaken) {
+    m_createdTxns.merge(t_createdTxns);
+    MempoolInsertionStatus status;
+    for (const auto& entry : t_processedTransactions) {
+      m_createdTxns.insert(entry.second.GetTransaction(), status);
+    }
+  }
+
+  t_createdTxns.clear();
+  swap(m_createdTxns, t_createdTxns);
+  m_createdTxnsTaken = true;
+}
+
+bool Node::FindCreatedTxn(const TxnHash& txnHash, Transaction& t) {
+  if (m_createdTxns.get(txnHash, t)) {
+    return true;
   }
+  if (!m_createdTxnsTaken) {
+    return false;
+  }
+  if (t_createdTxns.get(txnHash, t)) {
+    return true;
+  }
+  const auto& processed = t_processedTransactions.find(txnHash);
+  if (processed != t_processedTransactions.end()) {
+    t = processed->second.GetTransaction();
+    return true;
+  }
+  return false;
 }
 
 void Node::ProcessTransactionWhenShardLeader(
@@ -272,12 +413,14 @@ void Node::ProcessTransactionWhenShardLeader(
     UpdateBalanceForPreGeneratedAccounts();
   }
 
-  lock_guard<mutex> g(m_mutexCreatedTransactions);
-
-  t_createdTxns = m_createdTxns;
+  lock_guard<mutex> takenLock(m_mutexTakenTxns);
+  TakeCreatedTxns();
   map<Address, map<uint64_t, Transaction>> t_addrNonceTxnMap;
-  t_processedTransactions.clear();
-  m_TxnOrder.clear();
+  {
+    lock_guard<mutex> g(m_mutexProcessedTransactions);
+    t_processedTransactions.clear();
+    m_TxnOrder.clear();
+  }
 
   if (LOG_PARAMETERS) {
     LOG_STATE("[TXNPROC-BEG][" << m_mediator.m_currentEpochNum
@@ -285,15 +428,8 @@ void Node::ProcessTransactionWhenShardLeader(
                                << " NumTx=" << t_createdTxns.size());
   }
 
-  bool txnProcTimeout = false;
-
-  auto txnProcTimer = [this, &txnProcTimeout]() -> void {
-    NotifyTimeout(txnProcTimeout);
-  };
-
-  DetachedFunction(1, txnProcTimer);
-
-  this_thread::sleep_for(chrono::milliseconds(100));
+  const auto txnProcDeadline = GetTxnProcDeadline();
+  AccountStore::GetInstance().SetTxnProcessDeadline(txnProcDeadline);
 
   auto findOneFromAddrNonceTxnMap =
       [](Transaction& t,
@@ -314,10 +450,30 @@ void Node::ProcessTransactionWhenShardLeader(
     return false;
   };
 
-  auto appendOne = [this](const Transaction& t, const TransactionReceipt& tr) {
-    t_processedTransactions.insert(
-        make_pair(t.GetTranID(), TransactionWithReceipt(t, tr)));
-    m_TxnOrder.push_back(t.GetTranID());
+  const bool streamTxnOrder =
+      ENABLE_LEADER_TXN_ORDER_REPLAY &&
+      m_mediator.m_ds->m_mode == DirectoryService::Mode::IDLE;
+  vector<TxnHash> txnOrderBatch;
+  uint32_t txnOrderStart = 0;
+
+  auto appendOne = [this, streamTxnOrder, &txnOrderBatch, &txnOrderStart](
+                       const Transaction& t, const TransactionReceipt& tr) {
+    {
+      // Backups may fetch the txn as soon as it is streamed
+      lock_guard<mutex> g(m_mutexProcessedTransactions);
+      t_processedTransactions.insert(
+          make_pair(t.GetTranID(), TransactionWithReceipt(t, tr)));
+      m_TxnOrder.push_back(t.GetTranID());
+    }
+
+    if (streamTxnOrder) {
+      txnOrderBatch.emplace_back(t.GetTranID());
+      if (txnOrderBatch.size() >= LEADER_TXN_ORDER_BATCH_SIZE) {
+        SendLeaderTxnOrder(txnOrderStart, txnOrderBatch, false);
+        txnOrderStart += txnOrderBatch.size();
+        txnOrderBatch.clear();
+      }
+    }
   };
 
   m_gasUsedTotal = 0;
@@ -329,7 +485,8 @@ void Node::ProcessTransactionWhenShardLeader(
   AccountStore::GetInstance().CleanStorageRootUpdateBufferTemp();
 
   while (m_gasUsedTotal < microblock_gas_limit) {
-    if (txnProcTimeout) {
+    if (chrono::steady_clock::now() >= txnProcDeadline) {
+      LOG_GENERAL(WARNING, "Txn processing timeout!");
       break;
     }
 
@@ -445,15 +602,27 @@ void Node::ProcessTransactionWhenShardLeader(
     }
   }
 
+  if (streamTxnOrder) {
+    SendLeaderTxnOrder(txnOrderStart, txnOrderBatch, true);
+  }
+
+  AccountStore::GetInstance().ClearTxnProcessDeadline();
   AccountStore::GetInstance().ProcessStorageRootUpdateBufferTemp();
   AccountStore::GetInstance().CleanNewLibrariesCacheTemp();
-
-  cv_TxnProcFinished.notify_all();
-  PutTxnsInTempDataBase(t_processedTransactions);
-  if (ENABLE_TXNS_BACKUP) {
-    SaveTxnsToS3(t_processedTransactions);
+  if (m_txnArchive) {
+    ArchivedTxns archivedTxns;
+    PutTxnsInTempDataBase(t_processedTransactions, &archivedTxns);
+    ArchiveTxns(move(archivedTxns));
+  } else {
+    PutTxnsInTempDataBase(t_processedTransactions);
   }
 
+  static auto& selectionTime = Metrics::GetInstance().GetHistogram(
+      "zilliqa_txn_selection_us", "role=\"leader\"");
+  selectionTime.Record(chrono::duration_cast<chrono::microseconds>(
+                           chrono::high_resolution_clock::now() - startTime)
+                           .count());
+
   if (LOG_PARAMETERS) {
     double elaspedTimeMs =
         std::chrono::duration<double, std::milli>(
@@ -473,10 +642,13 @@ bool Node::VerifyTxnsOrdering(const vector<TxnHash>& tranHashes,
   LOG_MARKER();
 
   {
-    lock_guard<mutex> g(m_mutexCreatedTransactions);
+    lock(m_mutexTakenTxns, m_mutexCreatedTransactions);
+    lock_guard<mutex> g(m_mutexTakenTxns, adopt_lock);
+    lock_guard<mutex> g2(m_mutexCreatedTransactions, adopt_lock);
 
     for (const auto& tranHash : tranHashes) {
-      if (!m_createdTxns.exist(tranHash)) {
+      Transaction t;
+      if (!FindCreatedTxn(tranHash, t)) {
         missingtranHashes.emplace_back(tranHash);
       }
     }
@@ -491,9 +663,12 @@ bool Node::VerifyTxnsOrdering(const vector<TxnHash>& tranHashes,
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Failed to Verify due to bad txn ordering");
 
+    lock(m_mutexTakenTxns, m_mutexCreatedTransactions);
+    lock_guard<mutex> g(m_mutexTakenTxns, adopt_lock);
+    lock_guard<mutex> g2(m_mutexCreatedTransactions, adopt_lock);
     for (const auto& th : m_expectedTranOrdering) {
       Transaction t;
-      if (m_createdTxns.get(th, t)) {
+      if (FindCreatedTxn(th, t)) {
         LOG_GENERAL(INFO, "Expected txn: "
                               << t.GetTranID() << " " << t.GetSenderAddr()
                               << " " << t.GetNonce() << " " << t.GetGasPrice());
@@ -501,7 +676,7 @@ bool Node::VerifyTxnsOrdering(const vector<TxnHash>& tranHashes,
     }
     for (const auto& th : tranHashes) {
       Transaction t;
-      if (m_createdTxns.get(th, t)) {
+      if (FindCreatedTxn(th, t)) {
         LOG_GENERAL(INFO, "Received txn: "
                               << t.GetTranID() << " " << t.GetSenderAddr()
                               << " " << t.GetNonce() << " " << t.GetGasPrice());
@@ -514,13 +689,87 @@ bool Node::VerifyTxnsOrdering(const vector<TxnHash>& tranHashes,
   return true;
 }
 
+void Node::ResolveMicroBlockTxnHashes(vector<uint32_t>& missingTxnIndices) {
+  missingTxnIndices.clear();
+  if (m_microblockCompactTxnHashes.IsEmpty()) {
+    return;
+  }
+
+  static auto& resolveTime =
+      Metrics::GetInstance().GetHistogram("zilliqa_compact_txn_resolve_us");
+  Metrics::ScopedTimer timer(resolveTime);
+
+  CompactTxnHashesResolver resolver(m_microblockCompactTxnHashes);
+  {
+    lock(m_mutexTakenTxns, m_mutexCreatedTransactions);
+    lock_guard<mutex> g(m_mutexTakenTxns, adopt_lock);
+    lock_guard<mutex> g2(m_mutexCreatedTransactions, adopt_lock);
+    for (const auto& txn : m_createdTxns.HashIndex) {
+      resolver.Offer(txn.first);
+    }
+    if (m_createdTxnsTaken) {
+      for (const auto& txn : t_createdTxns.HashIndex) {
+        resolver.Offer(txn.first);
+      }
+      for (const auto& txn : t_processedTransactions) {
+        resolver.Offer(txn.first);
+      }
+    }
+  }
+
+  vector<TxnHash> tranHashes;
+  resolver.Resolve(tranHashes, missingTxnIndices);
+  m_microblock->SetTranHashes(move(tranHashes));
+  m_microblockCompactTxnHashes = CompactTxnHashes();
+
+  static auto& resolved = Metrics::GetInstance().GetCounter(
+      "zilliqa_compact_txn_ids_total", "result=\"resolved\"");
+  static auto& missing = Metrics::GetInstance().GetCounter(
+      "zilliqa_compact_txn_ids_total", "result=\"missing\"");
+  resolved.Increment(m_microblock->GetTranHashes().size() -
+                     missingTxnIndices.size());
+  missing.Increment(missingTxnIndices.size());
+
+  LOG_GENERAL(INFO, "Rebuilt txn list from short IDs, "
+                        << missingTxnIndices.size() << " of "
+                        << m_microblock->GetTranHashes().size()
+                        << " txns missing");
+}
+
+CompactTxnHashes Node::GetMicroBlockCompactTxnHashes() const {
+  if (!ENABLE_COMPACT_TXN_RELAY || m_microblock == nullptr ||
+      m_microblock->GetTranHashes().empty()) {
+    return CompactTxnHashes();
+  }
+
+  CompactTxnHashes compact(RandomGenerator::GetRandom<uint64_t>(),
+                           m_microblock->GetTranHashes());
+
+  const size_t fullSize = m_microblock->GetTranHashes().size() * TxnHash::size;
+  const size_t compactSize = compact.GetShortIds().size() + sizeof(uint64_t);
+  static auto& fullBytes = Metrics::GetInstance().GetCounter(
+      "zilliqa_compact_txn_relay_bytes_total", "list=\"full\"");
+  static auto& compactBytes = Metrics::GetInstance().GetCounter(
+      "zilliqa_compact_txn_relay_bytes_total", "list=\"compact\"");
+  fullBytes.Increment(fullSize);
+  compactBytes.Increment(compactSize);
+
+  LOG_GENERAL(INFO, "Txn list of " << m_microblock->GetTranHashes().size()
+                                   << " txns sent as " << compactSize
+                                   << " bytes of short IDs instead of "
+                                   << fullSize);
+  return compact;
+}
+
 void Node::UpdateProcessedTransactions() {
   LOG_MARKER();
 
+  lock_guard<mutex> takenLock(m_mutexTakenTxns);
   {
+    // Remaining txns join those admitted while the microblock was made
     lock_guard<mutex> g(m_mutexCreatedTransactions);
-    m_createdTxns = move(t_createdTxns);
-    t_createdTxns.clear();
+    m_createdTxns.merge(t_createdTxns);
+    m_createdTxnsTaken = false;
   }
   if (m_mediator.m_currentEpochNum % NUM_STORE_TX_BODIES_INTERVAL == 0) {
     BlockStorage::GetBlockStorage().ResetDB(
@@ -539,15 +788,25 @@ void Node::ProcessTransactionWhenShardBackup(
     const uint64_t& microblock_gas_limit) {
   LOG_MARKER();
 
+  lock_guard<mutex> takenLock(m_mutexTakenTxns);
+
+  if (ENABLE_LEADER_TXN_ORDER_REPLAY &&
+      m_mediator.m_ds->m_mode == DirectoryService::Mode::IDLE) {
+    if (ReplayLeaderTxnOrder(microblock_gas_limit)) {
+      return;
+    }
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Leader txn order incomplete, selecting txns locally");
+    AccountStore::GetInstance().InitTemp();
+  }
+
   auto startTime = std::chrono::high_resolution_clock::now();
 
   if (ENABLE_ACCOUNTS_POPULATING && UPDATE_PREGENED_ACCOUNTS) {
     UpdateBalanceForPreGeneratedAccounts();
   }
 
-  lock_guard<mutex> g(m_mutexCreatedTransactions);
-
-  t_createdTxns = m_createdTxns;
+  TakeCreatedTxns();
   m_expectedTranOrdering.clear();
   map<Address, map<uint64_t, Transaction>> t_addrNonceTxnMap;
   t_processedTransactions.clear();
@@ -558,15 +817,8 @@ void Node::ProcessTransactionWhenShardBackup(
                                << " NumTx=" << t_createdTxns.size());
   }
 
-  bool txnProcTimeout = false;
-
-  auto txnProcTimer = [this, &txnProcTimeout]() -> void {
-    NotifyTimeout(txnProcTimeout);
-  };
-
-  DetachedFunction(1, txnProcTimer);
-
-  this_thread::sleep_for(chrono::milliseconds(100));
+  const auto txnProcDeadline = GetTxnProcDeadline();
+  AccountStore::GetInstance().SetTxnProcessDeadline(txnProcDeadline);
 
   auto findOneFromAddrNonceTxnMap =
       [](Transaction& t,
@@ -603,7 +855,8 @@ void Node::ProcessTransactionWhenShardBackup(
   AccountStore::GetInstance().CleanStorageRootUpdateBufferTemp();
 
   while (m_gasUsedTotal < microblock_gas_limit) {
-    if (txnProcTimeout) {
+    if (chrono::steady_clock::now() >= txnProcDeadline) {
+      LOG_GENERAL(WARNING, "Txn processing timeout!");
       break;
     }
 
@@ -713,13 +966,18 @@ void Node::ProcessTransactionWhenShardBackup(
     }
   }
 
+  AccountStore::GetInstance().ClearTxnProcessDeadline();
   AccountStore::GetInstance().ProcessStorageRootUpdateBufferTemp();
   AccountStore::GetInstance().CleanNewLibrariesCacheTemp();
 
-  cv_TxnProcFinished.notify_all();
-
   PutTxnsInTempDataBase(t_processedTransactions);
 
+  static auto& selectionTime = Metrics::GetInstance().GetHistogram(
+      "zilliqa_txn_selection_us", "role=\"backup\"");
+  selectionTime.Record(chrono::duration_cast<chrono::microseconds>(
+                           chrono::high_resolution_clock::now() - startTime)
+                           .count());
+
   if (LOG_PARAMETERS) {
     double elaspedTimeMs =
         std::chrono::duration<double, std::milli>(
@@ -734,61 +992,216 @@ void Node::ProcessTransactionWhenShardBackup(
   ReinstateMemPool(t_addrNonceTxnMap, gasLimitExceededTxnBuffer, droppedTxns);
 }
 
-void Node::PutTxnsInTempDataBase(
-    const std::unordered_map<TxnHash, TransactionWithReceipt>&
-        processedTransactions) {
-  for (const auto& hashTxnPair : processedTransactions) {
-    bytes serializedTxn;
-    hashTxnPair.second.Serialize(serializedTxn, 0);
-    BlockStorage::GetBlockStorage().PutProcessedTxBodyTmp(hashTxnPair.first,
-                                                          serializedTxn);
+bool Node::TakeCreatedTxn(const TxnHash& txnHash, Transaction& t) {
+  if (t_createdTxns.take(txnHash, t)) {
+    return true;
   }
+  lock_guard<mutex> g(m_mutexCreatedTransactions);
+  return m_createdTxns.take(txnHash, t);
 }
 
-void Node::SaveTxnsToS3(
-    const std::unordered_map<TxnHash, TransactionWithReceipt>&
-        processedTransactions) {
-  ostringstream oss;
-  oss << "/tmp/txns_shard_" << m_myshardId << "_txblk_"
-      << m_mediator.m_currentEpochNum;
-  string txns_filename = oss.str();
-  ofstream txns_file(txns_filename, std::fstream::binary);
+bool Node::WaitForCreatedTxn(const TxnHash& txnHash, Transaction& t,
+                             const chrono::steady_clock::time_point& deadline) {
+  unique_lock<mutex> lock(m_mutexCVMicroBlockMissingTxn);
+  while (!TakeCreatedTxn(txnHash, t)) {
+    if (cv_MicroBlockMissingTxn.wait_until(lock, deadline) ==
+        cv_status::timeout) {
+      return TakeCreatedTxn(txnHash, t);
+    }
+  }
+  return true;
+}
 
-  for (const auto& hashTxnPair : processedTransactions) {
-    bytes serializedTxn;
-    hashTxnPair.second.Serialize(serializedTxn, 0);
+bool Node::ReplayLeaderTxnOrder(const uint64_t& microblock_gas_limit) {
+  LOG_MARKER();
 
-    // write HASH LEN and HASH
-    size_t size = hashTxnPair.first.size;
-    txns_file.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
-    txns_file.write(reinterpret_cast<const char*>(hashTxnPair.first.data()),
-                    size);
+  auto startTime = std::chrono::high_resolution_clock::now();
 
-    // write TXN LEN AND TXN
-    size = serializedTxn.size();
-    txns_file.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
-    txns_file.write(reinterpret_cast<const char*>(serializedTxn.data()), size);
+  if (ENABLE_ACCOUNTS_POPULATING && UPDATE_PREGENED_ACCOUNTS) {
+    UpdateBalanceForPreGeneratedAccounts();
   }
 
-  txns_file.close();
+  TakeCreatedTxns();
+  m_expectedTranOrdering.clear();
+  t_processedTransactions.clear();
+
+  // The leader starts selecting after the announcement delay, and gives up
+  // the order unless its first batch arrives soon after
+  const auto firstBatchDeadline =
+      chrono::steady_clock::now() +
+      chrono::milliseconds(TX_DISTRIBUTE_TIME_IN_MS +
+                           2 * ANNOUNCEMENT_DELAY_IN_MS);
+  const auto txnProcDeadline =
+      GetTxnProcDeadline() + chrono::milliseconds(TX_DISTRIBUTE_TIME_IN_MS +
+                                                  ANNOUNCEMENT_DELAY_IN_MS);
+  AccountStore::GetInstance().SetTxnProcessDeadline(txnProcDeadline);
 
-  // upload to S3
-  if (!SysCommand::ExecuteCmd(SysCommand::WITHOUT_OUTPUT,
-                              GetAwsS3CpString(txns_filename))) {
-    LOG_GENERAL(WARNING, "Failed to upload txns file :" << txns_filename);
-  } else {
-    LOG_GENERAL(DEBUG,
-                "upload txns file : " << txns_filename << " successfully");
+  m_gasUsedTotal = 0;
+  m_txnFees = 0;
+
+  vector<pair<TxnHash, TxnStatus>> droppedTxns;
+  // Every txn taken from the pool, to give back if the replay fails
+  vector<Transaction> takenTxns;
+
+  AccountStore::GetInstance().CleanStorageRootUpdateBufferTemp();
+
+  size_t next = 0;
+  bool complete = false;
+  bool failed = false;
+  while (!complete && !failed) {
+    vector<TxnHash> txnHashes;
+    if (!m_leaderTxnOrder.WaitForTxns(
+            m_mediator.m_currentEpochNum, next,
+            next == 0 ? firstBatchDeadline : txnProcDeadline, txnHashes,
+            complete)) {
+      LOG_GENERAL(WARNING, "Timeout waiting for the leader txn order after "
+                               << next << " txns");
+      failed = true;
+      break;
+    }
+    next += txnHashes.size();
+
+    // Fetch the txns this node lacks while executing those it has
+    vector<Transaction> txns(txnHashes.size());
+    vector<bool> found(txnHashes.size());
+    vector<TxnHash> missingTxnHashes;
+    for (unsigned int i = 0; i < txnHashes.size(); i++) {
+      found[i] = TakeCreatedTxn(txnHashes[i], txns[i]);
+      if (found[i]) {
+        takenTxns.emplace_back(txns[i]);
+      } else {
+        missingTxnHashes.emplace_back(txnHashes[i]);
+      }
+    }
+
+    auto fetchDeadline = txnProcDeadline;
+    if (!missingTxnHashes.empty()) {
+      bytes request = {MessageType::NODE, NodeInstructionType::GETMISSINGTXNS};
+      if (Messenger::SetNodeMissingTxnsErrorMsg(
+              request, MessageOffset::BODY, missingTxnHashes, {},
+              m_mediator.m_currentEpochNum,
+              m_mediator.m_selfPeer.m_listenPortHost)) {
+        lock_guard<mutex> g(m_mutexShardMember);
+        if (m_consensusLeaderID < m_myShardMembers->size()) {
+          P2PComm::GetInstance().SendMessage(
+              (*m_myShardMembers)[m_consensusLeaderID].second, request);
+        }
+      }
+
+      // A leader that does not answer soon is not worth waiting for, as
+      // local selection still needs the rest of the window
+      fetchDeadline = min(
+          fetchDeadline, chrono::steady_clock::now() +
+                             chrono::seconds(FETCHING_MISSING_DATA_TIMEOUT));
+    }
+
+    for (unsigned int i = 0; i < txns.size(); i++) {
+      if (!found[i]) {
+        if (!WaitForCreatedTxn(txnHashes[i], txns[i], fetchDeadline)) {
+          LOG_GENERAL(WARNING, "Timeout fetching txn " << txnHashes[i]);
+          failed = true;
+          break;
+        }
+        takenTxns.emplace_back(txns[i]);
+      }
+
+      const Transaction& t = txns[i];
+      TransactionReceipt tr;
+      TxnStatus error_code;
+      if (!m_mediator.m_validator->CheckCreatedTransaction(t, tr,
+                                                          error_code)) {
+        droppedTxns.emplace_back(t.GetTranID(), error_code);
+        continue;
+      }
+      if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
+                                   m_gasUsedTotal)) {
+        LOG_GENERAL(WARNING, "m_gasUsedTotal addition overflow!");
+        failed = true;
+        break;
+      }
+      uint128_t txnFee;
+      if (!SafeMath<uint128_t>::mul(tr.GetCumGas(), t.GetGasPrice(),
+                                    txnFee) ||
+          !SafeMath<uint128_t>::add(m_txnFees, txnFee, m_txnFees)) {
+        LOG_GENERAL(WARNING, "m_txnFees addition overflow!");
+        failed = true;
+        break;
+      }
+      m_expectedTranOrdering.emplace_back(t.GetTranID());
+      t_processedTransactions.insert(
+          make_pair(t.GetTranID(), TransactionWithReceipt(t, tr)));
+    }
   }
 
-  !SHARDLDR_SAVE_TXN_LOCALLY && std::remove(txns_filename.c_str());
+  AccountStore::GetInstance().ClearTxnProcessDeadline();
+
+  if (failed) {
+    // Local selection starts over from the pool, so give back every txn
+    // taken for the replay, including those already executed or dropped
+    MempoolInsertionStatus status;
+    for (const auto& t : takenTxns) {
+      t_createdTxns.insert(t, status);
+    }
+    t_processedTransactions.clear();
+    m_expectedTranOrdering.clear();
+    return false;
+  }
+
+  if (m_gasUsedTotal > microblock_gas_limit) {
+    LOG_GENERAL(WARNING, "Leader txn order uses " << m_gasUsedTotal
+                                                  << " gas, limit is "
+                                                  << microblock_gas_limit);
+  }
+
+  AccountStore::GetInstance().ProcessStorageRootUpdateBufferTemp();
+  AccountStore::GetInstance().CleanNewLibrariesCacheTemp();
+
+  PutTxnsInTempDataBase(t_processedTransactions);
+
+  static auto& selectionTime = Metrics::GetInstance().GetHistogram(
+      "zilliqa_txn_selection_us", "role=\"replay\"");
+  selectionTime.Record(chrono::duration_cast<chrono::microseconds>(
+                           chrono::high_resolution_clock::now() - startTime)
+                           .count());
+
+  if (LOG_PARAMETERS) {
+    double elaspedTimeMs =
+        std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - startTime)
+            .count();
+    LOG_STATE("[TXNPROC-END][" << m_mediator.m_currentEpochNum
+                               << "] Shard=" << m_myshardId
+                               << " NumTx=" << t_processedTransactions.size()
+                               << " Time=" << elaspedTimeMs);
+  }
+
+  ReinstateMemPool({}, {}, droppedTxns);
+  return true;
 }
 
-std::string Node::GetAwsS3CpString(const std::string& uploadFilePath) {
-  std::ostringstream ossS3Cmd;
-  ossS3Cmd << "aws s3 cp " << uploadFilePath << " s3://" << BUCKET_NAME << "/"
-           << TXN_PERSISTENCE_NAME << "/";
-  return ossS3Cmd.str();
+void Node::PutTxnsInTempDataBase(
+    const std::unordered_map<TxnHash, TransactionWithReceipt>&
+        processedTransactions,
+    ArchivedTxns* archivedTxns) {
+  if (archivedTxns != nullptr) {
+    archivedTxns->reserve(processedTransactions.size());
+  }
+  for (const auto& hashTxnPair : processedTransactions) {
+    bytes serializedTxn;
+    hashTxnPair.second.Serialize(serializedTxn, 0);
+    BlockStorage::GetBlockStorage().PutProcessedTxBodyTmp(hashTxnPair.first,
+                                                          serializedTxn);
+    if (archivedTxns != nullptr) {
+      archivedTxns->emplace_back(hashTxnPair.first, move(serializedTxn));
+    }
+  }
+}
+
+void Node::ArchiveTxns(ArchivedTxns&& archivedTxns) {
+  ostringstream oss;
+  oss << "txns_shard_" << m_myshardId << "_txblk_"
+      << m_mediator.m_currentEpochNum;
+  m_txnArchive->Archive(oss.str(), move(archivedTxns));
 }
 
 void Node::ReinstateMemPool(
@@ -994,7 +1407,7 @@ bool Node::RunConsensusOnMicroBlockWhenShardLeader() {
              bytes& messageToCosign) mutable -> bool {
     return Messenger::SetNodeMicroBlockAnnouncement(
         dst, offset, consensusID, blockNumber, blockHash, leaderID, leaderKey,
-        *m_microblock, messageToCosign);
+        *m_microblock, GetMicroBlockCompactTxnHashes(), messageToCosign);
   };
 
   LOG_STATE(
@@ -1028,7 +1441,11 @@ bool Node::RunConsensusOnMicroBlockWhenShardBackup() {
                 .GetDSDifficulty() >= TXN_DS_TARGET_DIFFICULTY) ||
        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
            TXN_DS_TARGET_NUM)) {
-    std::this_thread::sleep_for(chrono::milliseconds(TX_DISTRIBUTE_TIME_IN_MS));
+    // The leader txn order is waited for as it is streamed
+    if (!ENABLE_LEADER_TXN_ORDER_REPLAY) {
+      std::this_thread::sleep_for(
+          chrono::milliseconds(TX_DISTRIBUTE_TIME_IN_MS));
+    }
     ProcessTransactionWhenShardBackup(SHARD_MICROBLOCK_GAS_LIMIT);
   }
 
@@ -1204,7 +1621,8 @@ bool Node::CheckMicroBlockTimestamp() {
                          CONSENSUS_OBJECT_TIMEOUT);
 }
 
-unsigned char Node::CheckLegitimacyOfTxnHashes(bytes& errorMsg) {
+unsigned char Node::CheckLegitimacyOfTxnHashes(
+    bytes& errorMsg, const vector<uint32_t>& missingTxnIndices) {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
                 "Node::CheckLegitimacyOfTxnHashes not expected to be "
@@ -1221,14 +1639,17 @@ unsigned char Node::CheckLegitimacyOfTxnHashes(bytes& errorMsg) {
        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
            TXN_DS_TARGET_NUM)) {
     vector<TxnHash> missingTxnHashes;
-    if (!VerifyTxnsOrdering(m_microblock->GetTranHashes(), missingTxnHashes)) {
+    // The order cannot be checked until the txn list is complete
+    if (missingTxnIndices.empty() &&
+        !VerifyTxnsOrdering(m_microblock->GetTranHashes(), missingTxnHashes)) {
       LOG_GENERAL(WARNING, "The leader may have composed wrong order");
       return LEGITIMACYRESULT::WRONGORDER;
     }
 
-    if (missingTxnHashes.size() > 0) {
+    if (missingTxnHashes.size() > 0 || !missingTxnIndices.empty()) {
       if (!Messenger::SetNodeMissingTxnsErrorMsg(
-              errorMsg, 0, missingTxnHashes, m_mediator.m_currentEpochNum,
+              errorMsg, 0, missingTxnHashes, missingTxnIndices,
+              m_mediator.m_currentEpochNum,
               m_mediator.m_selfPeer.m_listenPortHost)) {
         LOG_GENERAL(WARNING, "Messenger::SetNodeMissingTxnsErrorMsg failed");
         return false;
@@ -1297,6 +1718,9 @@ bool Node::CheckMicroBlockHashes(bytes& errorMsg) {
     return true;
   }
 
+  vector<uint32_t> missingTxnIndices;
+  ResolveMicroBlockTxnHashes(missingTxnIndices);
+
   // Check transaction hashes (number of hashes must be = Tx count field)
   uint32_t txhashessize = m_microblock->GetTranHashes().size();
   uint32_t numtxs = m_microblock->GetHeader().GetNumTxs();
@@ -1312,7 +1736,7 @@ bool Node::CheckMicroBlockHashes(bytes& errorMsg) {
 
   LOG_GENERAL(INFO, "Hash count check passed");
 
-  switch (CheckLegitimacyOfTxnHashes(errorMsg)) {
+  switch (CheckLegitimacyOfTxnHashes(errorMsg, missingTxnIndices)) {
     case LEGITIMACYRESULT::SUCCESS:
       break;
     case LEGITIMACYRESULT::MISSEDTXN:
@@ -1492,7 +1916,8 @@ bool Node::MicroBlockValidator(const bytes& message, unsigned int offset,
 
   if (!Messenger::GetNodeMicroBlockAnnouncement(
           message, offset, consensusID, blockNumber, blockHash, leaderID,
-          leaderKey, *m_microblock, messageToCosign)) {
+          leaderKey, *m_microblock, m_microblockCompactTxnHashes,
+          messageToCosign)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::GetNodeMicroBlockAnnouncement failed");
     return false;
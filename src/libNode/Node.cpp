@@ -17,8 +17,11 @@
 
 #include <arpa/inet.h>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
 #include <thread>
 #include <tuple>
 
@@ -50,6 +53,7 @@
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
 #include "libUtils/SanityChecks.h"
+#include "libUtils/Scheduler.h"
 #include "libUtils/TimeLockedFunction.h"
 #include "libUtils/TimeUtils.h"
 #include "libValidator/Validator.h"
@@ -63,6 +67,50 @@ const unsigned int MIN_CHILD_CLUSTER_SIZE = 2;
 
 #define IP_MAPPING_FILE_NAME "ipMapping.xml"
 
+namespace {
+// Tx blocks handed to one CheckIntegrity worker at a time
+const uint64_t INTEGRITY_CHUNK_SIZE = 1000;
+const chrono::seconds INTEGRITY_PROGRESS_INTERVAL{10};
+// Written by the validateDB binary so an interrupted run can resume
+const string INTEGRITY_CHECKPOINT_FILE = "validateDB.checkpoint";
+
+/// Returns the first Tx block still to be checked: one past the checkpoint if
+/// the checkpointed block is still in the DB with the same hash, else 0
+uint64_t LoadIntegrityCheckpoint(const uint64_t latestTxBlockNum) {
+  ifstream in(INTEGRITY_CHECKPOINT_FILE);
+  uint64_t blockNum = 0;
+  string hashStr;
+  if (!(in >> blockNum >> hashStr)) {
+    return 0;
+  }
+
+  TxBlockSharedPtr txBlock;
+  if (blockNum > latestTxBlockNum ||
+      !BlockStorage::GetBlockStorage().GetTxBlock(blockNum, txBlock) ||
+      txBlock->GetHeader().GetMyHash().hex() != hashStr) {
+    LOG_GENERAL(WARNING, "Ignoring stale checkpoint at Tx block " << blockNum);
+    return 0;
+  }
+
+  return blockNum + 1;
+}
+
+void SaveIntegrityCheckpoint(const uint64_t blockNum, const BlockHash& hash) {
+  const string tmpFile = INTEGRITY_CHECKPOINT_FILE + ".tmp";
+  {
+    ofstream out(tmpFile, ios::trunc);
+    out << blockNum << " " << hash.hex() << endl;
+    if (!out) {
+      LOG_GENERAL(WARNING, "Failed to write " << tmpFile);
+      return;
+    }
+  }
+  if (rename(tmpFile.c_str(), INTEGRITY_CHECKPOINT_FILE.c_str()) != 0) {
+    LOG_GENERAL(WARNING, "Failed to update " << INTEGRITY_CHECKPOINT_FILE);
+  }
+}
+}  // namespace
+
 void Node::PopulateAccounts(bool temp) {
   if (!ENABLE_ACCOUNTS_POPULATING) {
     LOG_GENERAL(INFO, "Accounts Pregen is not enabled");
@@ -145,7 +193,15 @@ void Node::AddBalanceToGenesisAccount() {
 
 Node::Node(Mediator& mediator, [[gnu::unused]] unsigned int syncType,
            [[gnu::unused]] bool toRetrieveHistory)
-    : m_mediator(mediator) {}
+    : m_mediator(mediator) {
+  if (ENABLE_TXNS_BACKUP) {
+    auto backend = TxnArchive::CreateBackendFromConstants();
+    if (backend) {
+      m_txnArchive =
+          make_unique<TxnArchive>(move(backend), TXN_ARCHIVE_QUEUE_SIZE);
+    }
+  }
+}
 
 Node::~Node() {}
 
@@ -286,14 +342,17 @@ bool Node::CheckIntegrity(const bool fromValidateDBBinary) {
   };
 
   // Retrieve the latest Tx block from storage
-  // If using validateDB binary, we use GetLatestTxBlock
+  // If using validateDB binary, we look it up from the DB
   // If using within zilliqa process, we need to avoid keeping the lock on
   // txBlocks DB
   TxBlock latestTxBlock;
   if (fromValidateDBBinary) {
+    uint64_t latestNum = 0;
     TxBlockSharedPtr latestTxBlockPtr;
-    if (!BlockStorage::GetBlockStorage().GetLatestTxBlock(latestTxBlockPtr)) {
-      LOG_GENERAL(WARNING, "BlockStorage::GetLatestTxBlock failed");
+    if (!BlockStorage::GetBlockStorage().GetLatestTxBlockNum(latestNum) ||
+        !BlockStorage::GetBlockStorage().GetTxBlock(latestNum,
+                                                    latestTxBlockPtr)) {
+      LOG_GENERAL(WARNING, "BlockStorage::GetLatestTxBlockNum failed");
       return false;
     }
     latestTxBlock = *latestTxBlockPtr;
@@ -301,20 +360,6 @@ bool Node::CheckIntegrity(const bool fromValidateDBBinary) {
     latestTxBlock = m_mediator.m_txBlockChain.GetLastBlock();
   }
 
-  const uint64_t& latestTxBlockNum = latestTxBlock.GetHeader().GetBlockNum();
-  const uint64_t& latestDSIndex = latestTxBlock.GetHeader().GetDSBlockNum();
-
-  if (fromValidateDBBinary) {
-    cout << "[" << getTime() << "] Latest Tx block = " << latestTxBlockNum
-         << endl;
-    cout << "[" << getTime() << "] Latest DS block = " << latestDSIndex << endl;
-    cout << "[" << getTime() << "] Loading dir blocks" << endl;
-  } else {
-    LOG_GENERAL(INFO, "Latest Tx block = " << latestTxBlockNum);
-    LOG_GENERAL(INFO, "Latest DS block = " << latestDSIndex);
-    LOG_GENERAL(INFO, "Loading dir blocks");
-  }
-
   // Load all dir blocks (until latestTxBlockNum) from blocklink chain
   std::list<BlockLink> blocklinks;
 
@@ -330,6 +375,31 @@ bool Node::CheckIntegrity(const bool fromValidateDBBinary) {
       return std::get<BlockLinkIndex::INDEX>(a) <
              std::get<BlockLinkIndex::INDEX>(b);
     });
+
+    // The lookup above stops at the first gap in the Tx chain. If there are DS
+    // blocks beyond that point, Tx blocks exist past the gap too, so fall back
+    // to the full scan and let the checks below report the missing ones.
+    uint64_t latestDSIndexInLinks = 0;
+    for (const auto& blocklink : blocklinks) {
+      if (get<BlockLinkIndex::BLOCKTYPE>(blocklink) == BlockType::DS) {
+        latestDSIndexInLinks = max<uint64_t>(
+            latestDSIndexInLinks, get<BlockLinkIndex::DSINDEX>(blocklink));
+      }
+    }
+    if (latestDSIndexInLinks > latestTxBlock.GetHeader().GetDSBlockNum() + 1) {
+      LOG_GENERAL(WARNING, "Latest DS block "
+                               << latestDSIndexInLinks
+                               << " is ahead of Tx block "
+                               << latestTxBlock.GetHeader().GetBlockNum()
+                               << ", scanning the Tx block DB");
+      TxBlockSharedPtr latestTxBlockPtr;
+      if (!BlockStorage::GetBlockStorage().GetLatestTxBlock(
+              latestTxBlockPtr)) {
+        LOG_GENERAL(WARNING, "BlockStorage::GetLatestTxBlock failed");
+        return false;
+      }
+      latestTxBlock = *latestTxBlockPtr;
+    }
   } else {
     // Get the blocklink size from m_blocklinkchain since we can't get it from
     // the database
@@ -348,6 +418,20 @@ bool Node::CheckIntegrity(const bool fromValidateDBBinary) {
     }
   }
 
+  const uint64_t latestTxBlockNum = latestTxBlock.GetHeader().GetBlockNum();
+  const uint64_t latestDSIndex = latestTxBlock.GetHeader().GetDSBlockNum();
+
+  if (fromValidateDBBinary) {
+    cout << "[" << getTime() << "] Latest Tx block = " << latestTxBlockNum
+         << endl;
+    cout << "[" << getTime() << "] Latest DS block = " << latestDSIndex << endl;
+    cout << "[" << getTime() << "] Loading dir blocks" << endl;
+  } else {
+    LOG_GENERAL(INFO, "Latest Tx block = " << latestTxBlockNum);
+    LOG_GENERAL(INFO, "Latest DS block = " << latestDSIndex);
+    LOG_GENERAL(INFO, "Loading dir blocks");
+  }
+
   bool firstMinerInfoFound = false;
 
   // Load the stored data blocks based on the dir blocks
@@ -479,126 +563,219 @@ bool Node::CheckIntegrity(const bool fromValidateDBBinary) {
     return false;
   }
 
-  // Check the other Tx blocks
-  shared_ptr<bool> result = make_shared<bool>(new bool(true));
-
-  // This lambda performs all the checks on one Tx block
-  auto validateOneTxBlock =
-      [&, result, fromValidateDBBinary](uint64_t blockNum) mutable -> void {
-    // Abort checking if overall result is false already
-    if (!*result && !fromValidateDBBinary) {
-      return;
-    }
-    if (blockNum % 1000 == 0) {
-      if (fromValidateDBBinary) {
-        cout << "[" << getTime() << "] On Tx block " << blockNum << endl;
-      } else {
-        LOG_GENERAL(INFO, "On Tx block " << blockNum);
-      }
+  // Check the other Tx blocks. The latest block's cosignature anchors the
+  // chain, so every other block only needs its prevHash link and its
+  // microblocks checked. Blocks are handed out in fixed-size chunks; each chunk
+  // is read in order keeping only the previous block, so memory use does not
+  // grow with the chain.
+  uint64_t startBlockNum = 0;
+  if (fromValidateDBBinary) {
+    startBlockNum = LoadIntegrityCheckpoint(latestTxBlockNum);
+    if (startBlockNum > 0) {
+      cout << "[" << getTime() << "] Resuming from Tx block " << startBlockNum
+           << endl;
     }
+  }
 
-    // Fetch the block
-    TxBlockSharedPtr txBlock;
-    if (!BlockStorage::GetBlockStorage().GetTxBlock(blockNum, txBlock)) {
-      LOG_GENERAL(WARNING, "Missing FB: " << blockNum);
-      *result = false;
-      return;
-    }
+  const uint64_t numBlocks = latestTxBlockNum + 1 - startBlockNum;
+  const uint64_t numChunks =
+      (numBlocks + INTEGRITY_CHUNK_SIZE - 1) / INTEGRITY_CHUNK_SIZE;
 
-    // Check that prevHash field == hash of previous Tx block
-    if (blockNum > 0) {
+  atomic<bool> result{true};
+  atomic<uint64_t> nextChunk{0};
+  atomic<uint64_t> checkedBlocks{0};
+
+  // Checks blocks [begin, end) and returns the hash of the last one
+  auto validateTxBlockRange = [&](const uint64_t begin, const uint64_t end,
+                                  BlockHash& lastHash) -> bool {
+    bool ok = true;
+    bool havePrev = false;
+    BlockHash prevBlockHash;
+
+    if (begin > 0) {
       TxBlockSharedPtr txBlockPrev;
-      if (!BlockStorage::GetBlockStorage().GetTxBlock(blockNum - 1,
-                                                      txBlockPrev)) {
-        LOG_GENERAL(WARNING, "Missing FB: " << blockNum - 1);
-        *result = false;
-        return;
-      }
-      const BlockHash& prevHash = txBlock->GetHeader().GetPrevHash();
-      const BlockHash& prevBlockHash = txBlockPrev->GetHeader().GetMyHash();
-      if (prevHash != prevBlockHash) {
-        LOG_CHECK_FAIL("Prev hash for block " << blockNum, prevHash,
-                       prevBlockHash);
-        *result = false;
-        return;
+      if (BlockStorage::GetBlockStorage().GetTxBlock(begin - 1, txBlockPrev)) {
+        prevBlockHash = txBlockPrev->GetHeader().GetMyHash();
+        havePrev = true;
       }
     }
 
-    // Check the microblocks
-    const auto& microblockInfos = txBlock->GetMicroBlockInfos();
-    for (const auto& mbInfo : microblockInfos) {
-      MicroBlockSharedPtr mbptr;
-      // Skip because empty microblocks are not stored
-      if (mbInfo.m_txnRootHash == TxnHash()) {
+    for (uint64_t blockNum = begin; blockNum < end; blockNum++) {
+      // Abort checking if overall result is false already
+      if (!result && !fromValidateDBBinary) {
+        return false;
+      }
+      checkedBlocks++;
+
+      // Fetch the block
+      TxBlockSharedPtr txBlock;
+      if (!BlockStorage::GetBlockStorage().GetTxBlock(blockNum, txBlock)) {
+        LOG_GENERAL(WARNING, "Missing FB: " << blockNum);
+        ok = false;
+        havePrev = false;
         continue;
       }
-      if (BlockStorage::GetBlockStorage().GetMicroBlock(mbInfo.m_microBlockHash,
-                                                        mbptr)) {
-        if (find(VERIFIER_EXCLUSION_LIST.begin(), VERIFIER_EXCLUSION_LIST.end(),
-                 make_pair(blockNum, mbInfo.m_shardId)) !=
-            VERIFIER_EXCLUSION_LIST.end()) {
+
+      // Check that prevHash field == hash of previous Tx block
+      if (blockNum > 0) {
+        const BlockHash& prevHash = txBlock->GetHeader().GetPrevHash();
+        if (!havePrev) {
+          LOG_GENERAL(WARNING, "Missing FB: " << blockNum - 1);
+          ok = false;
+        } else if (prevHash != prevBlockHash) {
+          LOG_CHECK_FAIL("Prev hash for block " << blockNum, prevHash,
+                         prevBlockHash);
+          ok = false;
+        }
+      }
+      prevBlockHash = txBlock->GetHeader().GetMyHash();
+      havePrev = true;
+
+      // Check the microblocks
+      const auto& microblockInfos = txBlock->GetMicroBlockInfos();
+      for (const auto& mbInfo : microblockInfos) {
+        MicroBlockSharedPtr mbptr;
+        // Skip because empty microblocks are not stored
+        if (mbInfo.m_txnRootHash == TxnHash()) {
           continue;
         }
-        // Check the transactions
-        const auto& tranHashes = mbptr->GetTranHashes();
-        for (const auto& tranHash : tranHashes) {
-          TxBodySharedPtr tx;
-          if (!BlockStorage::GetBlockStorage().CheckTxBody(tranHash)) {
-            LOG_GENERAL(WARNING, "FB: " << blockNum
-                                        << " MB: " << mbInfo.m_shardId
-                                        << " Missing Tx: " << tranHash);
-            *result = false;
+        if (BlockStorage::GetBlockStorage().GetMicroBlock(
+                mbInfo.m_microBlockHash, mbptr)) {
+          if (find(VERIFIER_EXCLUSION_LIST.begin(),
+                   VERIFIER_EXCLUSION_LIST.end(),
+                   make_pair(blockNum, mbInfo.m_shardId)) !=
+              VERIFIER_EXCLUSION_LIST.end()) {
+            continue;
           }
+          // Check the transactions
+          const auto& tranHashes = mbptr->GetTranHashes();
+          for (const auto& tranHash : tranHashes) {
+            if (!BlockStorage::GetBlockStorage().CheckTxBody(tranHash)) {
+              LOG_GENERAL(WARNING, "FB: " << blockNum
+                                          << " MB: " << mbInfo.m_shardId
+                                          << " Missing Tx: " << tranHash);
+              ok = false;
+            }
+          }
+        } else {
+          LOG_GENERAL(WARNING, "FB: " << blockNum << " Missing MB: "
+                                      << mbInfo.m_microBlockHash);
+          ok = false;
         }
-      } else {
-        LOG_GENERAL(WARNING, "FB: " << blockNum << " Missing MB: "
-                                    << mbInfo.m_microBlockHash);
-        *result = false;
       }
     }
+
+    lastHash = prevBlockHash;
+    return ok;
   };
 
-  // If using validateDB binary, we use a thread pool to get fast results
+  const auto startTime = r_timer_start();
+  auto reportProgress = [&]() {
+    const uint64_t done = checkedBlocks;
+    const double elapsed = r_timer_end(startTime) / 1000000;
+    const double rate = elapsed > 0 ? done / elapsed : 0;
+    const uint64_t eta = rate > 0 ? (numBlocks - done) / rate : 0;
+    ostringstream oss;
+    oss << "On Tx block " << startBlockNum + done << "/" << latestTxBlockNum
+        << " (" << static_cast<uint64_t>(rate) << " blocks/s, ETA " << eta
+        << "s)";
+    if (fromValidateDBBinary) {
+      cout << "[" << getTime() << "] " << oss.str() << endl;
+    } else {
+      LOG_GENERAL(INFO, oss.str());
+    }
+  };
+
+  // Chunks finish out of order; the checkpoint only moves over the contiguous
+  // run of chunks that passed, so a resumed run never skips a failed one
+  mutex chunkMutex;
+  condition_variable chunkCv;
+  vector<bool> chunkPassed(numChunks, false);
+  vector<BlockHash> chunkLastHash(numChunks);
+  uint64_t chunksDone = 0;
+  uint64_t checkpointChunk = 0;
+
+  auto worker = [&]() {
+    while (result || fromValidateDBBinary) {
+      const uint64_t chunk = nextChunk++;
+      if (chunk >= numChunks) {
+        return;
+      }
+      const uint64_t begin = startBlockNum + chunk * INTEGRITY_CHUNK_SIZE;
+      const uint64_t end =
+          min(begin + INTEGRITY_CHUNK_SIZE, latestTxBlockNum + 1);
+
+      BlockHash lastHash;
+      const bool ok = validateTxBlockRange(begin, end, lastHash);
+      if (!ok) {
+        result = false;
+      }
+
+      {
+        lock_guard<mutex> g(chunkMutex);
+        chunkPassed[chunk] = ok;
+        chunkLastHash[chunk] = lastHash;
+        chunksDone++;
+
+        if (fromValidateDBBinary) {
+          const uint64_t prevCheckpointChunk = checkpointChunk;
+          while (checkpointChunk < numChunks && chunkPassed[checkpointChunk]) {
+            checkpointChunk++;
+          }
+          if (checkpointChunk != prevCheckpointChunk) {
+            SaveIntegrityCheckpoint(
+                min(startBlockNum + checkpointChunk * INTEGRITY_CHUNK_SIZE,
+                    latestTxBlockNum + 1) -
+                    1,
+                chunkLastHash[checkpointChunk - 1]);
+          }
+        }
+      }
+      chunkCv.notify_one();
+
+      if (!fromValidateDBBinary) {
+        reportProgress();
+      }
+    }
+  };
+
+  // If using validateDB binary, we use all cores to get fast results
   // If using within zilliqa process, we do block validation sequentially to
   // control resource consumption
-  uint64_t blockNum = 0;
   if (fromValidateDBBinary) {
-    const unsigned int NUMTHREADS = 10;
-    const int MAXJOBSLEFT = NUMTHREADS * 3;
-    ThreadPool validatePool(NUMTHREADS, "ValidatePool");
-
-    while (blockNum <= latestTxBlockNum) {
-      validatePool.AddJob([validateOneTxBlock, blockNum]() mutable -> void {
-        validateOneTxBlock(blockNum);
-      });
+    const unsigned int numThreads =
+        max(1U, min<unsigned int>(thread::hardware_concurrency(), numChunks));
+    vector<thread> workers;
+    for (unsigned int i = 0; i < numThreads; i++) {
+      workers.emplace_back(worker);
+    }
 
-      while (validatePool.GetJobsLeft() > MAXJOBSLEFT) {
+    {
+      unique_lock<mutex> lock(chunkMutex);
+      while (!chunkCv.wait_for(lock, INTEGRITY_PROGRESS_INTERVAL,
+                               [&]() { return chunksDone == numChunks; })) {
+        lock.unlock();
+        reportProgress();
+        lock.lock();
       }
-
-      blockNum++;
     }
 
-    while (validatePool.GetJobsLeft() > 0) {
-      std::this_thread::sleep_for(std::chrono::seconds(1));
+    for (auto& t : workers) {
+      t.join();
     }
 
+    reportProgress();
     cout << "[" << getTime() << "] Done" << endl;
   } else {
-    while (blockNum <= latestTxBlockNum) {
-      validateOneTxBlock(blockNum);
-      if (!*result) {
-        break;
-      }
-      blockNum++;
-    }
+    worker();
     LOG_GENERAL(INFO, "Done");
   }
 
   // Set validation state for StatusServer
   m_mediator.m_validateState =
-      *result ? ValidateState::DONE : ValidateState::ERROR;
+      result ? ValidateState::DONE : ValidateState::ERROR;
 
-  return *result;
+  return result;
 }
 
 void Node::ClearUnconfirmedTxn() {
@@ -1322,17 +1499,18 @@ void Node::WakeupAtDSEpoch() {
       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty();
   SetState(POW_SUBMISSION);
 
+  LOG_GENERAL(INFO, "Shard node, wait "
+                        << SHARD_DELAY_WAKEUP_IN_SECONDS -
+                               WAIT_LOOKUP_WAKEUP_IN_SECONDS
+                        << " more seconds for lookup and DS nodes wakeup...");
   auto func = [this, block_num, dsDifficulty, difficulty]() mutable -> void {
-    LOG_GENERAL(INFO, "Shard node, wait "
-                          << SHARD_DELAY_WAKEUP_IN_SECONDS -
-                                 WAIT_LOOKUP_WAKEUP_IN_SECONDS
-                          << " more seconds for lookup and DS nodes wakeup...");
-    this_thread::sleep_for(chrono::seconds(SHARD_DELAY_WAKEUP_IN_SECONDS -
-                                           WAIT_LOOKUP_WAKEUP_IN_SECONDS));
     StartPoW(block_num, dsDifficulty, difficulty, m_mediator.m_dsBlockRand,
              m_mediator.m_txBlockRand);
   };
-  DetachedFunction(1, func);
+  // Mining runs for the whole PoW window, so it gets its own thread
+  Scheduler::GetInstance().ScheduleAfter(
+      [func]() mutable { DetachedFunction(1, func); },
+      (SHARD_DELAY_WAKEUP_IN_SECONDS - WAIT_LOOKUP_WAKEUP_IN_SECONDS) * 1000);
 }
 
 void Node::WakeupAtTxEpoch() {
@@ -1635,12 +1813,18 @@ bool Node::ProcessSubmitMissingTxn(const bytes& message, unsigned int offset,
     return false;
   }
 
-  lock_guard<mutex> g(m_mutexCreatedTransactions);
-  for (const auto& submittedTxn : txns) {
-    MempoolInsertionStatus status;
-    m_createdTxns.insert(submittedTxn, status);
+  {
+    lock_guard<mutex> g(m_mutexCreatedTransactions);
+    for (const auto& submittedTxn : txns) {
+      MempoolInsertionStatus status;
+      m_createdTxns.insert(submittedTxn, status);
+    }
   }
 
+  {
+    // So that a waiter between its check and its wait is not missed
+    lock_guard<mutex> g(m_mutexCVMicroBlockMissingTxn);
+  }
   cv_MicroBlockMissingTxn.notify_all();
   return true;
 }
@@ -2164,7 +2348,11 @@ uint16_t Node::GetConsensusLeaderID() const {
 }
 
 void Node::AddBlock(const TxBlock& block) {
-  m_mediator.m_txBlockChain.AddBlock(block);
+  if (m_mediator.m_txBlockChain.AddBlock(block) == 1 && !LOOKUP_NODE_MODE) {
+    m_mediator.m_ds->m_gasPriceTracker.AddTxBlock(
+        block.GetHeader().GetBlockNum(), block.GetHeader().GetGasUsed(),
+        block.GetHeader().GetGasLimit());
+  }
 }
 
 void Node::RejoinAsNormal() {
@@ -2303,10 +2491,13 @@ void Node::SetMyshardId(uint32_t shardId) {
 
 void Node::CleanCreatedTransaction() {
   LOG_MARKER();
+  // Waits for a running txn selection to hand the taken txns back
+  std::lock_guard<mutex> takenLock(m_mutexTakenTxns);
   {
     std::lock_guard<mutex> g(m_mutexCreatedTransactions);
     m_createdTxns.clear();
     t_createdTxns.clear();
+    m_createdTxnsTaken = false;
   }
   {
     std::lock_guard<mutex> g(m_mutexTxnPacketBuffer);
@@ -3006,7 +3197,9 @@ bool Node::Execute(const bytes& message, unsigned int offset,
                                        &Node::ProcessRemoveNodeFromBlacklist,
                                        &Node::ProcessPendingTxn,
                                        &Node::ProcessVCFinalBlock,
-                                       &Node::ProcessNewShardNodeNetworkInfo};
+                                       &Node::ProcessNewShardNodeNetworkInfo,
+                                       &Node::ProcessTxnOrder,
+                                       &Node::ProcessGetMissingTxns};
 
   const unsigned char ins_byte = message.at(offset);
   const unsigned int ins_handlers_count =
@@ -17,6 +17,7 @@
 #ifndef ZILLIQA_SRC_LIBNODE_NODE_H_
 #define ZILLIQA_SRC_LIBNODE_NODE_H_
 
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <list>
@@ -26,6 +27,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "LeaderTxnOrder.h"
 #include "common/Constants.h"
 #include "common/Executable.h"
 #include "common/TxnStatus.h"
@@ -40,6 +42,7 @@
 #include "libNetwork/DataSender.h"
 #include "libNetwork/P2PComm.h"
 #include "libPersistence/BlockStorage.h"
+#include "libPersistence/TxnArchive.h"
 
 class Mediator;
 class Retriever;
@@ -142,7 +145,17 @@ class Node : public Executable {
 
   // Transactions information
   std::mutex m_mutexCreatedTransactions;
+  // New txns are admitted to m_createdTxns while the txns taken into
+  // t_createdTxns are selected for the microblock
   TxnPool m_createdTxns, t_createdTxns;
+  bool m_createdTxnsTaken = false;
+  // Held by txn selection for as long as it works on t_createdTxns and
+  // t_processedTransactions, and by anyone else reading or resetting them.
+  // Always taken before m_mutexCreatedTransactions
+  std::mutex m_mutexTakenTxns;
+
+  // Txn order streamed by the shard leader, replayed by the backups
+  LeaderTxnOrder m_leaderTxnOrder;
 
   std::vector<TxnHash> m_expectedTranOrdering;
   std::mutex m_mutexProcessedTransactions;
@@ -180,10 +193,6 @@ class Node : public Executable {
   std::mutex m_mutexTxnPacketBuffer;
   std::map<bytes, bytes> m_txnPacketBuffer;
 
-  // txn proc timeout related
-  std::mutex m_mutexCVTxnProcFinished;
-  std::condition_variable cv_TxnProcFinished;
-
   std::mutex m_mutexMicroBlockConsensusBuffer;
   std::unordered_map<uint32_t, VectorOfNodeMsg> m_microBlockConsensusBuffer;
 
@@ -312,6 +321,11 @@ class Node : public Executable {
   bool ProcessNewShardNodeNetworkInfo(const bytes& message, unsigned int offset,
                                       const Peer& from);
 
+  bool ProcessTxnOrder(const bytes& message, unsigned int offset,
+                       const Peer& from);
+  bool ProcessGetMissingTxns(const bytes& message, unsigned int offset,
+                             const Peer& from);
+
   // bool ProcessCreateAccounts(const bytes & message,
   // unsigned int offset, const Peer & from);
   bool ProcessVCDSBlocksMessage(const bytes& message, unsigned int cur_offset,
@@ -345,7 +359,8 @@ class Node : public Executable {
                            const uint64_t blockNumber, const bytes& blockHash,
                            const uint16_t leaderID, const PubKey& leaderKey,
                            bytes& messageToCosign);
-  unsigned char CheckLegitimacyOfTxnHashes(bytes& errorMsg);
+  unsigned char CheckLegitimacyOfTxnHashes(
+      bytes& errorMsg, const std::vector<uint32_t>& missingTxnIndices);
   bool CheckMicroBlockVersion();
   bool CheckMicroBlockshardId();
   bool CheckMicroBlockTimestamp();
@@ -355,9 +370,18 @@ class Node : public Executable {
   bool CheckMicroBlockStateDeltaHash();
   bool CheckMicroBlockTranReceiptHash();
 
-  void NotifyTimeout(bool& txnProcTimeout);
+  std::chrono::steady_clock::time_point GetTxnProcDeadline();
+  /// Hands the pool over to txn selection in O(1); operates under
+  /// m_mutexTakenTxns
+  void TakeCreatedTxns();
+  /// Looks up a txn in the pool, including those taken for selection;
+  /// operates under m_mutexTakenTxns and m_mutexCreatedTransactions
+  bool FindCreatedTxn(const TxnHash& txnHash, Transaction& t);
   bool VerifyTxnsOrdering(const std::vector<TxnHash>& tranHashes,
                           std::vector<TxnHash>& missingtranHashes);
+  /// Rebuilds the txn list of m_microblock from
+  /// m_microblockCompactTxnHashes and the txns held locally
+  void ResolveMicroBlockTxnHashes(std::vector<uint32_t>& missingTxnIndices);
 
   // Fallback Consensus
   void FallbackTimerLaunch();
@@ -448,6 +472,8 @@ class Node : public Executable {
   std::shared_ptr<DequeOfNode> m_myShardMembers;
 
   std::shared_ptr<MicroBlock> m_microblock;
+  // Set while the txn list of a received m_microblock is still short txn IDs
+  CompactTxnHashes m_microblockCompactTxnHashes;
 
   std::mutex m_mutexCVMicroBlockMissingTxn;
   std::condition_variable cv_MicroBlockMissingTxn;
@@ -458,6 +484,9 @@ class Node : public Executable {
 
   std::mutex m_mutexIsEveryMicroBlockAvailable;
 
+  // Archive of the txns processed as shard leader, if ENABLE_TXNS_BACKUP
+  std::unique_ptr<TxnArchive> m_txnArchive;
+
   // Transaction body sharing variables
   std::mutex m_mutexUnavailableMicroBlocks;
   UnavailableMicroBlockList m_unavailableMicroBlocks;
@@ -631,6 +660,20 @@ class Node : public Executable {
 
   void ProcessTransactionWhenShardLeader(const uint64_t& microblock_gas_limit);
   void ProcessTransactionWhenShardBackup(const uint64_t& microblock_gas_limit);
+
+  /// Leader streams the txns it selected to the backups in batches
+  void SendLeaderTxnOrder(const uint32_t startIndex,
+                          const std::vector<TxnHash>& txnHashes,
+                          const bool last);
+  /// Backup executes the txns in the order streamed by the leader, and
+  /// returns false if the order did not arrive in time; operates under
+  /// m_mutexTakenTxns
+  bool ReplayLeaderTxnOrder(const uint64_t& microblock_gas_limit);
+  /// Takes a txn from those taken for selection, or else from the pool;
+  /// operates under m_mutexTakenTxns
+  bool TakeCreatedTxn(const TxnHash& txnHash, Transaction& t);
+  bool WaitForCreatedTxn(const TxnHash& txnHash, Transaction& t,
+                         const std::chrono::steady_clock::time_point& deadline);
   bool ComposeMicroBlock(const uint64_t& microblock_gas_limit);
   bool CheckMicroBlockValidity(bytes& errorMsg,
                                const uint64_t& microblock_gas_limit);
@@ -638,6 +681,10 @@ class Node : public Executable {
   bool OnNodeMissingTxns(const bytes& errorMsg, const unsigned int offset,
                          const Peer& from);
 
+  /// Returns the txn list of m_microblock as short txn IDs for the
+  /// announcement, or an empty instance to send it in full
+  CompactTxnHashes GetMicroBlockCompactTxnHashes() const;
+
   void UpdateStateForNextConsensusRound();
 
   // Start synchronization with lookup as a shard node
@@ -786,14 +833,13 @@ class Node : public Executable {
   std::atomic<NodeState> m_fallbackState{};
   bool ValidateFallbackState(NodeState nodeState, NodeState statePropose);
 
+  /// Also collects the serialized txns into archivedTxns, if given.
   void PutTxnsInTempDataBase(
       const std::unordered_map<TxnHash, TransactionWithReceipt>&
-          processedTransactions);
-
-  void SaveTxnsToS3(const std::unordered_map<TxnHash, TransactionWithReceipt>&
-                        processedTransactions);
+          processedTransactions,
+      ArchivedTxns* archivedTxns = nullptr);
 
-  std::string GetAwsS3CpString(const std::string& uploadFilePath);
+  void ArchiveTxns(ArchivedTxns&& archivedTxns);
 };
 
 #endif  // ZILLIQA_SRC_LIBNODE_NODE_H_
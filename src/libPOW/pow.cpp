@@ -20,6 +20,8 @@
 #include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <thread>
 
 #include "common/Serializable.h"
 #include "depends/libethash/include/ethash/ethash.hpp"
@@ -228,7 +230,11 @@ uint8_t POW::DevidedBoundaryToDifficulty(ethash_hash256 boundary) {
 
 bool POW::EthashConfigureClient(uint64_t block_number, bool fullDataset) {
   std::lock_guard<std::mutex> g(m_mutexLightClientConfigure);
+  ConfigureClientLocked(block_number, fullDataset);
+  return true;
+}
 
+void POW::ConfigureClientLocked(uint64_t block_number, bool fullDataset) {
   if (block_number < m_currentBlockNum) {
     LOG_GENERAL(WARNING,
                 "WARNING: How come the latest block number is smaller than "
@@ -254,8 +260,6 @@ bool POW::EthashConfigureClient(uint64_t block_number, bool fullDataset) {
   }
 
   m_currentBlockNum = block_number;
-
-  return true;
 }
 
 ethash_mining_result_t POW::MineGetWork(uint64_t blockNum,
@@ -276,72 +280,152 @@ ethash_mining_result_t POW::MineGetWork(uint64_t blockNum,
   return result;
 }
 
-ethash_mining_result_t POW::MineLight(ethash_hash256 const& headerHash,
-                                      ethash_hash256 const& boundary,
-                                      uint64_t startNonce, int timeWindow) {
-  uint64_t nonce = startNonce;
-  auto startTime = std::chrono::high_resolution_clock::now();
+template <class EpochContext>
+ethash_mining_result_t POW::MineCpu(const EpochContext& context,
+                                    ethash_hash256 const& headerHash,
+                                    ethash_hash256 const& boundary,
+                                    uint64_t startNonce, int timeWindow,
+                                    uint64_t timeCheckInterval) {
+  unsigned int numThreads = m_cpuMiningThreads;
+  if (numThreads == 0) {
+    numThreads = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  // Each thread walks its own slice of the nonce space
+  const uint64_t stride = std::numeric_limits<uint64_t>::max() / numThreads;
+  const auto startTime = std::chrono::steady_clock::now();
+  const auto deadline = startTime + std::chrono::seconds(timeWindow);
+
+  std::atomic<bool> found{false};
+  std::atomic<bool> timedOut{false};
+  ethash_mining_result_t winning_result = {"", "", 0, false};
+  std::mutex mutexWinningResult;
+  std::vector<uint64_t> hashesPerThread(numThreads, 0);
+
+  auto mine = [&](unsigned int index) {
+    uint64_t nonce = startNonce + index * stride;
+    uint64_t hashes = 0;
+
+    while (m_shouldMine && !found) {
+      auto mineResult = ethash::hash(context, headerHash, nonce);
+      hashes++;
+      if (ethash::is_less_or_equal(mineResult.final_hash, boundary)) {
+        bool expected = false;
+        if (found.compare_exchange_strong(expected, true)) {
+          std::lock_guard<std::mutex> g(mutexWinningResult);
+          winning_result = {BlockhashToHexString(mineResult.final_hash),
+                            BlockhashToHexString(mineResult.mix_hash), nonce,
+                            true};
+        }
+        break;
+      }
+      nonce++;
 
-  while (m_shouldMine) {
-    auto mineResult = ethash::hash(*m_epochContextLight, headerHash, nonce);
-    if (ethash::is_less_or_equal(mineResult.final_hash, boundary)) {
-      ethash_mining_result_t winning_result = {
-          BlockhashToHexString(mineResult.final_hash),
-          BlockhashToHexString(mineResult.mix_hash), nonce, true};
-      return winning_result;
+      if (hashes % timeCheckInterval == 0 &&
+          std::chrono::steady_clock::now() > deadline) {
+        timedOut = true;
+        break;
+      }
     }
-    nonce++;
 
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    auto timePassedInSeconds = std::chrono::duration_cast<std::chrono::seconds>(
-                                   currentTime - startTime)
-                                   .count();
-    if (timePassedInSeconds > timeWindow) {
-      LOG_GENERAL(WARNING,
-                  "Time out while mining pow result, time "
-                  "passed in seconds "
-                      << timePassedInSeconds << ", time window " << timeWindow);
-      m_shouldMine = false;
-      break;
+    hashesPerThread[index] = hashes;
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads);
+  for (unsigned int i = 0; i < numThreads; i++) {
+    threads.emplace_back(mine, i);
+#if defined(__linux__)
+    if (CPU_MINE_AFFINITY) {
+      cpu_set_t cpuset;
+      CPU_ZERO(&cpuset);
+      CPU_SET(i % std::max(1U, std::thread::hardware_concurrency()), &cpuset);
+      if (pthread_setaffinity_np(threads.back().native_handle(),
+                                 sizeof(cpu_set_t), &cpuset) != 0) {
+        LOG_GENERAL(WARNING, "Failed to pin mining thread " << i);
+      }
     }
+#endif
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - startTime)
+                             .count();
+  uint64_t totalHashes = 0;
+  for (unsigned int i = 0; i < numThreads; i++) {
+    totalHashes += hashesPerThread[i];
+    LOG_GENERAL(INFO, "Mining thread " << i << ": " << hashesPerThread[i]
+                                       << " hashes, "
+                                       << hashesPerThread[i] / seconds
+                                       << " H/s");
+  }
+  LOG_GENERAL(INFO, "Mining total: " << totalHashes / seconds << " H/s on "
+                                     << numThreads << " threads");
+
+  {
+    std::lock_guard<std::mutex> g(m_mutexCpuMiningStats);
+    m_lastCpuMiningStats.m_hashesPerThread = move(hashesPerThread);
+    m_lastCpuMiningStats.m_seconds = seconds;
+  }
+
+  if (found) {
+    return winning_result;
+  }
+
+  if (timedOut) {
+    LOG_GENERAL(WARNING, "Time out while mining pow result, time "
+                         "passed in seconds "
+                             << static_cast<int>(seconds) << ", time window "
+                             << timeWindow);
+    m_shouldMine = false;
   }
 
   ethash_mining_result_t failure_result = {"", "", 0, false};
   return failure_result;
 }
 
+ethash_mining_result_t POW::MineLight(ethash_hash256 const& headerHash,
+                                      ethash_hash256 const& boundary,
+                                      uint64_t startNonce, int timeWindow) {
+  // A light hash rebuilds its dataset items on the fly and is slow, so check
+  // the clock more often than for the full dataset
+  const uint64_t TIME_CHECK_INTERVAL = 16;
+
+  std::shared_ptr<ethash::epoch_context> context;
+  {
+    std::lock_guard<std::mutex> g(m_mutexLightClientConfigure);
+    context = m_epochContextLight;
+  }
+
+  return MineCpu(*context, headerHash, boundary, startNonce, timeWindow,
+                 TIME_CHECK_INTERVAL);
+}
+
 ethash_mining_result_t POW::MineFull(ethash_hash256 const& headerHash,
                                      ethash_hash256 const& boundary,
                                      uint64_t startNonce, int timeWindow) {
-  uint64_t nonce = startNonce;
-  auto startTime = std::chrono::high_resolution_clock::now();
-
-  while (m_shouldMine) {
-    auto mineResult = ethash::hash(*m_epochContextFull, headerHash, nonce);
-    if (ethash::is_less_or_equal(mineResult.final_hash, boundary)) {
-      ethash_mining_result_t winning_result = {
-          BlockhashToHexString(mineResult.final_hash),
-          BlockhashToHexString(mineResult.mix_hash), nonce, true};
-      return winning_result;
-    }
-    nonce++;
+  const uint64_t TIME_CHECK_INTERVAL = 1024;
 
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    auto timePassedInSeconds = std::chrono::duration_cast<std::chrono::seconds>(
-                                   currentTime - startTime)
-                                   .count();
-    if (timePassedInSeconds > timeWindow) {
-      LOG_GENERAL(WARNING,
-                  "Time out while mining pow result, time "
-                  "passed in seconds "
-                      << timePassedInSeconds << ", time window " << timeWindow);
-      m_shouldMine = false;
-      break;
-    }
+  std::shared_ptr<ethash::epoch_context_full> context;
+  {
+    std::lock_guard<std::mutex> g(m_mutexLightClientConfigure);
+    context = m_epochContextFull;
   }
 
-  ethash_mining_result_t failure_result = {"", "", 0, false};
-  return failure_result;
+  return MineCpu(*context, headerHash, boundary, startNonce, timeWindow,
+                 TIME_CHECK_INTERVAL);
+}
+
+void POW::SetCpuMiningThreads(unsigned int numThreads) {
+  m_cpuMiningThreads = numThreads;
+}
+
+POW::CpuMiningStats POW::GetLastCpuMiningStats() const {
+  std::lock_guard<std::mutex> g(m_mutexCpuMiningStats);
+  return m_lastCpuMiningStats;
 }
 
 ethash_mining_result_t POW::MineFullGPU(uint64_t blockNum,
@@ -609,7 +693,7 @@ bool POW::VerifyRemoteSoln(uint64_t blockNum, ethash_hash256 const& boundary,
     return false;
   }
 
-  return ethash::verify(*m_epochContextLight, headerHash, mixHash, nonce,
+  return ethash::verify(*GetLightContext(blockNum), headerHash, mixHash, nonce,
                         boundary);
 }
 
@@ -806,7 +890,6 @@ bool POW::PoWVerify(uint64_t blockNum, uint8_t difficulty,
                     const std::string& winning_result,
                     const std::string& winning_mixhash) {
   LOG_MARKER();
-  EthashConfigureClient(blockNum);
   const auto boundary = DifficultyLevelInIntDevided(difficulty);
   auto winnning_result = StringToBlockhash(winning_result);
   auto winningMixhash = StringToBlockhash(winning_mixhash);
@@ -816,15 +899,23 @@ bool POW::PoWVerify(uint64_t blockNum, uint8_t difficulty,
     return false;
   }
 
-  return ethash::verify(*m_epochContextLight, headerHash, winningMixhash,
+  return ethash::verify(*GetLightContext(blockNum), headerHash, winningMixhash,
                         winning_nonce, boundary);
 }
 
+std::shared_ptr<ethash::epoch_context> POW::GetLightContext(
+    uint64_t blockNum) {
+  // Configure and copy under one lock, so that a concurrent call for another
+  // epoch cannot swap the context in between
+  std::lock_guard<std::mutex> g(m_mutexLightClientConfigure);
+  ConfigureClientLocked(blockNum, false);
+  return m_epochContextLight;
+}
+
 ethash::result POW::LightHash(uint64_t blockNum,
                               ethash_hash256 const& headerHash,
                               uint64_t nonce) {
-  EthashConfigureClient(blockNum);
-  return ethash::hash(*m_epochContextLight, headerHash, nonce);
+  return ethash::hash(*GetLightContext(blockNum), headerHash, nonce);
 }
 
 bool POW::CheckSolnAgainstsTargetedDifficulty(const ethash_hash256& result,
@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 #include <array>
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -130,7 +131,24 @@ class POW {
                         const ethash_hash256& headerHash,
                         ethash_hash256 const& boundary, bool verifyResult);
 
+  /// Hashes done by each CPU mining thread in the last MineLight / MineFull.
+  struct CpuMiningStats {
+    std::vector<uint64_t> m_hashesPerThread;
+    double m_seconds{};
+  };
+
+  /// Overrides CPU_MINE_THREADS for later mining runs (0 = one per core).
+  void SetCpuMiningThreads(unsigned int numThreads);
+  CpuMiningStats GetLastCpuMiningStats() const;
+
  private:
+  /// Returns the light context for blockNum's epoch. The copy stays valid for
+  /// the caller even if another thread switches epochs meanwhile.
+  std::shared_ptr<ethash::epoch_context> GetLightContext(uint64_t blockNum);
+  /// Switches the epoch contexts to block_number's epoch. Caller must hold
+  /// m_mutexLightClientConfigure.
+  void ConfigureClientLocked(uint64_t block_number, bool fullDataset);
+
   std::shared_ptr<ethash::epoch_context> m_epochContextLight = nullptr;
   std::shared_ptr<ethash::epoch_context_full> m_epochContextFull = nullptr;
   uint64_t m_currentBlockNum;
@@ -141,6 +159,18 @@ class POW {
   std::condition_variable m_cvMiningResult;
   std::mutex m_mutexMiningResult;
   std::unique_ptr<jsonrpc::HttpClient> m_httpClient;
+  std::atomic<unsigned int> m_cpuMiningThreads{CPU_MINE_THREADS};
+  mutable std::mutex m_mutexCpuMiningStats;
+  CpuMiningStats m_lastCpuMiningStats;
+
+  /// Splits the nonce space across CPU threads. The clock is read only every
+  /// timeCheckInterval hashes per thread.
+  template <class EpochContext>
+  ethash_mining_result_t MineCpu(const EpochContext& context,
+                                 ethash_hash256 const& headerHash,
+                                 ethash_hash256 const& boundary,
+                                 uint64_t startNonce, int timeWindow,
+                                 uint64_t timeCheckInterval);
 
   ethash_mining_result_t MineLight(ethash_hash256 const& headerHash,
                                    ethash_hash256 const& boundary,
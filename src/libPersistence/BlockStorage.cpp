@@ -22,6 +22,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <string>
 
@@ -89,12 +90,107 @@ bool BlockStorage::PutTxBlock(const uint64_t& blockNum, const bytes& body) {
   return PutBlock(blockNum, body, BlockType::Tx);
 }
 
-bool BlockStorage::PutTxBody(const dev::h256& key, const bytes& body) {
+bool BlockStorage::PutTxBlocks(const vector<pair<uint64_t, bytes>>& blocks) {
+  if (blocks.empty()) {
+    return true;
+  }
+
+  unordered_map<string, string> batch;
+  for (const auto& block : blocks) {
+    batch.emplace(to_string(block.first),
+                  DataConversion::CharArrayToString(block.second));
+  }
+
+  unique_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
+  if (!m_txBlockchainDB->BatchInsert(batch)) {
+    return false;
+  }
+  LOG_GENERAL(INFO, "Stored TxBlock num = " << blocks.front().first << " - "
+                                            << blocks.back().first);
+  return true;
+}
+
+bool BlockStorage::PutTxnCounts(
+    const vector<pair<uint64_t, bytes>>& entries) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING, "Non lookup node should not trigger this.");
+    return false;
+  }
+
+  if (entries.empty()) {
+    return true;
+  }
+
+  unordered_map<string, string> batch;
+  for (const auto& entry : entries) {
+    batch.emplace(to_string(entry.first),
+                  DataConversion::CharArrayToString(entry.second));
+  }
+
+  unique_lock<shared_timed_mutex> g(m_mutexTxnCounts);
+  return m_txnCountsDB->BatchInsert(batch);
+}
+
+bool BlockStorage::GetAllTxnCounts(map<uint64_t, bytes>& entries) {
+  LOG_MARKER();
+
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING, "Non lookup node should not trigger this.");
+    return false;
+  }
+
+  shared_lock<shared_timed_mutex> g(m_mutexTxnCounts);
+
+  leveldb::Iterator* it =
+      m_txnCountsDB->GetDB()->NewIterator(leveldb::ReadOptions());
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    const string blockNumStr = it->key().ToString();
+    const string entryStr = it->value().ToString();
+    try {
+      entries.emplace(stoull(blockNumStr),
+                      bytes(entryStr.begin(), entryStr.end()));
+    } catch (...) {
+      LOG_GENERAL(WARNING, "Invalid txn count key " << blockNumStr);
+      delete it;
+      return false;
+    }
+  }
+  delete it;
+
+  LOG_GENERAL(INFO, "Retrieved " << entries.size() << " txn count entries");
+  return true;
+}
+
+string BlockStorage::GetTxBodyStorePath() {
+  return STORAGE_PATH + PERSISTENCE_PATH + "/txBodySegments";
+}
+
+void BlockStorage::RetireTxBodySegments(const uint64_t& epochNum) {
+  if (TXBODY_SEGMENT_RETAIN_EPOCHS == 0 ||
+      epochNum <= TXBODY_SEGMENT_RETAIN_EPOCHS) {
+    return;
+  }
+  if (!m_txBodyStore->RetireSegmentsBefore(
+          epochNum - TXBODY_SEGMENT_RETAIN_EPOCHS,
+          TXBODY_SEGMENT_ARCHIVE_PATH)) {
+    LOG_GENERAL(WARNING, "Failed to retire txn body segments");
+  }
+}
+
+bool BlockStorage::PutTxBody(const uint64_t& epochNum, const dev::h256& key,
+                             const bytes& body) {
   int ret;
 
   if (!LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING, "Non lookup node should not trigger this.");
     return false;
+  } else if (m_txBodyStore) {
+    unique_lock<shared_timed_mutex> g(m_mutexTxBody);
+    if (!m_txBodyStore->Put(epochNum, {{key, body}})) {
+      return false;
+    }
+    RetireTxBodySegments(epochNum);
+    return true;
   } else  // IS_LOOKUP_NODE
   {
     unique_lock<shared_timed_mutex> g(m_mutexTxBody);
@@ -104,6 +200,36 @@ bool BlockStorage::PutTxBody(const dev::h256& key, const bytes& body) {
   return (ret == 0);
 }
 
+bool BlockStorage::PutTxBodies(const uint64_t& epochNum,
+                               const vector<pair<dev::h256, bytes>>& bodies) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING, "Non lookup node should not trigger this.");
+    return false;
+  }
+
+  if (bodies.empty()) {
+    return true;
+  }
+
+  if (m_txBodyStore) {
+    unique_lock<shared_timed_mutex> g(m_mutexTxBody);
+    if (!m_txBodyStore->Put(epochNum, bodies)) {
+      return false;
+    }
+    RetireTxBodySegments(epochNum);
+    return true;
+  }
+
+  unordered_map<string, string> batch;
+  for (const auto& body : bodies) {
+    batch.emplace(body.first.hex(),
+                  DataConversion::CharArrayToString(body.second));
+  }
+
+  unique_lock<shared_timed_mutex> g(m_mutexTxBody);
+  return m_txBodyDB->BatchInsert(batch);
+}
+
 bool BlockStorage::PutProcessedTxBodyTmp(const dev::h256& key,
                                          const bytes& body) {
   int ret;
@@ -127,6 +253,11 @@ bool BlockStorage::InitiateHistoricalDB(const string& path) {
   {
     unique_lock<shared_timed_mutex> g(m_mutexTxnHistorical);
     m_txnHistoricalDB = make_shared<LevelDB>("txBodies", path, (string) "");
+    const string storePath = path + "/txBodySegments";
+    if (boost::filesystem::exists(storePath)) {
+      m_txBodyHistoricalStore =
+          make_unique<TxBodyStore>(storePath, TXBODY_SEGMENT_SIZE);
+    }
   }
   {
     unique_lock<shared_timed_mutex> g(m_mutexMBHistorical);
@@ -141,6 +272,12 @@ bool BlockStorage::GetTxnFromHistoricalDB(const dev::h256& key,
   std::string bodyString;
   {
     shared_lock<shared_timed_mutex> g(m_mutexTxnHistorical);
+    bytes storedBody;
+    if (m_txBodyHistoricalStore &&
+        m_txBodyHistoricalStore->Get(key, storedBody)) {
+      body = make_shared<TransactionWithReceipt>(storedBody, 0);
+      return true;
+    }
     bodyString = m_txnHistoricalDB->Lookup(key);
   }
   if (bodyString.empty()) {
@@ -332,6 +469,7 @@ bool BlockStorage::ReleaseDB() {
   {
     unique_lock<shared_timed_mutex> g(m_mutexTxBody);
     m_txBodyDB.reset();
+    m_txBodyStore.reset();
   }
   {
     unique_lock<shared_timed_mutex> g(m_mutexMicroBlock);
@@ -464,11 +602,53 @@ bool BlockStorage::GetLatestTxBlock(TxBlockSharedPtr& block) {
   return GetTxBlock(latestTxBlockNum, block);
 }
 
+bool BlockStorage::GetLatestTxBlockNum(uint64_t& blockNum) {
+  using boost::multiprecision::uint256_t;
+
+  shared_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
+
+  if (!m_txBlockchainDB->Exists(uint256_t(0))) {
+    LOG_GENERAL(WARNING, "Disk has no TxBlock");
+    return false;
+  }
+
+  // Grow the upper bound until it points past the end of the chain
+  uint64_t low = 0;
+  uint64_t high = 1;
+  while (m_txBlockchainDB->Exists(uint256_t(high))) {
+    low = high;
+    if (high > (numeric_limits<uint64_t>::max() >> 1)) {
+      LOG_GENERAL(WARNING, "Tx block numbers out of range");
+      return false;
+    }
+    high <<= 1;
+  }
+
+  // low exists and high does not
+  while (high - low > 1) {
+    const uint64_t mid = low + (high - low) / 2;
+    if (m_txBlockchainDB->Exists(uint256_t(mid))) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+
+  blockNum = low;
+  return true;
+}
+
 bool BlockStorage::GetTxBody(const dev::h256& key, TxBodySharedPtr& body) {
   std::string bodyString;
 
   {
     shared_lock<shared_timed_mutex> g(m_mutexTxBody);
+    bytes storedBody;
+    if (m_txBodyStore && m_txBodyStore->Get(key, storedBody)) {
+      body = make_shared<TransactionWithReceipt>(storedBody, 0);
+      return true;
+    }
+    // Bodies written before the segment store was enabled stay in LevelDB
     bodyString = m_txBodyDB->Lookup(key);
   }
 
@@ -481,8 +661,35 @@ bool BlockStorage::GetTxBody(const dev::h256& key, TxBodySharedPtr& body) {
   return true;
 }
 
+bool BlockStorage::GetTxBodiesForEpoch(
+    const uint64_t& epochNum, const unordered_set<dev::h256>& txnHashes,
+    vector<TxBodySharedPtr>& bodies) {
+  bodies.clear();
+  TxBodyStore::Bodies storedBodies;
+  {
+    shared_lock<shared_timed_mutex> g(m_mutexTxBody);
+    if (!m_txBodyStore ||
+        !m_txBodyStore->GetRange(epochNum, epochNum, storedBodies)) {
+      return false;
+    }
+  }
+
+  bodies.reserve(txnHashes.size());
+  for (const auto& storedBody : storedBodies) {
+    if (txnHashes.find(storedBody.first) == txnHashes.end()) {
+      continue;
+    }
+    bodies.emplace_back(
+        make_shared<TransactionWithReceipt>(storedBody.second, 0));
+  }
+  return true;
+}
+
 bool BlockStorage::CheckTxBody(const dev::h256& key) {
   shared_lock<shared_timed_mutex> g(m_mutexTxBody);
+  if (m_txBodyStore && m_txBodyStore->Exists(key)) {
+    return true;
+  }
   return m_txBodyDB->Exists(key);
 }
 
@@ -517,6 +724,11 @@ bool BlockStorage::DeleteTxBody(const dev::h256& key) {
   if (!LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING, "Non lookup node should not trigger this");
     return false;
+  } else if (m_txBodyStore) {
+    unique_lock<shared_timed_mutex> g(m_mutexTxBody);
+    // The body may still be in LevelDB if written before the store was on
+    const bool deleted = m_txBodyStore->Delete(key);
+    return (m_txBodyDB->DeleteKey(key) == 0) && deleted;
   } else {
     unique_lock<shared_timed_mutex> g(m_mutexTxBody);
     ret = m_txBodyDB->DeleteKey(key);
@@ -1442,6 +1654,9 @@ bool BlockStorage::ResetDB(DBTYPE type) {
     case TX_BODY: {
       unique_lock<shared_timed_mutex> g(m_mutexTxBody);
       ret = m_txBodyDB->ResetDB();
+      if (m_txBodyStore) {
+        ret = m_txBodyStore->Reset() && ret;
+      }
       break;
     }
     case MICROBLOCK: {
@@ -1525,6 +1740,11 @@ bool BlockStorage::ResetDB(DBTYPE type) {
       ret = m_extSeedPubKeysDB->ResetDB();
       break;
     }
+    case TXN_COUNTS: {
+      unique_lock<shared_timed_mutex> g(m_mutexTxnCounts);
+      ret = m_txnCountsDB->ResetDB();
+      break;
+    }
   }
   if (!ret) {
     LOG_GENERAL(INFO, "FAIL: Reset DB " << type << " failed");
@@ -1554,6 +1774,12 @@ bool BlockStorage::RefreshDB(DBTYPE type) {
     case TX_BODY: {
       unique_lock<shared_timed_mutex> g(m_mutexTxBody);
       ret = m_txBodyDB->RefreshDB();
+      if (m_txBodyStore) {
+        m_txBodyStore.reset();
+        m_txBodyStore = make_unique<TxBodyStore>(GetTxBodyStorePath(),
+                                                 TXBODY_SEGMENT_SIZE);
+        ret = m_txBodyStore->IsOpen() && ret;
+      }
       break;
     }
     case MICROBLOCK: {
@@ -1637,6 +1863,11 @@ bool BlockStorage::RefreshDB(DBTYPE type) {
       ret = m_extSeedPubKeysDB->RefreshDB();
       break;
     }
+    case TXN_COUNTS: {
+      unique_lock<shared_timed_mutex> g(m_mutexTxnCounts);
+      ret = m_txnCountsDB->RefreshDB();
+      break;
+    }
   }
   if (!ret) {
     LOG_GENERAL(INFO, "FAIL: Refresh DB " << type << " failed");
@@ -1742,6 +1973,11 @@ std::vector<std::string> BlockStorage::GetDBName(DBTYPE type) {
       ret.push_back(m_extSeedPubKeysDB->GetDBName());
       break;
     }
+    case TXN_COUNTS: {
+      shared_lock<shared_timed_mutex> g(m_mutexTxnCounts);
+      ret.push_back(m_txnCountsDB->GetDBName());
+      break;
+    }
   }
 
   return ret;
@@ -1766,7 +2002,8 @@ bool BlockStorage::ResetAll() {
            ResetDB(TEMP_STATE) & ResetDB(DIAGNOSTIC_NODES) &
            ResetDB(DIAGNOSTIC_COINBASE) & ResetDB(STATE_ROOT) &
            ResetDB(PROCESSED_TEMP) & ResetDB(MINER_INFO_DSCOMM) &
-           ResetDB(MINER_INFO_SHARDS) & ResetDB(EXTSEED_PUBKEYS);
+           ResetDB(MINER_INFO_SHARDS) & ResetDB(EXTSEED_PUBKEYS) &
+           ResetDB(TXN_COUNTS);
   }
 }
 
@@ -1792,7 +2029,7 @@ bool BlockStorage::RefreshAll() {
            RefreshDB(DIAGNOSTIC_NODES) & RefreshDB(DIAGNOSTIC_COINBASE) &
            RefreshDB(STATE_ROOT) & RefreshDB(PROCESSED_TEMP) &
            RefreshDB(MINER_INFO_DSCOMM) & RefreshDB(MINER_INFO_SHARDS) &
-           RefreshDB(EXTSEED_PUBKEYS) &
+           RefreshDB(EXTSEED_PUBKEYS) & RefreshDB(TXN_COUNTS) &
            Contract::ContractStorage2::GetContractStorage().RefreshAll();
   }
 }
\ No newline at end of file
@@ -19,12 +19,15 @@
 #define ZILLIQA_SRC_LIBPERSISTENCE_BLOCKSTORAGE_H_
 
 #include <list>
+#include <map>
 #include <mutex>
 #include <shared_mutex>
+#include <unordered_set>
 #include <vector>
 
 #include <Schnorr.h>
 #include "ContractStorage.h"
+#include "TxBodyStore.h"
 #include "common/Singleton.h"
 #include "depends/libDatabase/LevelDB.h"
 #include "libData/BlockData/Block.h"
@@ -102,12 +105,17 @@ class BlockStorage : public Singleton<BlockStorage> {
   /// used for historical data
   std::shared_ptr<LevelDB> m_txnHistoricalDB;
   std::shared_ptr<LevelDB> m_MBHistoricalDB;
+  /// used instead of m_txBodyDB and m_txnHistoricalDB if TXBODY_SEGMENT_STORE
+  std::unique_ptr<TxBodyStore> m_txBodyStore;
+  std::unique_ptr<TxBodyStore> m_txBodyHistoricalStore;
   /// used for miner nodes (DS committee) retrieval
   std::shared_ptr<LevelDB> m_minerInfoDSCommDB;
   /// used for miner nodes (shards) retrieval
   std::shared_ptr<LevelDB> m_minerInfoShardsDB;
   /// used for extseed pub key storage and retrieval
   std::shared_ptr<LevelDB> m_extSeedPubKeysDB;
+  /// used for the cumulative txn counts of Tx blocks
+  std::shared_ptr<LevelDB> m_txnCountsDB;
 
   BlockStorage(const std::string& path = "", bool diagnostic = false)
       : m_metadataDB(std::make_shared<LevelDB>("metadata")),
@@ -131,14 +139,23 @@ class BlockStorage : public Singleton<BlockStorage> {
         m_diagnosticDBCoinbaseCounter(0) {
     if (LOOKUP_NODE_MODE) {
       m_txBodyDB = std::make_shared<LevelDB>("txBodies");
+      if (TXBODY_SEGMENT_STORE) {
+        m_txBodyStore = std::make_unique<TxBodyStore>(GetTxBodyStorePath(),
+                                                      TXBODY_SEGMENT_SIZE);
+      }
       m_minerInfoDSCommDB = std::make_shared<LevelDB>("minerInfoDSComm");
       m_minerInfoShardsDB = std::make_shared<LevelDB>("minerInfoShards");
       m_extSeedPubKeysDB = std::make_shared<LevelDB>("extSeedPubKeys");
+      m_txnCountsDB = std::make_shared<LevelDB>("txnCounts");
     }
   };
   ~BlockStorage() = default;
   bool PutBlock(const uint64_t& blockNum, const bytes& body,
                 const BlockType& blockType);
+  static std::string GetTxBodyStorePath();
+  /// Retires the segments of m_txBodyStore older than
+  /// TXBODY_SEGMENT_RETAIN_EPOCHS. Caller must hold m_mutexTxBody.
+  void RetireTxBodySegments(const uint64_t& epochNum);
 
  public:
   enum DBTYPE {
@@ -160,7 +177,8 @@ class BlockStorage : public Singleton<BlockStorage> {
     PROCESSED_TEMP,
     MINER_INFO_DSCOMM,
     MINER_INFO_SHARDS,
-    EXTSEED_PUBKEYS
+    EXTSEED_PUBKEYS,
+    TXN_COUNTS
   };
 
   /// Returns the singleton BlockStorage instance.
@@ -181,11 +199,26 @@ class BlockStorage : public Singleton<BlockStorage> {
   /// Adds a Tx block to storage.
   bool PutTxBlock(const uint64_t& blockNum, const bytes& body);
 
+  /// Adds consecutive Tx blocks to storage in a single write batch.
+  bool PutTxBlocks(const std::vector<std::pair<uint64_t, bytes>>& blocks);
+
+  /// Adds the txn count index entries of Tx blocks in a single write batch.
+  bool PutTxnCounts(const std::vector<std::pair<uint64_t, bytes>>& entries);
+
+  /// Retrieves the txn count index entries, keyed by Tx block number.
+  bool GetAllTxnCounts(std::map<uint64_t, bytes>& entries);
+
   // /// Adds a micro block to storage.
   bool PutMicroBlock(const BlockHash& blockHash, const bytes& body);
 
-  /// Adds a transaction body to storage.
-  bool PutTxBody(const dev::h256& key, const bytes& body);
+  /// Adds a transaction body of the given epoch to storage.
+  bool PutTxBody(const uint64_t& epochNum, const dev::h256& key,
+                 const bytes& body);
+
+  /// Adds transaction bodies of the given epoch to storage in a single write
+  /// batch.
+  bool PutTxBodies(const uint64_t& epochNum,
+                   const std::vector<std::pair<dev::h256, bytes>>& bodies);
 
   bool PutProcessedTxBodyTmp(const dev::h256& key, const bytes& body);
 
@@ -202,6 +235,10 @@ class BlockStorage : public Singleton<BlockStorage> {
 
   bool GetLatestTxBlock(TxBlockSharedPtr& block);
 
+  /// Finds the highest Tx block number with O(log n) point lookups instead of
+  /// a full scan. Assumes blocks are stored contiguously from 0.
+  bool GetLatestTxBlockNum(uint64_t& blockNum);
+
   bool CheckTxBody(const dev::h256& key);
 
   bool ReleaseDB();
@@ -221,6 +258,13 @@ class BlockStorage : public Singleton<BlockStorage> {
   /// Retrieves the requested transaction body.
   bool GetTxBody(const dev::h256& key, TxBodySharedPtr& body);
 
+  /// Retrieves the transaction bodies of an epoch in one range read, only
+  /// deserializing those in txnHashes. Only supported with
+  /// TXBODY_SEGMENT_STORE.
+  bool GetTxBodiesForEpoch(const uint64_t& epochNum,
+                           const std::unordered_set<dev::h256>& txnHashes,
+                           std::vector<TxBodySharedPtr>& bodies);
+
   bool GetTxnFromHistoricalDB(const dev::h256& key, TxBodySharedPtr& body);
 
   bool GetHistoricalMicroBlock(const BlockHash& blockhash,
@@ -413,6 +457,7 @@ class BlockStorage : public Singleton<BlockStorage> {
   mutable std::shared_timed_mutex m_mutexMinerInfoDSComm;
   mutable std::shared_timed_mutex m_mutexMinerInfoShards;
   mutable std::shared_timed_mutex m_mutexExtSeedPubKeys;
+  mutable std::shared_timed_mutex m_mutexTxnCounts;
 
   unsigned int m_diagnosticDBNodesCounter;
   unsigned int m_diagnosticDBCoinbaseCounter;
@@ -46,19 +46,34 @@ bool Retriever::RetrieveTxBlocks() {
 
   unsigned int extra_txblocks = (lastBlockNum + 1) % NUM_FINAL_BLOCK_PER_POW;
 
+  // Ask for every missing state-delta up front, so that the seeds serve them
+  // while we wait for the first one
+  std::unique_lock<std::mutex> cv_lk(
+      m_mediator.m_lookup->m_mutexSetStateDeltaFromSeed);
+  m_mediator.m_lookup->m_skipAddStateDeltaToAccountStore = true;
+
+  std::vector<uint64_t> missingBlockNums;
   for (uint64_t blockNum = lastBlockNum + 1 - extra_txblocks;
        blockNum <= lastBlockNum; blockNum++) {
     bytes stateDelta;
     if (!BlockStorage::GetBlockStorage().GetStateDelta(blockNum, stateDelta)) {
       LOG_GENERAL(INFO, "Didn't find the state-delta for txBlkNum: "
                             << blockNum << ". Try fetching it from seeds");
+      m_mediator.m_lookup->GetStateDeltaFromSeedNodes(blockNum);
+      missingBlockNums.emplace_back(blockNum);
+    }
+  }
+
+  for (uint64_t blockNum = lastBlockNum + 1 - extra_txblocks;
+       blockNum <= lastBlockNum; blockNum++) {
+    bytes stateDelta;
+    if (std::find(missingBlockNums.begin(), missingBlockNums.end(),
+                  blockNum) != missingBlockNums.end()) {
+      // Deltas are stored with the lock held, so none can be missed here
+      bool received =
+          BlockStorage::GetBlockStorage().GetStateDelta(blockNum, stateDelta);
       unsigned int retry = 1;
-      while (retry <= RETRY_GETSTATEDELTAS_COUNT) {
-        // Get the state-delta for this txBlock from random seed nodes
-        std::unique_lock<std::mutex> cv_lk(
-            m_mediator.m_lookup->m_mutexSetStateDeltaFromSeed);
-        m_mediator.m_lookup->m_skipAddStateDeltaToAccountStore = true;
-        m_mediator.m_lookup->GetStateDeltaFromSeedNodes(blockNum);
+      while (!received && retry <= RETRY_GETSTATEDELTAS_COUNT) {
         if (m_mediator.m_lookup->cv_setStateDeltaFromSeed.wait_for(
                 cv_lk,
                 std::chrono::seconds(GETSTATEDELTAS_TIMEOUT_IN_SECONDS)) ==
@@ -67,26 +82,29 @@ bool Retriever::RetrieveTxBlocks() {
                       "[Retry: " << retry
                                  << "] Didn't receive statedelta for txBlkNum: "
                                  << blockNum << "! Will try again");
+          m_mediator.m_lookup->GetStateDeltaFromSeedNodes(blockNum);
           retry++;
-        } else {
-          break;
         }
+        received =
+            BlockStorage::GetBlockStorage().GetStateDelta(blockNum, stateDelta);
       }
       // if state-delta is still not fetched from extra txblocks set, simple
       // skip all extra blocks
-      if (retry > RETRY_GETSTATEDELTAS_COUNT) {
+      if (!received) {
         extraStateDeltas.clear();
         trimIncompletedBlocks = true;
         break;
       }
 
       // got state-delta at last
-      BlockStorage::GetBlockStorage().GetStateDelta(blockNum, stateDelta);
       BlockStorage::GetBlockStorage().DeleteStateDelta(blockNum);
+    } else {
+      BlockStorage::GetBlockStorage().GetStateDelta(blockNum, stateDelta);
     }
     // store it.
     extraStateDeltas.push_back(stateDelta);
   }
+  cv_lk.unlock();
 
   if ((lastBlockNum - extra_txblocks + 1) %
           (INCRDB_DSNUMS_WITH_STATEDELTAS * NUM_FINAL_BLOCK_PER_POW) ==
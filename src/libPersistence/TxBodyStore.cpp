@@ -0,0 +1,580 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+
+#include "TxBodyStore.h"
+#include "common/Serializable.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+namespace bfs = boost::filesystem;
+
+namespace {
+const unsigned int HASH_LEN = dev::h256::size;
+const unsigned int UINT32_LEN = sizeof(uint32_t);
+const unsigned int UINT64_LEN = sizeof(uint64_t);
+const unsigned int RECORD_HEADER_LEN = HASH_LEN + UINT64_LEN + UINT32_LEN;
+const unsigned int RECORDS_ENTRY_LEN =
+    HASH_LEN + UINT64_LEN + UINT64_LEN + UINT32_LEN;
+const uint32_t TOMBSTONE = UINT32_MAX;
+const string SEGMENT_SUFFIX = ".seg";
+const string RECORDS_SUFFIX = ".idx";
+const string TMP_SUFFIX = ".tmp";
+
+void AppendNumber(bytes& dst, uint64_t value, unsigned int len) {
+  Serializable::SetNumber<uint64_t>(dst, dst.size(), value, len);
+}
+
+uint64_t ReadNumber(const bytes& src, unsigned int offset, unsigned int len) {
+  return Serializable::GetNumber<uint64_t>(src, offset, len);
+}
+
+void AppendRecordHeader(bytes& dst, const dev::h256& key, uint64_t epochNum,
+                        uint32_t length) {
+  dst.insert(dst.end(), key.data(), key.data() + HASH_LEN);
+  AppendNumber(dst, epochNum, UINT64_LEN);
+  AppendNumber(dst, length, UINT32_LEN);
+}
+
+bool ReadAt(int fd, uint64_t offset, size_t length, bytes& dst) {
+  dst.resize(length);
+  size_t done = 0;
+  while (done < length) {
+    const ssize_t n =
+        pread(fd, dst.data() + done, length - done, offset + done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    done += n;
+  }
+  return true;
+}
+}  // namespace
+
+TxBodyStore::TxBodyStore(const string& dir, uint64_t maxSegmentSize)
+    : m_dir(dir), m_maxSegmentSize(maxSegmentSize) {
+  unique_lock<shared_timed_mutex> g(m_mutex);
+  m_open = Open();
+}
+
+TxBodyStore::~TxBodyStore() {
+  unique_lock<shared_timed_mutex> g(m_mutex);
+  Close();
+}
+
+bool TxBodyStore::IsOpen() const {
+  shared_lock<shared_timed_mutex> g(m_mutex);
+  return m_open;
+}
+
+string TxBodyStore::GetSegmentPath(uint32_t id) const {
+  ostringstream oss;
+  oss << setw(10) << setfill('0') << id << SEGMENT_SUFFIX;
+  return (bfs::path(m_dir) / oss.str()).string();
+}
+
+string TxBodyStore::GetRecordsPath(uint32_t id) const {
+  return bfs::path(GetSegmentPath(id)).replace_extension(RECORDS_SUFFIX)
+      .string();
+}
+
+bool TxBodyStore::Open() {
+  boost::system::error_code ec;
+  bfs::create_directories(m_dir, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to create txn body store dir "
+                             << m_dir << ": " << ec.message());
+    return false;
+  }
+
+  vector<uint32_t> ids;
+  for (bfs::directory_iterator it(m_dir, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    if (it->path().extension() != SEGMENT_SUFFIX) {
+      continue;
+    }
+    try {
+      ids.emplace_back(stoul(it->path().stem().string()));
+    } catch (...) {
+      LOG_GENERAL(WARNING, "Ignoring " << it->path().string());
+    }
+  }
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to list txn body store dir "
+                             << m_dir << ": " << ec.message());
+    return false;
+  }
+  sort(ids.begin(), ids.end());
+
+  for (const auto id : ids) {
+    Segment& segment = m_segments[id];
+    if (!LoadSegment(id, segment)) {
+      Close();
+      return false;
+    }
+    // Only the newest segment is appended to, so an unsealed older one was
+    // left behind by a crash while sealing
+    if (!segment.m_sealed && id != ids.back() && !SealSegment(id, segment)) {
+      Close();
+      return false;
+    }
+  }
+
+  LOG_GENERAL(INFO, "Opened txn body store " << m_dir << " with "
+                                             << m_index.size() << " bodies in "
+                                             << m_segments.size()
+                                             << " segments");
+  return true;
+}
+
+void TxBodyStore::Close() {
+  for (auto& segment : m_segments) {
+    if (segment.second.m_fd >= 0) {
+      close(segment.second.m_fd);
+    }
+  }
+  m_segments.clear();
+  m_index.clear();
+  m_extents.clear();
+  m_open = false;
+}
+
+bool TxBodyStore::LoadSegment(uint32_t id, Segment& segment) {
+  const string path = GetSegmentPath(id);
+  segment.m_fd = open(path.c_str(), O_RDWR | O_APPEND);
+  struct stat st;
+  if (segment.m_fd < 0 || fstat(segment.m_fd, &st) != 0) {
+    LOG_GENERAL(WARNING, "Failed to open " << path << ": " << strerror(errno));
+    return false;
+  }
+  segment.m_size = st.st_size;
+
+  if (bfs::exists(GetRecordsPath(id))) {
+    segment.m_sealed = true;
+    if (LoadRecords(id, segment)) {
+      return true;
+    }
+    LOG_GENERAL(WARNING, "Rescanning " << path);
+    segment.m_sealed = false;
+  }
+  return ScanSegment(id, segment);
+}
+
+bool TxBodyStore::ScanSegment(uint32_t id, Segment& segment) {
+  bytes header;
+  uint64_t offset = 0;
+  while (offset < segment.m_size) {
+    if (offset + RECORD_HEADER_LEN > segment.m_size ||
+        !ReadAt(segment.m_fd, offset, RECORD_HEADER_LEN, header)) {
+      break;
+    }
+    Record record{dev::h256(header.data(), dev::h256::ConstructFromPointer),
+                  ReadNumber(header, HASH_LEN, UINT64_LEN), offset,
+                  static_cast<uint32_t>(
+                      ReadNumber(header, HASH_LEN + UINT64_LEN, UINT32_LEN))};
+    const uint64_t end = offset + RECORD_HEADER_LEN +
+                         (record.m_length == TOMBSTONE ? 0 : record.m_length);
+    if (end > segment.m_size) {
+      break;
+    }
+    ApplyRecord(id, segment, record);
+    offset = end;
+  }
+
+  if (offset < segment.m_size) {
+    // A crash in the middle of an append leaves part of a record behind
+    LOG_GENERAL(WARNING, "Dropping " << segment.m_size - offset
+                                     << " bytes of partial record from "
+                                     << GetSegmentPath(id));
+    if (ftruncate(segment.m_fd, offset) != 0) {
+      LOG_GENERAL(WARNING, "Failed to truncate " << GetSegmentPath(id));
+      return false;
+    }
+    segment.m_size = offset;
+  }
+  return true;
+}
+
+bool TxBodyStore::LoadRecords(uint32_t id, Segment& segment) {
+  ifstream file(GetRecordsPath(id), ios::binary | ios::ate);
+  if (!file) {
+    return false;
+  }
+  bytes data(file.tellg());
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(data.data()), data.size());
+  if (!file || data.size() < UINT64_LEN ||
+      data.size() !=
+          UINT64_LEN + ReadNumber(data, 0, UINT64_LEN) * RECORDS_ENTRY_LEN) {
+    LOG_GENERAL(WARNING, "Corrupt " << GetRecordsPath(id));
+    return false;
+  }
+
+  for (uint64_t offset = UINT64_LEN; offset < data.size();
+       offset += RECORDS_ENTRY_LEN) {
+    Record record{
+        dev::h256(data.data() + offset, dev::h256::ConstructFromPointer),
+        ReadNumber(data, offset + HASH_LEN, UINT64_LEN),
+        ReadNumber(data, offset + HASH_LEN + UINT64_LEN, UINT64_LEN),
+        static_cast<uint32_t>(ReadNumber(
+            data, offset + HASH_LEN + UINT64_LEN + UINT64_LEN, UINT32_LEN))};
+    ApplyRecord(id, segment, record);
+  }
+  return true;
+}
+
+void TxBodyStore::ApplyRecord(uint32_t id, Segment& segment,
+                              const Record& record) {
+  if (!segment.m_sealed) {
+    segment.m_records.emplace_back(record);
+  }
+  if (record.m_length == TOMBSTONE) {
+    m_index.erase(record.m_key);
+    return;
+  }
+
+  segment.m_minEpoch = min(segment.m_minEpoch, record.m_epochNum);
+  segment.m_maxEpoch = max(segment.m_maxEpoch, record.m_epochNum);
+  m_index[record.m_key] = {id, record.m_length,
+                           record.m_offset + RECORD_HEADER_LEN};
+
+  const uint64_t end = record.m_offset + RECORD_HEADER_LEN + record.m_length;
+  auto& extents = m_extents[record.m_epochNum];
+  if (!extents.empty() && extents.back().m_segment == id &&
+      extents.back().m_end == record.m_offset) {
+    extents.back().m_end = end;
+  } else {
+    extents.push_back({id, record.m_offset, end});
+  }
+}
+
+bool TxBodyStore::SealSegment(uint32_t id, Segment& segment) {
+  bytes data;
+  data.reserve(UINT64_LEN + segment.m_records.size() * RECORDS_ENTRY_LEN);
+  AppendNumber(data, segment.m_records.size(), UINT64_LEN);
+  for (const auto& record : segment.m_records) {
+    data.insert(data.end(), record.m_key.data(),
+                record.m_key.data() + HASH_LEN);
+    AppendNumber(data, record.m_epochNum, UINT64_LEN);
+    AppendNumber(data, record.m_offset, UINT64_LEN);
+    AppendNumber(data, record.m_length, UINT32_LEN);
+  }
+
+  const string path = GetRecordsPath(id);
+  {
+    ofstream file(path + TMP_SUFFIX, ios::binary | ios::trunc);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    if (!file) {
+      LOG_GENERAL(WARNING, "Failed to write " << path);
+      return false;
+    }
+  }
+  if (fdatasync(segment.m_fd) != 0 ||
+      rename((path + TMP_SUFFIX).c_str(), path.c_str()) != 0) {
+    LOG_GENERAL(WARNING, "Failed to seal " << GetSegmentPath(id));
+    return false;
+  }
+
+  segment.m_sealed = true;
+  vector<Record>().swap(segment.m_records);
+  return true;
+}
+
+bool TxBodyStore::StartSegment() {
+  const uint32_t id = m_segments.empty() ? 0 : m_segments.rbegin()->first + 1;
+  const string path = GetSegmentPath(id);
+  const int fd = open(path.c_str(), O_RDWR | O_APPEND | O_CREAT | O_TRUNC,
+                      S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  if (fd < 0) {
+    LOG_GENERAL(WARNING, "Failed to create " << path << ": "
+                                             << strerror(errno));
+    return false;
+  }
+  m_segments[id].m_fd = fd;
+  return true;
+}
+
+bool TxBodyStore::Append(const bytes& data) {
+  if (m_segments.empty() || m_segments.rbegin()->second.m_sealed) {
+    if (!StartSegment()) {
+      return false;
+    }
+  }
+  auto it = m_segments.rbegin();
+  if (it->second.m_size > 0 &&
+      it->second.m_size + data.size() > m_maxSegmentSize) {
+    if (!SealSegment(it->first, it->second) || !StartSegment()) {
+      return false;
+    }
+    it = m_segments.rbegin();
+  }
+
+  Segment& segment = it->second;
+  size_t done = 0;
+  while (done < data.size()) {
+    const ssize_t n =
+        write(segment.m_fd, data.data() + done, data.size() - done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      LOG_GENERAL(WARNING, "Failed to append to " << GetSegmentPath(it->first)
+                                                  << ": " << strerror(errno));
+      // Leave no partial record behind
+      if (ftruncate(segment.m_fd, segment.m_size) != 0) {
+        LOG_GENERAL(WARNING, "Failed to truncate "
+                                 << GetSegmentPath(it->first));
+      }
+      return false;
+    }
+    done += n;
+  }
+  return true;
+}
+
+bool TxBodyStore::Put(uint64_t epochNum, const Bodies& bodies) {
+  if (bodies.empty()) {
+    return true;
+  }
+
+  size_t length = 0;
+  for (const auto& body : bodies) {
+    if (body.second.size() >= TOMBSTONE) {
+      LOG_GENERAL(WARNING, "Txn body too large " << body.first);
+      return false;
+    }
+    length += RECORD_HEADER_LEN + body.second.size();
+  }
+  bytes data;
+  data.reserve(length);
+  for (const auto& body : bodies) {
+    AppendRecordHeader(data, body.first, epochNum, body.second.size());
+    data.insert(data.end(), body.second.begin(), body.second.end());
+  }
+
+  unique_lock<shared_timed_mutex> g(m_mutex);
+  if (!m_open || !Append(data)) {
+    return false;
+  }
+
+  const auto it = m_segments.rbegin();
+  uint64_t offset = it->second.m_size;
+  for (const auto& body : bodies) {
+    const uint32_t bodyLength = body.second.size();
+    ApplyRecord(it->first, it->second,
+                {body.first, epochNum, offset, bodyLength});
+    offset += RECORD_HEADER_LEN + bodyLength;
+  }
+  it->second.m_size = offset;
+  return true;
+}
+
+bool TxBodyStore::Get(const dev::h256& key, bytes& body) const {
+  shared_lock<shared_timed_mutex> g(m_mutex);
+  const auto it = m_index.find(key);
+  if (it == m_index.end()) {
+    return false;
+  }
+  const Location& location = it->second;
+  return ReadAt(m_segments.at(location.m_segment).m_fd, location.m_offset,
+                location.m_length, body);
+}
+
+bool TxBodyStore::Exists(const dev::h256& key) const {
+  shared_lock<shared_timed_mutex> g(m_mutex);
+  return m_index.find(key) != m_index.end();
+}
+
+bool TxBodyStore::Delete(const dev::h256& key) {
+  unique_lock<shared_timed_mutex> g(m_mutex);
+  if (!m_open) {
+    return false;
+  }
+  if (m_index.find(key) == m_index.end()) {
+    return true;
+  }
+
+  bytes data;
+  AppendRecordHeader(data, key, 0, TOMBSTONE);
+  if (!Append(data)) {
+    return false;
+  }
+  const auto it = m_segments.rbegin();
+  ApplyRecord(it->first, it->second, {key, 0, it->second.m_size, TOMBSTONE});
+  it->second.m_size += data.size();
+  return true;
+}
+
+bool TxBodyStore::GetRange(uint64_t loEpoch, uint64_t hiEpoch,
+                           Bodies& bodies) const {
+  bodies.clear();
+  shared_lock<shared_timed_mutex> g(m_mutex);
+  if (!m_open) {
+    return false;
+  }
+
+  bytes data;
+  for (auto it = m_extents.lower_bound(loEpoch);
+       it != m_extents.end() && it->first <= hiEpoch; ++it) {
+    for (const auto& extent : it->second) {
+      if (!ReadAt(m_segments.at(extent.m_segment).m_fd, extent.m_begin,
+                  extent.m_end - extent.m_begin, data)) {
+        LOG_GENERAL(WARNING,
+                    "Failed to read txn bodies of epoch " << it->first);
+        return false;
+      }
+
+      for (uint64_t offset = 0; offset + RECORD_HEADER_LEN <= data.size();) {
+        const dev::h256 key(data.data() + offset,
+                            dev::h256::ConstructFromPointer);
+        const uint32_t length =
+            ReadNumber(data, offset + HASH_LEN + UINT64_LEN, UINT32_LEN);
+        const uint64_t bodyOffset = offset + RECORD_HEADER_LEN;
+        // Skip bodies that were deleted or put again since
+        const auto location = m_index.find(key);
+        if (location != m_index.end() &&
+            location->second.m_segment == extent.m_segment &&
+            location->second.m_offset == extent.m_begin + bodyOffset) {
+          bodies.emplace_back(key, bytes(data.begin() + bodyOffset,
+                                         data.begin() + bodyOffset + length));
+        }
+        offset = bodyOffset + length;
+      }
+    }
+  }
+  return true;
+}
+
+bool TxBodyStore::RetireSegmentsBefore(uint64_t epochNum,
+                                       const string& archiveDir) {
+  unique_lock<shared_timed_mutex> g(m_mutex);
+  if (!m_open) {
+    return false;
+  }
+
+  while (!m_segments.empty()) {
+    const auto it = m_segments.begin();
+    const uint32_t id = it->first;
+    Segment& segment = it->second;
+    if (!segment.m_sealed || (segment.m_minEpoch <= segment.m_maxEpoch &&
+                              segment.m_maxEpoch >= epochNum)) {
+      break;
+    }
+
+    // Reading the record list again is cheaper than searching the index
+    Segment retired;
+    retired.m_sealed = true;
+    {
+      decltype(m_index) index;
+      decltype(m_extents) extents;
+      swap(index, m_index);
+      swap(extents, m_extents);
+      const bool loaded = LoadRecords(id, retired);
+      swap(index, m_index);
+      swap(extents, m_extents);
+      if (!loaded) {
+        return false;
+      }
+      for (const auto& entry : index) {
+        const auto location = m_index.find(entry.first);
+        if (location != m_index.end() && location->second.m_segment == id) {
+          m_index.erase(location);
+        }
+      }
+      for (const auto& entry : extents) {
+        auto epochExtents = m_extents.find(entry.first);
+        if (epochExtents == m_extents.end()) {
+          continue;
+        }
+        auto& list = epochExtents->second;
+        list.erase(remove_if(list.begin(), list.end(),
+                             [id](const Extent& extent) {
+                               return extent.m_segment == id;
+                             }),
+                   list.end());
+        if (list.empty()) {
+          m_extents.erase(epochExtents);
+        }
+      }
+    }
+    close(segment.m_fd);
+    m_segments.erase(it);
+
+    boost::system::error_code ec;
+    for (const auto& path : {GetSegmentPath(id), GetRecordsPath(id)}) {
+      if (archiveDir.empty()) {
+        bfs::remove(path, ec);
+      } else {
+        bfs::create_directories(archiveDir, ec);
+        const auto target = bfs::path(archiveDir) / bfs::path(path).filename();
+        bfs::rename(path, target, ec);
+        if (ec) {
+          // Possibly on another file system
+          ec.clear();
+          bfs::copy_file(path, target, bfs::copy_option::overwrite_if_exists,
+                         ec);
+          if (!ec) {
+            bfs::remove(path, ec);
+          }
+        }
+      }
+      if (ec) {
+        LOG_GENERAL(WARNING, "Failed to retire " << path << ": "
+                                                 << ec.message());
+        return false;
+      }
+    }
+    LOG_GENERAL(INFO, "Retired txn body segment " << GetSegmentPath(id));
+  }
+  return true;
+}
+
+bool TxBodyStore::Reset() {
+  unique_lock<shared_timed_mutex> g(m_mutex);
+  Close();
+  boost::system::error_code ec;
+  bfs::remove_all(m_dir, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to remove " << m_dir << ": " << ec.message());
+  }
+  m_open = Open();
+  return m_open;
+}
+
+size_t TxBodyStore::GetNumBodies() const {
+  shared_lock<shared_timed_mutex> g(m_mutex);
+  return m_index.size();
+}
+
+size_t TxBodyStore::GetNumSegments() const {
+  shared_lock<shared_timed_mutex> g(m_mutex);
+  return m_segments.size();
+}
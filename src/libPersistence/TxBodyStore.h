@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBPERSISTENCE_TXBODYSTORE_H_
+#define ZILLIQA_SRC_LIBPERSISTENCE_TXBODYSTORE_H_
+
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/BaseType.h"
+#include "depends/common/FixedHash.h"
+
+/// Append-only store of txn bodies, kept as a series of segment files.
+///
+/// Bodies are appended to the newest segment in the order they are put,
+/// which for a lookup is epoch order, so the bodies of an epoch sit next to
+/// each other and can be read back with one read per segment. A segment is
+/// sealed once it reaches the size limit, and a list of its records is then
+/// written next to it so that reopening the store does not have to scan it.
+/// Whole segments can be retired once their epochs are no longer needed.
+///
+/// Each record is hash (32) | epoch (8) | body length (4) | body. A deleted
+/// body is recorded as a record with no body and a length of TOMBSTONE.
+class TxBodyStore {
+ public:
+  using Bodies = std::vector<std::pair<dev::h256, bytes>>;
+
+  /// Opens the store in dir, creating dir if needed.
+  TxBodyStore(const std::string& dir, uint64_t maxSegmentSize);
+  ~TxBodyStore();
+
+  TxBodyStore(const TxBodyStore&) = delete;
+  TxBodyStore& operator=(const TxBodyStore&) = delete;
+
+  bool IsOpen() const;
+
+  /// Appends the bodies of the given epoch. A body put again replaces the
+  /// earlier one.
+  bool Put(uint64_t epochNum, const Bodies& bodies);
+  bool Get(const dev::h256& key, bytes& body) const;
+  bool Exists(const dev::h256& key) const;
+  bool Delete(const dev::h256& key);
+
+  /// Reads the bodies put for epochs loEpoch to hiEpoch, in put order.
+  bool GetRange(uint64_t loEpoch, uint64_t hiEpoch, Bodies& bodies) const;
+
+  /// Retires the oldest sealed segments as long as all their epochs are
+  /// below epochNum. They are moved to archiveDir, where they can be opened
+  /// as another store, or deleted if archiveDir is empty.
+  bool RetireSegmentsBefore(uint64_t epochNum, const std::string& archiveDir);
+
+  /// Deletes every segment.
+  bool Reset();
+
+  size_t GetNumBodies() const;
+  size_t GetNumSegments() const;
+
+ private:
+  struct Location {
+    uint32_t m_segment;
+    uint32_t m_length;
+    uint64_t m_offset;  // of the body
+  };
+
+  /// A run of records of the same epoch
+  struct Extent {
+    uint32_t m_segment;
+    uint64_t m_begin;
+    uint64_t m_end;
+  };
+
+  struct Record {
+    dev::h256 m_key;
+    uint64_t m_epochNum;
+    uint64_t m_offset;  // of the record
+    uint32_t m_length;
+  };
+
+  struct Segment {
+    int m_fd{-1};
+    uint64_t m_size{0};
+    uint64_t m_minEpoch{UINT64_MAX};
+    uint64_t m_maxEpoch{0};
+    bool m_sealed{false};
+    /// Records of the unsealed segment, written out when it is sealed
+    std::vector<Record> m_records;
+  };
+
+  const std::string m_dir;
+  const uint64_t m_maxSegmentSize;
+  bool m_open{false};
+
+  mutable std::shared_timed_mutex m_mutex;
+  std::map<uint32_t, Segment> m_segments;
+  std::unordered_map<dev::h256, Location> m_index;
+  std::map<uint64_t, std::vector<Extent>> m_extents;
+
+  std::string GetSegmentPath(uint32_t id) const;
+  std::string GetRecordsPath(uint32_t id) const;
+  bool Open();
+  void Close();
+  bool LoadSegment(uint32_t id, Segment& segment);
+  bool ScanSegment(uint32_t id, Segment& segment);
+  bool LoadRecords(uint32_t id, Segment& segment);
+  void ApplyRecord(uint32_t id, Segment& segment, const Record& record);
+  bool SealSegment(uint32_t id, Segment& segment);
+  bool StartSegment();
+  bool Append(const bytes& data);
+};
+
+#endif  // ZILLIQA_SRC_LIBPERSISTENCE_TXBODYSTORE_H_
@@ -0,0 +1,516 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+
+#include "TxnArchive.h"
+#include "common/Constants.h"
+#include "common/Serializable.h"
+#include "libUtils/Logger.h"
+#include "libUtils/Metrics.h"
+#include "libUtils/SysCommand.h"
+
+using namespace std;
+namespace bfs = boost::filesystem;
+
+namespace {
+const char SEGMENT_MAGIC[] = "ZTXA";
+const unsigned int MAGIC_LEN = 4;
+const uint32_t SEGMENT_VERSION = 1;
+const unsigned int UINT32_LEN = sizeof(uint32_t);
+const unsigned int UINT64_LEN = sizeof(uint64_t);
+const unsigned int HEADER_LEN = MAGIC_LEN + UINT32_LEN;
+const unsigned int FOOTER_LEN = UINT64_LEN + UINT32_LEN;
+const unsigned int INDEX_ENTRY_LEN = TxnHash::size + UINT64_LEN + UINT32_LEN;
+const string TMP_SUFFIX = ".tmp";
+
+void AppendNumber(bytes& dst, uint64_t value, unsigned int len) {
+  Serializable::SetNumber<uint64_t>(dst, dst.size(), value, len);
+}
+
+uint64_t ReadNumber(const bytes& src, uint64_t offset, unsigned int len) {
+  return Serializable::GetNumber<uint64_t>(src, offset, len);
+}
+
+/// Checks the magic and version at the start of the segment.
+bool CheckHeader(const bytes& header) {
+  if (header.size() < HEADER_LEN ||
+      memcmp(header.data(), SEGMENT_MAGIC, MAGIC_LEN) != 0 ||
+      ReadNumber(header, MAGIC_LEN, UINT32_LEN) != SEGMENT_VERSION) {
+    LOG_GENERAL(WARNING, "Not a txn archive segment");
+    return false;
+  }
+  return true;
+}
+
+/// Reads the footer found at footerPos in data, which is footerOffset into
+/// the segment, and returns where the index starts.
+bool ReadFooter(const bytes& data, uint64_t footerPos, uint64_t footerOffset,
+                uint64_t& indexOffset, uint32_t& numEntries) {
+  indexOffset = ReadNumber(data, footerPos, UINT64_LEN);
+  numEntries = ReadNumber(data, footerPos + UINT64_LEN, UINT32_LEN);
+  if (indexOffset < HEADER_LEN ||
+      indexOffset + uint64_t{numEntries} * INDEX_ENTRY_LEN != footerOffset) {
+    LOG_GENERAL(WARNING, "Corrupt txn archive segment index");
+    return false;
+  }
+  return true;
+}
+
+/// Checks the header and footer, and returns where the index starts.
+bool ReadIndexPosition(const bytes& segment, uint64_t& indexOffset,
+                       uint32_t& numEntries) {
+  if (segment.size() < HEADER_LEN + FOOTER_LEN) {
+    LOG_GENERAL(WARNING, "Not a txn archive segment");
+    return false;
+  }
+  if (!CheckHeader(segment)) {
+    return false;
+  }
+  const uint64_t footerOffset = segment.size() - FOOTER_LEN;
+  return ReadFooter(segment, footerOffset, footerOffset, indexOffset,
+                    numEntries);
+}
+
+/// Binary searches the index entries starting at indexPos in data.
+bool FindIndexEntry(const bytes& data, uint64_t indexPos, uint32_t numEntries,
+                    const TxnHash& txnHash, uint64_t& entryPos) {
+  uint32_t lo = 0, hi = numEntries;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    entryPos = indexPos + uint64_t{mid} * INDEX_ENTRY_LEN;
+    const int cmp =
+        memcmp(data.data() + entryPos, txnHash.data(), TxnHash::size);
+    if (cmp == 0) {
+      return true;
+    } else if (cmp < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return false;
+}
+
+/// Reads where the body of the index entry at entryPos in data lies,
+/// checking it is before the index.
+bool ReadBodyPosition(const bytes& data, uint64_t entryPos,
+                      uint64_t indexOffset, uint64_t& bodyOffset,
+                      uint64_t& bodyLen) {
+  bodyOffset = ReadNumber(data, entryPos + TxnHash::size, UINT64_LEN);
+  bodyLen = ReadNumber(data, entryPos + TxnHash::size + UINT64_LEN, UINT32_LEN);
+  if (bodyOffset < HEADER_LEN || bodyOffset + bodyLen > indexOffset) {
+    LOG_GENERAL(WARNING, "Corrupt txn archive segment index entry");
+    return false;
+  }
+  return true;
+}
+
+/// Reads the body of the given index entry of a whole segment.
+bool ReadBody(const bytes& segment, uint64_t indexOffset, uint64_t entryOffset,
+              bytes& body) {
+  uint64_t bodyOffset, bodyLen;
+  if (!ReadBodyPosition(segment, entryOffset, indexOffset, bodyOffset,
+                        bodyLen)) {
+    return false;
+  }
+  body.assign(segment.begin() + bodyOffset,
+              segment.begin() + bodyOffset + bodyLen);
+  return true;
+}
+}  // namespace
+
+bool TxnArchiveBackend::GetSegmentSize(const string& name, uint64_t& size) {
+  bytes segment;
+  if (!GetSegment(name, segment)) {
+    return false;
+  }
+  size = segment.size();
+  return true;
+}
+
+bool TxnArchiveBackend::GetSegmentRange(const string& name, uint64_t offset,
+                                        uint64_t len, bytes& data) {
+  bytes segment;
+  if (!GetSegment(name, segment) || offset + len > segment.size()) {
+    return false;
+  }
+  data.assign(segment.begin() + offset, segment.begin() + offset + len);
+  return true;
+}
+
+LocalTxnArchiveBackend::LocalTxnArchiveBackend(string dir)
+    : m_dir(move(dir)) {
+  boost::system::error_code ec;
+  bfs::create_directories(m_dir, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING,
+                "Failed to create txn archive dir " << m_dir << ": "
+                                                    << ec.message());
+  }
+}
+
+string LocalTxnArchiveBackend::GetPath(const string& name) const {
+  return (bfs::path(m_dir) / name).string();
+}
+
+bool LocalTxnArchiveBackend::PutSegment(const string& name,
+                                        const bytes& segment) {
+  // Write aside and rename, so that readers never see half a segment
+  const string path = GetPath(name);
+  {
+    ofstream file(path + TMP_SUFFIX, ios::binary | ios::trunc);
+    file.write(reinterpret_cast<const char*>(segment.data()), segment.size());
+    if (!file) {
+      LOG_GENERAL(WARNING, "Failed to write txn archive segment " << path);
+      return false;
+    }
+  }
+  boost::system::error_code ec;
+  bfs::rename(path + TMP_SUFFIX, path, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to rename txn archive segment "
+                             << path << ": " << ec.message());
+    return false;
+  }
+  return true;
+}
+
+bool LocalTxnArchiveBackend::GetSegment(const string& name, bytes& segment) {
+  ifstream file(GetPath(name), ios::binary | ios::ate);
+  if (!file) {
+    return false;
+  }
+  segment.resize(file.tellg());
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(segment.data()), segment.size());
+  return static_cast<bool>(file);
+}
+
+bool LocalTxnArchiveBackend::GetSegmentSize(const string& name,
+                                            uint64_t& size) {
+  boost::system::error_code ec;
+  size = bfs::file_size(GetPath(name), ec);
+  return !ec;
+}
+
+bool LocalTxnArchiveBackend::GetSegmentRange(const string& name,
+                                             uint64_t offset, uint64_t len,
+                                             bytes& data) {
+  ifstream file(GetPath(name), ios::binary);
+  if (!file) {
+    return false;
+  }
+  data.resize(len);
+  file.seekg(offset);
+  file.read(reinterpret_cast<char*>(data.data()), len);
+  return static_cast<bool>(file);
+}
+
+bool LocalTxnArchiveBackend::ListSegments(vector<string>& names) {
+  names.clear();
+  boost::system::error_code ec;
+  for (bfs::directory_iterator it(m_dir, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    const string name = it->path().filename().string();
+    if (bfs::is_regular_file(it->status()) &&
+        !boost::algorithm::ends_with(name, TMP_SUFFIX)) {
+      names.emplace_back(name);
+    }
+  }
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to list txn archive dir " << m_dir << ": "
+                                                           << ec.message());
+    return false;
+  }
+  sort(names.begin(), names.end());
+  return true;
+}
+
+S3TxnArchiveBackend::S3TxnArchiveBackend(string stagingDir,
+                                         const string& bucketName,
+                                         const string& folderName,
+                                         bool keepLocalCopy)
+    : LocalTxnArchiveBackend(move(stagingDir)),
+      m_destination("s3://" + bucketName + "/" + folderName + "/"),
+      m_keepLocalCopy(keepLocalCopy) {}
+
+bool S3TxnArchiveBackend::PutSegment(const string& name,
+                                     const bytes& segment) {
+  if (!LocalTxnArchiveBackend::PutSegment(name, segment)) {
+    return false;
+  }
+  const string path = GetPath(name);
+  const bool uploaded = SysCommand::ExecuteCmd(
+      SysCommand::WITHOUT_OUTPUT, "aws s3 cp " + path + " " + m_destination);
+  if (!uploaded) {
+    LOG_GENERAL(WARNING, "Failed to upload txns file :" << path);
+  } else {
+    LOG_GENERAL(DEBUG, "upload txns file : " << path << " successfully");
+  }
+  if (!m_keepLocalCopy) {
+    boost::system::error_code ec;
+    bfs::remove(path, ec);
+  }
+  return uploaded;
+}
+
+void TxnArchive::BuildSegment(const ArchivedTxns& txns, bytes& segment) {
+  size_t bodiesLen = 0;
+  for (const auto& txn : txns) {
+    bodiesLen += txn.second.size();
+  }
+  segment.clear();
+  segment.reserve(HEADER_LEN + bodiesLen + txns.size() * INDEX_ENTRY_LEN +
+                  FOOTER_LEN);
+
+  segment.insert(segment.end(), SEGMENT_MAGIC, SEGMENT_MAGIC + MAGIC_LEN);
+  AppendNumber(segment, SEGMENT_VERSION, UINT32_LEN);
+
+  vector<uint64_t> offsets;
+  offsets.reserve(txns.size());
+  for (const auto& txn : txns) {
+    offsets.emplace_back(segment.size());
+    segment.insert(segment.end(), txn.second.begin(), txn.second.end());
+  }
+
+  vector<size_t> order(txns.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  sort(order.begin(), order.end(), [&txns](size_t a, size_t b) {
+    return txns[a].first < txns[b].first;
+  });
+
+  const uint64_t indexOffset = segment.size();
+  for (const auto i : order) {
+    segment.insert(segment.end(), txns[i].first.begin(), txns[i].first.end());
+    AppendNumber(segment, offsets[i], UINT64_LEN);
+    AppendNumber(segment, txns[i].second.size(), UINT32_LEN);
+  }
+  AppendNumber(segment, indexOffset, UINT64_LEN);
+  AppendNumber(segment, txns.size(), UINT32_LEN);
+}
+
+bool TxnArchive::FindTxn(const bytes& segment, const TxnHash& txnHash,
+                         bytes& body) {
+  uint64_t indexOffset;
+  uint32_t numEntries;
+  if (!ReadIndexPosition(segment, indexOffset, numEntries)) {
+    return false;
+  }
+
+  uint64_t entryOffset;
+  return FindIndexEntry(segment, indexOffset, numEntries, txnHash,
+                        entryOffset) &&
+         ReadBody(segment, indexOffset, entryOffset, body);
+}
+
+bool TxnArchive::ReadAllTxns(const bytes& segment, ArchivedTxns& txns) {
+  uint64_t indexOffset;
+  uint32_t numEntries;
+  if (!ReadIndexPosition(segment, indexOffset, numEntries)) {
+    return false;
+  }
+
+  txns.clear();
+  txns.reserve(numEntries);
+  for (uint32_t i = 0; i < numEntries; i++) {
+    const uint64_t entryOffset = indexOffset + uint64_t{i} * INDEX_ENTRY_LEN;
+    txns.emplace_back(
+        TxnHash(segment.data() + entryOffset, TxnHash::ConstructFromPointer),
+        bytes());
+    if (!ReadBody(segment, indexOffset, entryOffset, txns.back().second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TxnArchive::ReadLegacyTxns(const bytes& data, ArchivedTxns& txns) {
+  txns.clear();
+  size_t offset = 0;
+  auto readLen = [&data, &offset](size_t& len) {
+    if (data.size() - offset < sizeof(len)) {
+      return false;
+    }
+    memcpy(&len, data.data() + offset, sizeof(len));
+    offset += sizeof(len);
+    return len <= data.size() - offset;
+  };
+
+  while (offset < data.size()) {
+    size_t hashLen, bodyLen;
+    if (!readLen(hashLen) || hashLen != TxnHash::size) {
+      LOG_GENERAL(WARNING, "Corrupt legacy txns file");
+      return false;
+    }
+    TxnHash txnHash(data.data() + offset, TxnHash::ConstructFromPointer);
+    offset += hashLen;
+    if (!readLen(bodyLen)) {
+      LOG_GENERAL(WARNING, "Corrupt legacy txns file");
+      return false;
+    }
+    txns.emplace_back(txnHash, bytes(data.begin() + offset,
+                                     data.begin() + offset + bodyLen));
+    offset += bodyLen;
+  }
+  return true;
+}
+
+bool TxnArchive::ReadSegmentOrLegacyTxns(const bytes& data,
+                                         ArchivedTxns& txns) {
+  if (data.size() >= MAGIC_LEN &&
+      memcmp(data.data(), SEGMENT_MAGIC, MAGIC_LEN) == 0) {
+    return ReadAllTxns(data, txns);
+  }
+  return ReadLegacyTxns(data, txns);
+}
+
+shared_ptr<TxnArchiveBackend> TxnArchive::CreateBackendFromConstants() {
+  if (TXN_ARCHIVE_BACKEND == "local") {
+    return make_shared<LocalTxnArchiveBackend>(TXN_ARCHIVE_PATH);
+  }
+  if (TXN_ARCHIVE_BACKEND == "s3") {
+    return make_shared<S3TxnArchiveBackend>(TXN_ARCHIVE_PATH, BUCKET_NAME,
+                                            TXN_PERSISTENCE_NAME,
+                                            SHARDLDR_SAVE_TXN_LOCALLY);
+  }
+  LOG_GENERAL(WARNING, "Unknown TXN_ARCHIVE_BACKEND " << TXN_ARCHIVE_BACKEND);
+  return nullptr;
+}
+
+TxnArchive::TxnArchive(shared_ptr<TxnArchiveBackend> backend,
+                       size_t maxPending)
+    : m_backend(move(backend)), m_maxPending(maxPending) {
+  m_writer = thread([this]() { WriterLoop(); });
+}
+
+TxnArchive::~TxnArchive() { Stop(); }
+
+bool TxnArchive::Archive(string segmentName, ArchivedTxns txns) {
+  lock_guard<mutex> g(m_mutex);
+  if (m_stopping || m_pending.size() >= m_maxPending) {
+    static auto& dropped = Metrics::GetInstance().GetCounter(
+        "zilliqa_txn_archive_dropped_total");
+    dropped.Increment();
+    m_stats.m_dropped++;
+    LOG_GENERAL(WARNING, "Txn archive writer behind, dropped segment "
+                             << segmentName);
+    return false;
+  }
+  m_pending.emplace_back(move(segmentName), move(txns));
+  m_cvWriter.notify_one();
+  return true;
+}
+
+bool TxnArchive::WaitUntilIdle(const chrono::milliseconds& timeout) {
+  unique_lock<mutex> g(m_mutex);
+  return m_cvIdle.wait_for(
+      g, timeout, [this]() { return m_pending.empty() && !m_writing; });
+}
+
+void TxnArchive::Stop() {
+  {
+    lock_guard<mutex> g(m_mutex);
+    m_stopping = true;
+    m_cvWriter.notify_one();
+  }
+  if (m_writer.joinable()) {
+    m_writer.join();
+  }
+}
+
+bool TxnArchive::GetTxn(const string& segmentName, const TxnHash& txnHash,
+                        bytes& body) {
+  uint64_t size;
+  bytes header, footer;
+  if (!m_backend->GetSegmentSize(segmentName, size)) {
+    return false;
+  }
+  if (size < HEADER_LEN + FOOTER_LEN ||
+      !m_backend->GetSegmentRange(segmentName, 0, HEADER_LEN, header) ||
+      !CheckHeader(header) ||
+      !m_backend->GetSegmentRange(segmentName, size - FOOTER_LEN, FOOTER_LEN,
+                                  footer)) {
+    LOG_GENERAL(WARNING, "Failed to read txn archive segment " << segmentName);
+    return false;
+  }
+
+  uint64_t indexOffset;
+  uint32_t numEntries;
+  bytes index;
+  if (!ReadFooter(footer, 0, size - FOOTER_LEN, indexOffset, numEntries) ||
+      !m_backend->GetSegmentRange(segmentName, indexOffset,
+                                  uint64_t{numEntries} * INDEX_ENTRY_LEN,
+                                  index)) {
+    return false;
+  }
+
+  uint64_t entryPos, bodyOffset, bodyLen;
+  return FindIndexEntry(index, 0, numEntries, txnHash, entryPos) &&
+         ReadBodyPosition(index, entryPos, indexOffset, bodyOffset,
+                          bodyLen) &&
+         m_backend->GetSegmentRange(segmentName, bodyOffset, bodyLen, body);
+}
+
+TxnArchive::Stats TxnArchive::GetStats() const {
+  lock_guard<mutex> g(m_mutex);
+  return m_stats;
+}
+
+void TxnArchive::WriterLoop() {
+  static auto& writeTime =
+      Metrics::GetInstance().GetHistogram("zilliqa_txn_archive_write_us");
+
+  unique_lock<mutex> g(m_mutex);
+  while (true) {
+    m_cvWriter.wait(g, [this]() { return m_stopping || !m_pending.empty(); });
+    if (m_pending.empty()) {
+      break;
+    }
+
+    auto next = move(m_pending.front());
+    m_pending.pop_front();
+    m_writing = true;
+    g.unlock();
+
+    bool written;
+    {
+      Metrics::ScopedTimer timer(writeTime);
+      bytes segment;
+      BuildSegment(next.second, segment);
+      written = m_backend->PutSegment(next.first, segment);
+    }
+
+    g.lock();
+    m_writing = false;
+    if (written) {
+      m_stats.m_written++;
+    } else {
+      m_stats.m_failed++;
+    }
+    if (m_pending.empty()) {
+      m_cvIdle.notify_all();
+    }
+  }
+}
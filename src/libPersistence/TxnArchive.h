@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBPERSISTENCE_TXNARCHIVE_H_
+#define ZILLIQA_SRC_LIBPERSISTENCE_TXNARCHIVE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/BaseType.h"
+#include "libData/AccountData/Transaction.h"
+
+using ArchivedTxns = std::vector<std::pair<TxnHash, bytes>>;
+
+/// Where TxnArchive puts its segments, one segment per named blob.
+class TxnArchiveBackend {
+ public:
+  virtual ~TxnArchiveBackend() {}
+
+  virtual bool PutSegment(const std::string& name, const bytes& segment) = 0;
+  virtual bool GetSegment(const std::string& name, bytes& segment) = 0;
+  virtual bool ListSegments(std::vector<std::string>& names) = 0;
+
+  /// Reads len bytes at offset into the segment. Backends that can seek
+  /// should override these two; the defaults fetch the whole segment.
+  virtual bool GetSegmentSize(const std::string& name, uint64_t& size);
+  virtual bool GetSegmentRange(const std::string& name, uint64_t offset,
+                               uint64_t len, bytes& data);
+};
+
+/// Keeps the segments as files in a local directory.
+class LocalTxnArchiveBackend : public TxnArchiveBackend {
+ protected:
+  const std::string m_dir;
+
+  std::string GetPath(const std::string& name) const;
+
+ public:
+  explicit LocalTxnArchiveBackend(std::string dir);
+
+  bool PutSegment(const std::string& name, const bytes& segment) override;
+  bool GetSegment(const std::string& name, bytes& segment) override;
+  bool ListSegments(std::vector<std::string>& names) override;
+  bool GetSegmentSize(const std::string& name, uint64_t& size) override;
+  bool GetSegmentRange(const std::string& name, uint64_t offset, uint64_t len,
+                       bytes& data) override;
+};
+
+/// Stages the segments in a local directory and copies them to an S3 bucket
+/// folder. Only the staged segments can be read back or listed.
+class S3TxnArchiveBackend : public LocalTxnArchiveBackend {
+  const std::string m_destination;
+  const bool m_keepLocalCopy;
+
+ public:
+  S3TxnArchiveBackend(std::string stagingDir, const std::string& bucketName,
+                      const std::string& folderName, bool keepLocalCopy);
+
+  bool PutSegment(const std::string& name, const bytes& segment) override;
+};
+
+/// Archives the txns processed in an epoch as one segment, written by a
+/// background thread so that the caller never waits on the backend.
+///
+/// A segment holds the txn bodies back to back followed by an index sorted
+/// by txn hash, so that a single txn can be found without parsing the rest:
+///   "ZTXA" | version (4) | bodies | index entries | index offset (8) |
+///   entry count (4)
+/// where an index entry is hash (32) | body offset (8) | body length (4).
+class TxnArchive {
+ public:
+  struct Stats {
+    uint64_t m_written{};
+    uint64_t m_failed{};
+    uint64_t m_dropped{};
+  };
+
+  static void BuildSegment(const ArchivedTxns& txns, bytes& segment);
+  static bool FindTxn(const bytes& segment, const TxnHash& txnHash,
+                      bytes& body);
+  static bool ReadAllTxns(const bytes& segment, ArchivedTxns& txns);
+  /// Reads a txns file uploaded before segments were introduced, where each
+  /// txn is hash length | hash | body length | body, lengths as size_t.
+  static bool ReadLegacyTxns(const bytes& data, ArchivedTxns& txns);
+  /// Reads a segment, or a legacy txns file if the segment header is absent.
+  static bool ReadSegmentOrLegacyTxns(const bytes& data, ArchivedTxns& txns);
+
+  /// Creates the backend named by TXN_ARCHIVE_BACKEND.
+  static std::shared_ptr<TxnArchiveBackend> CreateBackendFromConstants();
+
+  TxnArchive(std::shared_ptr<TxnArchiveBackend> backend, size_t maxPending);
+  ~TxnArchive();
+
+  TxnArchive(const TxnArchive&) = delete;
+  TxnArchive& operator=(const TxnArchive&) = delete;
+
+  /// Hands the txns over to the writer. Does not block; returns false if the
+  /// writer is too far behind and the segment was dropped.
+  bool Archive(std::string segmentName, ArchivedTxns txns);
+
+  /// Blocks until every segment handed over so far has been written or has
+  /// failed. Returns false on timeout.
+  bool WaitUntilIdle(const std::chrono::milliseconds& timeout);
+
+  /// Writes the pending segments and stops the writer.
+  void Stop();
+
+  /// Reads only the footer, the index and the one body from the backend.
+  bool GetTxn(const std::string& segmentName, const TxnHash& txnHash,
+              bytes& body);
+
+  Stats GetStats() const;
+
+ private:
+  const std::shared_ptr<TxnArchiveBackend> m_backend;
+  const size_t m_maxPending;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cvWriter;
+  std::condition_variable m_cvIdle;
+  std::deque<std::pair<std::string, ArchivedTxns>> m_pending;
+  bool m_writing{false};
+  bool m_stopping{false};
+  Stats m_stats;
+  std::thread m_writer;
+
+  void WriterLoop();
+};
+
+#endif  // ZILLIQA_SRC_LIBPERSISTENCE_TXNARCHIVE_H_
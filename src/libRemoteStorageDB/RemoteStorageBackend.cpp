@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <thread>
+
+#include "RemoteStorageBackend.h"
+
+using namespace std;
+
+bool MemoryRemoteStorageBackend::Write(const vector<RemoteStorageOp>& ops) {
+  m_numWrites++;
+  if (m_latencyMs > 0) {
+    this_thread::sleep_for(chrono::milliseconds(m_latencyMs));
+  }
+
+  unsigned int failuresLeft = m_failuresLeft;
+  while (failuresLeft > 0 &&
+         !m_failuresLeft.compare_exchange_weak(failuresLeft,
+                                               failuresLeft - 1)) {
+  }
+  if (failuresLeft > 0) {
+    return false;
+  }
+
+  lock_guard<mutex> g(m_mutex);
+  for (const auto& op : ops) {
+    auto it = m_documents.find(op.m_txnHash);
+    if (op.m_type == RemoteStorageOp::INSERT) {
+      if (it == m_documents.end()) {
+        m_documents.emplace(op.m_txnHash, op.m_fields);
+      }
+    } else if (it != m_documents.end() &&
+               it->second["modificationState"].asInt() <=
+                   op.m_modificationState) {
+      for (const auto& name : op.m_fields.getMemberNames()) {
+        it->second[name] = op.m_fields[name];
+      }
+    }
+  }
+  return true;
+}
+
+Json::Value MemoryRemoteStorageBackend::Get(const string& txnHash) const {
+  lock_guard<mutex> g(m_mutex);
+  const auto it = m_documents.find(txnHash);
+  return it == m_documents.end() ? Json::Value::null : it->second;
+}
+
+size_t MemoryRemoteStorageBackend::GetNumDocuments() const {
+  lock_guard<mutex> g(m_mutex);
+  return m_documents.size();
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBREMOTESTORAGEDB_REMOTESTORAGEBACKEND_H_
+#define ZILLIQA_SRC_LIBREMOTESTORAGEDB_REMOTESTORAGEBACKEND_H_
+
+#include <json/json.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// A pending write of a txn status document.
+struct RemoteStorageOp {
+  enum Type { INSERT, UPDATE };
+
+  Type m_type{INSERT};
+  std::string m_txnHash;
+  /// An INSERT of an existing txn is ignored. An UPDATE is applied only if
+  /// the stored document is at this state or an earlier one.
+  int m_modificationState{0};
+  /// The whole document for INSERT, the fields to set for UPDATE
+  Json::Value m_fields;
+};
+
+/// Where RemoteStorageDB sends its writes.
+class RemoteStorageBackend {
+ public:
+  virtual ~RemoteStorageBackend() {}
+
+  /// Applies the ops as one batch. Must be safe to repeat after a failure,
+  /// as a failed batch is retried whole.
+  virtual bool Write(const std::vector<RemoteStorageOp>& ops) = 0;
+};
+
+/// In-memory stand-in with the same semantics as the Mongo backend, for tests
+/// and benchmarks. Writes can be slowed down or made to fail.
+class MemoryRemoteStorageBackend : public RemoteStorageBackend {
+  mutable std::mutex m_mutex;
+  std::map<std::string, Json::Value> m_documents;
+  std::atomic<unsigned int> m_latencyMs{0};
+  std::atomic<unsigned int> m_failuresLeft{0};
+  std::atomic<uint64_t> m_numWrites{0};
+
+ public:
+  bool Write(const std::vector<RemoteStorageOp>& ops) override;
+
+  /// The stored document, null if there is none.
+  Json::Value Get(const std::string& txnHash) const;
+  size_t GetNumDocuments() const;
+  uint64_t GetNumWrites() const { return m_numWrites; }
+
+  void SetLatency(unsigned int latencyMs) { m_latencyMs = latencyMs; }
+  /// The next numFailures writes fail without applying anything.
+  void FailNextWrites(unsigned int numFailures) {
+    m_failuresLeft = numFailures;
+  }
+};
+
+#endif  // ZILLIQA_SRC_LIBREMOTESTORAGEDB_REMOTESTORAGEBACKEND_H_
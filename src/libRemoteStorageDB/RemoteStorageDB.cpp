@@ -39,6 +39,65 @@ ModificationState RemoteStorageDB::GetModificationState(
   }
 }
 
+namespace {
+/// Sends each batch as one unordered bulk write. Inserts are upserts that
+/// leave an existing document alone, so that a retried batch is harmless.
+class MongoRemoteStorageBackend : public RemoteStorageBackend {
+  const shared_ptr<mongocxx::pool> m_pool;
+  const string m_dbName;
+  const string m_collectionName;
+
+ public:
+  MongoRemoteStorageBackend(shared_ptr<mongocxx::pool> pool, string dbName,
+                            string collectionName)
+      : m_pool(move(pool)),
+        m_dbName(move(dbName)),
+        m_collectionName(move(collectionName)) {}
+
+  bool Write(const vector<RemoteStorageOp>& ops) override {
+    try {
+      const auto& conn = m_pool->acquire();
+      auto txnCollection = conn->database(m_dbName)[m_collectionName];
+      mongocxx::options::bulk_write bulk_opts;
+      bulk_opts.ordered(false);
+      auto bulk = txnCollection.create_bulk_write(bulk_opts);
+
+      for (const auto& op : ops) {
+        const auto& fields = bsoncxx::from_json(op.m_fields.toStyledString());
+        if (op.m_type == RemoteStorageOp::INSERT) {
+          mongocxx::model::update_one upsert_op{
+              make_document(kvp("ID", op.m_txnHash)),
+              make_document(kvp("$setOnInsert", fields.view()))};
+          upsert_op.upsert(true);
+          bulk.append(upsert_op);
+        } else {
+          mongocxx::model::update_one update_op{
+              make_document(kvp("ID", op.m_txnHash),
+                            kvp("modificationState",
+                                make_document(
+                                    kvp("$lte", op.m_modificationState)))),
+              make_document(kvp("$set", fields.view()))};
+          bulk.append(update_op);
+        }
+      }
+
+      const auto& res = bulk.execute();
+      if (!res) {
+        LOG_GENERAL(WARNING, "Failed to ExecuteWrite");
+        return false;
+      }
+      LOG_GENERAL(INFO, "Inserted " << res.value().upserted_count()
+                                    << " & Updated "
+                                    << res.value().modified_count());
+      return true;
+    } catch (exception& e) {
+      LOG_GENERAL(WARNING, "Failed to write bulk " << e.what());
+      return false;
+    }
+  }
+};
+}  // namespace
+
 pair<string, string> getCreds() {
   string username, password;
   if (const char* env_p = getenv("ZIL_DB_USERNAME")) {
@@ -86,17 +145,11 @@ void RemoteStorageDB::Init(bool reset) {
       LOG_GENERAL(INFO, "ServerSelectionTimeoutInMS: "
                             << URI.server_selection_timeout_ms().value());
     }
-    m_pool = bsoncxx::stdx::make_unique<mongocxx::pool>(move(URI));
-    mongocxx::options::bulk_write bulk_opts;
-    bulk_opts.ordered(false);
-    const auto& conn = GetConnection();
-    auto txnCollection = conn->database(m_dbName)[m_txnCollectionName];
-    auto bulk = bsoncxx::stdx::make_unique<mongocxx::bulk_write>(
-        txnCollection.create_bulk_write(bulk_opts));
-    {
-      lock_guard<mutex> g(m_mutexBulkWrite);
-      m_bulkWrite = move(bulk);
-    }
+    // The old queue keeps the old pool alive until it has sent what it holds
+    auto pool = make_shared<mongocxx::pool>(move(URI));
+    StartWriteQueue(make_shared<MongoRemoteStorageBackend>(
+        pool, m_dbName, m_txnCollectionName));
+    m_pool = move(pool);
     m_initialized = true;
   } catch (exception& e) {
     LOG_GENERAL(WARNING, "Failed to initialize DB: " << e.what());
@@ -104,6 +157,74 @@ void RemoteStorageDB::Init(bool reset) {
   }
 }
 
+void RemoteStorageDB::InitWithBackend(
+    shared_ptr<RemoteStorageBackend> backend) {
+  StartWriteQueue(move(backend));
+  m_initialized = true;
+}
+
+void RemoteStorageDB::StartWriteQueue(
+    shared_ptr<RemoteStorageBackend> backend) {
+  RemoteStorageQueue::Options options;
+  options.m_maxQueued = REMOTESTORAGE_DB_QUEUE_SIZE;
+  options.m_batchSize = REMOTESTORAGE_DB_BATCH_SIZE;
+  options.m_batchInterval =
+      chrono::milliseconds(REMOTESTORAGE_DB_BATCH_INTERVAL_MS);
+  if (!RemoteStorageQueue::ParseOverflowPolicy(
+          REMOTESTORAGE_DB_OVERFLOW_POLICY, options.m_overflowPolicy)) {
+    LOG_GENERAL(WARNING, "Unknown REMOTESTORAGE_DB_OVERFLOW_POLICY "
+                             << REMOTESTORAGE_DB_OVERFLOW_POLICY
+                             << ", using block");
+  }
+  options.m_maxRetries = REMOTESTORAGE_DB_MAX_RETRIES;
+  options.m_retryBackoff =
+      chrono::milliseconds(REMOTESTORAGE_DB_RETRY_BACKOFF_MS);
+  {
+    lock_guard<mutex> g(m_mutexNumWriteQueues);
+    m_numWriteQueues++;
+  }
+  shared_ptr<RemoteStorageQueue> writeQueue(
+      new RemoteStorageQueue(move(backend), options),
+      [this](RemoteStorageQueue* queue) { ReleaseWriteQueue(queue); });
+  {
+    lock_guard<mutex> g(m_mutexWriteQueue);
+    m_writeQueue.swap(writeQueue);
+  }
+}
+
+void RemoteStorageDB::ReleaseWriteQueue(RemoteStorageQueue* writeQueue) {
+  // The last user of a replaced queue may be the block commit path, which
+  // must not wait for the queue to send its ops and join its writer
+  auto release = [this, writeQueue]() {
+    delete writeQueue;
+    lock_guard<mutex> g(m_mutexNumWriteQueues);
+    m_numWriteQueues--;
+    m_cvNumWriteQueues.notify_all();
+  };
+
+  try {
+    thread(release).detach();
+  } catch (const system_error& e) {
+    LOG_GENERAL(WARNING, "Failed to start write queue release thread: "
+                             << e.what());
+    release();
+  }
+}
+
+RemoteStorageDB::~RemoteStorageDB() {
+  {
+    lock_guard<mutex> g(m_mutexWriteQueue);
+    m_writeQueue.reset();
+  }
+  unique_lock<mutex> g(m_mutexNumWriteQueues);
+  m_cvNumWriteQueues.wait(g, [this]() { return m_numWriteQueues == 0; });
+}
+
+shared_ptr<RemoteStorageQueue> RemoteStorageDB::GetWriteQueue() const {
+  lock_guard<mutex> g(m_mutexWriteQueue);
+  return m_writeQueue;
+}
+
 inline mongoConnection RemoteStorageDB::GetConnection() {
   return m_pool->acquire();
 }
@@ -116,30 +237,19 @@ bool RemoteStorageDB::InsertTxn(const Transaction& txn, const TxnStatus status,
     LOG_GENERAL(WARNING, "DB not initialized");
     return false;
   }
-  Json::Value tx_json = JSONConversion::convertTxtoJson(txn);
-  tx_json["status"] = static_cast<int>(status);
-  tx_json["success"] = success;
-  tx_json["epochInserted"] = to_string(epoch);
-  tx_json["epochUpdated"] = to_string(epoch);
-  tx_json["lastModified"] = to_string(get_time_as_int());
-  tx_json["modificationState"] = static_cast<int>(GetModificationState(status));
-
-  try {
-    const bsoncxx::document::value& doc_val =
-        bsoncxx::from_json(tx_json.toStyledString());
-
-    mongocxx::model::insert_one insert_op{doc_val.view()};
-    {
-      lock_guard<mutex> g(m_mutexBulkWrite);
-      m_bulkWrite->append(insert_op);
-      m_bulkWriteEmpty = false;
-    }
-  } catch (exception& e) {
-    LOG_GENERAL(WARNING, "Failed to InsertTxn " << e.what());
-    return false;
-  }
+  RemoteStorageOp op;
+  op.m_type = RemoteStorageOp::INSERT;
+  op.m_fields = JSONConversion::convertTxtoJson(txn);
+  op.m_fields["status"] = static_cast<int>(status);
+  op.m_fields["success"] = success;
+  op.m_fields["epochInserted"] = to_string(epoch);
+  op.m_fields["epochUpdated"] = to_string(epoch);
+  op.m_fields["lastModified"] = to_string(get_time_as_int());
+  op.m_modificationState = static_cast<int>(GetModificationState(status));
+  op.m_fields["modificationState"] = op.m_modificationState;
+  op.m_txnHash = op.m_fields["ID"].asString();
 
-  return true;
+  return PushWrite(move(op));
 }
 
 bool RemoteStorageDB::ExecuteWrite() {
@@ -148,43 +258,40 @@ bool RemoteStorageDB::ExecuteWrite() {
     LOG_GENERAL(WARNING, "DB not initialized");
     return false;
   }
+  GetWriteQueue()->Flush();
+  return true;
+}
 
-  auto resetBulkWrite = [this]() mutable {
-    mongocxx::options::bulk_write bulk_opts;
-    m_bulkWrite.reset(nullptr);
-    bulk_opts.ordered(false);
-    const auto& conn = GetConnection();
-    auto txnCollection = conn->database(m_dbName)[m_txnCollectionName];
-    auto bulk = bsoncxx::stdx::make_unique<mongocxx::bulk_write>(
-        txnCollection.create_bulk_write(bulk_opts));
-    m_bulkWrite = move(bulk);
-    m_bulkWriteEmpty = true;
-  };
-  lock_guard<mutex> g(m_mutexBulkWrite);
-  if (m_bulkWriteEmpty) {
-    LOG_GENERAL(INFO, "No txns for RemoteStorageDB");
-    return true;
+bool RemoteStorageDB::WaitUntilWritten(unsigned int timeoutMs) {
+  if (!m_initialized) {
+    LOG_GENERAL(WARNING, "DB not initialized");
+    return false;
   }
-  try {
-    const auto& res = m_bulkWrite->execute();
-
-    if (!res) {
-      LOG_GENERAL(WARNING, "Failed to ExecuteWrite");
-      resetBulkWrite();
+  const auto deadline =
+      chrono::steady_clock::now() + chrono::milliseconds(timeoutMs);
+  {
+    unique_lock<mutex> g(m_mutexNumWriteQueues);
+    if (!m_cvNumWriteQueues.wait_until(
+            g, deadline, [this]() { return m_numWriteQueues <= 1; })) {
       return false;
     }
+  }
+  return GetWriteQueue()->WaitUntilIdle(
+      chrono::duration_cast<chrono::milliseconds>(
+          deadline - chrono::steady_clock::now()));
+}
 
-    LOG_GENERAL(INFO, "Inserted " << res.value().inserted_count()
-                                  << " & Updated "
-                                  << res.value().modified_count());
+RemoteStorageQueue::Stats RemoteStorageDB::GetWriteStats() const {
+  const auto writeQueue = GetWriteQueue();
+  return writeQueue ? writeQueue->GetStats() : RemoteStorageQueue::Stats();
+}
 
-    resetBulkWrite();
-    return true;
-  } catch (exception& e) {
-    LOG_GENERAL(WARNING, "Failed to write bulk " << e.what());
-    resetBulkWrite();
+bool RemoteStorageDB::PushWrite(RemoteStorageOp op) {
+  if (!GetWriteQueue()->Push(move(op))) {
+    LOG_GENERAL(WARNING, "Remote storage write queue full, dropped write");
     return false;
   }
+  return true;
 }
 
 inline bsoncxx::stdx::optional<mongoConnection>
@@ -198,30 +305,17 @@ bool RemoteStorageDB::UpdateTxn(const string& txnhash, const TxnStatus status,
     LOG_GENERAL(WARNING, "DB not initialized");
     return false;
   }
-  const auto& modifState = static_cast<int>(GetModificationState(status));
-  try {
-    const auto& currentTime = to_string(get_time_as_int());
-    const auto& query_doc = make_document(
-        kvp("ID", txnhash),
-        kvp("modificationState", make_document(kvp("$lte", modifState))));
-    const auto& doc = make_document(
-        kvp("$set", make_document(kvp("status", static_cast<int>(status)),
-                                  kvp("success", success),
-                                  kvp("epochUpdated", to_string(epoch)),
-                                  kvp("lastModified", currentTime),
-                                  kvp("modificationState", modifState))));
-
-    mongocxx::model::update_one update_op{query_doc.view(), doc.view()};
-    {
-      lock_guard<mutex> g(m_mutexBulkWrite);
-      m_bulkWrite->append(update_op);
-      m_bulkWriteEmpty = false;
-    }
-  } catch (exception& e) {
-    LOG_GENERAL(WARNING, "Failed to UpdateTxn " << txnhash << " " << e.what());
-    return false;
-  }
-  return true;
+  RemoteStorageOp op;
+  op.m_type = RemoteStorageOp::UPDATE;
+  op.m_txnHash = txnhash;
+  op.m_modificationState = static_cast<int>(GetModificationState(status));
+  op.m_fields["status"] = static_cast<int>(status);
+  op.m_fields["success"] = success;
+  op.m_fields["epochUpdated"] = to_string(epoch);
+  op.m_fields["lastModified"] = to_string(get_time_as_int());
+  op.m_fields["modificationState"] = op.m_modificationState;
+
+  return PushWrite(move(op));
 }
 
 bool RemoteStorageDB::InsertJson(const Json::Value& _json,
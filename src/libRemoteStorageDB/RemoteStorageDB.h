@@ -18,6 +18,10 @@
 #ifndef ZILLIQA_SRC_LIBREMOTESTORAGEDB_REMOTESTORAGEDB_H_
 #define ZILLIQA_SRC_LIBREMOTESTORAGEDB_REMOTESTORAGEDB_H_
 
+#include <condition_variable>
+#include <mutex>
+
+#include "RemoteStorageQueue.h"
 #include "common/TxnStatus.h"
 #include "libData/AccountData/Account.h"
 #include "libData/AccountData/Transaction.h"
@@ -35,23 +39,33 @@ enum class ModificationState {
 };
 
 class RemoteStorageDB : public Singleton<RemoteStorageDB> {
-  std::unique_ptr<mongocxx::pool> m_pool;
+  // Shared with the write queue's backend, which may outlive a reset
+  std::shared_ptr<mongocxx::pool> m_pool;
   std::unique_ptr<mongocxx::instance> m_inst;
   bool m_initialized;
-  bool m_bulkWriteEmpty;
   const std::string m_dbName;
   const std::string m_txnCollectionName;
-  std::unique_ptr<mongocxx::bulk_write> m_bulkWrite;
-  std::mutex m_mutexBulkWrite;
+  // Replaced by Init(reset) while txn writes may be pushed, so it is only
+  // used through GetWriteQueue
+  std::shared_ptr<RemoteStorageQueue> m_writeQueue;
+  mutable std::mutex m_mutexWriteQueue;
+  // Write queues not yet destroyed, including m_writeQueue. A replaced queue
+  // is destroyed on a background thread, as that sends what it still holds.
+  unsigned int m_numWriteQueues{0};
+  std::mutex m_mutexNumWriteQueues;
+  std::condition_variable m_cvNumWriteQueues;
 
  public:
   RemoteStorageDB(std::string txnCollectionName = "TransactionStatus")
       : m_initialized(false),
-        m_bulkWriteEmpty(true),
         m_dbName(REMOTESTORAGE_DB_NAME),
         m_txnCollectionName(std::move(txnCollectionName)) {}
+  ~RemoteStorageDB();
 
   void Init(bool reset = false);
+  /// Sends txn writes to the given backend instead of Mongo, e.g. for tests
+  /// and benchmarks. Queries still need Init.
+  void InitWithBackend(std::shared_ptr<RemoteStorageBackend> backend);
   bool InsertJson(const Json::Value& _json, const std::string& collectionName);
   bool InsertTxn(const Transaction& txn, const TxnStatus status,
                  const uint64_t& epoch, const bool success = false);
@@ -59,7 +73,13 @@ class RemoteStorageDB : public Singleton<RemoteStorageDB> {
                  const uint64_t& epoch, const bool success);
   Json::Value QueryTxnHash(const std::string& txnhash);
   ModificationState GetModificationState(const TxnStatus status) const;
+  /// Asks the write queue to send the pending txn writes now. The writes
+  /// themselves happen in the background.
   bool ExecuteWrite();
+  /// Blocks until the pending txn writes, including those left in replaced
+  /// write queues, have been sent or have failed.
+  bool WaitUntilWritten(unsigned int timeoutMs);
+  RemoteStorageQueue::Stats GetWriteStats() const;
   bool IsInitialized() const;
 
   static RemoteStorageDB& GetInstance() {
@@ -70,6 +90,13 @@ class RemoteStorageDB : public Singleton<RemoteStorageDB> {
  private:
   mongoConnection GetConnection();
   bsoncxx::stdx::optional<mongoConnection> TryGetConnection();
+  /// Swaps in a new write queue. The old one sends what it holds on a
+  /// background thread once its last user lets go of it.
+  void StartWriteQueue(std::shared_ptr<RemoteStorageBackend> backend);
+  /// Destroys a write queue off the caller's thread
+  void ReleaseWriteQueue(RemoteStorageQueue* writeQueue);
+  std::shared_ptr<RemoteStorageQueue> GetWriteQueue() const;
+  bool PushWrite(RemoteStorageOp op);
 };
 
 #endif  // ZILLIQA_SRC_LIBREMOTESTORAGEDB_REMOTESTORAGEDB_H_
\ No newline at end of file
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "RemoteStorageQueue.h"
+#include "libUtils/Logger.h"
+#include "libUtils/Metrics.h"
+
+using namespace std;
+
+namespace {
+Metrics::Gauge& GetQueueDepthGauge() {
+  static auto& gauge =
+      Metrics::GetInstance().GetGauge("zilliqa_remotestorage_queue_depth");
+  return gauge;
+}
+
+Metrics::Counter& GetDroppedCounter() {
+  static auto& counter = Metrics::GetInstance().GetCounter(
+      "zilliqa_remotestorage_dropped_total");
+  return counter;
+}
+
+Metrics::Histogram& GetWriteHistogram() {
+  static auto& histogram =
+      Metrics::GetInstance().GetHistogram("zilliqa_remotestorage_write_us");
+  return histogram;
+}
+}  // namespace
+
+bool RemoteStorageQueue::ParseOverflowPolicy(const string& name,
+                                             OverflowPolicy& policy) {
+  if (name == "block") {
+    policy = BLOCK;
+  } else if (name == "drop_newest") {
+    policy = DROP_NEWEST;
+  } else if (name == "drop_oldest") {
+    policy = DROP_OLDEST;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+RemoteStorageQueue::RemoteStorageQueue(
+    shared_ptr<RemoteStorageBackend> backend, const Options& options)
+    : m_backend(move(backend)), m_options(options) {
+  m_writer = thread([this]() { WriterLoop(); });
+}
+
+RemoteStorageQueue::~RemoteStorageQueue() { Stop(); }
+
+bool RemoteStorageQueue::Push(RemoteStorageOp op) {
+  unique_lock<mutex> g(m_mutex);
+
+  if (!m_stopping && m_queue.size() >= m_options.m_maxQueued) {
+    switch (m_options.m_overflowPolicy) {
+      case BLOCK:
+        m_cvSpace.wait_for(g, m_options.m_batchInterval, [this]() {
+          return m_stopping || m_queue.size() < m_options.m_maxQueued;
+        });
+        break;
+      case DROP_NEWEST:
+        break;
+      case DROP_OLDEST:
+        m_queue.pop_front();
+        m_stats.m_dropped++;
+        GetDroppedCounter().Increment();
+        break;
+    }
+  }
+  if (m_stopping || m_queue.size() >= m_options.m_maxQueued) {
+    m_stats.m_dropped++;
+    GetDroppedCounter().Increment();
+    return false;
+  }
+
+  m_queue.emplace_back(move(op));
+  m_stats.m_queued++;
+  GetQueueDepthGauge().Set(m_queue.size());
+  if (m_queue.size() >= m_options.m_batchSize) {
+    m_cvWriter.notify_one();
+  }
+  return true;
+}
+
+void RemoteStorageQueue::Flush() {
+  lock_guard<mutex> g(m_mutex);
+  m_flushRequested = true;
+  m_cvWriter.notify_one();
+}
+
+bool RemoteStorageQueue::WaitUntilIdle(const chrono::milliseconds& timeout) {
+  unique_lock<mutex> g(m_mutex);
+  m_flushRequested = true;
+  m_cvWriter.notify_one();
+  return m_cvIdle.wait_for(
+      g, timeout, [this]() { return m_queue.empty() && m_inFlight == 0; });
+}
+
+void RemoteStorageQueue::Stop() {
+  {
+    lock_guard<mutex> g(m_mutex);
+    m_stopping = true;
+    m_cvWriter.notify_one();
+    m_cvSpace.notify_all();
+  }
+  if (m_writer.joinable()) {
+    m_writer.join();
+  }
+}
+
+RemoteStorageQueue::Stats RemoteStorageQueue::GetStats() const {
+  lock_guard<mutex> g(m_mutex);
+  return m_stats;
+}
+
+void RemoteStorageQueue::WriterLoop() {
+  unique_lock<mutex> g(m_mutex);
+
+  while (true) {
+    m_cvWriter.wait_for(g, m_options.m_batchInterval, [this]() {
+      return m_stopping || m_flushRequested ||
+             m_queue.size() >= m_options.m_batchSize;
+    });
+
+    if (m_queue.empty()) {
+      m_flushRequested = false;
+      m_cvIdle.notify_all();
+      if (m_stopping) {
+        break;
+      }
+      continue;
+    }
+
+    const size_t count = min(m_queue.size(), m_options.m_batchSize);
+    vector<RemoteStorageOp> batch;
+    batch.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+      batch.emplace_back(move(m_queue.front()));
+      m_queue.pop_front();
+    }
+    m_inFlight = count;
+    GetQueueDepthGauge().Set(m_queue.size());
+    m_cvSpace.notify_all();
+
+    g.unlock();
+    const bool written = WriteWithRetries(batch);
+    g.lock();
+
+    m_inFlight = 0;
+    m_stats.m_batches++;
+    if (written) {
+      m_stats.m_written += count;
+    } else {
+      m_stats.m_failed += count;
+    }
+    if (m_queue.empty()) {
+      m_cvIdle.notify_all();
+    }
+  }
+}
+
+bool RemoteStorageQueue::WriteWithRetries(
+    const vector<RemoteStorageOp>& batch) {
+  for (unsigned int attempt = 0;; attempt++) {
+    {
+      Metrics::ScopedTimer timer(GetWriteHistogram());
+      if (m_backend->Write(batch)) {
+        return true;
+      }
+    }
+    if (attempt >= m_options.m_maxRetries) {
+      LOG_GENERAL(WARNING, "Dropping " << batch.size() << " remote storage ops"
+                                       << " after " << attempt + 1
+                                       << " failed writes");
+      return false;
+    }
+    LOG_GENERAL(WARNING, "Remote storage write of " << batch.size()
+                                                    << " ops failed, retrying");
+    {
+      lock_guard<mutex> g(m_mutex);
+      m_stats.m_retries++;
+    }
+    this_thread::sleep_for(m_options.m_retryBackoff * (attempt + 1));
+  }
+}
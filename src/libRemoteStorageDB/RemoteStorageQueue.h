@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBREMOTESTORAGEDB_REMOTESTORAGEQUEUE_H_
+#define ZILLIQA_SRC_LIBREMOTESTORAGEDB_REMOTESTORAGEQUEUE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "RemoteStorageBackend.h"
+
+/// Bounded write-behind queue in front of a RemoteStorageBackend.
+///
+/// A single writer thread sends the queued ops in FIFO batches, once a batch
+/// is full, the batch interval has passed or a flush is requested. A failed
+/// batch is retried with a growing backoff before the next one is sent, and
+/// dropped once the retries run out. Stopping sends whatever is still queued.
+class RemoteStorageQueue {
+ public:
+  /// What Push does when the queue is full.
+  enum OverflowPolicy {
+    BLOCK,        // wait up to the batch interval for room, then drop the op
+    DROP_NEWEST,  // drop the op being pushed
+    DROP_OLDEST   // drop the oldest queued op to make room
+  };
+
+  struct Options {
+    size_t m_maxQueued{100000};
+    size_t m_batchSize{1000};
+    std::chrono::milliseconds m_batchInterval{1000};
+    OverflowPolicy m_overflowPolicy{BLOCK};
+    unsigned int m_maxRetries{3};
+    std::chrono::milliseconds m_retryBackoff{500};
+  };
+
+  struct Stats {
+    uint64_t m_queued{};
+    uint64_t m_written{};
+    uint64_t m_dropped{};   // on overflow
+    uint64_t m_failed{};    // in batches that ran out of retries
+    uint64_t m_batches{};
+    uint64_t m_retries{};
+  };
+
+  static bool ParseOverflowPolicy(const std::string& name,
+                                  OverflowPolicy& policy);
+
+  RemoteStorageQueue(std::shared_ptr<RemoteStorageBackend> backend,
+                     const Options& options);
+  ~RemoteStorageQueue();
+
+  RemoteStorageQueue(const RemoteStorageQueue&) = delete;
+  RemoteStorageQueue& operator=(const RemoteStorageQueue&) = delete;
+
+  /// Returns false if the op was dropped.
+  bool Push(RemoteStorageOp op);
+
+  /// Sends the queued ops without waiting for the batch to fill up.
+  void Flush();
+
+  /// Blocks until every op pushed so far has been handled or the timeout
+  /// expires. Returns false on timeout.
+  bool WaitUntilIdle(const std::chrono::milliseconds& timeout);
+
+  /// Sends the queued ops and stops the writer. Later pushes are dropped.
+  void Stop();
+
+  Stats GetStats() const;
+
+ private:
+  const std::shared_ptr<RemoteStorageBackend> m_backend;
+  const Options m_options;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cvWriter;
+  std::condition_variable m_cvSpace;
+  std::condition_variable m_cvIdle;
+  std::deque<RemoteStorageOp> m_queue;
+  size_t m_inFlight{0};
+  bool m_flushRequested{false};
+  bool m_stopping{false};
+  Stats m_stats;
+  std::thread m_writer;
+
+  void WriterLoop();
+  bool WriteWithRetries(const std::vector<RemoteStorageOp>& batch);
+};
+
+#endif  // ZILLIQA_SRC_LIBREMOTESTORAGEDB_REMOTESTORAGEQUEUE_H_
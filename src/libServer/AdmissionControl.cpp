@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AdmissionControl.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+thread_local AdmissionControl::Limit* AdmissionControl::t_held = nullptr;
+
+AdmissionControl::Ticket::Ticket(AdmissionControl* control, Limit* limit)
+    : m_control(control), m_limit(limit), m_previous(t_held) {
+  if (m_limit != nullptr) {
+    t_held = m_limit;
+  }
+}
+
+AdmissionControl::Ticket::~Ticket() {
+  if (m_control != nullptr && m_limit != nullptr) {
+    t_held = m_previous;
+    m_control->Release(m_limit);
+  }
+}
+
+AdmissionControl::AdmissionControl(unsigned int budget,
+                                   unsigned int timeoutInMs)
+    : m_budget(budget), m_timeout(timeoutInMs) {}
+
+void AdmissionControl::SetLimit(const string& method, unsigned int maxRunning,
+                                unsigned int maxQueued) {
+  if (maxRunning == 0) {
+    LOG_GENERAL(WARNING, "Invalid limit for " << method);
+    return;
+  }
+  m_limits[method] = {maxRunning, maxQueued, 0, 0, {0, 0, 0, 0}};
+}
+
+bool AdmissionControl::IsLimited(const string& method) const {
+  return m_limits.find(method) != m_limits.end();
+}
+
+AdmissionControl::Ticket AdmissionControl::Admit(const string& method) {
+  auto it = m_limits.find(method);
+  if (it == m_limits.end()) {
+    return Ticket(this, nullptr);
+  }
+  Limit& limit = it->second;
+
+  if (t_held == &limit) {
+    return Ticket(this, nullptr);
+  }
+
+  unique_lock<mutex> lock(m_mutex);
+
+  if (limit.m_running < limit.m_maxRunning && m_inUse < m_budget) {
+    limit.m_running++;
+    m_inUse++;
+    limit.m_stats.m_admitted++;
+    return Ticket(this, &limit);
+  }
+
+  if (limit.m_queued >= limit.m_maxQueued || m_inUse >= m_budget) {
+    limit.m_stats.m_rejected++;
+    return Ticket(nullptr, nullptr);
+  }
+
+  // Waiting calls count against the budget as they hold a server thread
+  limit.m_queued++;
+  m_inUse++;
+  limit.m_stats.m_queued++;
+
+  const bool admitted = m_cv.wait_for(lock, m_timeout, [&limit]() {
+    return limit.m_running < limit.m_maxRunning;
+  });
+
+  limit.m_queued--;
+  if (!admitted) {
+    m_inUse--;
+    limit.m_stats.m_timedOut++;
+    return Ticket(nullptr, nullptr);
+  }
+
+  limit.m_running++;
+  limit.m_stats.m_admitted++;
+  return Ticket(this, &limit);
+}
+
+void AdmissionControl::Release(Limit* limit) {
+  {
+    lock_guard<mutex> g(m_mutex);
+    limit->m_running--;
+    m_inUse--;
+  }
+  m_cv.notify_all();
+}
+
+AdmissionControl::Stats AdmissionControl::GetStats(const string& method) {
+  lock_guard<mutex> g(m_mutex);
+  auto it = m_limits.find(method);
+  if (it == m_limits.end()) {
+    return {0, 0, 0, 0};
+  }
+  return it->second.m_stats;
+}
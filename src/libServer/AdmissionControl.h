@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBSERVER_ADMISSIONCONTROL_H_
+#define ZILLIQA_SRC_LIBSERVER_ADMISSIONCONTROL_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/// Per-method concurrency limits for RPC handlers.
+///
+/// A limited method runs at most maxRunning calls at a time, and at most
+/// maxQueued further calls wait for a slot. Waiting calls give up after the
+/// timeout, and calls arriving with the queue full are rejected at once. The
+/// running and waiting calls of all limited methods also share one budget,
+/// so that they can never hold all the server threads. Methods without a
+/// limit are always admitted.
+///
+/// Admission is reentrant per thread: a thread holding a slot for a method,
+/// such as one running the calls of a batch request, makes further calls of
+/// that method under the same slot.
+class AdmissionControl {
+ public:
+  struct Stats {
+    uint64_t m_admitted;
+    uint64_t m_queued;
+    uint64_t m_rejected;
+    uint64_t m_timedOut;
+  };
+
+ private:
+  struct Limit {
+    unsigned int m_maxRunning;
+    unsigned int m_maxQueued;
+    unsigned int m_running;
+    unsigned int m_queued;
+    Stats m_stats;
+  };
+
+  const unsigned int m_budget;
+  const std::chrono::milliseconds m_timeout;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::unordered_map<std::string, Limit> m_limits;
+  unsigned int m_inUse{0};
+
+  /// Slot held by the calling thread
+  static thread_local Limit* t_held;
+
+ public:
+  /// Held for the duration of an admitted call.
+  class Ticket {
+    AdmissionControl* m_control;
+    Limit* m_limit;
+    Limit* m_previous;
+
+   public:
+    Ticket(AdmissionControl* control, Limit* limit);
+    Ticket(Ticket&& other)
+        : m_control(other.m_control),
+          m_limit(other.m_limit),
+          m_previous(other.m_previous) {
+      other.m_limit = nullptr;
+    }
+    Ticket(const Ticket&) = delete;
+    Ticket& operator=(const Ticket&) = delete;
+    ~Ticket();
+
+    /// False if the call was rejected or timed out.
+    bool IsAdmitted() const { return m_control != nullptr; }
+  };
+
+  AdmissionControl(unsigned int budget, unsigned int timeoutInMs);
+
+  AdmissionControl(const AdmissionControl&) = delete;
+  AdmissionControl& operator=(const AdmissionControl&) = delete;
+
+  /// Limits the number of concurrent calls of method. Not thread-safe, to be
+  /// called before the server starts listening.
+  void SetLimit(const std::string& method, unsigned int maxRunning,
+                unsigned int maxQueued);
+
+  bool IsLimited(const std::string& method) const;
+
+  /// Waits for a slot for method, if it is limited.
+  Ticket Admit(const std::string& method);
+
+  Stats GetStats(const std::string& method);
+
+ private:
+  void Release(Limit* limit);
+};
+
+#endif  // ZILLIQA_SRC_LIBSERVER_ADMISSIONCONTROL_H_
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "AdmissionControl.h"
+#include "BatchRequestHandler.h"
+#include "Server.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+struct BatchRequestHandler::Batch {
+  Json::Value m_calls;
+  vector<pair<string, vector<Json::ArrayIndex>>> m_groups;
+  vector<Json::Value> m_responses;
+  atomic<unsigned int> m_nextGroup{0};
+
+  mutex m_mutex;
+  condition_variable m_cvDone;
+  unsigned int m_doneGroups{0};
+};
+
+BatchRequestHandler::BatchRequestHandler(
+    jsonrpc::AbstractProtocolHandler& protocolHandler,
+    AdmissionControl& admission, unsigned int maxBatchSize,
+    unsigned int numThreads)
+    : m_protocolHandler(protocolHandler),
+      m_admission(admission),
+      m_maxBatchSize(maxBatchSize),
+      m_numThreads(numThreads),
+      m_pool(numThreads, "BatchPool") {}
+
+Json::Value BatchRequestHandler::MakeError(const Json::Value& id, int code,
+                                           const string& message) const {
+  Json::Value response;
+  response["jsonrpc"] = "2.0";
+  response["id"] = id;
+  response["error"]["code"] = code;
+  response["error"]["message"] = message;
+  return response;
+}
+
+void BatchRequestHandler::HandleRequest(const string& request,
+                                        string& retValue) {
+  // Single calls are parsed by the protocol handler as before
+  const auto first = request.find_first_not_of(" \t\r\n");
+  if (first == string::npos || request[first] != '[') {
+    m_protocolHandler.HandleRequest(request, retValue);
+    return;
+  }
+
+  auto batch = make_shared<Batch>();
+  Json::Reader reader;
+  Json::Value& calls = batch->m_calls;
+  if (!reader.parse(request, calls, false) || !calls.isArray() ||
+      calls.empty()) {
+    m_protocolHandler.HandleRequest(request, retValue);
+    return;
+  }
+
+  Json::FastWriter writer;
+
+  if (calls.size() > m_maxBatchSize) {
+    retValue = writer.write(MakeError(Json::nullValue,
+                                      ServerBase::RPC_INVALID_REQUEST,
+                                      "Batch size exceeds " +
+                                          to_string(m_maxBatchSize)));
+    return;
+  }
+
+  // Calls of the same method share one admission slot
+  map<string, vector<Json::ArrayIndex>> groups;
+  for (Json::ArrayIndex i = 0; i < calls.size(); i++) {
+    const Json::Value& call = calls[i];
+    const string method = call.isObject() && call["method"].isString()
+                              ? call["method"].asString()
+                              : "";
+    groups[method].emplace_back(i);
+  }
+  batch->m_groups.assign(make_move_iterator(groups.begin()),
+                         make_move_iterator(groups.end()));
+  batch->m_responses.resize(calls.size());
+
+  // Helpers that only get a pool thread after the groups have all been
+  // claimed find nothing left to do
+  const unsigned int numHelpers =
+      min<unsigned int>(m_numThreads, batch->m_groups.size() - 1);
+  for (unsigned int i = 0; i < numHelpers; i++) {
+    m_pool.AddJob([this, batch]() { RunGroups(*batch); });
+  }
+  RunGroups(*batch);
+
+  {
+    unique_lock<mutex> lk(batch->m_mutex);
+    batch->m_cvDone.wait(lk, [&batch]() {
+      return batch->m_doneGroups == batch->m_groups.size();
+    });
+  }
+
+  // Notifications get no response
+  Json::Value result = Json::arrayValue;
+  for (const auto& response : batch->m_responses) {
+    if (!response.isNull()) {
+      result.append(response);
+    }
+  }
+
+  retValue = result.empty() ? "" : writer.write(result);
+}
+
+void BatchRequestHandler::RunGroups(Batch& batch) {
+  for (unsigned int g = batch.m_nextGroup++; g < batch.m_groups.size();
+       g = batch.m_nextGroup++) {
+    const string& method = batch.m_groups[g].first;
+    const auto& indices = batch.m_groups[g].second;
+    const Json::Value& calls = batch.m_calls;
+
+    {
+      const auto ticket = m_admission.Admit(method);
+      for (const auto& i : indices) {
+        if (!ticket.IsAdmitted()) {
+          batch.m_responses[i] =
+              MakeError(calls[i].get("id", Json::nullValue),
+                        ServerBase::RPC_SERVER_BUSY,
+                        "Too many " + method + " requests, retry later");
+          continue;
+        }
+        try {
+          m_protocolHandler.HandleJsonRequest(calls[i], batch.m_responses[i]);
+        } catch (const exception& e) {
+          LOG_GENERAL(WARNING, "Batch call failed: " << e.what());
+          batch.m_responses[i] = MakeError(calls[i].get("id", Json::nullValue),
+                                           ServerBase::RPC_INTERNAL_ERROR,
+                                           "Unable to process");
+        }
+      }
+    }
+
+    lock_guard<mutex> lock(batch.m_mutex);
+    if (++batch.m_doneGroups == batch.m_groups.size()) {
+      batch.m_cvDone.notify_all();
+    }
+  }
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBSERVER_BATCHREQUESTHANDLER_H_
+#define ZILLIQA_SRC_LIBSERVER_BATCHREQUESTHANDLER_H_
+
+#include <json/json.h>
+#include <string>
+
+#include "jsonrpccpp/server/abstractprotocolhandler.h"
+#include "jsonrpccpp/server/abstractserverconnector.h"
+#include "libUtils/Logger.h"
+#include "libUtils/ThreadPool.h"
+
+class AdmissionControl;
+
+/// Connection handler that serves JSON-RPC 2.0 batch arrays.
+///
+/// The batch is parsed once and its calls are grouped by method. Each group
+/// takes a single admission slot for its method and runs its calls in order.
+/// The server thread works through the groups itself, helped by a thread pool
+/// shared by all batches, so a burst of batches cannot add threads without
+/// bound. Responses keep the order of the calls. Anything other than a batch
+/// goes to the protocol handler unchanged.
+class BatchRequestHandler : public jsonrpc::IClientConnectionHandler {
+  jsonrpc::AbstractProtocolHandler& m_protocolHandler;
+  AdmissionControl& m_admission;
+  const unsigned int m_maxBatchSize;
+  const unsigned int m_numThreads;
+
+  /// State of one batch, shared with the pool jobs helping to run it.
+  struct Batch;
+
+  /// Runs groups of the batch until none are left unclaimed.
+  void RunGroups(Batch& batch);
+
+  /// Error response for a call that could not be admitted.
+  Json::Value MakeError(const Json::Value& id, int code,
+                        const std::string& message) const;
+
+  // Declared last, so that it is joined before the members above go away
+  ThreadPool m_pool;
+
+ public:
+  /// numThreads == 0 runs every batch on the server thread that received it.
+  BatchRequestHandler(jsonrpc::AbstractProtocolHandler& protocolHandler,
+                      AdmissionControl& admission, unsigned int maxBatchSize,
+                      unsigned int numThreads);
+
+  void HandleRequest(const std::string& request,
+                     std::string& retValue) override;
+};
+
+#endif  // ZILLIQA_SRC_LIBSERVER_BATCHREQUESTHANDLER_H_
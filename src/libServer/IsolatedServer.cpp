@@ -26,13 +26,15 @@ using namespace std;
 IsolatedServer::IsolatedServer(Mediator& mediator,
                                AbstractServerConnector& server,
                                const uint64_t& blocknum,
-                               const uint32_t& timeDelta)
+                               const uint32_t& timeDelta,
+                               const uint32_t& batchSize)
     : LookupServer(mediator, server),
       jsonrpc::AbstractServer<IsolatedServer>(server,
                                               jsonrpc::JSONRPC_SERVER_V2),
       m_blocknum(blocknum),
       m_timeDelta(timeDelta),
-      m_key(Schnorr::GenKeyPair()) {
+      m_key(Schnorr::GenKeyPair()),
+      m_batchSize(timeDelta > 0 ? batchSize : 0) {
   AbstractServer<IsolatedServer>::bindAndAddMethod(
       jsonrpc::Procedure("CreateTransaction", jsonrpc::PARAMS_BY_POSITION,
                          jsonrpc::JSON_STRING, "param01", jsonrpc::JSON_OBJECT,
@@ -221,95 +223,114 @@ bool IsolatedServer::RetrieveHistory() {
   return true;
 }
 
-Json::Value IsolatedServer::CreateTransaction(const Json::Value& _json) {
-  try {
-    if (!JSONConversion::checkJsonTx(_json)) {
-      throw JsonRpcException(RPC_PARSE_ERROR, "Invalid Transaction JSON");
-    }
+Json::Value IsolatedServer::CheckTransaction(const Transaction& tx) {
+  Json::Value ret;
 
-    lock_guard<mutex> g(m_blockMutex);
+  uint64_t senderNonce;
+  uint128_t senderBalance;
 
-    LOG_GENERAL(INFO, "On the isolated server ");
+  const Address fromAddr = tx.GetSenderAddr();
 
-    Transaction tx = JSONConversion::convertJsontoTx(_json);
+  {
+    shared_lock<shared_timed_mutex> lock(
+        AccountStore::GetInstance().GetPrimaryMutex());
 
-    Json::Value ret;
+    const Account* sender = AccountStore::GetInstance().GetAccount(fromAddr);
 
-    uint64_t senderNonce;
-    uint128_t senderBalance;
+    if (!ValidateTxn(tx, fromAddr, sender, m_gasPrice)) {
+      throw JsonRpcException(RPC_VERIFY_REJECTED, "Txn rejected");
+    }
 
-    const Address fromAddr = tx.GetSenderAddr();
+    senderNonce = sender->GetNonce();
+    senderBalance = sender->GetBalance();
+  }
 
-    {
-      shared_lock<shared_timed_mutex> lock(
-          AccountStore::GetInstance().GetPrimaryMutex());
+  const auto pendingNonce = m_pendingNonces.find(fromAddr);
+  if (pendingNonce != m_pendingNonces.end()) {
+    senderNonce = pendingNonce->second;
+  }
 
-      const Account* sender = AccountStore::GetInstance().GetAccount(fromAddr);
+  if (senderNonce + 1 != tx.GetNonce()) {
+    throw JsonRpcException(RPC_INVALID_PARAMETER,
+                           "Expected Nonce: " + to_string(senderNonce + 1));
+  }
 
-      if (!ValidateTxn(tx, fromAddr, sender, m_gasPrice)) {
-        return ret;
-      }
+  if (senderBalance < tx.GetAmount()) {
+    throw JsonRpcException(RPC_INVALID_PARAMETER,
+                           "Insufficient Balance: " + senderBalance.str());
+  }
 
-      senderNonce = sender->GetNonce();
-      senderBalance = sender->GetBalance();
-    }
+  if (m_gasPrice > tx.GetGasPrice()) {
+    throw JsonRpcException(RPC_INVALID_PARAMETER,
+                           "Minimum gas price greater: " + m_gasPrice.str());
+  }
 
-    if (senderNonce + 1 != tx.GetNonce()) {
-      throw JsonRpcException(RPC_INVALID_PARAMETER,
-                             "Expected Nonce: " + to_string(senderNonce + 1));
-    }
+  switch (Transaction::GetTransactionType(tx)) {
+    case Transaction::ContractType::NON_CONTRACT:
+      break;
+    case Transaction::ContractType::CONTRACT_CREATION:
+      if (!ENABLE_SC) {
+        throw JsonRpcException(RPC_MISC_ERROR, "Smart contract is disabled");
+      }
+      ret["ContractAddress"] =
+          Account::GetAddressForContract(fromAddr, senderNonce).hex();
+      break;
+    case Transaction::ContractType::CONTRACT_CALL: {
+      if (!ENABLE_SC) {
+        throw JsonRpcException(RPC_MISC_ERROR, "Smart contract is disabled");
+      }
 
-    if (senderBalance < tx.GetAmount()) {
-      throw JsonRpcException(RPC_INVALID_PARAMETER,
-                             "Insufficient Balance: " + senderBalance.str());
-    }
+      if (m_pendingContracts.count(tx.GetToAddr()) > 0) {
+        break;
+      }
 
-    if (m_gasPrice > tx.GetGasPrice()) {
-      throw JsonRpcException(RPC_INVALID_PARAMETER,
-                             "Minimum gas price greater: " + m_gasPrice.str());
-    }
+      {
+        shared_lock<shared_timed_mutex> lock(
+            AccountStore::GetInstance().GetPrimaryMutex());
 
-    switch (Transaction::GetTransactionType(tx)) {
-      case Transaction::ContractType::NON_CONTRACT:
-        break;
-      case Transaction::ContractType::CONTRACT_CREATION:
-        if (!ENABLE_SC) {
-          throw JsonRpcException(RPC_MISC_ERROR, "Smart contract is disabled");
+        const Account* account =
+            AccountStore::GetInstance().GetAccount(tx.GetToAddr());
+
+        if (account == nullptr) {
+          throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
+                                 "To addr is null");
         }
-        ret["ContractAddress"] =
-            Account::GetAddressForContract(fromAddr, senderNonce).hex();
-        break;
-      case Transaction::ContractType::CONTRACT_CALL: {
-        if (!ENABLE_SC) {
-          throw JsonRpcException(RPC_MISC_ERROR, "Smart contract is disabled");
+
+        else if (!account->isContract()) {
+          throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
+                                 "Non - contract address called");
         }
+      }
+    } break;
+
+    case Transaction::ContractType::ERROR:
+      throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
+                             "Code is empty and To addr is null");
+      break;
+    default:
+      throw JsonRpcException(RPC_MISC_ERROR, "Txn type unexpected");
+  }
 
-        {
-          shared_lock<shared_timed_mutex> lock(
-              AccountStore::GetInstance().GetPrimaryMutex());
+  return ret;
+}
 
-          const Account* account =
-              AccountStore::GetInstance().GetAccount(tx.GetToAddr());
+Json::Value IsolatedServer::CreateTransaction(const Json::Value& _json) {
+  try {
+    if (!JSONConversion::checkJsonTx(_json)) {
+      throw JsonRpcException(RPC_PARSE_ERROR, "Invalid Transaction JSON");
+    }
 
-          if (account == nullptr) {
-            throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
-                                   "To addr is null");
-          }
+    if (m_batchSize > 0) {
+      return QueueTransaction(JSONConversion::convertJsontoTx(_json));
+    }
 
-          else if (!account->isContract()) {
-            throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
-                                   "Non - contract address called");
-          }
-        }
-      } break;
+    lock_guard<mutex> g(m_blockMutex);
 
-      case Transaction::ContractType::ERROR:
-        throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
-                               "Code is empty and To addr is null");
-        break;
-      default:
-        throw JsonRpcException(RPC_MISC_ERROR, "Txn type unexpected");
-    }
+    LOG_GENERAL(INFO, "On the isolated server ");
+
+    Transaction tx = JSONConversion::convertJsontoTx(_json);
+
+    Json::Value ret = CheckTransaction(tx);
 
     TransactionReceipt txreceipt;
 
@@ -347,7 +368,8 @@ Json::Value IsolatedServer::CreateTransaction(const Json::Value& _json) {
 
     m_currEpochGas += txreceipt.GetCumGas();
 
-    if (!BlockStorage::GetBlockStorage().PutTxBody(tx.GetTranID(), twr_ser)) {
+    if (!BlockStorage::GetBlockStorage().PutTxBody(m_blocknum, tx.GetTranID(),
+                                                   twr_ser)) {
       LOG_GENERAL(WARNING, "Unable to put tx body");
     }
     const auto& txHash = tx.GetTranID();
@@ -371,6 +393,145 @@ Json::Value IsolatedServer::CreateTransaction(const Json::Value& _json) {
   }
 }
 
+Json::Value IsolatedServer::QueueTransaction(const Transaction& tx) {
+  bool applyNow;
+  Json::Value ret;
+  {
+    lock_guard<mutex> g(m_pendingMutex);
+
+    ret = CheckTransaction(tx);
+
+    const Address fromAddr = tx.GetSenderAddr();
+    if (Transaction::GetTransactionType(tx) ==
+        Transaction::ContractType::CONTRACT_CREATION) {
+      m_pendingContracts.emplace(
+          Account::GetAddressForContract(fromAddr, tx.GetNonce() - 1));
+    }
+    m_pendingNonces[fromAddr] = tx.GetNonce();
+    m_pendingTxns.emplace_back(tx);
+    applyNow = m_pendingTxns.size() >= m_batchSize;
+  }
+
+  // Apply a full batch without waiting for the next block
+  if (applyNow && !m_applyLaunched.exchange(true)) {
+    auto func = [this]() mutable -> void {
+      lock_guard<mutex> g(m_blockMutex);
+      m_applyLaunched = false;
+      ApplyPendingTxns();
+    };
+    DetachedFunction(1, func);
+  }
+
+  ret["TranID"] = tx.GetTranID().hex();
+  ret["Info"] = "Txn queued";
+  return ret;
+}
+
+void IsolatedServer::ApplyPendingTxns() {
+  vector<Transaction> txns;
+  {
+    lock_guard<mutex> g(m_pendingMutex);
+    txns.swap(m_pendingTxns);
+  }
+  if (txns.empty()) {
+    return;
+  }
+
+  vector<TransactionWithReceipt> twrs;
+  vector<pair<dev::h256, bytes>> bodies;
+  twrs.reserve(txns.size());
+  bodies.reserve(txns.size());
+
+  for (const auto& tx : txns) {
+    TransactionReceipt txreceipt;
+    TxnStatus error_code;
+    txreceipt.SetEpochNum(m_blocknum);
+
+    // A failed txn leaves a gap before the later queued txns of its sender
+    const uint128_t expectedNonce =
+        AccountStore::GetInstance().GetNonceTemp(tx.GetSenderAddr()) + 1;
+    bool applied = false;
+    if (tx.GetNonce() != expectedNonce) {
+      error_code = tx.GetNonce() < expectedNonce
+                       ? TxnStatus::NONCE_TOO_LOW
+                       : TxnStatus::PRESENT_NONCE_HIGH;
+    } else {
+      applied = AccountStore::GetInstance().UpdateAccountsTemp(
+          m_blocknum, 3  // Arbitrary values
+          ,
+          true, tx, txreceipt, error_code);
+    }
+
+    if (!applied) {
+      LOG_GENERAL(WARNING, "Txn " << tx.GetTranID()
+                                  << " failed, error code: " << error_code);
+
+      // The client was already told the txn is queued, so keep a failed
+      // receipt with the error the unbatched path would have thrown
+      TransactionReceipt failedReceipt;
+      failedReceipt.SetEpochNum(m_blocknum);
+      failedReceipt.SetCumGas(0);
+      failedReceipt.SetResult(false);
+      Json::Value exceptions = Json::arrayValue;
+      Json::Value& exception = exceptions.append(Json::objectValue);
+      exception["error_message"] = "Error Code: " + to_string(error_code);
+      exception["start_location"]["line"] = 0;
+      failedReceipt.AddException(exceptions);
+      failedReceipt.update();
+
+      bodies.emplace_back(tx.GetTranID(), bytes());
+      TransactionWithReceipt(tx, failedReceipt)
+          .Serialize(bodies.back().second, 0);
+      continue;
+    }
+
+    m_currEpochGas += txreceipt.GetCumGas();
+    twrs.emplace_back(tx, txreceipt);
+    bodies.emplace_back(tx.GetTranID(), bytes());
+    twrs.back().Serialize(bodies.back().second, 0);
+  }
+
+  AccountStore::GetInstance().ProcessStorageRootUpdateBufferTemp();
+  AccountStore::GetInstance().CleanNewLibrariesCacheTemp();
+
+  AccountStore::GetInstance().SerializeDelta();
+  AccountStore::GetInstance().CommitTemp();
+
+  if (!BlockStorage::GetBlockStorage().PutTxBodies(m_blocknum, bodies)) {
+    LOG_GENERAL(WARNING, "Unable to put tx bodies");
+  }
+
+  for (const auto& twr : twrs) {
+    const auto& txHash = twr.GetTransaction().GetTranID();
+    LookupServer::AddToRecentTransactions(txHash);
+    {
+      lock_guard<mutex> g(m_txnBlockNumMapMutex);
+      m_txnBlockNumMap[m_blocknum].emplace_back(txHash);
+    }
+    WebsocketServer::GetInstance().ParseTxn(twr);
+  }
+
+  {
+    // Senders without newer queued txns continue from the committed state
+    lock_guard<mutex> g(m_pendingMutex);
+    for (const auto& tx : txns) {
+      const Address fromAddr = tx.GetSenderAddr();
+      const auto it = m_pendingNonces.find(fromAddr);
+      if (it != m_pendingNonces.end() && it->second == tx.GetNonce()) {
+        m_pendingNonces.erase(it);
+      }
+      if (Transaction::GetTransactionType(tx) ==
+          Transaction::ContractType::CONTRACT_CREATION) {
+        m_pendingContracts.erase(
+            Account::GetAddressForContract(fromAddr, tx.GetNonce() - 1));
+      }
+    }
+  }
+
+  LOG_GENERAL(INFO, "Applied " << twrs.size() << " of " << txns.size()
+                               << " queued txns to blocknum: " << m_blocknum);
+}
+
 Json::Value IsolatedServer::GetTransactionsForTxBlock(
     const string& txBlockNum) {
   uint64_t txNum;
@@ -495,6 +656,9 @@ TxBlock IsolatedServer::GenerateTxBlock() {
 
 void IsolatedServer::PostTxBlock() {
   lock_guard<mutex> g(m_blockMutex);
+  if (m_batchSize > 0) {
+    ApplyPendingTxns();
+  }
   const TxBlock& txBlock = GenerateTxBlock();
   if (ENABLE_WEBSOCKET) {
     // send tx block and attach txhashes
@@ -18,6 +18,10 @@
 #ifndef ZILLIQA_SRC_LIBSERVER_ISOLATEDSERVER_H_
 #define ZILLIQA_SRC_LIBSERVER_ISOLATEDSERVER_H_
 
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "LookupServer.h"
 
 class Mediator;
@@ -33,13 +37,35 @@ class IsolatedServer : public LookupServer,
   const PairOfKey m_key;
   uint64_t m_currEpochGas{0};
 
+  // Group commit: if m_batchSize > 0, CreateTransaction only checks and
+  // queues a txn. Queued txns are applied together, with one delta commit
+  // and one body write, at the next block or once m_batchSize are queued.
+  const uint32_t m_batchSize;
+  std::vector<Transaction> m_pendingTxns;
+  // Nonce of the last queued txn of each sender, and contracts whose
+  // creation is queued
+  std::unordered_map<Address, uint64_t> m_pendingNonces;
+  std::unordered_set<Address> m_pendingContracts;
+  std::mutex mutable m_pendingMutex;
+  std::atomic<bool> m_applyLaunched{false};
+
   bool StartBlocknumIncrement();
   TxBlock GenerateTxBlock();
   void PostTxBlock();
 
+  /// Checks tx against the committed state, continuing from the queued txns
+  /// of the sender, and returns the response fields known before execution.
+  Json::Value CheckTransaction(const Transaction& tx);
+  Json::Value QueueTransaction(const Transaction& tx);
+  /// Executes and commits the queued txns. A txn that fails is left out of
+  /// the block but stored with a failed receipt. Requires m_blockMutex.
+  void ApplyPendingTxns();
+
  public:
+  /// A batchSize > 0 enables group commit, in time-trigger mode only.
   IsolatedServer(Mediator& mediator, jsonrpc::AbstractServerConnector& server,
-                 const uint64_t& blocknum, const uint32_t& timeDelta);
+                 const uint64_t& blocknum, const uint32_t& timeDelta,
+                 const uint32_t& batchSize = 0);
   ~IsolatedServer() = default;
 
   inline virtual void CreateTransactionI(const Json::Value& request,
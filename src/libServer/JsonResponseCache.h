@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBSERVER_JSONRESPONSECACHE_H_
+#define ZILLIQA_SRC_LIBSERVER_JSONRESPONSECACHE_H_
+
+#include <json/json.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+/// Size-bounded LRU cache of JSON-RPC response fragments.
+///
+/// Only meant for content that never changes once written, such as
+/// finalized blocks and confirmed transactions, so entries are never
+/// invalidated. Values are shared and immutable, which keeps the time spent
+/// under the lock to a pointer copy.
+template <class Key>
+class JsonResponseCache {
+ public:
+  typedef std::shared_ptr<const Json::Value> ValuePtr;
+
+  struct Stats {
+    uint64_t m_hits;
+    uint64_t m_misses;
+    size_t m_size;
+  };
+
+ private:
+  typedef std::list<std::pair<Key, ValuePtr>> EntryList;
+
+  const size_t m_capacity;
+  mutable std::mutex m_mutex;
+  EntryList m_entries;
+  std::unordered_map<Key, typename EntryList::iterator> m_index;
+
+  std::atomic<uint64_t> m_hits{0};
+  std::atomic<uint64_t> m_misses{0};
+
+ public:
+  /// A capacity of 0 disables the cache.
+  explicit JsonResponseCache(size_t capacity) : m_capacity(capacity) {}
+
+  JsonResponseCache(const JsonResponseCache&) = delete;
+  JsonResponseCache& operator=(const JsonResponseCache&) = delete;
+
+  bool IsEnabled() const { return m_capacity > 0; }
+
+  /// Returns the cached value for key, or nullptr if absent.
+  ValuePtr Get(const Key& key) {
+    if (!IsEnabled()) {
+      return nullptr;
+    }
+
+    std::lock_guard<std::mutex> g(m_mutex);
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+      m_misses++;
+      return nullptr;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    m_hits++;
+    return it->second->second;
+  }
+
+  /// Copies value into the cache, evicting the least recently used entry
+  /// when full.
+  ValuePtr Put(const Key& key, const Json::Value& value) {
+    auto ptr = std::make_shared<const Json::Value>(value);
+    Put(key, ptr);
+    return ptr;
+  }
+
+  void Put(const Key& key, const ValuePtr& value) {
+    if (!IsEnabled() || value == nullptr) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> g(m_mutex);
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+      it->second->second = value;
+      m_entries.splice(m_entries.begin(), m_entries, it->second);
+      return;
+    }
+
+    m_entries.emplace_front(key, value);
+    m_index.emplace(key, m_entries.begin());
+    if (m_entries.size() > m_capacity) {
+      m_index.erase(m_entries.back().first);
+      m_entries.pop_back();
+    }
+  }
+
+  Stats GetStats() const {
+    std::lock_guard<std::mutex> g(m_mutex);
+    return {m_hits, m_misses, m_entries.size()};
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> g(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+  }
+};
+
+#endif  // ZILLIQA_SRC_LIBSERVER_JSONRESPONSECACHE_H_
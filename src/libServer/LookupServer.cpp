@@ -17,7 +17,9 @@
 #include "LookupServer.h"
 #include <Schnorr.h>
 #include <boost/multiprecision/cpp_dec_float.hpp>
+#include <unordered_set>
 #include "JSONConversion.h"
+#include "JsonResponseCache.h"
 #include "common/Messages.h"
 #include "common/Serializable.h"
 #include "libCrypto/Sha2.h"
@@ -47,11 +49,40 @@ const unsigned int TXN_PAGE_SIZE = 100;
 //[warning] do not make this constant too big as it loops over blockchain
 const unsigned int REF_BLOCK_DIFF = 1;
 
+namespace {
+/// Response fragments of finalized blocks and confirmed transactions, which
+/// never change once written.
+struct ResponseCaches {
+  JsonResponseCache<TxnHash> m_txns{RPC_RESPONSE_CACHE_SIZE};
+  JsonResponseCache<uint64_t> m_txBlocks{RPC_RESPONSE_CACHE_SIZE};
+  JsonResponseCache<uint64_t> m_dsBlocks{RPC_RESPONSE_CACHE_SIZE};
+  JsonResponseCache<uint64_t> m_txBlockTxnHashes{RPC_RESPONSE_CACHE_SIZE};
+};
+
+// Function-local so that the constants are read before the caches are built
+ResponseCaches& GetResponseCaches() {
+  static ResponseCaches caches;
+  return caches;
+}
+
+template <class Key>
+Json::Value CacheStatsToJson(const JsonResponseCache<Key>& cache) {
+  const auto stats = cache.GetStats();
+  Json::Value _json;
+  _json["Hits"] = to_string(stats.m_hits);
+  _json["Misses"] = to_string(stats.m_misses);
+  _json["Size"] = to_string(stats.m_size);
+  return _json;
+}
+}  // namespace
+
 LookupServer::LookupServer(Mediator& mediator,
                            jsonrpc::AbstractServerConnector& server)
     : Server(mediator),
       jsonrpc::AbstractServer<LookupServer>(server,
-                                            jsonrpc::JSONRPC_SERVER_V2) {
+                                            jsonrpc::JSONRPC_SERVER_V2),
+      m_admission(RPC_HEAVY_METHOD_BUDGET, RPC_ADMISSION_TIMEOUT_IN_MS),
+      m_connector(server) {
   this->bindAndAddMethod(
       jsonrpc::Procedure("GetCurrentMiniEpoch", jsonrpc::PARAMS_BY_POSITION,
                          jsonrpc::JSON_STRING, NULL),
@@ -255,10 +286,54 @@ LookupServer::LookupServer(Mediator& mediator,
   m_TxBlockCache.first = 0;
   m_TxBlockCache.second.resize(NUM_PAGES_CACHE * PAGE_SIZE);
   m_RecentTransactions.resize(TXN_PAGE_SIZE);
-  m_TxBlockCountSumPair.first = 0;
-  m_TxBlockCountSumPair.second = 0;
   random_device rd;
   m_eng = mt19937(rd());
+
+  // Calls that scan storage or state are limited, so that they cannot hold
+  // every server thread and stall the cheap queries
+  for (const auto& method :
+       {"GetSmartContractState", "GetSmartContracts", "DSBlockListing",
+        "TxBlockListing", "GetTransactionsForTxBlock",
+        "GetTxnBodiesForTxBlock"}) {
+    m_admission.SetLimit(method, RPC_HEAVY_METHOD_MAX_RUNNING,
+                         RPC_HEAVY_METHOD_MAX_QUEUED);
+  }
+
+  // Serve batch requests in parallel, ahead of the protocol handler
+  auto protocolHandler =
+      dynamic_cast<jsonrpc::AbstractProtocolHandler*>(server.GetHandler());
+  if (protocolHandler == nullptr) {
+    LOG_GENERAL(WARNING, "Batch requests will be served sequentially");
+  } else {
+    m_batchHandler = make_unique<BatchRequestHandler>(
+        *protocolHandler, m_admission, RPC_MAX_BATCH_SIZE, RPC_BATCH_THREADS);
+    m_protocolHandler = protocolHandler;
+    m_connector.SetHandler(m_batchHandler.get());
+  }
+
+  // Load or rebuild the txn counts before the first statistics query
+  auto func = [this]() -> void {
+    m_txnCountIndex.Update(m_mediator.m_txBlockChain);
+  };
+  DetachedFunction(1, func);
+}
+
+LookupServer::~LookupServer() {
+  if (m_batchHandler) {
+    m_connector.SetHandler(m_protocolHandler);
+  }
+}
+
+void LookupServer::HandleMethodCall(jsonrpc::Procedure& proc,
+                                    const Json::Value& input,
+                                    Json::Value& output) {
+  const auto ticket = m_admission.Admit(proc.GetProcedureName());
+  if (!ticket.IsAdmitted()) {
+    throw JsonRpcException(
+        RPC_SERVER_BUSY,
+        "Too many " + proc.GetProcedureName() + " requests, retry later");
+  }
+  jsonrpc::AbstractServer<LookupServer>::HandleMethodCall(proc, input, output);
 }
 
 string LookupServer::GetNetworkId() {
@@ -621,6 +696,11 @@ Json::Value LookupServer::GetTransaction(const string& transactionHash) {
     if (transactionHash.size() != TRAN_HASH_SIZE * 2) {
       throw JsonRpcException(RPC_INVALID_PARAMS, "Size not appropriate");
     }
+    auto& cache = GetResponseCaches().m_txns;
+    const auto cached = cache.Get(tranHash);
+    if (cached != nullptr) {
+      return *cached;
+    }
     bool isPresent = BlockStorage::GetBlockStorage().GetTxBody(tranHash, tptr);
     bool isPresentHistorical = false;
     if (m_mediator.m_lookup->m_historicalDB && !isPresent) {
@@ -629,8 +709,7 @@ Json::Value LookupServer::GetTransaction(const string& transactionHash) {
                                                                  tptr);
     }
     if (isPresentHistorical || isPresent) {
-      Json::Value _json;
-      return JSONConversion::convertTxtoJson(*tptr);
+      return *cache.Put(tranHash, JSONConversion::convertTxtoJson(*tptr));
     } else {
       throw JsonRpcException(RPC_DATABASE_ERROR, "Txn Hash not Present");
     }
@@ -683,8 +762,17 @@ Json::Value LookupServer::GetDsBlock(const string& blockNum) {
 
   try {
     uint64_t BlockNum = stoull(blockNum);
-    return JSONConversion::convertDSblocktoJson(
-        m_mediator.m_dsBlockChain.GetBlock(BlockNum));
+    auto& cache = GetResponseCaches().m_dsBlocks;
+    const auto cached = cache.Get(BlockNum);
+    if (cached != nullptr) {
+      return *cached;
+    }
+    const DSBlock dsBlock = m_mediator.m_dsBlockChain.GetBlock(BlockNum);
+    if (dsBlock.GetHeader().GetBlockNum() != BlockNum) {
+      // Dummy block, do not cache
+      return JSONConversion::convertDSblocktoJson(dsBlock);
+    }
+    return *cache.Put(BlockNum, JSONConversion::convertDSblocktoJson(dsBlock));
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (runtime_error& e) {
@@ -709,8 +797,17 @@ Json::Value LookupServer::GetTxBlock(const string& blockNum) {
 
   try {
     uint64_t BlockNum = stoull(blockNum);
-    return JSONConversion::convertTxBlocktoJson(
-        m_mediator.m_txBlockChain.GetBlock(BlockNum));
+    auto& cache = GetResponseCaches().m_txBlocks;
+    const auto cached = cache.Get(BlockNum);
+    if (cached != nullptr) {
+      return *cached;
+    }
+    const TxBlock txBlock = m_mediator.m_txBlockChain.GetBlock(BlockNum);
+    if (txBlock.GetHeader().GetBlockNum() != BlockNum) {
+      // Dummy block, do not cache
+      return JSONConversion::convertTxBlocktoJson(txBlock);
+    }
+    return *cache.Put(BlockNum, JSONConversion::convertTxBlocktoJson(txBlock));
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (runtime_error& e) {
@@ -1101,22 +1198,14 @@ string LookupServer::GetNumTransactions() {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
 
-  lock_guard<mutex> g(m_mutexBlockTxPair);
-
   uint64_t currBlock =
       m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
   if (currBlock == INIT_BLOCK_NUMBER) {
     throw JsonRpcException(RPC_IN_WARMUP, "No Tx blocks");
   }
-  if (m_BlockTxPair.first < currBlock) {
-    for (uint64_t i = m_BlockTxPair.first + 1; i <= currBlock; i++) {
-      m_BlockTxPair.second +=
-          m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
-    }
-  }
-  m_BlockTxPair.first = currBlock;
+  m_txnCountIndex.Update(m_mediator.m_txBlockChain);
 
-  return m_BlockTxPair.second.str();
+  return m_txnCountIndex.GetNumTxns(0, currBlock).str();
 }
 
 size_t LookupServer::GetNumTransactions(uint64_t blockNum) {
@@ -1135,13 +1224,10 @@ size_t LookupServer::GetNumTransactions(uint64_t blockNum) {
     return 0;
   }
 
-  size_t i, res = 0;
+  m_txnCountIndex.Update(m_mediator.m_txBlockChain);
 
-  for (i = blockNum + 1; i <= currBlockNum; i++) {
-    res += m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
-  }
-
-  return res;
+  return m_txnCountIndex.GetNumTxns(blockNum, currBlockNum)
+      .convert_to<size_t>();
 }
 double LookupServer::GetTransactionRate() {
   LOG_MARKER();
@@ -1542,6 +1628,33 @@ void LookupServer::AddToRecentTransactions(const TxnHash& txhash) {
   lock_guard<mutex> g(m_mutexRecentTxns);
   m_RecentTransactions.insert_new(m_RecentTransactions.size(), txhash.hex());
 }
+
+void LookupServer::AddToResponseCache(const TransactionWithReceipt& twr) {
+  auto& cache = GetResponseCaches().m_txns;
+  if (cache.IsEnabled()) {
+    cache.Put(twr.GetTransaction().GetTranID(),
+              JSONConversion::convertTxtoJson(twr));
+  }
+}
+
+void LookupServer::AddToResponseCache(const TxBlock& txBlock) {
+  auto& cache = GetResponseCaches().m_txBlocks;
+  if (cache.IsEnabled()) {
+    cache.Put(txBlock.GetHeader().GetBlockNum(),
+              JSONConversion::convertTxBlocktoJson(txBlock));
+  }
+}
+
+Json::Value LookupServer::GetResponseCacheStats() {
+  auto& caches = GetResponseCaches();
+  Json::Value _json;
+  _json["Transactions"] = CacheStatsToJson(caches.m_txns);
+  _json["TxBlocks"] = CacheStatsToJson(caches.m_txBlocks);
+  _json["DSBlocks"] = CacheStatsToJson(caches.m_dsBlocks);
+  _json["TxBlockTxnHashes"] = CacheStatsToJson(caches.m_txBlockTxnHashes);
+  return _json;
+}
+
 Json::Value LookupServer::GetShardingStructure() {
   LOG_MARKER();
   if (!LOOKUP_NODE_MODE) {
@@ -1594,37 +1707,11 @@ string LookupServer::GetNumTxnsDSEpoch() {
     auto latestTxBlockNum = latestTxBlock.GetBlockNum();
     auto latestDSBlockNum = latestTxBlock.GetDSBlockNum();
 
-    lock_guard<mutex> g(m_mutexTxBlockCountSumPair);
-
-    if (latestTxBlockNum > m_TxBlockCountSumPair.first) {
-      // Case where the DS Epoch is same
-      if (m_mediator.m_txBlockChain.GetBlock(m_TxBlockCountSumPair.first)
-              .GetHeader()
-              .GetDSBlockNum() == latestDSBlockNum) {
-        for (auto i = latestTxBlockNum; i > m_TxBlockCountSumPair.first; i--) {
-          m_TxBlockCountSumPair.second +=
-              m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
-        }
-      }
-      // Case if DS Epoch Changed
-      else {
-        m_TxBlockCountSumPair.second = 0;
-
-        for (auto i = latestTxBlockNum; i > m_TxBlockCountSumPair.first; i--) {
-          if (m_mediator.m_txBlockChain.GetBlock(i)
-                  .GetHeader()
-                  .GetDSBlockNum() < latestDSBlockNum) {
-            break;
-          }
-          m_TxBlockCountSumPair.second +=
-              m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
-        }
-      }
-
-      m_TxBlockCountSumPair.first = latestTxBlockNum;
-    }
+    m_txnCountIndex.Update(m_mediator.m_txBlockChain);
 
-    return m_TxBlockCountSumPair.second.str();
+    return m_txnCountIndex
+        .GetNumTxnsInDSEpoch(latestDSBlockNum, latestTxBlockNum)
+        .str();
   } catch (const JsonRpcException& je) {
     throw je;
   }
@@ -1679,10 +1766,45 @@ Json::Value LookupServer::GetTxnBodiesForTxBlock(const string& txBlockNum) {
       throw JsonRpcException(RPC_MISC_ERROR, "TxBlock has no transactions");
     }
 
+    // Serve what is cached, and read the rest from the block's bodies
+    auto& cache = GetResponseCaches().m_txns;
+    vector<TxnHash> txnHashes;
+    vector<JsonResponseCache<TxnHash>::ValuePtr> responses;
+    unordered_set<TxnHash> missing;
     for (const auto& shard_txn : hashes) {
       for (const auto& txn_hash : shard_txn) {
-        auto json_txn = GetTransaction(txn_hash.asString());
-        _json.append(json_txn);
+        txnHashes.emplace_back(txn_hash.asString());
+        responses.emplace_back(cache.Get(txnHashes.back()));
+        if (responses.back() == nullptr) {
+          missing.emplace(txnHashes.back());
+        }
+      }
+    }
+
+    // The segment store keeps the bodies of a block together, so read them
+    // in one go instead of looking up each txn
+    vector<TxBodySharedPtr> blockBodies;
+    if (!missing.empty() &&
+        BlockStorage::GetBlockStorage().GetTxBodiesForEpoch(txNum, missing,
+                                                            blockBodies)) {
+      unordered_map<TxnHash, TxBodySharedPtr> bodies;
+      for (const auto& body : blockBodies) {
+        bodies.emplace(body->GetTransaction().GetTranID(), body);
+      }
+      for (size_t i = 0; i < txnHashes.size(); i++) {
+        const auto body = bodies.find(txnHashes[i]);
+        if (responses[i] == nullptr && body != bodies.end()) {
+          responses[i] = cache.Put(
+              body->first, JSONConversion::convertTxtoJson(*body->second));
+        }
+      }
+    }
+
+    for (size_t i = 0; i < txnHashes.size(); i++) {
+      if (responses[i] != nullptr) {
+        _json.append(*responses[i]);
+      } else {
+        _json.append(GetTransaction(txnHashes[i].hex()));
       }
     }
   } catch (const JsonRpcException& je) {
@@ -1709,6 +1831,15 @@ Json::Value LookupServer::GetTransactionsForTxBlock(const TxBlock& txBlock,
     throw JsonRpcException(RPC_INVALID_PARAMS, "Tx Block does not exist");
   }
 
+  // Microblocks of a block in the chain are final, so a complete listing can
+  // be served again without reading them
+  auto& cache = GetResponseCaches().m_txBlockTxnHashes;
+  const uint64_t blockNum = txBlock.GetHeader().GetBlockNum();
+  const auto cached = cache.Get(blockNum);
+  if (cached != nullptr) {
+    return *cached;
+  }
+
   auto microBlockInfos = txBlock.GetMicroBlockInfos();
   Json::Value _json = Json::arrayValue;
   bool hasTransactions = false;
@@ -1744,6 +1875,8 @@ Json::Value LookupServer::GetTransactionsForTxBlock(const TxBlock& txBlock,
     throw JsonRpcException(RPC_MISC_ERROR, "TxBlock has no transactions");
   }
 
+  cache.Put(blockNum, _json);
+
   return _json;
 }
 
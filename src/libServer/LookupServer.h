@@ -18,7 +18,10 @@
 #ifndef ZILLIQA_SRC_LIBSERVER_LOOKUPSERVER_H_
 #define ZILLIQA_SRC_LIBSERVER_LOOKUPSERVER_H_
 
+#include "AdmissionControl.h"
+#include "BatchRequestHandler.h"
 #include "Server.h"
+#include "TxnCountIndex.h"
 
 class Mediator;
 
@@ -27,10 +30,14 @@ typedef std::function<bool(const Transaction& tx, uint32_t shardId)>
 
 class LookupServer : public Server,
                      public jsonrpc::AbstractServer<LookupServer> {
-  std::mutex m_mutexBlockTxPair;
-  std::pair<uint64_t, uint128_t> m_BlockTxPair;
-  std::mutex m_mutexTxBlockCountSumPair;
-  std::pair<uint64_t, uint128_t> m_TxBlockCountSumPair;
+  TxnCountIndex m_txnCountIndex;
+  AdmissionControl m_admission;
+  // Installed on m_connector ahead of m_protocolHandler. The connector only
+  // holds a plain pointer to it, so the destructor puts the protocol handler
+  // back first.
+  std::unique_ptr<BatchRequestHandler> m_batchHandler;
+  jsonrpc::AbstractServerConnector& m_connector;
+  jsonrpc::IClientConnectionHandler* m_protocolHandler{nullptr};
   uint64_t m_StartTimeTx;
   uint64_t m_StartTimeDs;
   std::mutex m_mutexDSBlockCache;
@@ -50,7 +57,11 @@ class LookupServer : public Server,
 
  public:
   LookupServer(Mediator& mediator, jsonrpc::AbstractServerConnector& server);
-  ~LookupServer() = default;
+  ~LookupServer();
+
+  /// Admits the call under the limit of its method, if it has one.
+  void HandleMethodCall(jsonrpc::Procedure& proc, const Json::Value& input,
+                        Json::Value& output) override;
 
   inline virtual void GetNetworkIdI(const Json::Value& request,
                                     Json::Value& response) {
@@ -268,6 +279,16 @@ class LookupServer : public Server,
 
   static void AddToRecentTransactions(const dev::h256& txhash);
 
+  /// Stores the response fragment of a confirmed transaction, so that the
+  /// first query for it does not go to BlockStorage.
+  static void AddToResponseCache(const TransactionWithReceipt& twr);
+
+  /// Stores the response fragment of a finalized Tx block.
+  static void AddToResponseCache(const TxBlock& txBlock);
+
+  /// Hit and miss counts of the block and transaction response caches.
+  static Json::Value GetResponseCacheStats();
+
   // gets the number of transaction starting from block blockNum to most recent
   // block
   Json::Value GetPendingTxn(const std::string& tranID);
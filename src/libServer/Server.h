@@ -56,6 +56,7 @@ class ServerBase {
     RPC_VERIFY_REJECTED =
         -26,  //!< Transaction or block was rejected by network rules
     RPC_IN_WARMUP = -28,          //!< Client still warming up
+    RPC_SERVER_BUSY = -30,        //!< Too many calls of the method
     RPC_METHOD_DEPRECATED = -32,  //!< RPC method is deprecated
   };
 };
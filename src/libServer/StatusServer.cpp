@@ -17,8 +17,10 @@
 
 #include "StatusServer.h"
 #include "JSONConversion.h"
+#include "LookupServer.h"
 #include "libNetwork/Blacklist.h"
 #include "libRemoteStorageDB/RemoteStorageDB.h"
+#include "libUtils/Metrics.h"
 
 using namespace jsonrpc;
 using namespace std;
@@ -147,6 +149,14 @@ StatusServer::StatusServer(Mediator& mediator,
       jsonrpc::Procedure("InitRemoteStorage", jsonrpc::PARAMS_BY_POSITION,
                          jsonrpc::JSON_OBJECT, NULL),
       &StatusServer::InitRemoteStorageI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetResponseCacheStats", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, NULL),
+      &StatusServer::GetResponseCacheStatsI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetMetrics", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, NULL),
+      &StatusServer::GetMetricsI);
 }
 
 string StatusServer::GetLatestEpochStatesUpdated() {
@@ -566,3 +576,49 @@ bool StatusServer::InitRemoteStorage() {
 
   return true;
 }
+
+Json::Value StatusServer::GetResponseCacheStats() {
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST,
+                           "Not to be queried on non-lookup");
+  }
+  return LookupServer::GetResponseCacheStats();
+}
+
+Json::Value StatusServer::GetMetrics() {
+  vector<Metrics::Sample<uint64_t>> counters;
+  vector<Metrics::Sample<int64_t>> gauges;
+  vector<Metrics::Sample<Metrics::Histogram::Snapshot>> histograms;
+  Metrics::GetInstance().Collect(counters, gauges, histograms);
+
+  auto getKey = [](const string& name, const string& labels) -> string {
+    return labels.empty() ? name : name + "{" + labels + "}";
+  };
+
+  Json::Value _json;
+  _json["Counters"] = Json::objectValue;
+  for (const auto& counter : counters) {
+    _json["Counters"][getKey(counter.m_name, counter.m_labels)] =
+        to_string(counter.m_value);
+  }
+  _json["Gauges"] = Json::objectValue;
+  for (const auto& gauge : gauges) {
+    _json["Gauges"][getKey(gauge.m_name, gauge.m_labels)] =
+        to_string(gauge.m_value);
+  }
+  _json["Histograms"] = Json::objectValue;
+  for (const auto& histogram : histograms) {
+    const auto& snapshot = histogram.m_value;
+    Json::Value _jsonHistogram;
+    _jsonHistogram["Count"] = to_string(snapshot.m_count);
+    _jsonHistogram["Sum"] = to_string(snapshot.m_sum);
+    _jsonHistogram["Max"] = to_string(snapshot.m_max);
+    _jsonHistogram["P50"] = to_string(snapshot.GetPercentile(0.5));
+    _jsonHistogram["P90"] = to_string(snapshot.GetPercentile(0.9));
+    _jsonHistogram["P99"] = to_string(snapshot.GetPercentile(0.99));
+    _jsonHistogram["P999"] = to_string(snapshot.GetPercentile(0.999));
+    _json["Histograms"][getKey(histogram.m_name, histogram.m_labels)] =
+        _jsonHistogram;
+  }
+  return _json;
+}
@@ -130,6 +130,16 @@ class StatusServer : public Server,
     (void)request;
     response = this->InitRemoteStorage();
   }
+  inline virtual void GetResponseCacheStatsI(const Json::Value& request,
+                                             Json::Value& response) {
+    (void)request;
+    response = this->GetResponseCacheStats();
+  }
+  inline virtual void GetMetricsI(const Json::Value& request,
+                                  Json::Value& response) {
+    (void)request;
+    response = this->GetMetrics();
+  }
 
   Json::Value IsTxnInMemPool(const std::string& tranID);
   bool AddToBlacklistExclusion(const std::string& ipAddr);
@@ -156,6 +166,8 @@ class StatusServer : public Server,
   bool ToggleRemoteStorage();
   bool GetRemoteStorage();
   bool InitRemoteStorage();
+  Json::Value GetResponseCacheStats();
+  Json::Value GetMetrics();
 };
 
 #endif  // ZILLIQA_SRC_LIBSERVER_STATUSSERVER_H_
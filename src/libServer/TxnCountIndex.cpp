@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TxnCountIndex.h"
+#include "common/Constants.h"
+#include "common/Serializable.h"
+#include "libPersistence/BlockStorage.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace {
+const unsigned int ENTRY_SIZE = UINT128_SIZE + sizeof(uint64_t);
+
+// Persisted entry: cumulative txn count followed by the DS block number
+bytes SerializeEntry(const uint128_t& cumulativeTxns,
+                     const uint64_t& dsBlockNum) {
+  bytes entry;
+  Serializable::SetNumber<uint128_t>(entry, 0, cumulativeTxns, UINT128_SIZE);
+  Serializable::SetNumber<uint64_t>(entry, UINT128_SIZE, dsBlockNum,
+                                    sizeof(uint64_t));
+  return entry;
+}
+}  // namespace
+
+TxnCountIndex::TxnCountIndex(bool persist) : m_persist(persist) {}
+
+void TxnCountIndex::AppendLocked(const uint64_t& dsBlockNum,
+                                 const uint32_t& numTxs) {
+  const uint64_t blockNum = m_cumulativeTxns.size();
+  const uint128_t previous =
+      m_cumulativeTxns.empty() ? 0 : m_cumulativeTxns.back();
+  m_cumulativeTxns.emplace_back(previous + numTxs);
+
+  if (dsBlockNum != INIT_BLOCK_NUMBER) {
+    m_dsEpochStarts.emplace(dsBlockNum, blockNum);
+  }
+}
+
+void TxnCountIndex::TruncateLocked(const uint64_t& numBlocks) {
+  m_cumulativeTxns.resize(numBlocks);
+  for (auto it = m_dsEpochStarts.begin(); it != m_dsEpochStarts.end();) {
+    if (it->second >= numBlocks) {
+      it = m_dsEpochStarts.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void TxnCountIndex::LoadLocked() {
+  map<uint64_t, bytes> entries;
+  if (!BlockStorage::GetBlockStorage().GetAllTxnCounts(entries)) {
+    LOG_GENERAL(WARNING, "BlockStorage::GetAllTxnCounts failed");
+    return;
+  }
+
+  m_cumulativeTxns.clear();
+  m_dsEpochStarts.clear();
+  m_cumulativeTxns.reserve(entries.size());
+
+  for (const auto& entry : entries) {
+    // Anything past a gap is rebuilt from the blocks
+    if (entry.first != m_cumulativeTxns.size() ||
+        entry.second.size() != ENTRY_SIZE) {
+      LOG_GENERAL(WARNING, "Txn count index stops at block " << entry.first);
+      break;
+    }
+    const uint64_t dsBlockNum = Serializable::GetNumber<uint64_t>(
+        entry.second, UINT128_SIZE, sizeof(uint64_t));
+    m_cumulativeTxns.emplace_back(Serializable::GetNumber<uint128_t>(
+        entry.second, 0, UINT128_SIZE));
+    if (dsBlockNum != INIT_BLOCK_NUMBER) {
+      m_dsEpochStarts.emplace(dsBlockNum, entry.first);
+    }
+  }
+
+  LOG_GENERAL(INFO, "Loaded txn counts of " << m_cumulativeTxns.size()
+                                            << " Tx blocks");
+}
+
+bool TxnCountIndex::Update(TxBlockChain& txBlockChain) {
+  lock_guard<mutex> g(m_mutex);
+
+  if (m_persist && !m_loaded) {
+    LoadLocked();
+  }
+  m_loaded = true;
+
+  const uint64_t lastBlockNum =
+      txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+  if (lastBlockNum == INIT_BLOCK_NUMBER) {
+    return false;
+  }
+
+  // Entries past the tip belong to blocks that were since removed
+  if (m_cumulativeTxns.size() > lastBlockNum + 1) {
+    TruncateLocked(lastBlockNum + 1);
+  }
+
+  vector<pair<uint64_t, bytes>> entries;
+  bool complete = true;
+
+  for (uint64_t blockNum = m_cumulativeTxns.size(); blockNum <= lastBlockNum;
+       blockNum++) {
+    const TxBlock txBlock = txBlockChain.GetBlock(blockNum);
+    const TxBlockHeader& header = txBlock.GetHeader();
+
+    if (header.GetBlockNum() != blockNum) {
+      // Counting it as empty would skew every later count, so stop here and
+      // retry from this block on the next update
+      LOG_GENERAL(WARNING, "Tx block " << blockNum
+                                       << " missing, txn counts stop at "
+                                       << m_cumulativeTxns.size()
+                                       << " blocks");
+      complete = false;
+      break;
+    }
+
+    AppendLocked(header.GetDSBlockNum(), header.GetNumTxs());
+    if (m_persist) {
+      entries.emplace_back(blockNum, SerializeEntry(m_cumulativeTxns.back(),
+                                                    header.GetDSBlockNum()));
+    }
+  }
+
+  if (!entries.empty() &&
+      !BlockStorage::GetBlockStorage().PutTxnCounts(entries)) {
+    LOG_GENERAL(WARNING, "BlockStorage::PutTxnCounts failed");
+  }
+
+  return complete;
+}
+
+bool TxnCountIndex::Append(const uint64_t& blockNum,
+                           const uint64_t& dsBlockNum,
+                           const uint32_t& numTxs) {
+  lock_guard<mutex> g(m_mutex);
+
+  if (blockNum != m_cumulativeTxns.size()) {
+    LOG_GENERAL(WARNING, "Expected Tx block " << m_cumulativeTxns.size()
+                                              << " but got " << blockNum);
+    return false;
+  }
+
+  AppendLocked(dsBlockNum, numTxs);
+  return true;
+}
+
+uint64_t TxnCountIndex::GetNumBlocks() const {
+  lock_guard<mutex> g(m_mutex);
+  return m_cumulativeTxns.size();
+}
+
+uint128_t TxnCountIndex::GetNumTxns(const uint64_t& fromBlockNum,
+                                    const uint64_t& toBlockNum) const {
+  lock_guard<mutex> g(m_mutex);
+
+  if (m_cumulativeTxns.empty()) {
+    return 0;
+  }
+
+  const uint64_t to = min<uint64_t>(toBlockNum, m_cumulativeTxns.size() - 1);
+  if (fromBlockNum >= to) {
+    return 0;
+  }
+
+  return m_cumulativeTxns[to] - m_cumulativeTxns[fromBlockNum];
+}
+
+uint128_t TxnCountIndex::GetNumTxnsInDSEpoch(
+    const uint64_t& dsBlockNum, const uint64_t& toBlockNum) const {
+  lock_guard<mutex> g(m_mutex);
+
+  const auto it = m_dsEpochStarts.find(dsBlockNum);
+  if (it == m_dsEpochStarts.end() || m_cumulativeTxns.empty()) {
+    return 0;
+  }
+
+  const uint64_t to = min<uint64_t>(toBlockNum, m_cumulativeTxns.size() - 1);
+  const uint64_t start = it->second;
+  if (start > to) {
+    return 0;
+  }
+
+  return start == 0 ? m_cumulativeTxns[to]
+                    : m_cumulativeTxns[to] - m_cumulativeTxns[start - 1];
+}
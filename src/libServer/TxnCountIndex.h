@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBSERVER_TXNCOUNTINDEX_H_
+#define ZILLIQA_SRC_LIBSERVER_TXNCOUNTINDEX_H_
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "common/BaseType.h"
+#include "libData/BlockChainData/BlockChain.h"
+
+/// Cumulative txn counts of the Tx blocks, so that the number of txns in any
+/// range of blocks or in a DS epoch is found in constant time.
+///
+/// Each Tx block is read once when the index is extended to the tip of the
+/// chain. When persisted, the entries are kept in BlockStorage and reloaded
+/// on first use, so only blocks added since the last run are read again.
+class TxnCountIndex {
+  const bool m_persist;
+
+  mutable std::mutex m_mutex;
+  bool m_loaded{false};
+
+  /// Number of txns in Tx blocks 0 up to and including the index
+  std::vector<uint128_t> m_cumulativeTxns;
+
+  /// First Tx block of each DS epoch
+  std::map<uint64_t, uint64_t> m_dsEpochStarts;
+
+  void AppendLocked(const uint64_t& dsBlockNum, const uint32_t& numTxs);
+  void TruncateLocked(const uint64_t& numBlocks);
+  void LoadLocked();
+
+ public:
+  explicit TxnCountIndex(bool persist = true);
+
+  /// Extends the index up to the last block of the chain. Returns false if
+  /// the chain is empty or a block could not be read; the index then stops
+  /// before that block, and the next update resumes from it.
+  bool Update(TxBlockChain& txBlockChain);
+
+  /// Appends the counts of the next Tx block.
+  bool Append(const uint64_t& blockNum, const uint64_t& dsBlockNum,
+              const uint32_t& numTxs);
+
+  /// Number of Tx blocks covered by the index.
+  uint64_t GetNumBlocks() const;
+
+  /// Number of txns in Tx blocks fromBlockNum + 1 to toBlockNum.
+  uint128_t GetNumTxns(const uint64_t& fromBlockNum,
+                       const uint64_t& toBlockNum) const;
+
+  /// Number of txns in the Tx blocks of a DS epoch, up to toBlockNum.
+  uint128_t GetNumTxnsInDSEpoch(const uint64_t& dsBlockNum,
+                                const uint64_t& toBlockNum) const;
+};
+
+#endif  // ZILLIQA_SRC_LIBSERVER_TXNCOUNTINDEX_H_
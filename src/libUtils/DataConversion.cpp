@@ -17,8 +17,248 @@
 
 #include "DataConversion.h"
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define ZILLIQA_HEX_SIMD 1
+#endif
+
 using namespace std;
 
+// Hex conversions sit under every JSON-RPC response, log line and database
+// key, so they are vectorized: SSE2 (always present on x86-64), AVX2 when the
+// CPU supports it, and a scalar loop for the tail and for other platforms.
+namespace {
+
+const char HEX_UPPER[] = "0123456789ABCDEF";
+const char HEX_LOWER[] = "0123456789abcdef";
+
+void BytesToHexScalar(const uint8_t* src, size_t len, char* dst,
+                      bool upperCase) {
+  const char* digits = upperCase ? HEX_UPPER : HEX_LOWER;
+  for (size_t i = 0; i < len; i++) {
+    dst[2 * i] = digits[src[i] >> 4];
+    dst[2 * i + 1] = digits[src[i] & 0x0F];
+  }
+}
+
+int HexDigitValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+bool HexToBytesScalar(const char* src, size_t len, uint8_t* dst) {
+  for (size_t i = 0; i < len; i += 2) {
+    const int hi = HexDigitValue(src[i]);
+    const int lo = HexDigitValue(src[i + 1]);
+    if (hi < 0 || lo < 0) {
+      return false;
+    }
+    dst[i / 2] = static_cast<uint8_t>((hi << 4) | lo);
+  }
+  return true;
+}
+
+#ifdef ZILLIQA_HEX_SIMD
+// Each 16-bit lane holds one input byte; returns its two nibbles in output
+// order (high nibble in the low byte)
+inline __m128i SplitNibbles(__m128i v) {
+  const __m128i hi = _mm_srli_epi16(v, 4);
+  const __m128i lo = _mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x0F)), 8);
+  return _mm_or_si128(hi, lo);
+}
+
+// Maps nibbles 0-15 to their ASCII hex digits
+inline __m128i NibblesToAscii(__m128i n, __m128i letterOffset) {
+  const __m128i isLetter = _mm_cmpgt_epi8(n, _mm_set1_epi8(9));
+  return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')),
+                      _mm_and_si128(isLetter, letterOffset));
+}
+
+size_t BytesToHexSSE2(const uint8_t* src, size_t len, char* dst,
+                      bool upperCase) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i letterOffset = _mm_set1_epi8(upperCase ? 'A' - '0' - 10
+                                                       : 'a' - '0' - 10);
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i lo = SplitNibbles(_mm_unpacklo_epi8(v, zero));
+    const __m128i hi = SplitNibbles(_mm_unpackhi_epi8(v, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i),
+                     NibblesToAscii(lo, letterOffset));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 16),
+                     NibblesToAscii(hi, letterOffset));
+  }
+  return i;
+}
+
+// Returns the nibble value of each character, and sets valid to false if any
+// character is not a hex digit
+inline __m128i AsciiToNibbles(__m128i c, bool& valid) {
+  const __m128i isDigit =
+      _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                    _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+  const __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+  const __m128i isLetter =
+      _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                    _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+  valid = _mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) == 0xFFFF;
+
+  const __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+  const __m128i letter = _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10));
+  return _mm_or_si128(_mm_and_si128(isDigit, digit),
+                      _mm_andnot_si128(isDigit, letter));
+}
+
+size_t HexToBytesSSE2(const char* src, size_t len, uint8_t* dst, bool& valid) {
+  valid = true;
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32) {
+    bool valid1 = false;
+    bool valid2 = false;
+    const __m128i n1 = AsciiToNibbles(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), valid1);
+    const __m128i n2 = AsciiToNibbles(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16)),
+        valid2);
+    if (!valid1 || !valid2) {
+      valid = false;
+      return i;
+    }
+    // Join each (high, low) nibble pair held in a 16-bit lane
+    const __m128i mask = _mm_set1_epi16(0x00FF);
+    const __m128i b1 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n1, mask), 4),
+                                    _mm_srli_epi16(n1, 8));
+    const __m128i b2 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n2, mask), 4),
+                                    _mm_srli_epi16(n2, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i / 2),
+                     _mm_packus_epi16(b1, b2));
+  }
+  return i;
+}
+
+__attribute__((target("avx2"))) size_t BytesToHexAVX2(const uint8_t* src,
+                                                      size_t len, char* dst,
+                                                      bool upperCase) {
+  const __m256i low4 = _mm256_set1_epi16(0x0F);
+  const __m256i nine = _mm256_set1_epi8(9);
+  const __m256i ascii0 = _mm256_set1_epi8('0');
+  const __m256i letterOffset = _mm256_set1_epi8(
+      upperCase ? 'A' - '0' - 10 : 'a' - '0' - 10);
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const __m256i v = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    const __m256i n =
+        _mm256_or_si256(_mm256_srli_epi16(v, 4),
+                        _mm256_slli_epi16(_mm256_and_si256(v, low4), 8));
+    const __m256i isLetter = _mm256_cmpgt_epi8(n, nine);
+    const __m256i ascii = _mm256_add_epi8(
+        _mm256_add_epi8(n, ascii0), _mm256_and_si256(isLetter, letterOffset));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i), ascii);
+  }
+  return i;
+}
+
+__attribute__((target("avx2"))) inline __m256i AsciiToNibblesAVX2(
+    __m256i c, bool& valid) {
+  const __m256i isDigit =
+      _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+                       _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+  const __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+  const __m256i isLetter =
+      _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                       _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+  valid = _mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter)) == -1;
+
+  const __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+  const __m256i letter = _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10));
+  return _mm256_blendv_epi8(letter, digit, isDigit);
+}
+
+__attribute__((target("avx2"))) size_t HexToBytesAVX2(const char* src,
+                                                      size_t len, uint8_t* dst,
+                                                      bool& valid) {
+  const __m256i mask = _mm256_set1_epi16(0x00FF);
+  valid = true;
+  size_t i = 0;
+  for (; i + 64 <= len; i += 64) {
+    bool valid1 = false;
+    bool valid2 = false;
+    const __m256i n1 = AsciiToNibblesAVX2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), valid1);
+    const __m256i n2 = AsciiToNibblesAVX2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32)),
+        valid2);
+    if (!valid1 || !valid2) {
+      valid = false;
+      return i;
+    }
+    const __m256i b1 =
+        _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(n1, mask), 4),
+                        _mm256_srli_epi16(n1, 8));
+    const __m256i b2 =
+        _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(n2, mask), 4),
+                        _mm256_srli_epi16(n2, 8));
+    // packus works within 128-bit lanes, so restore the byte order after
+    const __m256i packed = _mm256_permute4x64_epi64(
+        _mm256_packus_epi16(b1, b2), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i / 2), packed);
+  }
+  return i;
+}
+
+bool HasAVX2() {
+  static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+  return hasAVX2;
+}
+#endif
+
+}  // namespace
+
+void DataConversion::BytesToHexChars(const uint8_t* src, size_t len, char* dst,
+                                     bool upperCase) {
+  size_t done = 0;
+#ifdef ZILLIQA_HEX_SIMD
+  if (HasAVX2()) {
+    done = BytesToHexAVX2(src, len, dst, upperCase);
+  }
+  done += BytesToHexSSE2(src + done, len - done, dst + 2 * done, upperCase);
+#endif
+  BytesToHexScalar(src + done, len - done, dst + 2 * done, upperCase);
+}
+
+bool DataConversion::HexCharsToBytes(const char* src, size_t len,
+                                     uint8_t* dst) {
+  if (len % 2 != 0) {
+    return false;
+  }
+
+  size_t done = 0;
+#ifdef ZILLIQA_HEX_SIMD
+  bool valid = true;
+  if (HasAVX2()) {
+    done = HexToBytesAVX2(src, len, dst, valid);
+  }
+  if (valid) {
+    done += HexToBytesSSE2(src + done, len - done, dst + done / 2, valid);
+  }
+  if (!valid) {
+    return false;
+  }
+#endif
+  return HexToBytesScalar(src + done, len - done, dst + done / 2);
+}
+
 bool DataConversion::HexStringToUint64(const std::string& s, uint64_t* res) {
   try {
     *res = std::stoull(s, nullptr, 16);
@@ -33,11 +273,9 @@ bool DataConversion::HexStringToUint64(const std::string& s, uint64_t* res) {
 }
 
 bool DataConversion::HexStrToUint8Vec(const string& hex_input, bytes& out) {
-  try {
+  out.resize(hex_input.size() / 2);
+  if (!HexCharsToBytes(hex_input.data(), hex_input.size(), out.data())) {
     out.clear();
-    boost::algorithm::unhex(hex_input.begin(), hex_input.end(),
-                            back_inserter(out));
-  } catch (exception& e) {
     LOG_GENERAL(WARNING, "Failed HexStrToUint8Vec conversion");
     return false;
   }
@@ -46,6 +284,11 @@ bool DataConversion::HexStrToUint8Vec(const string& hex_input, bytes& out) {
 
 bool DataConversion::HexStrToStdArray(const string& hex_input,
                                       array<uint8_t, 32>& d) {
+  if (hex_input.size() == d.size() * 2 &&
+      HexCharsToBytes(hex_input.data(), hex_input.size(), d.data())) {
+    return true;
+  }
+
   d = {{0}};
   bytes v;
   if (HexStrToUint8Vec(hex_input, v)) {
@@ -58,6 +301,11 @@ bool DataConversion::HexStrToStdArray(const string& hex_input,
 
 bool DataConversion::HexStrToStdArray64(const string& hex_input,
                                         array<uint8_t, 64>& d) {
+  if (hex_input.size() == d.size() * 2 &&
+      HexCharsToBytes(hex_input.data(), hex_input.size(), d.data())) {
+    return true;
+  }
+
   d = {{0}};
   bytes v;
   if (HexStrToUint8Vec(hex_input, v)) {
@@ -69,26 +317,19 @@ bool DataConversion::HexStrToStdArray64(const string& hex_input,
 }
 
 bool DataConversion::Uint8VecToHexStr(const bytes& hex_vec, string& str) {
-  try {
-    str = "";
-    boost::algorithm::hex(hex_vec.begin(), hex_vec.end(), back_inserter(str));
-  } catch (exception& e) {
-    LOG_GENERAL(WARNING, "Failed Uint8VecToHexStr conversion");
-    return false;
-  }
+  str.resize(hex_vec.size() * 2);
+  BytesToHexChars(hex_vec.data(), hex_vec.size(), &str[0]);
   return true;
 }
 
 bool DataConversion::Uint8VecToHexStr(const bytes& hex_vec, unsigned int offset,
                                       unsigned int len, string& str) {
-  try {
-    str = "";
-    boost::algorithm::hex(hex_vec.begin() + offset,
-                          hex_vec.begin() + offset + len, back_inserter(str));
-  } catch (exception& e) {
+  if ((size_t)offset + len > hex_vec.size()) {
     LOG_GENERAL(WARNING, "Failed Uint8VecToHexStr conversion");
     return false;
   }
+  str.resize((size_t)len * 2);
+  BytesToHexChars(hex_vec.data() + offset, len, &str[0]);
   return true;
 }
 
@@ -96,28 +337,14 @@ bool DataConversion::SerializableToHexStr(const Serializable& input,
                                           string& str) {
   bytes tmp;
   input.Serialize(tmp, 0);
-  try {
-    str = "";
-    boost::algorithm::hex(tmp.begin(), tmp.end(), back_inserter(str));
-  } catch (exception& e) {
-    LOG_GENERAL(WARNING, "Failed SerializableToHexStr conversion");
-    return false;
-  }
-  return true;
+  return Uint8VecToHexStr(tmp, str);
 }
 
 bool DataConversion::SerializableToHexStr(const SerializableCrypto& input,
                                           string& str) {
   bytes tmp;
   input.Serialize(tmp, 0);
-  try {
-    str = "";
-    boost::algorithm::hex(tmp.begin(), tmp.end(), back_inserter(str));
-  } catch (exception& e) {
-    LOG_GENERAL(WARNING, "Failed SerializableToHexStr conversion");
-    return false;
-  }
-  return true;
+  return Uint8VecToHexStr(tmp, str);
 }
 
 uint16_t DataConversion::charArrTo16Bits(const bytes& hex_arr) {
@@ -19,7 +19,6 @@
 #define ZILLIQA_SRC_LIBUTILS_DATACONVERSION_H_
 
 #include <array>
-#include <boost/algorithm/hex.hpp>
 #include <exception>
 #include <sstream>
 #include <string>
@@ -58,17 +57,19 @@ class DataConversion {
   template <size_t SIZE>
   static bool charArrToHexStr(const std::array<uint8_t, SIZE>& hex_arr,
                               std::string& str) {
-    try {
-      str = "";
-      boost::algorithm::hex(hex_arr.begin(), hex_arr.end(),
-                            std::back_inserter(str));
-    } catch (std::exception& e) {
-      LOG_GENERAL(WARNING, "Failed charArrToHexStr conversion");
-      return false;
-    }
+    str.resize(SIZE * 2);
+    BytesToHexChars(hex_arr.data(), SIZE, &str[0]);
     return true;
   }
 
+  /// Writes the 2 * len hex digits of src to dst (uppercase by default).
+  static void BytesToHexChars(const uint8_t* src, size_t len, char* dst,
+                              bool upperCase = true);
+
+  /// Decodes len hex digits from src into len / 2 bytes at dst. Accepts
+  /// either case. Returns false on odd length or non-hex input.
+  static bool HexCharsToBytes(const char* src, size_t len, uint8_t* dst);
+
   /// Converts a serializable object to alphanumeric hex string.
   static bool SerializableToHexStr(const Serializable& input, std::string& str);
 
@@ -21,6 +21,7 @@
 #include <functional>
 #include <thread>
 #include "libUtils/Logger.h"
+#include "libUtils/Metrics.h"
 
 /// Utility class for executing a function in one or more separate detached
 /// threads.
@@ -35,6 +36,9 @@ class DetachedFunction {
     std::function<typename std::result_of<callable(arguments...)>::type()> task(
         std::bind(std::forward<callable>(f), std::forward<arguments>(args)...));
 
+    static auto& launched =
+        Metrics::GetInstance().GetCounter("zilliqa_detached_threads_total");
+
     bool attempt_flag = false;
 
     for (int i = 0; i < num_threads; i++) {
@@ -43,6 +47,7 @@ class DetachedFunction {
           if (!attempt_flag) {
             std::thread(task).detach();  // attempt to detach a non-thread
             attempt_flag = true;
+            launched.Increment();
           }
         } catch (const std::system_error& e) {
           LOG_GENERAL(WARNING,
@@ -40,9 +40,7 @@ class HashUtils {
     SHA2<HashType::HASH_VARIANT_256> sha2;
 
     sha2.Update(vec);
-    const bytes& resVec = sha2.Finalize();
-
-    return resVec;
+    return sha2.Finalize();
   }
   static uint16_t SerializableToHash16Bits(const Serializable& sz) {
     const bytes& vec = SerializableToHash(sz);
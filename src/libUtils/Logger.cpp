@@ -17,9 +17,13 @@
 
 #include "Logger.h"
 
+#include <fcntl.h>
 #include <pthread.h>
+#include <signal.h>
 #include <sys/syscall.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cerrno>
 #include <boost/filesystem.hpp>
 #include <cstring>
 #include <iostream>
@@ -44,13 +48,177 @@ inline pid_t getCurrentPid() {
   return 0;
 #endif
 }
+
+/// The caller's thread id never changes, so look it up only once per thread
+inline pid_t getCachedPid() {
+  thread_local const pid_t tid = getCurrentPid();
+  return tid;
+}
+
+/// Writes all of buf to fd; only calls write(2), so it is async-signal-safe
+void WriteFully(int fd, const char* buf, size_t len) {
+  if (fd < 0) {
+    return;
+  }
+  while (len > 0) {
+    const ssize_t written = write(fd, buf, len);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    buf += written;
+    len -= written;
+  }
+}
+}  // namespace
+
+/// One log call captured with its raw fields; the line is only formatted by
+/// the writer thread.
+struct LogRecord {
+  enum Kind : unsigned char { GENERAL, EPOCH, PAYLOAD, STATE, EPOCHINFO };
+
+  Kind m_kind{GENERAL};
+  const LEVELS* m_level{&INFO};
+  chrono::system_clock::time_point m_time;
+  pid_t m_pid{0};
+  unsigned int m_line{0};
+  const char* m_file{""};
+  const char* m_function{""};
+  uint64_t m_epoch{0};
+  string m_msg;
+  bytes m_payload;  // already cut down to max_bytes_to_display
+  size_t m_payloadLen{0};
+  bool m_payloadTruncated{false};
+};
+
+/// Bounded multi-producer single-consumer ring of log records, shared by all
+/// threads logging to one Logger. Producers claim a slot with one CAS, so
+/// pushing never takes a lock and the memory used does not grow with the
+/// number of threads. Consumers are serialized by the owning Logger's mutex.
+class LogRing {
+ public:
+  static const size_t CAPACITY = 8192;  // must be a power of two
+
+  LogRing() : m_slots(new Slot[CAPACITY]) {
+    for (size_t i = 0; i < CAPACITY; i++) {
+      m_slots[i].m_seq.store(i, memory_order_relaxed);
+    }
+  }
+
+  bool Push(LogRecord&& record) {
+    size_t pos = m_tail.load(memory_order_relaxed);
+    while (true) {
+      Slot& slot = m_slots[pos & (CAPACITY - 1)];
+      const size_t seq = slot.m_seq.load(memory_order_acquire);
+      if (seq == pos) {
+        if (m_tail.compare_exchange_weak(pos, pos + 1,
+                                         memory_order_relaxed)) {
+          slot.m_record = move(record);
+          slot.m_seq.store(pos + 1, memory_order_release);
+          return true;
+        }
+      } else if (seq < pos) {
+        return false;
+      } else {
+        pos = m_tail.load(memory_order_relaxed);
+      }
+    }
+  }
+
+  bool Pop(LogRecord& record) {
+    const size_t head = m_head.load(memory_order_relaxed);
+    Slot& slot = m_slots[head & (CAPACITY - 1)];
+    if (slot.m_seq.load(memory_order_acquire) != head + 1) {
+      return false;
+    }
+    record = move(slot.m_record);
+    slot.m_seq.store(head + CAPACITY, memory_order_release);
+    m_head.store(head + 1, memory_order_relaxed);
+    return true;
+  }
+
+  bool Empty() const {
+    const size_t head = m_head.load(memory_order_relaxed);
+    return m_slots[head & (CAPACITY - 1)].m_seq.load(memory_order_acquire) !=
+           head + 1;
+  }
+
+ private:
+  struct Slot {
+    atomic<size_t> m_seq{0};
+    LogRecord m_record;
+  };
+
+  unique_ptr<Slot[]> m_slots;
+  alignas(64) atomic<size_t> m_head{0};
+  alignas(64) atomic<size_t> m_tail{0};
+};
+
+namespace {
+/// Loggers whose queued records are written out on a fatal signal
+const unsigned int MAX_LOGGERS = 3;
+atomic<Logger*> s_loggers[MAX_LOGGERS];
+
+const int FLUSH_SIGNALS[] = {SIGABRT, SIGBUS, SIGFPE, SIGILL, SIGSEGV, SIGTERM};
+struct sigaction s_prevActions[sizeof(FLUSH_SIGNALS) / sizeof(int)];
+
+void FlushOnSignal(int sig) {
+  for (auto& logger : s_loggers) {
+    Logger* l = logger.load(memory_order_acquire);
+    if (l != nullptr) {
+      l->WritePendingOnSignal();
+    }
+  }
+
+  // Hand the signal on to whatever handled it before
+  for (unsigned int i = 0; i < sizeof(FLUSH_SIGNALS) / sizeof(int); i++) {
+    if (FLUSH_SIGNALS[i] == sig) {
+      sigaction(sig, &s_prevActions[i], nullptr);
+      break;
+    }
+  }
+  raise(sig);
+}
+
+void RegisterForSignalFlush(Logger* logger) {
+  static once_flag installed;
+  call_once(installed, []() {
+    struct sigaction action {};
+    action.sa_handler = FlushOnSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESETHAND;
+    for (unsigned int i = 0; i < sizeof(FLUSH_SIGNALS) / sizeof(int); i++) {
+      sigaction(FLUSH_SIGNALS[i], &action, &s_prevActions[i]);
+    }
+  });
+
+  for (auto& slot : s_loggers) {
+    Logger* expected = nullptr;
+    if (slot.compare_exchange_strong(expected, logger)) {
+      return;
+    }
+  }
+}
+
+void UnregisterForSignalFlush(Logger* logger) {
+  for (auto& slot : s_loggers) {
+    Logger* expected = logger;
+    if (slot.compare_exchange_strong(expected, nullptr)) {
+      return;
+    }
+  }
+}
 }  // namespace
 
 const streampos Logger::MAX_FILE_SIZE =
     1024 * 1024 * 100;  // 100MB per log file
 
 Logger::Logger(const char* prefix, bool log_to_file, const char* logpath,
-               streampos max_file_size) {
+               streampos max_file_size)
+    : m_ring(make_unique<LogRing>()),
+      m_outBuf(make_unique<char[]>(OUT_BUF_SIZE)) {
   this->m_logToFile = log_to_file;
   this->m_maxFileSize = max_file_size;
   this->m_logPath = logpath;
@@ -79,17 +247,43 @@ Logger::Logger(const char* prefix, bool log_to_file, const char* logpath,
     m_fileNamePrefix = prefix ? prefix : "common";
     m_seqNum = 0;
     newLog();
+  } else {
+    m_outFd.store(STDOUT_FILENO, memory_order_release);
   }
+
+  m_writer = thread([this]() { WriterLoop(); });
+  RegisterForSignalFlush(this);
 }
 
-Logger::~Logger() { m_logFile.close(); }
+Logger::~Logger() {
+  UnregisterForSignalFlush(this);
+  m_stopWriter.store(true, memory_order_release);
+  {
+    lock_guard<mutex> lock(m_writerMutex);
+    m_writerCond.notify_one();
+  }
+  if (m_writer.joinable()) {
+    m_writer.join();
+  }
+
+  {
+    lock_guard<mutex> guard(m);
+    Drain();
+  }
+
+  if (m_logToFile) {
+    const int fd = m_outFd.exchange(-1);
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
 
 void Logger::checkLog() {
   std::ifstream in(m_fileName.c_str(),
                    std::ifstream::ate | std::ifstream::binary);
 
   if (in.tellg() >= m_maxFileSize) {
-    m_logFile.close();
     newLog();
   }
 }
@@ -114,7 +308,12 @@ void Logger::newLog() {
     sinkHandle->call(&g3::FileSink::overrideLogHeader, "").wait();
     initializeLogging(logworker.get());
   } else {
-    m_logFile.open(m_logPath + m_fileName, ios_base::app);
+    const int fd = open((m_logPath + m_fileName).c_str(),
+                        O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    const int prevFd = m_outFd.exchange(fd);
+    if (prevFd >= 0) {
+      close(prevFd);
+    }
   }
 }
 
@@ -137,190 +336,245 @@ Logger& Logger::GetEpochInfoLogger(const char* fname_prefix, bool log_to_file,
   return logger;
 }
 
-void Logger::LogState(const char* msg) {
-  lock_guard<mutex> guard(m);
+Logger& Logger::GetLogger() {
+  static Logger& logger = GetLogger(
+      NULL, true, boost::filesystem::absolute("./").string().c_str());
+  return logger;
+}
 
-  if (m_logToFile) {
-    checkLog();
-    m_logFile << msg << endl << flush;
-  } else {
-    cout << msg << endl << flush;
+Logger& Logger::GetStateLogger() {
+  static Logger& logger = GetStateLogger(
+      NULL, true, boost::filesystem::absolute("./").string().c_str());
+  return logger;
+}
+
+Logger& Logger::GetEpochInfoLogger() {
+  static Logger& logger = GetEpochInfoLogger(
+      NULL, true, boost::filesystem::absolute("./").string().c_str());
+  return logger;
+}
+
+void Logger::Enqueue(LogRecord&& record) {
+  // Back-pressure: wait for the writer rather than drop records
+  while (!m_ring->Push(move(record))) {
+    this_thread::yield();
+  }
+
+  // Pairs with the fence in WriterLoop: either the writer sees this record
+  // before it sleeps, or we see it idle and wake it
+  atomic_thread_fence(memory_order_seq_cst);
+  if (m_writerIdle.load(memory_order_relaxed)) {
+    lock_guard<mutex> lock(m_writerMutex);
+    m_writerCond.notify_one();
   }
 }
 
-void Logger::LogGeneral(const LEVELS& level, const char* msg,
-                        const unsigned int linenum, const char* filename,
-                        const char* function) {
-  if (IsG3Log()) {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-    LOG(level) << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-               << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-               << PAD(get_ms(cur), 3, '0') << "]["
-               << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN)
-               << "][" << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg;
+void Logger::Drain() {
+  LogRecord record;
+  if (!m_ring->Pop(record)) {
     return;
   }
 
-  lock_guard<mutex> guard(m);
+  ostringstream os;
+  if (IsG3Log()) {
+    // The g3log worker does the file I/O; only the formatting is done here
+    do {
+      os.str("");
+      WriteRecord(os, record);
+      LOG(*record.m_level) << os.str();
+    } while (m_ring->Pop(record));
+    return;
+  }
 
   if (m_logToFile) {
     checkLog();
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-    m_logFile << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-              << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-              << PAD(get_ms(cur), 3, '0') << "]["
-              << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-              << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg << endl
-              << flush;
-  } else {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-    cout << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-         << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-         << PAD(get_ms(cur), 3, '0') << "]["
-         << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-         << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg << endl
-         << flush;
-  }
-}
-
-void Logger::LogEpoch([[gnu::unused]] const LEVELS& level, const char* msg,
-                      const char* epoch, const unsigned int linenum,
-                      const char* filename, const char* function) {
-  lock_guard<mutex> guard(m);
+  }
+  do {
+    os.str("");
+    WriteRecord(os, record);
+    os << '\n';
+    Stage(os.str());
+  } while (m_ring->Pop(record));
+  WriteOut();
+}
 
-  if (m_logToFile) {
-    checkLog();
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-    m_logFile << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-              << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-              << PAD(get_ms(cur), 3, '0') << "]["
-              << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-              << LIMIT(function, MAX_FUNCNAME_LEN) << "] [Epoch " << epoch
-              << "] " << msg << endl
-              << flush;
-  } else {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-    cout << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-         << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-         << PAD(get_ms(cur), 3, '0') << "]["
-         << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-         << LIMIT(function, MAX_FUNCNAME_LEN) << "] [Epoch " << epoch << "] "
-         << msg << endl
-         << flush;
-  }
-}
-
-void Logger::LogPayload([[gnu::unused]] const LEVELS& level, const char* msg,
-                        const bytes& payload, size_t max_bytes_to_display,
-                        const unsigned int linenum, const char* filename,
-                        const char* function) {
-  std::unique_ptr<char[]> payload_string;
-  GetPayloadS(payload, max_bytes_to_display, payload_string);
-  lock_guard<mutex> guard(m);
+void Logger::Stage(const string& line) {
+  size_t len = m_outLen.load(memory_order_relaxed);
+  if (len + line.size() > OUT_BUF_SIZE) {
+    WriteOut();
+    len = 0;
+  }
+  if (line.size() > OUT_BUF_SIZE) {
+    WriteFully(m_outFd.load(memory_order_relaxed), line.data(), line.size());
+    return;
+  }
 
-  if (m_logToFile) {
-    checkLog();
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-
-    if (payload.size() > max_bytes_to_display) {
-      m_logFile << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-                << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-                << PAD(get_ms(cur), 3, '0') << "]["
-                << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN)
-                << "][" << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg
-                << " (Len=" << payload.size() << "): " << payload_string.get()
-                << "..." << endl
-                << flush;
-    } else {
-      m_logFile << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-                << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-                << PAD(get_ms(cur), 3, '0') << "]["
-                << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN)
-                << "][" << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg
-                << " (Len=" << payload.size() << "): " << payload_string.get()
-                << endl
-                << flush;
+  memcpy(m_outBuf.get() + len, line.data(), line.size());
+  // Publish the bytes to the signal handler only once they are complete
+  m_outLen.store(len + line.size(), memory_order_release);
+}
+
+void Logger::WriteOut() {
+  const size_t len = m_outLen.load(memory_order_relaxed);
+  if (len == 0) {
+    return;
+  }
+  WriteFully(m_outFd.load(memory_order_relaxed), m_outBuf.get(), len);
+  m_outLen.store(0, memory_order_release);
+}
+
+void Logger::WritePendingOnSignal() {
+  const size_t len = m_outLen.load(memory_order_acquire);
+  if (len > 0) {
+    WriteFully(m_outFd.load(memory_order_acquire), m_outBuf.get(), len);
+  }
+}
+
+void Logger::WriterLoop() {
+  while (!m_stopWriter.load(memory_order_acquire)) {
+    if (m_ring->Empty()) {
+      unique_lock<mutex> lock(m_writerMutex);
+      m_writerIdle.store(true, memory_order_relaxed);
+      atomic_thread_fence(memory_order_seq_cst);
+      m_writerCond.wait(lock, [this]() {
+        return m_stopWriter.load(memory_order_acquire) || !m_ring->Empty();
+      });
+      m_writerIdle.store(false, memory_order_relaxed);
+      continue;
     }
-  } else {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-
-    if (payload.size() > max_bytes_to_display) {
-      cout << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-           << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-           << PAD(get_ms(cur), 3, '0') << "]["
-           << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-           << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg
-           << " (Len=" << payload.size() << "): " << payload_string.get()
-           << "..." << endl
-           << flush;
-    } else {
-      cout << "[" << PAD(GetPid(), TID_LEN, ' ') << "]["
-           << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-           << PAD(get_ms(cur), 3, '0') << "]["
-           << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-           << LIMIT(function, MAX_FUNCNAME_LEN) << "] " << msg
-           << " (Len=" << payload.size() << "): " << payload_string.get()
-           << endl
-           << flush;
+
+    lock_guard<mutex> guard(m);
+    Drain();
+  }
+}
+
+void Logger::WriteRecord(ostream& os, const LogRecord& record) const {
+  if (record.m_kind == LogRecord::STATE) {
+    os << record.m_msg;
+    return;
+  }
+
+  auto cur_time_t = chrono::system_clock::to_time_t(record.m_time);
+  auto file_and_line =
+      string(record.m_file) + ":" + to_string(record.m_line);
+  os << "[" << PAD(record.m_pid, TID_LEN, ' ') << "]["
+     << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
+     << PAD(get_ms(record.m_time), 3, '0') << "]["
+     << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
+     << LIMIT(record.m_function, MAX_FUNCNAME_LEN) << "] ";
+
+  switch (record.m_kind) {
+    case LogRecord::EPOCH:
+    case LogRecord::EPOCHINFO:
+      os << "[Epoch " << record.m_epoch << "] " << record.m_msg;
+      break;
+    case LogRecord::PAYLOAD: {
+      std::unique_ptr<char[]> payload_string;
+      GetPayloadS(record.m_payload, record.m_payload.size(), payload_string);
+      os << record.m_msg << " (Len=" << record.m_payloadLen
+         << "): " << payload_string.get()
+         << (record.m_payloadTruncated ? "..." : "");
+      break;
     }
+    default:
+      os << record.m_msg;
+      break;
   }
 }
 
-void Logger::LogEpochInfo(const char* msg, const unsigned int linenum,
-                          const char* filename, const char* function,
-                          const char* epoch) {
-  pid_t tid = getCurrentPid();
+void Logger::Flush() {
   lock_guard<mutex> guard(m);
+  Drain();
+}
 
-  if (m_logToFile) {
-    checkLog();
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-    m_logFile << "[" << PAD(tid, TID_LEN, ' ') << "]["
-              << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-              << PAD(get_ms(cur), 3, '0') << "]["
-              << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-              << LIMIT(function, MAX_FUNCNAME_LEN) << "] [Epoch " << epoch
-              << "] " << msg << endl
-              << flush;
-  } else {
-    auto cur = chrono::system_clock::now();
-    auto cur_time_t = chrono::system_clock::to_time_t(cur);
-    auto file_and_line =
-        std::string(std::string(filename) + ":" + std::to_string(linenum));
-    cout << "[" << PAD(tid, TID_LEN, ' ') << "]["
-         << put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")
-         << PAD(get_ms(cur), 3, '0') << "]["
-         << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN) << "]["
-         << LIMIT(function, MAX_FUNCNAME_LEN) << "] [Epoch " << epoch << "] "
-         << msg << endl
-         << flush;
+void Logger::LogState(string msg) {
+  LogRecord record;
+  record.m_kind = LogRecord::STATE;
+  record.m_time = chrono::system_clock::now();
+  record.m_msg = move(msg);
+  Enqueue(move(record));
+}
+
+void Logger::LogGeneral(const LEVELS& level, string msg,
+                        const unsigned int linenum, const char* filename,
+                        const char* function) {
+  LogRecord record;
+  record.m_kind = LogRecord::GENERAL;
+  record.m_level = &level;
+  record.m_time = chrono::system_clock::now();
+  record.m_pid = GetPid();
+  record.m_line = linenum;
+  record.m_file = filename;
+  record.m_function = function;
+  record.m_msg = move(msg);
+  Enqueue(move(record));
+
+  if (level.value >= FATAL.value) {
+    Flush();
   }
 }
 
+void Logger::LogEpoch(const LEVELS& level, string msg, const uint64_t epoch,
+                      const unsigned int linenum, const char* filename,
+                      const char* function) {
+  LogRecord record;
+  record.m_kind = LogRecord::EPOCH;
+  record.m_level = &level;
+  record.m_time = chrono::system_clock::now();
+  record.m_pid = GetPid();
+  record.m_line = linenum;
+  record.m_file = filename;
+  record.m_function = function;
+  record.m_epoch = epoch;
+  record.m_msg = move(msg);
+  Enqueue(move(record));
+
+  if (level.value >= FATAL.value) {
+    Flush();
+  }
+}
+
+void Logger::LogPayload(const LEVELS& level, string msg, const bytes& payload,
+                        size_t max_bytes_to_display,
+                        const unsigned int linenum, const char* filename,
+                        const char* function) {
+  // Only the displayed prefix is kept; it is hex-encoded by the writer
+  const size_t displayed = min(payload.size(), max_bytes_to_display);
+
+  LogRecord record;
+  record.m_kind = LogRecord::PAYLOAD;
+  record.m_level = &level;
+  record.m_time = chrono::system_clock::now();
+  record.m_pid = GetPid();
+  record.m_line = linenum;
+  record.m_file = filename;
+  record.m_function = function;
+  record.m_msg = move(msg);
+  record.m_payload.assign(payload.begin(), payload.begin() + displayed);
+  record.m_payloadLen = payload.size();
+  record.m_payloadTruncated = payload.size() > max_bytes_to_display;
+  Enqueue(move(record));
+
+  if (level.value >= FATAL.value) {
+    Flush();
+  }
+}
+
+void Logger::LogEpochInfo(string msg, const unsigned int linenum,
+                          const char* filename, const char* function,
+                          const uint64_t epoch) {
+  LogRecord record;
+  record.m_kind = LogRecord::EPOCHINFO;
+  record.m_time = chrono::system_clock::now();
+  record.m_pid = GetPid();
+  record.m_line = linenum;
+  record.m_file = filename;
+  record.m_function = function;
+  record.m_epoch = epoch;
+  record.m_msg = move(msg);
+  Enqueue(move(record));
+}
+
 void Logger::DisplayLevelAbove(const LEVELS& level) {
   if (level != INFO && level != WARNING && level != FATAL) return;
 
@@ -333,8 +587,7 @@ void Logger::DisableLevel(const LEVELS& level) {
   g3::log_levels::disable(level);
 }
 
-pid_t Logger::GetPid() { return getCurrentPid(); }
-
+pid_t Logger::GetPid() { return getCachedPid(); }
 void Logger::GetPayloadS(const bytes& payload, size_t max_bytes_to_display,
                          std::unique_ptr<char[]>& res) {
   static const char* hex_table = "0123456789ABCDEF";
@@ -361,14 +614,14 @@ void Logger::GetPayloadS(const bytes& payload, size_t max_bytes_to_display,
 ScopeMarker::ScopeMarker(const unsigned int linenum, const char* filename,
                          const char* function)
     : m_linenum(linenum), m_filename(filename), m_function(function) {
-  Logger& logger = Logger::GetLogger(
-      NULL, true, boost::filesystem::absolute("./").string().c_str());
-  logger.LogGeneral(INFO, "BEG", linenum, filename, function);
+  if (Logger::IsLevelEnabled(INFO)) {
+    Logger::GetLogger().LogGeneral(INFO, "BEG", linenum, filename, function);
+  }
 }
 
 ScopeMarker::~ScopeMarker() {
-  Logger& logger = Logger::GetLogger(
-      NULL, true, boost::filesystem::absolute("./").string().c_str());
-  logger.LogGeneral(INFO, "END", m_linenum, m_filename.c_str(),
-                    m_function.c_str());
+  if (Logger::IsLevelEnabled(INFO)) {
+    Logger::GetLogger().LogGeneral(INFO, "END", m_linenum, m_filename,
+                                   m_function);
+  }
 }
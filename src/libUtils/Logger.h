@@ -19,12 +19,16 @@
 #define ZILLIQA_SRC_LIBUTILS_LOGGER_H_
 
 #include <boost/filesystem.hpp>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <fstream>
 #include <iomanip>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include "common/BaseType.h"
 #include "g3log/g3log.hpp"
@@ -42,6 +46,15 @@
 
 #define PAD(n, len, ch) std::setw(len) << std::setfill(ch) << std::right << n
 
+/// Levels below this one are compiled out of the LOG_* macros. Override with
+/// -DLOG_MIN_COMPILED_LEVEL=INFO (or cmake -DLOG_COMPILE_LEVEL=INFO).
+#ifndef LOG_MIN_COMPILED_LEVEL
+#define LOG_MIN_COMPILED_LEVEL DEBUG
+#endif
+
+struct LogRecord;
+class LogRing;
+
 /// Utility logging class for outputting messages to stdout or file.
 class Logger {
  private:
@@ -50,6 +63,24 @@ class Logger {
   std::streampos m_maxFileSize;
   std::unique_ptr<g3::LogWorker> logworker;
 
+  /// Records shared by all logging threads, drained by m_writer
+  std::unique_ptr<LogRing> m_ring;
+  std::atomic<bool> m_stopWriter{false};
+  std::thread m_writer;
+
+  /// The writer sleeps on m_writerCond while the ring is empty; producers
+  /// only take m_writerMutex to wake it when m_writerIdle is set
+  std::mutex m_writerMutex;
+  std::condition_variable m_writerCond;
+  std::atomic<bool> m_writerIdle{false};
+
+  /// Formatted lines not yet written to m_outFd. The signal handler writes
+  /// out [0, m_outLen) with write(2), so it never formats or allocates.
+  static const size_t OUT_BUF_SIZE = 64 * 1024;
+  std::unique_ptr<char[]> m_outBuf;
+  std::atomic<size_t> m_outLen{0};
+  std::atomic<int> m_outFd{-1};
+
   Logger(const char* prefix, bool log_to_file, const char* logpath,
          std::streampos max_file_size);
   ~Logger();
@@ -57,9 +88,23 @@ class Logger {
   void checkLog();
   void newLog();
 
+  /// Hands a record over to the background writer
+  void Enqueue(LogRecord&& record);
+
+  /// Writes out everything queued so far (caller must hold m)
+  void Drain();
+
+  void WriterLoop();
+  void WriteRecord(std::ostream& os, const LogRecord& record) const;
+
+  /// Appends a formatted line to m_outBuf, writing it out first if full
+  void Stage(const std::string& line);
+
+  /// Writes m_outBuf to m_outFd and empties it
+  void WriteOut();
+
   std::string m_fileNamePrefix;
   std::string m_fileName;
-  std::ofstream m_logFile;
   unsigned int m_seqNum;
   bool m_bRefactor{};
   std::string m_logPath;
@@ -99,35 +144,54 @@ class Logger {
       const char* fname_prefix, bool log_to_file, const char* logpath,
       std::streampos max_file_size = MAX_FILE_SIZE);
 
+  /// Cached handles used by the LOG_* macros. They create the logger with the
+  /// same defaults as before on first use, but resolve the default log path
+  /// only once per process.
+  static Logger& GetLogger();
+  static Logger& GetStateLogger();
+  static Logger& GetEpochInfoLogger();
+
+  /// Returns false if messages at this level are compiled out or disabled, so
+  /// callers can skip formatting them altogether.
+  static bool IsLevelEnabled(const LEVELS& level) {
+    return level.value >= LOG_MIN_COMPILED_LEVEL.value && g3::logLevel(level);
+  }
+
   /// Outputs the specified message and function name to the state/reporting
   /// log.
-  void LogState(const char* msg);
+  void LogState(std::string msg);
 
   /// Outputs the specified message and function name to the main log.
-  void LogGeneral(const LEVELS& level, const char* msg,
+  /// level, filename and function must have static storage duration (e.g.
+  /// INFO, __FILE__ and __FUNCTION__), as they are formatted later by the
+  /// writer thread.
+  void LogGeneral(const LEVELS& level, std::string msg,
                   const unsigned int linenum, const char* filename,
                   const char* function);
 
   /// Outputs the specified message, function name, and block number to the main
   /// log.
-  void LogEpoch(const LEVELS& level, const char* msg, const char* epoch,
+  void LogEpoch(const LEVELS& level, std::string msg, const uint64_t epoch,
                 const unsigned int linenum, const char* filename,
                 const char* function);
 
-  /// Outputs the specified message, function name, and payload to the main log.
-  void LogMessageAndPayload(const char* msg, const bytes& payload,
-                            size_t max_bytes_to_display,
-                            const unsigned int linenum, const char* filename,
-                            const char* function);
   /// Outputs the specified message and function name to the epoch info log.
-  void LogEpochInfo(const char* msg, const unsigned int linenum,
+  void LogEpochInfo(std::string msg, const unsigned int linenum,
                     const char* filename, const char* function,
-                    const char* epoch);
+                    const uint64_t epoch);
 
-  void LogPayload(const LEVELS& level, const char* msg, const bytes& payload,
+  void LogPayload(const LEVELS& level, std::string msg, const bytes& payload,
                   size_t max_bytes_to_display, const unsigned int linenum,
                   const char* filename, const char* function);
 
+  /// Blocks until every record queued so far has been written out.
+  void Flush();
+
+  /// Writes out lines the writer has formatted but not yet written, using
+  /// only write(2), so it can run in a signal handler. Records still queued
+  /// unformatted are lost, and a line being written may appear twice.
+  void WritePendingOnSignal();
+
   /// Setup the display debug level
   ///     INFO: display all message
   ///     WARNING: display warning and fatal message
@@ -154,8 +218,8 @@ class Logger {
 /// Utility class for automatically logging function or code block exit.
 class ScopeMarker {
   unsigned int m_linenum;
-  std::string m_filename;
-  std::string m_function;
+  const char* m_filename;
+  const char* m_function;
 
  public:
   /// Constructor.
@@ -176,131 +240,56 @@ class ScopeMarker {
 #define INIT_EPOCHINFO_LOGGER(fname_prefix, logpath) \
   Logger::GetEpochInfoLogger(fname_prefix, true, logpath)
 #define LOG_MARKER() ScopeMarker marker(__LINE__, __FILE__, __FUNCTION__)
-#define LOG_STATE(msg)                                                         \
-  {                                                                            \
-    std::ostringstream oss;                                                    \
-    auto cur = std::chrono::system_clock::now();                               \
-    auto cur_time_t = std::chrono::system_clock::to_time_t(cur);               \
-    oss << "[ " << std::put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")          \
-        << PAD(get_ms(cur), 3, '0') << " ]" << msg;                            \
-    Logger::GetStateLogger(NULL, true,                                         \
-                           boost::filesystem::absolute("./").string().c_str()) \
-        .LogState(oss.str().c_str());                                          \
+#define LOG_STATE(msg)                                                \
+  {                                                                   \
+    std::ostringstream oss;                                           \
+    auto cur = std::chrono::system_clock::now();                      \
+    auto cur_time_t = std::chrono::system_clock::to_time_t(cur);      \
+    oss << "[ " << std::put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.") \
+        << PAD(get_ms(cur), 3, '0') << " ]" << msg;                   \
+    Logger::GetStateLogger().LogState(oss.str());                     \
   }
-#define LOG_GENERAL(level, msg)                                                \
-  {                                                                            \
-    if (Logger::GetLogger(NULL, true,                                          \
-                          boost::filesystem::absolute("./").string().c_str())  \
-            .IsG3Log()) {                                                      \
-      auto cur = std::chrono::system_clock::now();                             \
-      auto cur_time_t = std::chrono::system_clock::to_time_t(cur);             \
-      auto file_and_line =                                                     \
-          std::string(std::string(__FILE__) + ":" + std::to_string(__LINE__)); \
-      LOG(level) << "[" << PAD(Logger::GetPid(), Logger::TID_LEN, ' ') << "][" \
-                 << std::put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")         \
-                 << PAD(get_ms(cur), 3, '0') << "]["                           \
-                 << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN)    \
-                 << "][" << LIMIT(__FUNCTION__, Logger::MAX_FUNCNAME_LEN)      \
-                 << "] " << msg;                                               \
-    } else {                                                                   \
-      std::ostringstream oss;                                                  \
-      oss << msg;                                                              \
-      Logger::GetLogger(NULL, true,                                            \
-                        boost::filesystem::absolute("./").string().c_str())    \
-          .LogGeneral(level, oss.str().c_str(), __LINE__, __FILE__,            \
-                      __FUNCTION__);                                           \
-    }                                                                          \
+#define LOG_GENERAL(level, msg)                                             \
+  {                                                                         \
+    if (Logger::IsLevelEnabled(level)) {                                    \
+      std::ostringstream oss;                                               \
+      oss << msg;                                                           \
+      Logger::GetLogger().LogGeneral(level, oss.str(), __LINE__, __FILE__,  \
+                                     __FUNCTION__);                         \
+    }                                                                       \
   }
-#define LOG_EPOCH(level, epoch, msg)                                           \
-  {                                                                            \
-    if (Logger::GetLogger(NULL, true,                                          \
-                          boost::filesystem::absolute("./").string().c_str())  \
-            .IsG3Log()) {                                                      \
-      auto cur = std::chrono::system_clock::now();                             \
-      auto cur_time_t = std::chrono::system_clock::to_time_t(cur);             \
-      auto file_and_line =                                                     \
-          std::string(std::string(__FILE__) + ":" + std::to_string(__LINE__)); \
-      LOG(level) << "[" << PAD(Logger::GetPid(), Logger::TID_LEN, ' ') << "][" \
-                 << std::put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")         \
-                 << PAD(get_ms(cur), 3, '0') << "]["                           \
-                 << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN)    \
-                 << "][" << LIMIT(__FUNCTION__, Logger::MAX_FUNCNAME_LEN)      \
-                 << "] [Epoch " << std::to_string(epoch).c_str() << "] "       \
-                 << msg;                                                       \
-    } else {                                                                   \
-      std::ostringstream oss;                                                  \
-      oss << msg;                                                              \
-      Logger::GetLogger(NULL, true,                                            \
-                        boost::filesystem::absolute("./").string().c_str())    \
-          .LogEpoch(level, std::to_string(epoch).c_str(), oss.str().c_str(),   \
-                    __LINE__, __FILE__, __FUNCTION__);                         \
-    }                                                                          \
+#define LOG_EPOCH(level, epoch, msg)                                        \
+  {                                                                         \
+    if (Logger::IsLevelEnabled(level)) {                                    \
+      std::ostringstream oss;                                               \
+      oss << msg;                                                           \
+      Logger::GetLogger().LogEpoch(level, oss.str(), (uint64_t)(epoch),     \
+                                   __LINE__, __FILE__, __FUNCTION__);       \
+    }                                                                       \
   }
-#define LOG_PAYLOAD(level, msg, payload, max_bytes_to_display)                 \
-  {                                                                            \
-    if (Logger::GetLogger(NULL, true,                                          \
-                          boost::filesystem::absolute("./").string().c_str())  \
-            .IsG3Log()) {                                                      \
-      std::unique_ptr<char[]> payload_string;                                  \
-      Logger::GetPayloadS(payload, max_bytes_to_display, payload_string);      \
-      auto cur = std::chrono::system_clock::now();                             \
-      auto cur_time_t = std::chrono::system_clock::to_time_t(cur);             \
-      auto file_and_line =                                                     \
-          std::string(std::string(__FILE__) + ":" + std::to_string(__LINE__)); \
-      if ((payload).size() > max_bytes_to_display) {                           \
-        LOG(level) << "[" << PAD(Logger::GetPid(), Logger::TID_LEN, ' ')       \
-                   << "]["                                                     \
-                   << std::put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")       \
-                   << PAD(get_ms(cur), 3, '0') << "]["                         \
-                   << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN)  \
-                   << "][" << LIMIT(__FUNCTION__, Logger::MAX_FUNCNAME_LEN)    \
-                   << "] " << msg << " (Len=" << (payload).size()              \
-                   << "): " << payload_string.get() << "...";                  \
-      } else {                                                                 \
-        LOG(level) << "[" << PAD(Logger::GetPid(), Logger::TID_LEN, ' ')       \
-                   << "]["                                                     \
-                   << std::put_time(gmtime(&cur_time_t), "%y-%m-%dT%T.")       \
-                   << PAD(get_ms(cur), 3, '0') << "]["                         \
-                   << LIMIT_RIGHT(file_and_line, Logger::MAX_FILEANDLINE_LEN)  \
-                   << "][" << LIMIT(__FUNCTION__, Logger::MAX_FUNCNAME_LEN)    \
-                   << "] " << msg << " (Len=" << (payload).size()              \
-                   << "): " << payload_string.get();                           \
-      }                                                                        \
-    } else {                                                                   \
-      std::ostringstream oss;                                                  \
-      oss << msg;                                                              \
-      Logger::GetLogger(NULL, true,                                            \
-                        boost::filesystem::absolute("./").string().c_str())    \
-          .LogPayload(level, oss.str().c_str(), payload, max_bytes_to_display, \
-                      __LINE__, __FILE__, __FUNCTION__);                       \
-    }                                                                          \
+#define LOG_PAYLOAD(level, msg, payload, max_bytes_to_display)              \
+  {                                                                         \
+    if (Logger::IsLevelEnabled(level)) {                                    \
+      std::ostringstream oss;                                               \
+      oss << msg;                                                           \
+      Logger::GetLogger().LogPayload(level, oss.str(), payload,             \
+                                     max_bytes_to_display, __LINE__,        \
+                                     __FILE__, __FUNCTION__);               \
+    }                                                                       \
   }
-#define LOG_DISPLAY_LEVEL_ABOVE(level)                                    \
+#define LOG_DISPLAY_LEVEL_ABOVE(level) \
+  { Logger::GetLogger().DisplayLevelAbove(level); }
+#define LOG_ENABLE_LEVEL(level) \
+  { Logger::GetLogger().EnableLevel(level); }
+#define LOG_DISABLE_LEVEL(level) \
+  { Logger::GetLogger().DisableLevel(level); }
+#define LOG_EPOCHINFO(blockNum, msg)                                      \
   {                                                                       \
-    Logger::GetLogger(NULL, true,                                         \
-                      boost::filesystem::absolute("./").string().c_str()) \
-        .DisplayLevelAbove(level);                                        \
-  }
-#define LOG_ENABLE_LEVEL(level)                                           \
-  {                                                                       \
-    Logger::GetLogger(NULL, true,                                         \
-                      boost::filesystem::absolute("./").string().c_str()) \
-        .EnableLevel(level);                                              \
-  }
-#define LOG_DISABLE_LEVEL(level)                                          \
-  {                                                                       \
-    Logger::GetLogger(NULL, true,                                         \
-                      boost::filesystem::absolute("./").string().c_str()) \
-        .DisableLevel(level);                                             \
-  }
-#define LOG_EPOCHINFO(blockNum, msg)                                       \
-  {                                                                        \
-    std::ostringstream oss;                                                \
-    oss << msg;                                                            \
-    Logger::GetEpochInfoLogger(                                            \
-        NULL, true, boost::filesystem::absolute("./").string().c_str())    \
-        .LogEpochInfo(oss.str().c_str(), __LINE__, __FILE__, __FUNCTION__, \
-                      std::to_string(blockNum).c_str());                   \
+    std::ostringstream oss;                                               \
+    oss << msg;                                                           \
+    Logger::GetEpochInfoLogger().LogEpochInfo(oss.str(), __LINE__,        \
+                                              __FILE__, __FUNCTION__,     \
+                                              (uint64_t)(blockNum));      \
   }
 
 #define LOG_CHECK_FAIL(checktype, received, expected) \
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "Metrics.h"
+
+using namespace std;
+
+namespace {
+const double SUMMARY_QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+string JoinLabels(const string& labels, const string& extra) {
+  if (labels.empty()) {
+    return extra.empty() ? "" : "{" + extra + "}";
+  }
+  return "{" + labels + (extra.empty() ? "" : "," + extra) + "}";
+}
+}  // namespace
+
+const unsigned int Metrics::Histogram::SUB_BUCKET_BITS;
+const unsigned int Metrics::Histogram::SUB_BUCKETS;
+const unsigned int Metrics::Histogram::NUM_BUCKETS;
+
+unsigned int Metrics::Histogram::GetBucketIndex(uint64_t value) {
+  if (value < SUB_BUCKETS) {
+    return value;
+  }
+  const unsigned int msb = 63 - __builtin_clzll(value);
+  const unsigned int shift = msb - SUB_BUCKET_BITS;
+  const unsigned int sub = (value >> shift) & (SUB_BUCKETS - 1);
+  return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t Metrics::Histogram::GetBucketUpperBound(unsigned int index) {
+  if (index < SUB_BUCKETS) {
+    return index;
+  }
+  const unsigned int shift = index / SUB_BUCKETS - 1;
+  const uint64_t sub = index % SUB_BUCKETS;
+  return ((SUB_BUCKETS + sub) << shift) + ((uint64_t{1} << shift) - 1);
+}
+
+void Metrics::Histogram::Record(uint64_t value) {
+  m_buckets[GetBucketIndex(value)].fetch_add(1, memory_order_relaxed);
+  m_sum.fetch_add(value, memory_order_relaxed);
+
+  uint64_t max = m_max.load(memory_order_relaxed);
+  while (value > max &&
+         !m_max.compare_exchange_weak(max, value, memory_order_relaxed)) {
+  }
+}
+
+Metrics::Histogram::Snapshot Metrics::Histogram::GetSnapshot() const {
+  Snapshot snapshot{0, m_sum.load(memory_order_relaxed),
+                    m_max.load(memory_order_relaxed),
+                    vector<uint64_t>(NUM_BUCKETS)};
+  for (unsigned int i = 0; i < NUM_BUCKETS; i++) {
+    snapshot.m_buckets[i] = m_buckets[i].load(memory_order_relaxed);
+    snapshot.m_count += snapshot.m_buckets[i];
+  }
+  return snapshot;
+}
+
+uint64_t Metrics::Histogram::Snapshot::GetPercentile(double p) const {
+  if (m_count == 0) {
+    return 0;
+  }
+  const uint64_t rank = min<uint64_t>(
+      m_count, max<uint64_t>(1, static_cast<uint64_t>(ceil(p * m_count))));
+
+  uint64_t seen = 0;
+  for (unsigned int i = 0; i < m_buckets.size(); i++) {
+    seen += m_buckets[i];
+    if (seen >= rank) {
+      return min(GetBucketUpperBound(i), m_max);
+    }
+  }
+  return m_max;
+}
+
+Metrics& Metrics::GetInstance() {
+  static Metrics metrics;
+  return metrics;
+}
+
+Metrics::Counter& Metrics::GetCounter(const string& name,
+                                      const string& labels) {
+  lock_guard<mutex> g(m_mutex);
+  auto& counter = m_counters[{name, labels}];
+  if (!counter) {
+    counter = make_unique<Counter>();
+  }
+  return *counter;
+}
+
+Metrics::Gauge& Metrics::GetGauge(const string& name, const string& labels) {
+  lock_guard<mutex> g(m_mutex);
+  auto& gauge = m_gauges[{name, labels}];
+  if (!gauge) {
+    gauge = make_unique<Gauge>();
+  }
+  return *gauge;
+}
+
+Metrics::Histogram& Metrics::GetHistogram(const string& name,
+                                          const string& labels) {
+  lock_guard<mutex> g(m_mutex);
+  auto& histogram = m_histograms[{name, labels}];
+  if (!histogram) {
+    histogram = make_unique<Histogram>();
+  }
+  return *histogram;
+}
+
+void Metrics::Collect(
+    vector<Sample<uint64_t>>& counters, vector<Sample<int64_t>>& gauges,
+    vector<Sample<Histogram::Snapshot>>& histograms) const {
+  lock_guard<mutex> g(m_mutex);
+  for (const auto& counter : m_counters) {
+    counters.push_back(
+        {counter.first.first, counter.first.second, counter.second->Get()});
+  }
+  for (const auto& gauge : m_gauges) {
+    gauges.push_back(
+        {gauge.first.first, gauge.first.second, gauge.second->Get()});
+  }
+  for (const auto& histogram : m_histograms) {
+    histograms.push_back({histogram.first.first, histogram.first.second,
+                          histogram.second->GetSnapshot()});
+  }
+}
+
+string Metrics::ToPrometheus() const {
+  vector<Sample<uint64_t>> counters;
+  vector<Sample<int64_t>> gauges;
+  vector<Sample<Histogram::Snapshot>> histograms;
+  Collect(counters, gauges, histograms);
+
+  ostringstream out;
+  string lastName;
+
+  for (const auto& counter : counters) {
+    if (counter.m_name != lastName) {
+      out << "# TYPE " << counter.m_name << " counter\n";
+      lastName = counter.m_name;
+    }
+    out << counter.m_name << JoinLabels(counter.m_labels, "") << " "
+        << counter.m_value << "\n";
+  }
+
+  for (const auto& gauge : gauges) {
+    if (gauge.m_name != lastName) {
+      out << "# TYPE " << gauge.m_name << " gauge\n";
+      lastName = gauge.m_name;
+    }
+    out << gauge.m_name << JoinLabels(gauge.m_labels, "") << " "
+        << gauge.m_value << "\n";
+  }
+
+  for (const auto& histogram : histograms) {
+    if (histogram.m_name != lastName) {
+      out << "# TYPE " << histogram.m_name << " summary\n";
+      lastName = histogram.m_name;
+    }
+    for (const auto& q : SUMMARY_QUANTILES) {
+      ostringstream quantile;
+      quantile << "quantile=\"" << q << "\"";
+      out << histogram.m_name << JoinLabels(histogram.m_labels, quantile.str())
+          << " " << histogram.m_value.GetPercentile(q) << "\n";
+    }
+    out << histogram.m_name << "_sum" << JoinLabels(histogram.m_labels, "")
+        << " " << histogram.m_value.m_sum << "\n";
+    out << histogram.m_name << "_count" << JoinLabels(histogram.m_labels, "")
+        << " " << histogram.m_value.m_count << "\n";
+  }
+
+  return out.str();
+}
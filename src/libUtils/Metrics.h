@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_METRICS_H_
+#define ZILLIQA_SRC_LIBUTILS_METRICS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// In-process registry of counters, gauges and latency histograms.
+///
+/// Metrics are created on first use under a lock and never removed, so
+/// callers keep the returned reference (e.g. in a function-local static)
+/// and update it with relaxed atomics only. Labels are given in Prometheus
+/// form, e.g. "msg=\"NODE_FORWARDTXNBLOCK\"".
+class Metrics {
+ public:
+  class Counter {
+    std::atomic<uint64_t> m_value{0};
+
+   public:
+    void Increment(uint64_t n = 1) {
+      m_value.fetch_add(n, std::memory_order_relaxed);
+    }
+    uint64_t Get() const { return m_value.load(std::memory_order_relaxed); }
+  };
+
+  class Gauge {
+    std::atomic<int64_t> m_value{0};
+
+   public:
+    void Set(int64_t value) {
+      m_value.store(value, std::memory_order_relaxed);
+    }
+    void Add(int64_t n) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    int64_t Get() const { return m_value.load(std::memory_order_relaxed); }
+  };
+
+  /// Log-linear histogram: each power of two is split into 8 buckets, so a
+  /// percentile is within 12.5% of the recorded value.
+  class Histogram {
+   public:
+    static const unsigned int SUB_BUCKET_BITS = 3;
+    static const unsigned int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const unsigned int NUM_BUCKETS =
+        (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    struct Snapshot {
+      uint64_t m_count;
+      uint64_t m_sum;
+      uint64_t m_max;
+      std::vector<uint64_t> m_buckets;
+
+      /// Upper bound of the bucket holding the p-th fraction of the values.
+      uint64_t GetPercentile(double p) const;
+    };
+
+    void Record(uint64_t value);
+    Snapshot GetSnapshot() const;
+
+    static unsigned int GetBucketIndex(uint64_t value);
+    static uint64_t GetBucketUpperBound(unsigned int index);
+
+   private:
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> m_buckets{};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+  };
+
+  /// Records the lifetime of the scope in microseconds.
+  class ScopedTimer {
+    Histogram& m_histogram;
+    const std::chrono::steady_clock::time_point m_start;
+
+   public:
+    explicit ScopedTimer(Histogram& histogram)
+        : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+      m_histogram.Record(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - m_start)
+              .count());
+    }
+  };
+
+  template <class T>
+  struct Sample {
+    std::string m_name;
+    std::string m_labels;
+    T m_value;
+  };
+
+  static Metrics& GetInstance();
+
+  Counter& GetCounter(const std::string& name, const std::string& labels = "");
+  Gauge& GetGauge(const std::string& name, const std::string& labels = "");
+  Histogram& GetHistogram(const std::string& name,
+                          const std::string& labels = "");
+
+  /// Current values of all metrics, sorted by name and labels.
+  void Collect(std::vector<Sample<uint64_t>>& counters,
+               std::vector<Sample<int64_t>>& gauges,
+               std::vector<Sample<Histogram::Snapshot>>& histograms) const;
+
+  /// All metrics in the Prometheus text format, histograms as summaries.
+  std::string ToPrometheus() const;
+
+ private:
+  using Key = std::pair<std::string, std::string>;
+
+  mutable std::mutex m_mutex;
+  std::map<Key, std::unique_ptr<Counter>> m_counters;
+  std::map<Key, std::unique_ptr<Gauge>> m_gauges;
+  std::map<Key, std::unique_ptr<Histogram>> m_histograms;
+
+  Metrics() = default;
+  Metrics(const Metrics&) = delete;
+  Metrics& operator=(const Metrics&) = delete;
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_METRICS_H_
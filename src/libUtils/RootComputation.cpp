@@ -56,12 +56,16 @@ TxnHash ConcatTranAndHash(const Container&... conts) {
         hasValue = true;
 
         for (auto& item : list) {
-          sha2.Update(GetHash(item).asBytes());
+          sha2.Update(GetHash(item).data(), TxnHash::size);
         }
       }(conts, sha2, hasValue),
       0)...};
 
-  return hasValue ? TxnHash{sha2.Finalize()} : TxnHash();
+  TxnHash root;
+  if (hasValue) {
+    sha2.Finalize(root.asArray());
+  }
+  return root;
 }
 
 h256 ComputeRoot(const vector<h256>& hashes) {
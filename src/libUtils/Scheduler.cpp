@@ -17,76 +17,168 @@
 
 #include "Scheduler.h"
 
-#include <utility>
 #include "ReverseLock.h"
+#include "common/Constants.h"
+#include "libUtils/Logger.h"
+#include "libUtils/Metrics.h"
 
 using namespace std;
 
-Scheduler::Scheduler() {}
+const Scheduler::TimerId Scheduler::INVALID_TIMER;
 
-Scheduler::~Scheduler() {}
+Scheduler& Scheduler::GetInstance() {
+  static Scheduler scheduler(SCHEDULER_WORKER_THREADS);
+  return scheduler;
+}
 
-void Scheduler::ServiceQueue() {
-  unique_lock<mutex> lock(newTaskMutex);
+Scheduler::Scheduler(unsigned int numWorkers) {
+  m_dispatcher = thread(&Scheduler::Dispatch, this);
+  for (unsigned int i = 0; i < max(numWorkers, 1U); i++) {
+    m_workers.emplace_back(&Scheduler::Work, this);
+  }
+}
 
-  while (true) {
-    try {
-      while (taskQueue.empty()) {
-        newTaskScheduled.wait(lock);
-      }
+Scheduler::~Scheduler() {
+  {
+    lock_guard<mutex> g(m_mutex);
+    m_stop = true;
+  }
+  m_cvDispatch.notify_all();
+  m_cvWorkers.notify_all();
 
-      while (!taskQueue.empty()) {
-        std::chrono::time_point<std::chrono::system_clock> timeToWaitFor =
-            taskQueue.begin()->first;
-        if (newTaskScheduled.wait_until(lock, timeToWaitFor) ==
-            std::cv_status::timeout) {
-          break;
-        }
-      }
+  m_dispatcher.join();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
 
-      if (taskQueue.empty()) {
-        continue;
-      }
+Scheduler::TimerId Scheduler::Add(function<void(void)> f, Clock::time_point t,
+                                  chrono::milliseconds period) {
+  TimerId id;
+  bool earliest;
+  {
+    lock_guard<mutex> g(m_mutex);
+    id = m_nextId++;
+    m_timers.emplace(id, Timer{move(f), t, period});
+    const auto it = m_deadlines.emplace(t, id).first;
+    earliest = it == m_deadlines.begin();
+  }
+  if (earliest) {
+    m_cvDispatch.notify_one();
+  }
+  return id;
+}
 
-      std::function<void(void)> f = taskQueue.begin()->second;
-      taskQueue.erase(taskQueue.begin());
+Scheduler::TimerId Scheduler::ScheduleAt(function<void(void)> f,
+                                         Clock::time_point t) {
+  return Add(move(f), t, chrono::milliseconds::zero());
+}
 
-      {
-        ReverseLock<unique_lock<mutex>> rlock(lock);
-        f();
-      }
-    } catch (...) {
-      throw;
-    }
-  }
-  newTaskScheduled.notify_one();
+Scheduler::TimerId Scheduler::ScheduleAfter(function<void(void)> f,
+                                            int64_t deltaMilliSeconds) {
+  return Add(move(f), Clock::now() + chrono::milliseconds(deltaMilliSeconds),
+             chrono::milliseconds::zero());
 }
 
-void Scheduler::ScheduleAt(std::function<void(void)> f,
-                           chrono::time_point<chrono::system_clock> t) {
-  {
-    lock_guard<mutex> lock(newTaskMutex);
-    taskQueue.emplace(t, f);
+Scheduler::TimerId Scheduler::SchedulePeriodically(function<void(void)> f,
+                                                   int64_t deltaMilliSeconds) {
+  const chrono::milliseconds period(max<int64_t>(deltaMilliSeconds, 1));
+  return Add(move(f), Clock::now() + period, period);
+}
+
+bool Scheduler::Cancel(TimerId id) {
+  static auto& cancelled =
+      Metrics::GetInstance().GetCounter("zilliqa_timers_cancelled_total");
+
+  lock_guard<mutex> g(m_mutex);
+  const auto it = m_timers.find(id);
+  if (it == m_timers.end()) {
+    return false;
   }
-  newTaskScheduled.notify_one();
+  // A timer already handed to the workers is skipped by them
+  m_deadlines.erase({it->second.m_deadline, id});
+  m_timers.erase(it);
+  cancelled.Increment();
+  return true;
 }
 
-void Scheduler::ScheduleAfter(std::function<void(void)> f,
-                              int64_t deltaMilliSeconds) {
-  ScheduleAt(move(f), chrono::system_clock::now() +
-                          chrono::milliseconds(deltaMilliSeconds));
+size_t Scheduler::GetNumPending() const {
+  lock_guard<mutex> g(m_mutex);
+  return m_timers.size();
 }
 
-static void SchedulePeriodicallyHelper(Scheduler* s,
-                                       std::function<void(void)> f,
-                                       int64_t deltaMilliSeconds) {
-  f();
-  s->ScheduleAfter(bind(&SchedulePeriodicallyHelper, s, f, deltaMilliSeconds),
-                   deltaMilliSeconds);
+void Scheduler::Dispatch() {
+  unique_lock<mutex> lock(m_mutex);
+  while (!m_stop) {
+    if (m_deadlines.empty()) {
+      m_cvDispatch.wait(lock);
+      continue;
+    }
+
+    const auto first = *m_deadlines.begin();
+    if (Clock::now() < first.first) {
+      m_cvDispatch.wait_until(lock, first.first);
+      continue;
+    }
+
+    m_deadlines.erase(m_deadlines.begin());
+    m_due.emplace_back(first.second);
+    m_cvWorkers.notify_one();
+  }
 }
 
-void Scheduler::SchedulePeriodically(std::function<void(void)> f,
-                                     int64_t deltaMilliSeconds) {
-  ScheduleAfter(bind(&SchedulePeriodicallyHelper, this, f, deltaMilliSeconds),
-                deltaMilliSeconds);
+void Scheduler::Work() {
+  static auto& fired =
+      Metrics::GetInstance().GetCounter("zilliqa_timers_fired_total");
+  static auto& jitter =
+      Metrics::GetInstance().GetHistogram("zilliqa_timer_jitter_us");
+
+  unique_lock<mutex> lock(m_mutex);
+  while (true) {
+    m_cvWorkers.wait(lock, [this]() { return m_stop || !m_due.empty(); });
+    if (m_stop) {
+      return;
+    }
+
+    const TimerId id = m_due.front();
+    m_due.pop_front();
+    auto it = m_timers.find(id);
+    if (it == m_timers.end()) {
+      continue;
+    }
+
+    jitter.Record(chrono::duration_cast<chrono::microseconds>(
+                      Clock::now() - it->second.m_deadline)
+                      .count());
+    fired.Increment();
+
+    const auto period = it->second.m_period;
+    function<void(void)> f;
+    if (period == chrono::milliseconds::zero()) {
+      f = move(it->second.m_func);
+      m_timers.erase(it);
+    } else {
+      f = it->second.m_func;
+    }
+
+    {
+      ReverseLock<unique_lock<mutex>> rlock(lock);
+      try {
+        f();
+      } catch (const exception& e) {
+        LOG_GENERAL(WARNING, "Timer " << id << " threw: " << e.what());
+      }
+    }
+
+    if (period != chrono::milliseconds::zero()) {
+      it = m_timers.find(id);
+      if (it != m_timers.end()) {
+        it->second.m_deadline = Clock::now() + period;
+        const auto next = m_deadlines.emplace(it->second.m_deadline, id).first;
+        if (next == m_deadlines.begin()) {
+          m_cvDispatch.notify_one();
+        }
+      }
+    }
+  }
 }
@@ -20,40 +20,80 @@
 
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
-#include <map>
 #include <mutex>
+#include <set>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
-// should be initialized this way
-// CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue,
-// &scheduler);
-// threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>,
-// "scheduler", serviceLoop));
-
-/// [TODO] Currently unused
+/// Timer service shared by the whole process.
+///
+/// One thread waits on the steady clock for the earliest deadline and hands
+/// due timers to a fixed pool of workers, so a pending timeout costs no
+/// thread of its own. Callbacks run on the workers and should be short; long
+/// work (e.g. a consensus round) is handed on to DetachedFunction. A timer
+/// can be cancelled until its callback starts, so callers no longer need
+/// flags to ignore timeouts that became stale.
 class Scheduler {
  public:
-  Scheduler();
+  using Clock = std::chrono::steady_clock;
+  using TimerId = uint64_t;
+
+  /// Never returned by the Schedule functions.
+  static const TimerId INVALID_TIMER = 0;
+
+  static Scheduler& GetInstance();
+
+  explicit Scheduler(unsigned int numWorkers);
   ~Scheduler();
 
-  void ScheduleAt(std::function<void(void)> f,
-                  std::chrono::time_point<std::chrono::system_clock> t =
-                      std::chrono::system_clock::now());
+  Scheduler(const Scheduler&) = delete;
+  Scheduler& operator=(const Scheduler&) = delete;
+
+  TimerId ScheduleAt(std::function<void(void)> f,
+                     Clock::time_point t = Clock::now());
 
-  void ScheduleAfter(std::function<void(void)> f, int64_t deltaMilliSeconds);
+  TimerId ScheduleAfter(std::function<void(void)> f, int64_t deltaMilliSeconds);
 
-  void SchedulePeriodically(std::function<void(void)> f,
-                            int64_t deltaMilliSeconds);
+  /// Runs f every deltaMilliSeconds, counted from the end of the previous
+  /// run, until cancelled.
+  TimerId SchedulePeriodically(std::function<void(void)> f,
+                               int64_t deltaMilliSeconds);
 
-  void ServiceQueue();
+  /// Returns false if the timer already fired (or is running, for a one-shot
+  /// timer) or was cancelled before.
+  bool Cancel(TimerId id);
+
+  /// Number of timers that are scheduled and not yet fired or cancelled.
+  size_t GetNumPending() const;
 
  private:
-  std::multimap<std::chrono::time_point<std::chrono::system_clock>,
-                std::function<void(void)>>
-      taskQueue;
-  std::condition_variable newTaskScheduled;
-  mutable std::mutex newTaskMutex;
+  struct Timer {
+    std::function<void(void)> m_func;
+    Clock::time_point m_deadline;
+    std::chrono::milliseconds m_period;
+  };
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cvDispatch;
+  std::condition_variable m_cvWorkers;
+  bool m_stop{false};
+  TimerId m_nextId{INVALID_TIMER + 1};
+
+  std::unordered_map<TimerId, Timer> m_timers;
+  std::set<std::pair<Clock::time_point, TimerId>> m_deadlines;
+  std::deque<TimerId> m_due;
+
+  std::thread m_dispatcher;
+  std::vector<std::thread> m_workers;
+
+  TimerId Add(std::function<void(void)> f, Clock::time_point t,
+              std::chrono::milliseconds period);
+  void Dispatch();
+  void Work();
 };
 
 #endif  // ZILLIQA_SRC_LIBUTILS_SCHEDULER_H_
@@ -15,9 +15,13 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <vector>
 
 #include "Validator.h"
+#include "libConsensus/AggregateKeyCache.h"
 #include "libData/AccountData/Account.h"
 #include "libMediator/Mediator.h"
 #include "libMessage/Messenger.h"
@@ -33,10 +37,8 @@ Validator::Validator(Mediator& mediator) : m_mediator(mediator) {}
 Validator::~Validator() {}
 
 bool Validator::VerifyTransaction(const Transaction& tran) {
-  bytes txnData;
-  tran.SerializeCoreFields(txnData, 0);
-
-  return Schnorr::Verify(txnData, tran.GetSignature(), tran.GetSenderPubKey());
+  return Schnorr::Verify(tran.GetSerializedCoreFields(), tran.GetSignature(),
+                         tran.GetSenderPubKey());
 }
 
 bool Validator::CheckCreatedTransaction(const Transaction& tx,
@@ -68,8 +70,7 @@ bool Validator::CheckCreatedTransaction(const Transaction& tx,
   }
 
   // Check if from account is sharded here
-  const PubKey& senderPubKey = tx.GetSenderPubKey();
-  Address fromAddr = Account::GetAddressFromPublicKey(senderPubKey);
+  Address fromAddr = tx.GetSenderAddr();
 
   if (IsNullAddress(fromAddr)) {
     LOG_GENERAL(WARNING, "Invalid address for issuing transactions");
@@ -259,10 +260,11 @@ bool Validator::CheckBlockCosignature(const DirectoryBlock& block,
   }
 
   // Generate the aggregated key
-  vector<PubKey> keys;
+  vector<const PubKey*> committee;
+  committee.reserve(B2.size());
   for (auto const& kv : commKeys) {
+    committee.emplace_back(&get<PubKey>(kv));
     if (B2.at(index)) {
-      keys.emplace_back(get<PubKey>(kv));
       count++;
     }
     index++;
@@ -273,7 +275,8 @@ bool Validator::CheckBlockCosignature(const DirectoryBlock& block,
     return false;
   }
 
-  shared_ptr<PubKey> aggregatedKey = MultiSig::AggregatePubKeys(keys);
+  shared_ptr<const PubKey> aggregatedKey =
+      AggregateKeyCache::GetInstance().AggregateKeys(committee, B2);
   if (aggregatedKey == nullptr) {
     LOG_GENERAL(WARNING, "Aggregated key generation failed");
     return false;
@@ -288,8 +291,10 @@ bool Validator::CheckBlockCosignature(const DirectoryBlock& block,
   if (!MultiSig::MultiSigVerify(serializedHeader, 0, serializedHeader.size(),
                                 block.GetCS2(), *aggregatedKey)) {
     LOG_GENERAL(WARNING, "Cosig verification failed");
-    for (auto& kv : keys) {
-      LOG_GENERAL(WARNING, kv);
+    for (unsigned int i = 0; i < committee.size(); i++) {
+      if (B2.at(i)) {
+        LOG_GENERAL(WARNING, *committee.at(i));
+      }
     }
     return false;
   }
@@ -648,11 +653,34 @@ Validator::TxBlockValidationMsg Validator::CheckTxBlocks(
     return TxBlockValidationMsg::VALID;
   }
 
+  // Header hashes do not depend on each other, so compute them in parallel
+  // before walking the chain of prev hashes
+  vector<BlockHash> headerHashes(txBlocks.size() - 1);
+  atomic<unsigned int> nextBlock{0};
+  auto worker = [&txBlocks, &headerHashes, &nextBlock]() -> void {
+    for (unsigned int n = nextBlock++; n < headerHashes.size();
+         n = nextBlock++) {
+      headerHashes[n] = txBlocks[n].GetHeader().GetMyHash();
+    }
+  };
+
+  const unsigned int numThreads =
+      max(1U, min<unsigned int>(thread::hardware_concurrency(),
+                                headerHashes.size()));
+  vector<thread> workers;
+  for (unsigned int i = 1; i < numThreads; i++) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : workers) {
+    t.join();
+  }
+
   BlockHash prevBlockHash = latestTxBlock.GetHeader().GetPrevHash();
   unsigned int sIndex = txBlocks.size() - 2;
 
   for (unsigned int i = 0; i < txBlocks.size() - 1; i++) {
-    if (prevBlockHash != txBlocks.at(sIndex).GetHeader().GetMyHash()) {
+    if (prevBlockHash != headerHashes.at(sIndex)) {
       LOG_GENERAL(WARNING,
                   "Prev hash "
                       << prevBlockHash << " and hash of blocknum "
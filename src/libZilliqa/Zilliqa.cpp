@@ -33,11 +33,43 @@
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
+#include "libUtils/Metrics.h"
 #include "libUtils/UpgradeManager.h"
 
 using namespace std;
 using namespace jsonrpc;
 
+namespace {
+Metrics::Histogram& GetMessageHistogram(unsigned char msgType,
+                                        unsigned char instruction) {
+  // Filled on first use, so the registry lock is not taken per message
+  static atomic<Metrics::Histogram*>
+      histograms[ARRAY_SIZE(MessageTypeStrings)][256];
+
+  auto& slot = histograms[msgType][instruction];
+  auto histogram = slot.load(memory_order_acquire);
+  if (histogram == nullptr) {
+    histogram = &Metrics::GetInstance().GetHistogram(
+        "zilliqa_message_processing_us",
+        "msg=\"" + Zilliqa::FormatMessageName(msgType, instruction) + "\"");
+    slot.store(histogram, memory_order_release);
+  }
+  return *histogram;
+}
+
+Metrics::Histogram& GetQueueWaitHistogram() {
+  static auto& histogram =
+      Metrics::GetInstance().GetHistogram("zilliqa_message_queue_wait_us");
+  return histogram;
+}
+
+Metrics::Gauge& GetQueueDepthGauge() {
+  static auto& gauge =
+      Metrics::GetInstance().GetGauge("zilliqa_message_queue_depth");
+  return gauge;
+}
+}  // namespace
+
 void Zilliqa::LogSelfNodeInfo(const PairOfKey& key, const Peer& peer) {
   bytes tmp1;
   bytes tmp2;
@@ -96,10 +128,12 @@ void Zilliqa::ProcessMessage(pair<bytes, Peer>* message) {
         return;
       }
 
+      const auto ins_byte = message->first.at(MessageOffset::INST);
+      Metrics::ScopedTimer timer(GetMessageHistogram(msg_type, ins_byte));
+
       std::chrono::time_point<std::chrono::high_resolution_clock> tpStart;
       std::string msgName;
       if (ENABLE_CHECK_PERFORMANCE_LOG) {
-        const auto ins_byte = message->first.at(MessageOffset::INST);
         msgName = FormatMessageName(msg_type, ins_byte);
         LOG_GENERAL(INFO, MessageSizeKeyword << msgName << " "
                                              << message->first.size());
@@ -154,8 +188,16 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
       while (m_msgQueue.pop(message)) {
         // For now, we use a thread pool to handle this message
         // Eventually processing will be single-threaded
-        m_queuePool.AddJob(
-            [this, message]() mutable -> void { ProcessMessage(message); });
+        const auto queued = chrono::steady_clock::now();
+        GetQueueDepthGauge().Add(1);
+        m_queuePool.AddJob([this, message, queued]() mutable -> void {
+          GetQueueDepthGauge().Add(-1);
+          GetQueueWaitHistogram().Record(
+              chrono::duration_cast<chrono::microseconds>(
+                  chrono::steady_clock::now() - queued)
+                  .count());
+          ProcessMessage(message);
+        });
       }
       std::this_thread::sleep_for(std::chrono::microseconds(1));
     }
@@ -387,7 +429,9 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
     }
 
     if (LOOKUP_NODE_MODE) {
-      m_lookupServerConnector = make_unique<SafeHttpServer>(LOOKUP_RPC_PORT);
+      m_lookupServerConnector = make_unique<SafeHttpServer>(
+          LOOKUP_RPC_PORT, "", "", 50, RPC_CONNECTION_TIMEOUT_IN_SECONDS,
+          RPC_MAX_CONNECTIONS);
       m_lookupServer =
           make_shared<LookupServer>(m_mediator, *m_lookupServerConnector);
 
@@ -437,6 +481,18 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
       }
     }
 
+    if (ENABLE_METRICS_HTTP) {
+      auto metricsServer = make_unique<SafeHttpServer>(METRICS_HTTP_PORT);
+      metricsServer->SetTextHandler(
+          "/metrics", []() { return Metrics::GetInstance().ToPrometheus(); });
+      if (metricsServer->StartListening()) {
+        LOG_GENERAL(INFO, "Metrics Server started successfully");
+        m_metricsServerConnector = move(metricsServer);
+      } else {
+        LOG_GENERAL(WARNING, "Metrics Server couldn't start");
+      }
+    }
+
     if (ENABLE_STAKING_RPC) {
       m_stakingServerConnector = make_unique<SafeHttpServer>(STAKING_RPC_PORT);
       m_stakingServer =
@@ -47,6 +47,7 @@ class Zilliqa {
   std::unique_ptr<jsonrpc::AbstractServerConnector> m_lookupServerConnector;
   std::unique_ptr<jsonrpc::AbstractServerConnector> m_stakingServerConnector;
   std::unique_ptr<jsonrpc::AbstractServerConnector> m_statusServerConnector;
+  std::unique_ptr<jsonrpc::AbstractServerConnector> m_metricsServerConnector;
 
   ThreadPool m_queuePool{MAXRECVMESSAGE, "QueuePool"};
 
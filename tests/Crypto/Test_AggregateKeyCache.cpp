@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <vector>
+
+#include <MultiSig.h>
+#include "libConsensus/AggregateKeyCache.h"
+#include "libConsensus/ConsensusCommon.h"
+#include "libUtils/Logger.h"
+#include "libUtils/TimeUtils.h"
+
+#define BOOST_TEST_MODULE aggregatekeycachetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const unsigned int COMMITTEE_SIZE = 600;
+const unsigned int NUM_BITMAPS = 20;
+
+/// Returns a bitmap with just enough signers for consensus, the rest being
+/// picked at random.
+vector<bool> GenerateBitmap() {
+  vector<bool> bitmap(COMMITTEE_SIZE, true);
+  unsigned int numNonSigners =
+      COMMITTEE_SIZE - ConsensusCommon::NumForConsensus(COMMITTEE_SIZE);
+  while (numNonSigners > 0) {
+    const unsigned int i = rand() % COMMITTEE_SIZE;
+    if (bitmap[i]) {
+      bitmap[i] = false;
+      numNonSigners--;
+    }
+  }
+  return bitmap;
+}
+
+shared_ptr<PubKey> AggregateDirectly(const vector<PubKey>& committee,
+                                     const vector<bool>& bitmap) {
+  vector<PubKey> keys;
+  for (unsigned int i = 0; i < committee.size(); i++) {
+    if (bitmap[i]) {
+      keys.emplace_back(committee[i]);
+    }
+  }
+  return MultiSig::AggregatePubKeys(keys);
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(aggregatekeycachetest)
+
+BOOST_AUTO_TEST_CASE(test_aggregate_matches_direct) {
+  INIT_STDOUT_LOGGER();
+
+  vector<PubKey> committee;
+  vector<const PubKey*> committeePtrs;
+  for (unsigned int i = 0; i < COMMITTEE_SIZE; i++) {
+    committee.emplace_back(Schnorr::GenKeyPair().second);
+  }
+  for (const auto& key : committee) {
+    committeePtrs.emplace_back(&key);
+  }
+
+  AggregateKeyCache& cache = AggregateKeyCache::GetInstance();
+  cache.Clear();
+
+  // All signed
+  vector<bool> bitmap(COMMITTEE_SIZE, true);
+  auto cached = cache.AggregateKeys(committeePtrs, bitmap);
+  BOOST_REQUIRE(cached != nullptr);
+  BOOST_CHECK(*cached == *AggregateDirectly(committee, bitmap));
+
+  // Few non-signers: full aggregate minus the non-signers
+  bitmap = GenerateBitmap();
+  cached = cache.AggregateKeys(committeePtrs, bitmap);
+  BOOST_REQUIRE(cached != nullptr);
+  BOOST_CHECK(*cached == *AggregateDirectly(committee, bitmap));
+
+  // Few signers: signers added up directly
+  vector<bool> inverted(COMMITTEE_SIZE);
+  for (unsigned int i = 0; i < COMMITTEE_SIZE; i++) {
+    inverted[i] = !bitmap[i];
+  }
+  cached = cache.AggregateKeys(committeePtrs, inverted);
+  BOOST_REQUIRE(cached != nullptr);
+  BOOST_CHECK(*cached == *AggregateDirectly(committee, inverted));
+
+  // Mismatched sizes are rejected
+  bitmap.pop_back();
+  BOOST_CHECK(cache.AggregateKeys(committeePtrs, bitmap) == nullptr);
+
+  // A different committee gets its own entry
+  vector<PubKey> otherCommittee(committee);
+  otherCommittee[0] = Schnorr::GenKeyPair().second;
+  vector<const PubKey*> otherPtrs;
+  for (const auto& key : otherCommittee) {
+    otherPtrs.emplace_back(&key);
+  }
+  bitmap.assign(COMMITTEE_SIZE, true);
+  cached = cache.AggregateKeys(otherPtrs, bitmap);
+  BOOST_REQUIRE(cached != nullptr);
+  BOOST_CHECK(*cached == *AggregateDirectly(otherCommittee, bitmap));
+
+  // The same keys held elsewhere find the first entry, with the hash either
+  // computed by the cache or passed in
+  vector<PubKey> sameCommittee(committee);
+  vector<const PubKey*> samePtrs;
+  for (const auto& key : sameCommittee) {
+    samePtrs.emplace_back(&key);
+  }
+  const auto committeeHash = AggregateKeyCache::HashCommittee(committeePtrs);
+  BOOST_CHECK(AggregateKeyCache::HashCommittee(samePtrs) == committeeHash);
+  BOOST_CHECK(AggregateKeyCache::HashCommittee(otherPtrs) != committeeHash);
+  cached = cache.AggregateKeys(samePtrs, bitmap);
+  BOOST_REQUIRE(cached != nullptr);
+  BOOST_CHECK(*cached == *AggregateDirectly(committee, bitmap));
+  cached = cache.AggregateKeys(committeeHash, samePtrs, inverted);
+  BOOST_REQUIRE(cached != nullptr);
+  BOOST_CHECK(*cached == *AggregateDirectly(committee, inverted));
+
+  const auto stats = cache.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_committeeMisses, 2U);
+  BOOST_CHECK_EQUAL(stats.m_committeeHits, 4U);
+}
+
+BOOST_AUTO_TEST_CASE(test_committee_eviction) {
+  INIT_STDOUT_LOGGER();
+
+  AggregateKeyCache& cache = AggregateKeyCache::GetInstance();
+  cache.Clear();
+  const auto before = cache.GetStats();
+
+  // More committees than the cache holds, each seen twice in a row
+  const unsigned int NUM_COMMITTEES = 40;
+  vector<vector<PubKey>> committees(NUM_COMMITTEES);
+  for (auto& committee : committees) {
+    for (unsigned int i = 0; i < 4; i++) {
+      committee.emplace_back(Schnorr::GenKeyPair().second);
+    }
+  }
+
+  const vector<bool> bitmap(4, true);
+  for (unsigned int round = 0; round < 2; round++) {
+    for (const auto& committee : committees) {
+      vector<const PubKey*> committeePtrs;
+      for (const auto& key : committee) {
+        committeePtrs.emplace_back(&key);
+      }
+      auto cached = cache.AggregateKeys(committeePtrs, bitmap);
+      BOOST_REQUIRE(cached != nullptr);
+      BOOST_CHECK(*cached == *AggregateDirectly(committee, bitmap));
+      BOOST_REQUIRE(cache.AggregateKeys(committeePtrs, bitmap) != nullptr);
+    }
+  }
+
+  // Evicted committees are rebuilt on the second round
+  const auto stats = cache.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_committeeMisses - before.m_committeeMisses,
+                    2 * NUM_COMMITTEES);
+  BOOST_CHECK_EQUAL(stats.m_committeeHits - before.m_committeeHits,
+                    2 * NUM_COMMITTEES);
+}
+
+BOOST_AUTO_TEST_CASE(test_aggregate_benchmark) {
+  INIT_STDOUT_LOGGER();
+
+  vector<PubKey> committee;
+  vector<const PubKey*> committeePtrs;
+  for (unsigned int i = 0; i < COMMITTEE_SIZE; i++) {
+    committee.emplace_back(Schnorr::GenKeyPair().second);
+  }
+  for (const auto& key : committee) {
+    committeePtrs.emplace_back(&key);
+  }
+
+  vector<vector<bool>> bitmaps;
+  for (unsigned int i = 0; i < NUM_BITMAPS; i++) {
+    bitmaps.emplace_back(GenerateBitmap());
+  }
+
+  AggregateKeyCache& cache = AggregateKeyCache::GetInstance();
+  cache.Clear();
+
+  // Baseline: what every cosig check used to do
+  auto startTime = r_timer_start();
+  for (const auto& bitmap : bitmaps) {
+    BOOST_REQUIRE(AggregateDirectly(committee, bitmap) != nullptr);
+  }
+  const double directUs = r_timer_end(startTime);
+
+  // First sight of each bitmap: full aggregate minus non-signers
+  startTime = r_timer_start();
+  for (const auto& bitmap : bitmaps) {
+    BOOST_REQUIRE(cache.AggregateKeys(committeePtrs, bitmap) != nullptr);
+  }
+  const double missUs = r_timer_end(startTime);
+
+  // Same bitmaps again, e.g. when a block is verified more than once
+  startTime = r_timer_start();
+  for (const auto& bitmap : bitmaps) {
+    BOOST_REQUIRE(cache.AggregateKeys(committeePtrs, bitmap) != nullptr);
+  }
+  const double hitUs = r_timer_end(startTime);
+
+  LOG_GENERAL(INFO, "Committee of " << COMMITTEE_SIZE << ", per bitmap: direct "
+                                    << directUs / NUM_BITMAPS << " us, cached "
+                                    << missUs / NUM_BITMAPS << " us, memo hit "
+                                    << hitUs / NUM_BITMAPS << " us");
+
+  BOOST_CHECK(missUs < directUs);
+  BOOST_CHECK(hitUs < missUs);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -17,9 +17,13 @@
  * Test cases obtained from https://www.di-mgt.com.au/sha_testvectors.html
  */
 
+#include <algorithm>
+#include <array>
+#include <cstdlib>
 #include <iomanip>
 #include "libCrypto/Sha2.h"
 #include "libUtils/DataConversion.h"
+#include "libUtils/TimeUtils.h"
 
 #define BOOST_TEST_MODULE sha2test
 #define BOOST_TEST_DYN_LINK
@@ -107,4 +111,91 @@ BOOST_AUTO_TEST_CASE(SHA256_002_check_896bitsx3_updatewithoffset) {
   BOOST_CHECK_EQUAL(is_equal, true);
 }
 
+/**
+ * \brief SHA256_fixed_buffers
+ *
+ * \details Test the pointer Update and array Finalize overloads, and compare
+ * them with the byte vector API when hashing many 32-byte inputs
+ */
+BOOST_AUTO_TEST_CASE(SHA256_fixed_buffers) {
+  INIT_STDOUT_LOGGER();
+
+  const unsigned int NUM_HASHES = 10000;
+  const unsigned int ITERATIONS = 100;
+  const unsigned int HASH_SIZE =
+      SHA2<HashType::HASH_VARIANT_256>::HASH_OUTPUT_SIZE;
+
+  vector<array<uint8_t, HASH_SIZE>> hashes(NUM_HASHES);
+  for (auto& hash : hashes) {
+    generate(hash.begin(), hash.end(), std::rand);
+  }
+
+  // Empty input is a valid message
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(bytes());
+  array<uint8_t, HASH_SIZE> digest{};
+  sha2.Finalize(digest);
+  bytes expected;
+  DataConversion::HexStrToUint8Vec(
+      "E3B0C44298FC1C149AFBF4C8996FB92427AE41E4649B934CA495991B7852B855",
+      expected);
+  BOOST_CHECK(equal(expected.begin(), expected.end(), digest.begin()));
+
+  // Concatenation of many hashes, as done by ComputeRoot
+  bytes vectorDigest;
+  auto startTime = r_timer_start();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    sha2.Reset();
+    for (const auto& hash : hashes) {
+      sha2.Update(bytes(hash.begin(), hash.end()));
+    }
+    vectorDigest = sha2.Finalize();
+  }
+  const double vectorUs = r_timer_end(startTime);
+
+  startTime = r_timer_start();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    sha2.Reset();
+    for (const auto& hash : hashes) {
+      sha2.Update(hash.data(), hash.size());
+    }
+    sha2.Finalize(digest);
+  }
+  const double arrayUs = r_timer_end(startTime);
+
+  BOOST_CHECK(equal(vectorDigest.begin(), vectorDigest.end(), digest.begin()));
+
+  // One digest per small input
+  startTime = r_timer_start();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    for (const auto& hash : hashes) {
+      SHA2<HashType::HASH_VARIANT_256> single;
+      single.Update(bytes(hash.begin(), hash.end()));
+      vectorDigest = single.Finalize();
+    }
+  }
+  const double singleVectorUs = r_timer_end(startTime);
+
+  startTime = r_timer_start();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    for (const auto& hash : hashes) {
+      sha2.Reset();
+      sha2.Update(hash.data(), hash.size());
+      sha2.Finalize(digest);
+    }
+  }
+  const double singleArrayUs = r_timer_end(startTime);
+
+  BOOST_CHECK(equal(vectorDigest.begin(), vectorDigest.end(), digest.begin()));
+
+  LOG_GENERAL(INFO, "Root of " << NUM_HASHES << " hashes: vector "
+                               << vectorUs / ITERATIONS << " us, array "
+                               << arrayUs / ITERATIONS << " us");
+  LOG_GENERAL(INFO, "Digest per 32-byte input: vector "
+                        << singleVectorUs * 1000 / (ITERATIONS * NUM_HASHES)
+                        << " ns, array "
+                        << singleArrayUs * 1000 / (ITERATIONS * NUM_HASHES)
+                        << " ns");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
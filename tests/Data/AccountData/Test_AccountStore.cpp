@@ -25,9 +25,12 @@
 #include "libData/AccountData/AccountStore.h"
 #include "libData/AccountData/AccountStoreSC.h"
 #include "libData/AccountData/Address.h"
+#include "libMessage/Messenger.h"
+#include "libMessage/StateDeltaStream.h"
 #include "libTestUtils/TestUtils.h"
 #include "libUtils/Logger.h"
 #include "libUtils/SysCommand.h"
+#include "libUtils/TimeUtils.h"
 
 #include "../ScillaTestUtil.h"
 
@@ -1116,4 +1119,92 @@ BOOST_AUTO_TEST_CASE(DiskOperation2) {
   BOOST_CHECK_EQUAL(0, num_errors);
 }
 
+BOOST_AUTO_TEST_CASE(stateDeltaFormats) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  AccountStore::GetInstance().Init();
+
+  const unsigned int NUM_ACCOUNTS = 100000;
+
+  AccountStoreTemp accountStoreTemp(AccountStore::GetInstance());
+  for (unsigned int i = 0; i < NUM_ACCOUNTS; i++) {
+    accountStoreTemp.AddAccount(Address::random(),
+                                {TestUtils::DistUint64(), i + 1});
+  }
+
+  bytes protoDelta, streamDelta;
+
+  auto tpStart = r_timer_start();
+  BOOST_CHECK(Messenger::SetAccountStoreDelta(
+      protoDelta, 0, accountStoreTemp, AccountStore::GetInstance(), 1));
+  auto protoSetTime = r_timer_end(tpStart);
+
+  tpStart = r_timer_start();
+  BOOST_CHECK(Messenger::SetAccountStoreDelta(streamDelta, 0, accountStoreTemp,
+                                              AccountStore::GetInstance(),
+                                              STATE_DELTA_VERSION_STREAM));
+  auto streamSetTime = r_timer_end(tpStart);
+
+  BOOST_CHECK(!StateDeltaStream::IsStreamFormat(protoDelta, 0));
+  BOOST_CHECK(StateDeltaStream::IsStreamFormat(streamDelta, 0));
+
+  std::unordered_map<Address, boost::multiprecision::int256_t> protoMap,
+      streamMap;
+  BOOST_CHECK(Messenger::StateDeltaToAddressMap(protoDelta, 0, protoMap));
+  BOOST_CHECK(Messenger::StateDeltaToAddressMap(streamDelta, 0, streamMap));
+  BOOST_CHECK(protoMap == streamMap);
+  BOOST_CHECK_EQUAL(streamMap.size(), NUM_ACCOUNTS);
+
+  // A record that fails to parse rejects the whole delta
+  {
+    std::vector<StateDeltaStream::RecordRef> index;
+    BOOST_REQUIRE(StateDeltaStream::GetIndex(streamDelta, 0, index));
+    bytes corrupted = streamDelta;
+    corrupted[index[NUM_ACCOUNTS / 2].m_offset] = 0xFF;
+    std::unordered_map<Address, boost::multiprecision::int256_t> corruptedMap;
+    BOOST_CHECK(
+        !Messenger::StateDeltaToAddressMap(corrupted, 0, corruptedMap));
+  }
+
+  auto root0 = AccountStore::GetInstance().GetStateRootHash();
+
+  tpStart = r_timer_start();
+  BOOST_CHECK(AccountStore::GetInstance().DeserializeDelta(protoDelta, 0, true));
+  auto protoGetTime = r_timer_end(tpStart);
+  auto rootProto = AccountStore::GetInstance().GetStateRootHash();
+
+  AccountStore::GetInstance().RevertCommitTemp();
+  AccountStore::GetInstance().InitRevertibles();
+  BOOST_CHECK(AccountStore::GetInstance().GetStateRootHash() == root0);
+
+  tpStart = r_timer_start();
+  BOOST_CHECK(
+      AccountStore::GetInstance().DeserializeDelta(streamDelta, 0, true));
+  auto streamGetTime = r_timer_end(tpStart);
+  auto rootStream = AccountStore::GetInstance().GetStateRootHash();
+
+  BOOST_CHECK(rootProto != root0);
+  BOOST_CHECK(rootProto == rootStream);
+
+  for (const auto& entry : *accountStoreTemp.GetAddressToAccount()) {
+    const Account* account = AccountStore::GetInstance().GetAccount(entry.first);
+    BOOST_REQUIRE(account != nullptr);
+    BOOST_CHECK(account->GetBalance() == entry.second.GetBalance());
+    BOOST_CHECK_EQUAL(account->GetNonce(), entry.second.GetNonce());
+  }
+
+  LOG_GENERAL(INFO, "Accounts: " << NUM_ACCOUNTS);
+  LOG_GENERAL(INFO, "Protobuf delta: " << protoDelta.size() << " bytes, set "
+                                       << protoSetTime << " us, apply "
+                                       << protoGetTime << " us");
+  LOG_GENERAL(INFO, "Stream delta:   " << streamDelta.size() << " bytes, set "
+                                       << streamSetTime << " us, apply "
+                                       << streamGetTime << " us");
+
+  AccountStore::GetInstance().RevertCommitTemp();
+  AccountStore::GetInstance().InitRevertibles();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
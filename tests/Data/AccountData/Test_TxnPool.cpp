@@ -27,6 +27,7 @@
 #include "libTestUtils/TestUtils.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/Logger.h"
+#include "libUtils/TimeUtils.h"
 
 using namespace boost::multiprecision;
 
@@ -209,4 +210,118 @@ BOOST_AUTO_TEST_CASE(txnpool_status) {
   BOOST_CHECK_EQUAL(status.second, txn.GetTranID());
 }
 
+BOOST_AUTO_TEST_CASE(txnpool_merge) {
+  INIT_STDOUT_LOGGER();
+
+  TestUtils::Initialize();
+
+  std::vector<Transaction> transaction_v;
+  generateUniqueTransactionVector(transaction_v, 100);
+
+  // Both pools hold some txns, and a few same nonce txns with another gas
+  TxnPool a, b;
+  MempoolInsertionStatus status;
+  for (unsigned int i = 0; i < transaction_v.size(); i++) {
+    const auto& t = transaction_v[i];
+    (i % 2 == 0 ? a : b).insert(t, status);
+    if (i % 10 == 0) {
+      b.insert(createTransaction(i % 20 == 0 ? t.GetGasPrice() + 1
+                                             : t.GetGasPrice() - 1,
+                                 t.GetSenderPubKey(), t.GetNonce()),
+               status);
+    }
+  }
+
+  TxnPool ab = a, ba = b;
+  ab.merge(b);
+  ba.merge(a);
+  BOOST_CHECK_EQUAL(0, a.size() + b.size());
+  BOOST_CHECK_EQUAL(transaction_v.size(), ab.size());
+  BOOST_CHECK_EQUAL(ab.size(), ba.size());
+  for (const auto& entry : ab.HashIndex) {
+    BOOST_CHECK_EQUAL(true, ba.exist(entry.first));
+  }
+
+  Transaction t;
+  for (unsigned int i = 0; i < transaction_v.size(); i++) {
+    BOOST_CHECK_EQUAL(true, ab.findOne(t));
+  }
+  BOOST_CHECK_EQUAL(false, ab.findOne(t));
+
+  // Taking the pool for a microblock is a swap rather than a copy
+  TxnPool pool;
+  transaction_v.clear();
+  generateUniqueTransactionVector(transaction_v, 10000);
+  for (const auto& t : transaction_v) {
+    pool.insert(t, status);
+  }
+
+  auto start = r_timer_start();
+  TxnPool copied = pool;
+  const double copyUs = r_timer_end(start);
+
+  start = r_timer_start();
+  TxnPool taken;
+  std::swap(pool, taken);
+  const double swapUs = r_timer_end(start);
+
+  LOG_GENERAL(INFO, "Taking " << taken.size() << " txns: copy " << copyUs
+                              << " us, swap " << swapUs << " us");
+  BOOST_CHECK_EQUAL(copied.size(), taken.size());
+  BOOST_CHECK_EQUAL(0, pool.size());
+}
+
+BOOST_AUTO_TEST_CASE(txnpool_replaced_price_level) {
+  TxnPool tp;
+
+  Transaction txn = generateUniqueTransaction();
+  Transaction lowGasTxn = createTransaction(
+      txn.GetGasPrice() / 2, TestUtils::GenerateRandomPubKey(), 0);
+  Transaction higherGasTxn =
+      createTransaction(txn.GetGasPrice() + 1, txn.GetSenderPubKey(),
+                        txn.GetNonce());
+
+  MempoolInsertionStatus status;
+  BOOST_CHECK_EQUAL(true, tp.insert(lowGasTxn, status));
+  BOOST_CHECK_EQUAL(true, tp.insert(txn, status));
+  BOOST_CHECK_EQUAL(true, tp.insert(higherGasTxn, status));
+
+  // The price level of the replaced txn must not end the selection
+  Transaction t;
+  BOOST_CHECK_EQUAL(true, tp.findOne(t));
+  BOOST_CHECK_EQUAL(true, t == higherGasTxn);
+  BOOST_CHECK_EQUAL(true, tp.findOne(t));
+  BOOST_CHECK_EQUAL(true, t == lowGasTxn);
+  BOOST_CHECK_EQUAL(false, tp.findOne(t));
+}
+
+BOOST_AUTO_TEST_CASE(txnpool_take) {
+  TxnPool tp;
+
+  Transaction txn = generateUniqueTransaction();
+  Transaction otherTxn = generateUniqueTransaction();
+
+  MempoolInsertionStatus status;
+  BOOST_CHECK_EQUAL(true, tp.insert(txn, status));
+  BOOST_CHECK_EQUAL(true, tp.insert(otherTxn, status));
+
+  Transaction t;
+  BOOST_CHECK_EQUAL(true, tp.take(txn.GetTranID(), t));
+  BOOST_CHECK_EQUAL(true, t == txn);
+  BOOST_CHECK_EQUAL(1, tp.size());
+  BOOST_CHECK_EQUAL(false, tp.exist(txn.GetTranID()));
+  BOOST_CHECK_EQUAL(false, tp.take(txn.GetTranID(), t));
+
+  // Gone from the nonce and gas indices too
+  BOOST_CHECK_EQUAL(true, tp.findOne(t));
+  BOOST_CHECK_EQUAL(true, t == otherTxn);
+  BOOST_CHECK_EQUAL(false, tp.findOne(t));
+
+  // A taken txn can be given back, e.g. after a failed replay
+  BOOST_CHECK_EQUAL(true, tp.insert(txn, status));
+  BOOST_CHECK_EQUAL(status.first, TxnStatus::NOT_PRESENT);
+  BOOST_CHECK_EQUAL(true, tp.findOne(t));
+  BOOST_CHECK_EQUAL(true, t == txn);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <random>
+#include <vector>
+
+#include "libData/BlockData/Block/CompactTxnHashes.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE compacttxnhashestest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+vector<TxnHash> GenerateTxnHashes(mt19937_64& eng, unsigned int num) {
+  vector<TxnHash> txnHashes(num);
+  for (auto& txnHash : txnHashes) {
+    for (unsigned int i = 0; i < TxnHash::size; i++) {
+      txnHash.data()[i] = eng();
+    }
+  }
+  return txnHashes;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(compacttxnhashestest)
+
+BOOST_AUTO_TEST_CASE(test_round_trip) {
+  INIT_STDOUT_LOGGER();
+
+  mt19937_64 eng(0);
+  const auto txnHashes = GenerateTxnHashes(eng, 1000);
+  const CompactTxnHashes sent(12345, txnHashes);
+  BOOST_CHECK_EQUAL(sent.GetShortIds().size(),
+                    txnHashes.size() * CompactTxnHashes::SHORT_ID_SIZE);
+
+  // Rebuilt from the wire format, with the local pool in another order
+  const CompactTxnHashes received(sent.GetSalt(), sent.GetShortIds());
+  BOOST_CHECK_EQUAL(received.GetNumTxns(), txnHashes.size());
+  CompactTxnHashesResolver resolver(received);
+  for (auto it = txnHashes.rbegin(); it != txnHashes.rend(); ++it) {
+    resolver.Offer(*it);
+  }
+  for (const auto& txnHash : GenerateTxnHashes(eng, 5000)) {
+    resolver.Offer(txnHash);
+  }
+
+  vector<TxnHash> resolved;
+  vector<uint32_t> missingIndices;
+  BOOST_CHECK_EQUAL(resolver.Resolve(resolved, missingIndices), 0);
+  BOOST_CHECK(missingIndices.empty());
+  BOOST_CHECK(resolved == txnHashes);
+}
+
+BOOST_AUTO_TEST_CASE(test_missing_txns) {
+  INIT_STDOUT_LOGGER();
+
+  mt19937_64 eng(1);
+  const auto txnHashes = GenerateTxnHashes(eng, 100);
+  const CompactTxnHashes compact(1, txnHashes);
+  CompactTxnHashesResolver resolver(compact);
+  for (unsigned int i = 0; i < txnHashes.size(); i++) {
+    if (i % 10 != 3) {
+      resolver.Offer(txnHashes[i]);
+    }
+  }
+
+  vector<TxnHash> resolved;
+  vector<uint32_t> missingIndices;
+  BOOST_REQUIRE_EQUAL(resolver.Resolve(resolved, missingIndices), 10);
+  BOOST_REQUIRE_EQUAL(resolved.size(), txnHashes.size());
+  for (unsigned int i = 0; i < txnHashes.size(); i++) {
+    if (i % 10 == 3) {
+      BOOST_CHECK_EQUAL(missingIndices[i / 10], i);
+      BOOST_CHECK(resolved[i] == TxnHash());
+    } else {
+      BOOST_CHECK(resolved[i] == txnHashes[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_repeated_txn) {
+  INIT_STDOUT_LOGGER();
+
+  mt19937_64 eng(2);
+  auto txnHashes = GenerateTxnHashes(eng, 3);
+  txnHashes.emplace_back(txnHashes[0]);
+  const CompactTxnHashes compact(2, txnHashes);
+  CompactTxnHashesResolver resolver(compact);
+  for (const auto& txnHash : txnHashes) {
+    resolver.Offer(txnHash);
+  }
+
+  // A repeated hash resolves to the same txn at both positions
+  vector<TxnHash> resolved;
+  vector<uint32_t> missingIndices;
+  BOOST_CHECK_EQUAL(resolver.Resolve(resolved, missingIndices), 0);
+  BOOST_CHECK(resolved == txnHashes);
+}
+
+BOOST_AUTO_TEST_CASE(test_salt) {
+  INIT_STDOUT_LOGGER();
+
+  mt19937_64 eng(3);
+  const auto txnHashes = GenerateTxnHashes(eng, 100);
+  const CompactTxnHashes first(1, txnHashes);
+  const CompactTxnHashes second(2, txnHashes);
+  BOOST_CHECK(first.GetShortIds() != second.GetShortIds());
+  BOOST_CHECK(first.GetShortIds() == CompactTxnHashes(1, txnHashes)
+                                         .GetShortIds());
+
+  // Short IDs of one salt do not resolve against another
+  const CompactTxnHashes mismatched(2, first.GetShortIds());
+  CompactTxnHashesResolver resolver(mismatched);
+  for (const auto& txnHash : txnHashes) {
+    resolver.Offer(txnHash);
+  }
+  vector<TxnHash> resolved;
+  vector<uint32_t> missingIndices;
+  BOOST_CHECK_GT(resolver.Resolve(resolved, missingIndices), 90);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
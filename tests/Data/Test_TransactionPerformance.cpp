@@ -17,11 +17,13 @@
 
 #include <Schnorr.h>
 #include <array>
+#include <chrono>
 #include <string>
 #include <vector>
 #include "libData/AccountData/Account.h"
 #include "libData/AccountData/Address.h"
 #include "libData/AccountData/Transaction.h"
+#include "libMessage/Messenger.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/Logger.h"
 
@@ -225,4 +227,83 @@ BOOST_AUTO_TEST_CASE(GenTxn1000) {
                 << " ms");
 }
 
+BOOST_AUTO_TEST_CASE(DerivedFieldsCache) {
+  INIT_STDOUT_LOGGER();
+  const auto n = 1000u;
+  const auto passes = 5u;
+  auto sender = Schnorr::GenKeyPair();
+  auto receiver = Schnorr::GenKeyPair();
+  auto txns = GenWithDummyValue(sender, receiver, n);
+  const Address expectedAddr = Account::GetAddressFromPublicKey(sender.second);
+
+  // What every GetSenderAddr call used to cost
+  auto t_start = std::chrono::high_resolution_clock::now();
+  for (auto pass = 0u; pass < passes; pass++) {
+    for (const auto& txn : txns) {
+      BOOST_REQUIRE(Account::GetAddressFromPublicKey(txn.GetSenderPubKey()) ==
+                    expectedAddr);
+    }
+  }
+  auto t_end = std::chrono::high_resolution_clock::now();
+  LOG_GENERAL(INFO, "Sender address, uncached: "
+                        << std::chrono::duration<double, std::milli>(
+                               t_end - t_start)
+                               .count()
+                        << " ms");
+
+  t_start = std::chrono::high_resolution_clock::now();
+  for (auto pass = 0u; pass < passes; pass++) {
+    for (const auto& txn : txns) {
+      BOOST_REQUIRE(txn.GetSenderAddr() == expectedAddr);
+    }
+  }
+  t_end = std::chrono::high_resolution_clock::now();
+  LOG_GENERAL(INFO, "Sender address, cached: "
+                        << std::chrono::duration<double, std::milli>(
+                               t_end - t_start)
+                               .count()
+                        << " ms");
+
+  // Core fields, as reserialized for every signature check before
+  t_start = std::chrono::high_resolution_clock::now();
+  for (auto pass = 0u; pass < passes; pass++) {
+    for (const auto& txn : txns) {
+      bytes coreFields;
+      BOOST_REQUIRE(
+          Messenger::SetTransactionCoreInfo(coreFields, 0, txn.GetCoreInfo()));
+      BOOST_REQUIRE(coreFields == txn.GetSerializedCoreFields());
+    }
+  }
+  t_end = std::chrono::high_resolution_clock::now();
+  LOG_GENERAL(INFO, "Core fields, uncached: "
+                        << std::chrono::duration<double, std::milli>(
+                               t_end - t_start)
+                               .count()
+                        << " ms");
+
+  t_start = std::chrono::high_resolution_clock::now();
+  for (auto pass = 0u; pass < passes; pass++) {
+    for (const auto& txn : txns) {
+      BOOST_REQUIRE(Schnorr::Verify(txn.GetSerializedCoreFields(),
+                                    txn.GetSignature(), txn.GetSenderPubKey()));
+    }
+  }
+  t_end = std::chrono::high_resolution_clock::now();
+  LOG_GENERAL(INFO, "Signature check on cached core fields: "
+                        << std::chrono::duration<double, std::milli>(
+                               t_end - t_start)
+                               .count()
+                        << " ms");
+
+  // Deserialized and copied transactions carry the same derived data
+  bytes serialized;
+  BOOST_REQUIRE(txns.front().Serialize(serialized, 0));
+  Transaction deserialized(serialized, 0);
+  const Transaction copied(deserialized);
+  BOOST_CHECK(deserialized.GetSenderAddr() == expectedAddr);
+  BOOST_CHECK(copied.GetSenderAddr() == expectedAddr);
+  BOOST_CHECK(copied.GetSerializedCoreFields() ==
+              txns.front().GetSerializedCoreFields());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "libDirectoryService/GasPriceTracker.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE gaspricetrackertest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const unsigned int CONGESTION_PERCENT = 80;
+const unsigned int NUM_BLOCKS = 2000;
+const uint64_t DS_WINDOW_SIZE = 6;
+
+struct TxBlock {
+  uint128_t m_gasUsed;
+  uint128_t m_gasLimit;
+};
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(gaspricetrackertest)
+
+BOOST_AUTO_TEST_CASE(test_congestion_matches_chain_walk) {
+  INIT_STDOUT_LOGGER();
+
+  GasPriceTracker tracker(CONGESTION_PERCENT, DS_WINDOW_SIZE);
+  mt19937_64 eng(0);
+  vector<TxBlock> chain;
+  unsigned int fetched = 0;
+  const auto fetch = [&](uint64_t blockNum) {
+    fetched++;
+    return tracker.IsCongested(chain.at(blockNum).m_gasUsed,
+                               chain.at(blockNum).m_gasLimit);
+  };
+
+  uint64_t loBlockNum = 0;
+  for (uint64_t blockNum = 0; blockNum < NUM_BLOCKS; blockNum++) {
+    chain.push_back({eng() % 1000, 1000});
+    // Some blocks reach the chain without being recorded, e.g. on a rejoin
+    if (eng() % 10 != 0) {
+      tracker.AddTxBlock(blockNum, chain.back().m_gasUsed,
+                         chain.back().m_gasLimit);
+    }
+    if (eng() % 25 == 0) {
+      // A new DS block moves the window on
+      loBlockNum = blockNum;
+      tracker.AddDSBlock(blockNum / 25, loBlockNum, 0);
+    }
+    if (eng() % 3 != 0) {
+      continue;
+    }
+
+    uint64_t total, congested;
+    tracker.CountCongested(loBlockNum, blockNum, fetch, total, congested);
+
+    uint64_t expectedTotal = 0, expectedCongested = 0;
+    for (uint64_t i = loBlockNum; i <= blockNum; i++) {
+      expectedCongested +=
+          chain[i].m_gasUsed >= chain[i].m_gasLimit * CONGESTION_PERCENT / 100;
+      expectedTotal++;
+    }
+    BOOST_REQUIRE_EQUAL(total, expectedTotal);
+    BOOST_REQUIRE_EQUAL(congested, expectedCongested);
+  }
+
+  // Only the unrecorded blocks are fetched, and each of them once
+  BOOST_CHECK_LT(fetched, NUM_BLOCKS / 5);
+
+  uint64_t total, congested;
+  tracker.CountCongested(10, 5, fetch, total, congested);
+  BOOST_CHECK_EQUAL(total, 0);
+  BOOST_CHECK_EQUAL(congested, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_ds_gas_prices) {
+  INIT_STDOUT_LOGGER();
+
+  GasPriceTracker tracker(CONGESTION_PERCENT, DS_WINDOW_SIZE);
+  mt19937_64 eng(1);
+  vector<uint128_t> chain{0};
+  const auto fetch = [&chain](uint64_t blockNum) { return chain.at(blockNum); };
+
+  for (uint64_t blockNum = 1; blockNum < NUM_BLOCKS; blockNum++) {
+    chain.emplace_back(uint128_t(eng()) << (eng() % 64));
+    if (eng() % 4 != 0) {
+      tracker.AddDSBlock(blockNum, 0, chain.back());
+    }
+    const uint64_t window = eng() % DS_WINDOW_SIZE;
+    const uint64_t lo = blockNum > window ? blockNum - window : 1;
+    BOOST_REQUIRE(tracker.GetDSGasPrices(lo, blockNum, fetch) ==
+                  vector<uint128_t>(chain.begin() + lo, chain.end()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_median_proposal) {
+  INIT_STDOUT_LOGGER();
+
+  GasPriceTracker tracker(CONGESTION_PERCENT, DS_WINDOW_SIZE);
+  mt19937_64 eng(2);
+  multiset<uint128_t> proposals;
+
+  for (unsigned int i = 0; i < 2000; i++) {
+    const uint128_t gasPrice = eng() % 100;
+    if (eng() % 3 == 0 && proposals.count(gasPrice) > 0) {
+      proposals.erase(proposals.find(gasPrice));
+      tracker.RemoveProposal(gasPrice);
+    } else {
+      proposals.emplace(gasPrice);
+      tracker.AddProposal(gasPrice);
+    }
+    BOOST_REQUIRE_EQUAL(tracker.GetNumProposals(), proposals.size());
+
+    // Median as DirectoryService::GetIncreasedGasPrice used to compute it
+    const uint128_t upperbound = eng() % 120;
+    multiset<uint128_t> kept;
+    for (const auto& p : proposals) {
+      if (p <= upperbound) {
+        kept.emplace(p);
+      }
+    }
+
+    uint128_t median;
+    BOOST_REQUIRE_EQUAL(tracker.GetMedianProposal(upperbound, median),
+                        !kept.empty());
+    if (kept.empty()) {
+      continue;
+    }
+    auto iter = kept.cbegin();
+    advance(iter, kept.size() / 2);
+    uint128_t expected;
+    if (kept.size() % 2 == 0) {
+      const auto iter2 = iter--;
+      expected = (*iter + *iter2) / 2;
+    } else {
+      expected = *iter;
+    }
+    BOOST_REQUIRE_EQUAL(median, expected);
+  }
+
+  tracker.ClearProposals();
+  uint128_t median;
+  BOOST_CHECK(!tracker.GetMedianProposal(1000, median));
+
+  // Usable again after being cleared
+  tracker.AddProposal(5);
+  tracker.AddProposal(7);
+  BOOST_REQUIRE(tracker.GetMedianProposal(1000, median));
+  BOOST_CHECK_EQUAL(median, 6);
+  tracker.RemoveProposal(5);
+  BOOST_REQUIRE(tracker.GetMedianProposal(1000, median));
+  BOOST_CHECK_EQUAL(median, 7);
+  BOOST_CHECK(!tracker.GetMedianProposal(6, median));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -15,6 +15,8 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 #include <Schnorr.h>
@@ -28,6 +30,7 @@
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
+#include "libUtils/TimeUtils.h"
 #include "libUtils/UpgradeManager.h"
 
 #define BOOST_TEST_MODULE coinbase
@@ -157,4 +160,106 @@ BOOST_AUTO_TEST_CASE(test_coinbase_correctness) {
                       "Lookup reward doesn't match");
 }
 
+BOOST_AUTO_TEST_CASE(test_coinbase_batch_matches_sequential) {
+  INIT_STDOUT_LOGGER();
+  LOG_MARKER();
+
+  const uint64_t nonce{0};
+  const unsigned int numNodes = 2000;
+  const unsigned int numEpochs = NUM_FINAL_BLOCK_PER_POW;
+
+  AccountStore::GetInstance().Init();
+  AccountStore::GetInstance().AddAccount(Address(),
+                                         {TOTAL_COINBASE_REWARD, nonce});
+  AccountStore::GetInstance().UpdateStateTrieAll();
+
+  vector<PubKey> pubKeys;
+  for (unsigned int i = 0; i < numNodes; i++) {
+    pubKeys.emplace_back(GenerateRandomPubKey());
+  }
+
+  // Base reward for every node, then a cosig reward per signing node per
+  // epoch, as InitCoinbase pays them out
+  vector<pair<const PubKey*, uint128_t>> payouts;
+  for (const auto& pk : pubKeys) {
+    payouts.emplace_back(&pk, 1000);
+  }
+  for (unsigned int epoch = 0; epoch < numEpochs; epoch++) {
+    for (const auto& pk : pubKeys) {
+      if (DistUint8() % 4 != 0) {
+        payouts.emplace_back(&pk, 10);
+      }
+    }
+  }
+  // More than is left, and a zero reward, both handled as before
+  payouts.emplace_back(&pubKeys.front(), TOTAL_COINBASE_REWARD);
+  payouts.emplace_back(&pubKeys.back(), 0);
+
+  AccountStore::GetInstance().InitTemp();
+  auto start = r_timer_start();
+  vector<bool> expected;
+  for (const auto& payout : payouts) {
+    expected.push_back(AccountStore::GetInstance().UpdateCoinbaseTemp(
+        Account::GetAddressFromPublicKey(*payout.first), Address(),
+        payout.second));
+  }
+  const double sequentialUs = r_timer_end(start);
+
+  map<Address, uint128_t> expectedBalances;
+  for (const auto& pk : pubKeys) {
+    const auto& address = Account::GetAddressFromPublicKey(pk);
+    expectedBalances[address] =
+        AccountStore::GetInstance().GetAccountTemp(address)->GetBalance();
+  }
+  expectedBalances[Address()] =
+      AccountStore::GetInstance().GetAccountTemp(Address())->GetBalance();
+
+  AccountStore::GetInstance().InitTemp();
+  start = r_timer_start();
+  unordered_map<PubKey, Address> addresses;
+  for (const auto& pk : pubKeys) {
+    addresses.emplace(pk, Account::GetAddressFromPublicKey(pk));
+  }
+  vector<pair<Address, uint128_t>> rewards;
+  for (const auto& payout : payouts) {
+    rewards.emplace_back(addresses.at(*payout.first), payout.second);
+  }
+  vector<bool> succeeded;
+  AccountStore::GetInstance().UpdateCoinbaseBatchTemp(Address(), rewards,
+                                                      succeeded);
+  const double batchUs = r_timer_end(start);
+
+  LOG_GENERAL(INFO, payouts.size()
+                        << " rewards to " << numNodes << " nodes: sequential "
+                        << sequentialUs << " us, batched " << batchUs
+                        << " us");
+
+  BOOST_CHECK(succeeded == expected);
+  BOOST_CHECK(!succeeded[payouts.size() - 2]);
+  for (const auto& entry : expectedBalances) {
+    BOOST_CHECK_EQUAL(
+        AccountStore::GetInstance().GetAccountTemp(entry.first)->GetBalance(),
+        entry.second);
+  }
+
+  // The timings are only logged. What the coinbase account paid out is
+  // exactly what the nodes received.
+  uint128_t paidOut = 0;
+  for (size_t i = 0; i < payouts.size(); i++) {
+    if (succeeded[i]) {
+      paidOut += payouts[i].second;
+    }
+  }
+  uint128_t received = 0;
+  for (const auto& entry : addresses) {
+    received +=
+        AccountStore::GetInstance().GetAccountTemp(entry.second)->GetBalance();
+  }
+  BOOST_CHECK_EQUAL(received, paidOut);
+  BOOST_CHECK_EQUAL(
+      TOTAL_COINBASE_REWARD -
+          AccountStore::GetInstance().GetAccountTemp(Address())->GetBalance(),
+      paidOut);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -246,6 +246,92 @@ BOOST_AUTO_TEST_CASE(test_SetAndGetFallbackBlock) {
   BOOST_CHECK(fallbackBlock == fallbackBlockDeserialized);
 }
 
+BOOST_AUTO_TEST_CASE(test_SetAndGetNodeTxnOrder) {
+  const PairOfKey leaderKey = TestUtils::GenerateRandomKeyPair();
+  const uint64_t epochNum = TestUtils::DistUint64();
+  const uint32_t startIndex = TestUtils::DistUint32();
+  vector<TxnHash> txnHashes(TestUtils::Dist1to99());
+  for (auto& txnHash : txnHashes) {
+    txnHash = TxnHash::random();
+  }
+
+  bytes dst;
+  const unsigned int offset = TestUtils::DistUint8();
+  BOOST_REQUIRE(Messenger::SetNodeTxnOrder(dst, offset, leaderKey, epochNum,
+                                           startIndex, txnHashes, true));
+
+  PubKey leaderPubKey;
+  uint64_t epochNumDeserialized = 0;
+  uint32_t startIndexDeserialized = 0;
+  vector<TxnHash> txnHashesDeserialized;
+  bool last = false;
+  BOOST_REQUIRE(Messenger::GetNodeTxnOrder(
+      dst, offset, leaderPubKey, epochNumDeserialized, startIndexDeserialized,
+      txnHashesDeserialized, last));
+  BOOST_CHECK(leaderPubKey == leaderKey.second);
+  BOOST_CHECK_EQUAL(epochNumDeserialized, epochNum);
+  BOOST_CHECK_EQUAL(startIndexDeserialized, startIndex);
+  BOOST_CHECK(txnHashesDeserialized == txnHashes);
+  BOOST_CHECK(last);
+
+  // An empty final batch closes the order
+  BOOST_REQUIRE(Messenger::SetNodeTxnOrder(dst, offset, leaderKey, epochNum,
+                                           startIndex, {}, true));
+  txnHashesDeserialized.clear();
+  BOOST_REQUIRE(Messenger::GetNodeTxnOrder(
+      dst, offset, leaderPubKey, epochNumDeserialized, startIndexDeserialized,
+      txnHashesDeserialized, last));
+  BOOST_CHECK(txnHashesDeserialized.empty());
+  BOOST_CHECK(last);
+
+  // Altered batches fail the leader's signature
+  BOOST_REQUIRE(Messenger::SetNodeTxnOrder(dst, offset, leaderKey, epochNum,
+                                           startIndex, txnHashes, false));
+  dst[offset + (dst.size() - offset) / 2] ^= 0x01;
+  txnHashesDeserialized.clear();
+  BOOST_CHECK(!Messenger::GetNodeTxnOrder(
+      dst, offset, leaderPubKey, epochNumDeserialized, startIndexDeserialized,
+      txnHashesDeserialized, last));
+}
+
+BOOST_AUTO_TEST_CASE(test_SetAndGetNodeMissingTxnsErrorMsg) {
+  vector<TxnHash> missingTxnHashes(TestUtils::Dist1to99());
+  for (auto& txnHash : missingTxnHashes) {
+    txnHash = TxnHash::random();
+  }
+  const vector<uint32_t> missingTxnIndices = {0, 7, 42};
+  const uint64_t epochNum = TestUtils::DistUint64();
+  const uint32_t listenPort = TestUtils::DistUint16();
+
+  // GETMISSINGTXNS carries hashes only
+  bytes dst;
+  const unsigned int offset = TestUtils::DistUint8();
+  BOOST_REQUIRE(Messenger::SetNodeMissingTxnsErrorMsg(
+      dst, offset, missingTxnHashes, {}, epochNum, listenPort));
+
+  vector<TxnHash> hashesDeserialized;
+  vector<uint32_t> indicesDeserialized;
+  uint64_t epochNumDeserialized = 0;
+  uint32_t listenPortDeserialized = 0;
+  BOOST_REQUIRE(Messenger::GetNodeMissingTxnsErrorMsg(
+      dst, offset, hashesDeserialized, indicesDeserialized,
+      epochNumDeserialized, listenPortDeserialized));
+  BOOST_CHECK(hashesDeserialized == missingTxnHashes);
+  BOOST_CHECK(indicesDeserialized.empty());
+  BOOST_CHECK_EQUAL(epochNumDeserialized, epochNum);
+  BOOST_CHECK_EQUAL(listenPortDeserialized, listenPort);
+
+  dst.clear();
+  hashesDeserialized.clear();
+  BOOST_REQUIRE(Messenger::SetNodeMissingTxnsErrorMsg(
+      dst, offset, {}, missingTxnIndices, epochNum, listenPort));
+  BOOST_REQUIRE(Messenger::GetNodeMissingTxnsErrorMsg(
+      dst, offset, hashesDeserialized, indicesDeserialized,
+      epochNumDeserialized, listenPortDeserialized));
+  BOOST_CHECK(hashesDeserialized.empty());
+  BOOST_CHECK(indicesDeserialized == missingTxnIndices);
+}
+
 BOOST_AUTO_TEST_CASE(test_CopyWithSizeCheck) {
   bytes arr;
   dev::h256 result;
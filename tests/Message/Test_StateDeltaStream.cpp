@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include "libMessage/StateDeltaStream.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE statedeltastream
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(statedeltastream)
+
+map<Address, bytes> GenerateRecords(const unsigned int count) {
+  map<Address, bytes> records;
+  for (unsigned int i = 0; i < count; i++) {
+    records.emplace(Address::random(),
+                    TestUtils::GenerateRandomCharVector(
+                        TestUtils::RandomIntInRng<size_t>(0, 300)));
+  }
+  return records;
+}
+
+bool WriteRecords(const map<Address, bytes>& records, bytes& dst,
+                  const unsigned int offset) {
+  StateDeltaStream::Writer writer(dst, offset);
+  for (const auto& record : records) {
+    unsigned int payloadOffset = 0;
+    if (!writer.BeginRecord(record.first, record.second.size(),
+                            payloadOffset)) {
+      return false;
+    }
+    copy(record.second.begin(), record.second.end(),
+         dst.begin() + payloadOffset);
+  }
+  writer.Finalize();
+  return true;
+}
+
+BOOST_AUTO_TEST_CASE(init) {
+  INIT_STDOUT_LOGGER();
+  TestUtils::Initialize();
+}
+
+BOOST_AUTO_TEST_CASE(test_RoundTrip) {
+  const auto records = GenerateRecords(1000);
+  const unsigned int offset = TestUtils::Dist1to99();
+
+  bytes dst(offset);
+  BOOST_REQUIRE(WriteRecords(records, dst, offset));
+  BOOST_CHECK(StateDeltaStream::IsStreamFormat(dst, offset));
+  BOOST_CHECK(!StateDeltaStream::IsStreamFormat(dst, 0));
+
+  vector<StateDeltaStream::RecordRef> index;
+  BOOST_REQUIRE(StateDeltaStream::GetIndex(dst, offset, index));
+  BOOST_REQUIRE_EQUAL(index.size(), records.size());
+
+  auto it = records.begin();
+  for (const auto& ref : index) {
+    BOOST_CHECK(ref.m_address == it->first);
+    BOOST_CHECK(bytes(dst.begin() + ref.m_offset,
+                      dst.begin() + ref.m_offset + ref.m_size) == it->second);
+    ++it;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_OutOfOrderRejected) {
+  bytes dst;
+  StateDeltaStream::Writer writer(dst, 0);
+  Address high, low;
+  high.asArray().fill(0xFF);
+  unsigned int payloadOffset = 0;
+  BOOST_CHECK(writer.BeginRecord(high, 0, payloadOffset));
+  BOOST_CHECK(!writer.BeginRecord(low, 0, payloadOffset));
+  BOOST_CHECK(!writer.BeginRecord(high, 0, payloadOffset));
+}
+
+BOOST_AUTO_TEST_CASE(test_TruncatedRejected) {
+  const auto records = GenerateRecords(10);
+  bytes dst;
+  BOOST_REQUIRE(WriteRecords(records, dst, 0));
+
+  vector<StateDeltaStream::RecordRef> index;
+  for (size_t size = StateDeltaStream::HEADER_SIZE; size < dst.size();
+       size++) {
+    bytes truncated(dst.begin(), dst.begin() + size);
+    BOOST_CHECK(!StateDeltaStream::GetIndex(truncated, 0, index));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_ChunkReader) {
+  const auto records = GenerateRecords(500);
+  bytes dst;
+  BOOST_REQUIRE(WriteRecords(records, dst, 0));
+
+  StateDeltaStream::ChunkReader reader;
+  auto it = records.begin();
+  size_t pos = 0;
+  while (pos < dst.size()) {
+    const size_t chunkSize = min<size_t>(
+        TestUtils::RandomIntInRng<size_t>(1, 700), dst.size() - pos);
+    reader.Feed(bytes(dst.begin() + pos, dst.begin() + pos + chunkSize));
+    pos += chunkSize;
+
+    Address address;
+    bytes payload;
+    while (reader.Next(address, payload)) {
+      BOOST_REQUIRE(it != records.end());
+      BOOST_CHECK(address == it->first);
+      BOOST_CHECK(payload == it->second);
+      ++it;
+    }
+    BOOST_REQUIRE(!reader.HasError());
+  }
+
+  BOOST_CHECK(it == records.end());
+  BOOST_CHECK(reader.IsDone());
+}
+
+BOOST_AUTO_TEST_CASE(test_PartitionByAddress) {
+  const auto records = GenerateRecords(1000);
+  bytes dst;
+  BOOST_REQUIRE(WriteRecords(records, dst, 0));
+
+  vector<StateDeltaStream::RecordRef> index;
+  BOOST_REQUIRE(StateDeltaStream::GetIndex(dst, 0, index));
+
+  for (unsigned int numParts = 1; numParts <= 16; numParts++) {
+    const auto parts = StateDeltaStream::PartitionByAddress(index, numParts);
+    BOOST_REQUIRE(!parts.empty());
+    BOOST_CHECK(parts.size() <= numParts);
+    BOOST_CHECK(parts.front().first == 0);
+    BOOST_CHECK_EQUAL(parts.back().second, index.size());
+    for (size_t i = 1; i < parts.size(); i++) {
+      BOOST_CHECK_EQUAL(parts[i - 1].second, parts[i].first);
+      BOOST_CHECK(parts[i].first < parts[i].second);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "libNetwork/IPFlagTable.h"
+#include "libUtils/Logger.h"
+#include "libUtils/TimeUtils.h"
+
+#define BOOST_TEST_MODULE ipflagtabletest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const unsigned int NUM_IPS = 10000;
+const unsigned int NUM_LOOKUPS = 1000000;
+const unsigned int NUM_THREADS = 8;
+
+// Blacklist lookup before it moved to IPFlagTable
+struct StringHash {
+  size_t operator()(const uint128_t& key) const {
+    return hash<string>()(key.convert_to<string>());
+  }
+};
+
+class MutexBlacklist {
+  mutex m_mutex;
+  unordered_map<uint128_t, bool, StringHash> m_blacklistIP;
+
+ public:
+  void Add(const uint128_t& ip) {
+    lock_guard<mutex> g(m_mutex);
+    m_blacklistIP.emplace(ip, true);
+  }
+
+  bool Exist(const uint128_t& ip) {
+    lock_guard<mutex> g(m_mutex);
+    return m_blacklistIP.find(ip) != m_blacklistIP.end();
+  }
+};
+
+vector<uint128_t> RandomIPs(unsigned int num, uint64_t seed) {
+  mt19937_64 eng(seed);
+  vector<uint128_t> ips;
+  for (unsigned int i = 0; i < num; i++) {
+    ips.emplace_back((uint128_t(eng()) << 64) | eng());
+  }
+  return ips;
+}
+
+template <class Lookup>
+double LookupNs(unsigned int numThreads, const vector<uint128_t>& ips,
+                Lookup lookup) {
+  vector<thread> threads;
+  atomic<unsigned int> found{0};
+  const auto start = r_timer_start();
+  for (unsigned int t = 0; t < numThreads; t++) {
+    threads.emplace_back([&ips, &lookup, &found, t]() {
+      unsigned int local = 0;
+      for (unsigned int i = 0; i < NUM_LOOKUPS; i++) {
+        local += lookup(ips[(i * 7 + t) % ips.size()]);
+      }
+      found += local;
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  BOOST_CHECK_EQUAL(found.load(), numThreads * NUM_LOOKUPS / 2);
+  return r_timer_end(start) * 1000 / NUM_LOOKUPS;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(ipflagtabletest)
+
+BOOST_AUTO_TEST_CASE(test_update_and_grow) {
+  INIT_STDOUT_LOGGER();
+
+  IPFlagTable table(16);
+  map<uint128_t, uint8_t> expected;
+  mt19937_64 eng(0);
+  const auto ips = RandomIPs(NUM_IPS, 1);
+
+  for (unsigned int i = 0; i < 20 * NUM_IPS; i++) {
+    // Small keys as well, e.g. IPv4 addresses in the low bits only
+    const uint128_t ip = (i % 3 == 0) ? uint128_t(eng() % NUM_IPS)
+                                      : ips[eng() % NUM_IPS];
+    const uint8_t setMask = eng() & 0x0F;
+    const uint8_t clearMask = eng() & 0x0F;
+
+    auto& flags = expected[ip];
+    BOOST_REQUIRE_EQUAL(table.Update(ip, setMask, clearMask), flags);
+    flags = (flags & ~clearMask) | setMask;
+    if (flags == 0) {
+      expected.erase(ip);
+    }
+  }
+
+  for (const auto& entry : expected) {
+    BOOST_REQUIRE_EQUAL(table.Get(entry.first), entry.second);
+  }
+  for (unsigned int i = 0; i < NUM_IPS; i++) {
+    const auto it = expected.find(ips[i]);
+    BOOST_REQUIRE_EQUAL(table.Get(ips[i]),
+                        it == expected.end() ? 0 : it->second);
+  }
+
+  size_t withBit = 0;
+  for (const auto& entry : expected) {
+    withBit += (entry.second & 0x01) != 0;
+  }
+  BOOST_CHECK_EQUAL(table.Count(0x01), withBit);
+
+  BOOST_CHECK_EQUAL(table.ClearAll(0x01, 10), min<size_t>(withBit, 10));
+  BOOST_CHECK_EQUAL(table.Count(0x01), withBit - min<size_t>(withBit, 10));
+  table.ClearAll(0x01);
+  BOOST_CHECK_EQUAL(table.Count(0x01), 0);
+
+  for (const auto& entry : expected) {
+    BOOST_REQUIRE_EQUAL(table.Get(entry.first), entry.second & ~0x01);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_readers) {
+  INIT_STDOUT_LOGGER();
+
+  IPFlagTable table(16);
+  const auto stable = RandomIPs(NUM_IPS, 2);
+  const auto churn = RandomIPs(NUM_IPS, 3);
+  for (const auto& ip : stable) {
+    table.Update(ip, 0x01, 0);
+  }
+
+  // Readers must always see the stable IPs and never see them torn, while
+  // the writer grows, erases and rebuilds the table around them
+  atomic<bool> stop{false};
+  atomic<unsigned int> errors{0};
+  vector<thread> readers;
+  for (unsigned int t = 0; t < NUM_THREADS; t++) {
+    readers.emplace_back([&, t]() {
+      unsigned int i = t;
+      while (!stop) {
+        if (table.Get(stable[i % NUM_IPS]) != 0x01) {
+          errors++;
+        }
+        if ((table.Get(churn[i % NUM_IPS]) & ~0x02) != 0) {
+          errors++;
+        }
+        i += NUM_THREADS;
+      }
+    });
+  }
+
+  for (unsigned int round = 0; round < 20; round++) {
+    for (const auto& ip : churn) {
+      table.Update(ip, 0x02, 0);
+    }
+    if (round % 2 == 0) {
+      for (const auto& ip : churn) {
+        table.Update(ip, 0, 0x02);
+      }
+    } else {
+      table.ClearAll(0x02);
+    }
+  }
+  stop = true;
+  for (auto& t : readers) {
+    t.join();
+  }
+
+  BOOST_CHECK_EQUAL(errors.load(), 0);
+  BOOST_CHECK_EQUAL(table.Count(0xFF), NUM_IPS);
+}
+
+BOOST_AUTO_TEST_CASE(test_lookup_benchmark) {
+  INIT_STDOUT_LOGGER();
+
+  // Half of the looked up IPs are blacklisted. LookupNs checks that both
+  // find them; the timings depend on the machine and are only logged.
+  const auto ips = RandomIPs(2 * NUM_IPS, 4);
+  MutexBlacklist before;
+  IPFlagTable after;
+  for (unsigned int i = 0; i < ips.size(); i += 2) {
+    before.Add(ips[i]);
+    after.Update(ips[i], 0x01, 0);
+  }
+
+  // Both give the same answer for every IP
+  unsigned int mismatches = 0;
+  for (const auto& ip : ips) {
+    mismatches += before.Exist(ip) != (after.Get(ip) != 0);
+  }
+  BOOST_CHECK_EQUAL(mismatches, 0);
+  BOOST_CHECK_EQUAL(after.Count(0x01), NUM_IPS);
+
+  for (const unsigned int numThreads : {1U, NUM_THREADS}) {
+    const double beforeNs = LookupNs(
+        numThreads, ips, [&before](const uint128_t& ip) {
+          return before.Exist(ip);
+        });
+    const double afterNs =
+        LookupNs(numThreads, ips, [&after](const uint128_t& ip) {
+          return after.Get(ip) != 0;
+        });
+
+    LOG_GENERAL(INFO, numThreads << " threads: mutex + string hash "
+                                 << beforeNs << " ns, IPFlagTable "
+                                 << afterNs << " ns per lookup");
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "libNode/LeaderTxnOrder.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE leadertxnordertest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+vector<TxnHash> GenerateTxnHashes(unsigned int num) {
+  vector<TxnHash> txnHashes(num);
+  for (auto& txnHash : txnHashes) {
+    txnHash = TxnHash::random();
+  }
+  return txnHashes;
+}
+
+vector<TxnHash> Slice(const vector<TxnHash>& txnHashes, unsigned int begin,
+                      unsigned int end) {
+  return vector<TxnHash>(txnHashes.begin() + begin, txnHashes.begin() + end);
+}
+
+chrono::steady_clock::time_point Now() { return chrono::steady_clock::now(); }
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(leadertxnordertest)
+
+BOOST_AUTO_TEST_CASE(test_in_order) {
+  INIT_STDOUT_LOGGER();
+
+  LeaderTxnOrder order;
+  const auto txnHashes = GenerateTxnHashes(30);
+  BOOST_REQUIRE(order.AddBatch(1, 0, Slice(txnHashes, 0, 10), false));
+
+  vector<TxnHash> received;
+  bool complete = true;
+  BOOST_REQUIRE(order.WaitForTxns(1, 0, Now(), received, complete));
+  BOOST_CHECK(received == Slice(txnHashes, 0, 10));
+  BOOST_CHECK(!complete);
+
+  BOOST_REQUIRE(order.AddBatch(1, 10, Slice(txnHashes, 10, 30), true));
+  BOOST_REQUIRE(order.WaitForTxns(1, 10, Now(), received, complete));
+  BOOST_CHECK(received == Slice(txnHashes, 10, 30));
+  BOOST_CHECK(complete);
+
+  // Nothing past the end of a complete order
+  BOOST_REQUIRE(order.WaitForTxns(1, 30, Now(), received, complete));
+  BOOST_CHECK(received.empty());
+  BOOST_CHECK(complete);
+}
+
+BOOST_AUTO_TEST_CASE(test_out_of_order) {
+  INIT_STDOUT_LOGGER();
+
+  LeaderTxnOrder order;
+  const auto txnHashes = GenerateTxnHashes(30);
+  BOOST_REQUIRE(order.AddBatch(1, 20, Slice(txnHashes, 20, 30), true));
+  BOOST_REQUIRE(order.AddBatch(1, 10, Slice(txnHashes, 10, 20), false));
+
+  // Held back until the first batch is in
+  vector<TxnHash> received;
+  bool complete = false;
+  BOOST_CHECK(!order.WaitForTxns(1, 0, Now(), received, complete));
+
+  BOOST_REQUIRE(order.AddBatch(1, 0, Slice(txnHashes, 0, 10), false));
+  BOOST_REQUIRE(order.WaitForTxns(1, 0, Now(), received, complete));
+  BOOST_CHECK(received == txnHashes);
+  BOOST_CHECK(complete);
+}
+
+BOOST_AUTO_TEST_CASE(test_rejected_batches) {
+  INIT_STDOUT_LOGGER();
+
+  LeaderTxnOrder order;
+  const auto txnHashes = GenerateTxnHashes(30);
+  BOOST_REQUIRE(order.AddBatch(2, 0, Slice(txnHashes, 0, 10), false));
+  BOOST_REQUIRE(order.AddBatch(2, 20, Slice(txnHashes, 20, 25), false));
+
+  // Repeated or overlapping what is already appended or pending
+  BOOST_CHECK(!order.AddBatch(2, 0, Slice(txnHashes, 0, 10), false));
+  BOOST_CHECK(!order.AddBatch(2, 5, Slice(txnHashes, 5, 15), false));
+  BOOST_CHECK(!order.AddBatch(2, 15, Slice(txnHashes, 15, 21), false));
+  BOOST_CHECK(!order.AddBatch(2, 24, Slice(txnHashes, 24, 26), false));
+
+  // A last batch that ends before a pending batch
+  BOOST_CHECK(!order.AddBatch(2, 10, Slice(txnHashes, 10, 15), true));
+
+  // Older epoch
+  BOOST_CHECK(!order.AddBatch(1, 10, Slice(txnHashes, 10, 20), false));
+
+  BOOST_REQUIRE(order.AddBatch(2, 25, Slice(txnHashes, 25, 30), true));
+
+  // Past the last batch, and a second last batch
+  BOOST_CHECK(!order.AddBatch(2, 30, GenerateTxnHashes(1), false));
+  BOOST_CHECK(!order.AddBatch(2, 30, {}, true));
+
+  BOOST_REQUIRE(order.AddBatch(2, 10, Slice(txnHashes, 10, 20), false));
+  vector<TxnHash> received;
+  bool complete = false;
+  BOOST_REQUIRE(order.WaitForTxns(2, 0, Now(), received, complete));
+  BOOST_CHECK(received == txnHashes);
+  BOOST_CHECK(complete);
+}
+
+BOOST_AUTO_TEST_CASE(test_empty_order) {
+  INIT_STDOUT_LOGGER();
+
+  LeaderTxnOrder order;
+  BOOST_REQUIRE(order.AddBatch(3, 0, {}, true));
+
+  vector<TxnHash> received;
+  bool complete = false;
+  BOOST_REQUIRE(order.WaitForTxns(3, 0, Now(), received, complete));
+  BOOST_CHECK(received.empty());
+  BOOST_CHECK(complete);
+}
+
+BOOST_AUTO_TEST_CASE(test_new_epoch) {
+  INIT_STDOUT_LOGGER();
+
+  LeaderTxnOrder order;
+  const auto oldTxnHashes = GenerateTxnHashes(10);
+  BOOST_REQUIRE(order.AddBatch(4, 0, vector<TxnHash>(oldTxnHashes), true));
+
+  // The next epoch's batches replace the previous order
+  const auto txnHashes = GenerateTxnHashes(5);
+  BOOST_REQUIRE(order.AddBatch(5, 0, vector<TxnHash>(txnHashes), true));
+
+  vector<TxnHash> received;
+  bool complete = false;
+  BOOST_REQUIRE(order.WaitForTxns(5, 0, Now(), received, complete));
+  BOOST_CHECK(received == txnHashes);
+  BOOST_CHECK(complete);
+
+  // The previous epoch's order is gone
+  BOOST_CHECK(!order.WaitForTxns(4, 0, Now(), received, complete));
+
+  // Waiting on a later epoch drops the order before any batch for it arrives
+  BOOST_CHECK(!order.WaitForTxns(6, 0, Now(), received, complete));
+  BOOST_CHECK(!order.AddBatch(5, 0, vector<TxnHash>(txnHashes), true));
+}
+
+BOOST_AUTO_TEST_CASE(test_wait_timeout) {
+  INIT_STDOUT_LOGGER();
+
+  LeaderTxnOrder order;
+  const auto txnHashes = GenerateTxnHashes(10);
+  BOOST_REQUIRE(order.AddBatch(7, 0, Slice(txnHashes, 0, 5), false));
+
+  vector<TxnHash> received;
+  bool complete = false;
+  const auto deadline = Now() + chrono::milliseconds(50);
+  BOOST_CHECK(!order.WaitForTxns(7, 5, deadline, received, complete));
+  BOOST_CHECK(Now() >= deadline);
+}
+
+BOOST_AUTO_TEST_CASE(test_wait_woken) {
+  INIT_STDOUT_LOGGER();
+
+  LeaderTxnOrder order;
+  const auto txnHashes = GenerateTxnHashes(10);
+  BOOST_REQUIRE(order.AddBatch(8, 0, Slice(txnHashes, 0, 5), false));
+
+  thread sender([&order, &txnHashes]() {
+    this_thread::sleep_for(chrono::milliseconds(20));
+    order.AddBatch(8, 5, Slice(txnHashes, 5, 10), true);
+  });
+
+  // The deadline is only a backstop; the batch wakes the waiter
+  vector<TxnHash> received;
+  bool complete = false;
+  BOOST_CHECK(order.WaitForTxns(8, 5, Now() + chrono::seconds(60), received,
+                                complete));
+  sender.join();
+  BOOST_CHECK(received == Slice(txnHashes, 5, 10));
+  BOOST_CHECK(complete);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,6 +20,7 @@
  */
 
 #include <libDirectoryService/DirectoryService.h>
+#include <libDirectoryService/PoWVerifier.h>
 #include <libPOW/pow.h>
 #include <iomanip>
 
@@ -33,10 +34,13 @@
 
 #include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
+#include <atomic>
 #include <fstream>
 #include <iostream>
+#include <thread>
 #include <vector>
 #include "libTestUtils/TestUtils.h"
+#include "libUtils/TimeUtils.h"
 
 using namespace std;
 using byte = uint8_t;
@@ -417,6 +421,142 @@ BOOST_AUTO_TEST_CASE(mining_high_diffculty_time_out) {
   BOOST_REQUIRE(!verifyLight);
 }
 
+BOOST_AUTO_TEST_CASE(cpu_mining_thread_scaling) {
+  POW& POWClient = POW::GetInstance();
+  std::array<unsigned char, 32> rand1 = {{'0', '1'}};
+  std::array<unsigned char, 32> rand2 = {{'0', '2'}};
+  auto peer = TestUtils::GenerateRandomPeer();
+  auto keyPair = Schnorr::GenKeyPair();
+  auto pubKey = keyPair.second;
+
+  // Difficulty high enough that every run mines for the whole window, so the
+  // hash rate is measured over the same period for each thread count
+  const uint8_t difficultyToUse = 50;
+  const int timeWindow = 2;
+  const uint64_t blockToUse = 0;
+  auto headerHash = POW::GenHeaderHash(rand1, rand2, peer, pubKey, 0, 0);
+
+  const unsigned int maxThreads =
+      std::max(1U, std::thread::hardware_concurrency());
+  for (unsigned int numThreads = 1; numThreads <= maxThreads;
+       numThreads *= 2) {
+    POWClient.SetCpuMiningThreads(numThreads);
+    ethash_mining_result_t winning_result =
+        POWClient.PoWMine(blockToUse, difficultyToUse, keyPair, headerHash,
+                          false, std::time(0), timeWindow);
+    BOOST_REQUIRE(!winning_result.success);
+
+    const auto stats = POWClient.GetLastCpuMiningStats();
+    BOOST_REQUIRE_EQUAL(stats.m_hashesPerThread.size(), numThreads);
+    uint64_t totalHashes = 0;
+    for (const auto& hashes : stats.m_hashesPerThread) {
+      BOOST_CHECK(hashes > 0);
+      totalHashes += hashes;
+    }
+    LOG_GENERAL(INFO, "Threads: " << numThreads << " hashes/sec: "
+                                  << totalHashes / stats.m_seconds);
+  }
+
+  POWClient.SetCpuMiningThreads(CPU_MINE_THREADS);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_verification_load) {
+  // Replay a burst of DS PoW submissions through the verification pool and
+  // compare against verifying them one by one
+  const unsigned int NUM_SOLUTIONS = 16;
+  const unsigned int NUM_SUBMISSIONS = 4000;
+  const uint8_t difficultyToUse = 3;
+  const uint64_t blockToUse = 0;
+
+  POW& POWClient = POW::GetInstance();
+  std::array<unsigned char, 32> rand1 = {{'0', '1'}};
+  std::array<unsigned char, 32> rand2 = {{'0', '2'}};
+
+  std::vector<PoWVerifier::Request> solutions;
+  for (unsigned int i = 0; i < NUM_SOLUTIONS; i++) {
+    auto peer = TestUtils::GenerateRandomPeer();
+    auto keyPair = Schnorr::GenKeyPair();
+    auto headerHash =
+        POW::GenHeaderHash(rand1, rand2, peer, keyPair.second, 0, 0);
+    ethash_mining_result_t winning_result =
+        POWClient.PoWMine(blockToUse, difficultyToUse, keyPair, headerHash,
+                          false, std::time(0), POW_WINDOW_IN_SECONDS);
+    BOOST_REQUIRE(winning_result.success);
+
+    PoWVerifier::Request request;
+    request.m_blockNum = blockToUse;
+    request.m_difficulty = difficultyToUse;
+    request.m_headerHash = headerHash;
+    request.m_nonce = winning_result.winning_nonce;
+    request.m_resultingHash = winning_result.result;
+    request.m_mixHash = winning_result.mix_hash;
+    solutions.emplace_back(request);
+  }
+
+  // Every fifth submission carries a wrong nonce
+  std::vector<std::pair<PoWVerifier::Request, bool>> submissions;
+  for (unsigned int i = 0; i < NUM_SUBMISSIONS; i++) {
+    PoWVerifier::Request request = solutions[i % NUM_SOLUTIONS];
+    const bool expected = (i % 5 != 0);
+    if (!expected) {
+      request.m_nonce++;
+    }
+    submissions.emplace_back(request, expected);
+  }
+
+  auto startTime = r_timer_start();
+  unsigned int serialValid = 0;
+  for (const auto& submission : submissions) {
+    const auto& request = submission.first;
+    if (POWClient.PoWVerify(request.m_blockNum, request.m_difficulty,
+                            request.m_headerHash, request.m_nonce,
+                            request.m_resultingHash, request.m_mixHash)) {
+      serialValid++;
+    }
+  }
+  const double serialUs = r_timer_end(startTime);
+
+  PoWVerifier verifier(0, 256);
+  std::atomic<unsigned int> parallelValid{0};
+  std::atomic<unsigned int> mismatches{0};
+  unsigned int rejectedOnSubmit = 0;
+  startTime = r_timer_start();
+  for (const auto& submission : submissions) {
+    const bool expected = submission.second;
+    if (!verifier.Verify(submission.first, [&parallelValid, &mismatches,
+                                            expected](bool result) {
+          if (result) {
+            parallelValid++;
+          }
+          if (result != expected) {
+            mismatches++;
+          }
+        })) {
+      // Only an invalid solution verified inline may be turned away here
+      BOOST_CHECK(!expected);
+      rejectedOnSubmit++;
+    }
+  }
+  BOOST_REQUIRE(verifier.WaitUntilIdle(std::chrono::seconds(60)));
+  const double parallelUs = r_timer_end(startTime);
+
+  const auto stats = verifier.GetStats();
+  BOOST_CHECK_EQUAL(mismatches.load(), 0U);
+  BOOST_CHECK_EQUAL(parallelValid.load(), serialValid);
+  BOOST_CHECK_EQUAL(serialValid, NUM_SUBMISSIONS - NUM_SUBMISSIONS / 5);
+  BOOST_CHECK_EQUAL(stats.m_queued + stats.m_inline, NUM_SUBMISSIONS);
+  BOOST_CHECK_EQUAL(stats.m_valid + stats.m_invalid, NUM_SUBMISSIONS);
+  BOOST_CHECK_EQUAL(stats.m_dropped, 0U);
+  BOOST_CHECK_LE(rejectedOnSubmit, stats.m_inline);
+
+  LOG_GENERAL(INFO, "Verified " << NUM_SUBMISSIONS << " submissions: serial "
+                                << serialUs / 1000 << " ms, pool "
+                                << parallelUs / 1000 << " ms (queued "
+                                << stats.m_queued << ", inline "
+                                << stats.m_inline << ", max queue "
+                                << stats.m_maxQueueDepth << ")");
+}
+
 // Please enable the OPENCL_GPU_MINE option in constants.xml to run this test
 // case
 BOOST_AUTO_TEST_CASE(gpu_mining_and_verification_1) {
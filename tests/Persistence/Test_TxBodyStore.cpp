@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "depends/libDatabase/LevelDB.h"
+#include "libPersistence/TxBodyStore.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE txbodystoretest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+namespace bfs = boost::filesystem;
+
+namespace {
+TxBodyStore::Bodies GenerateBodies(mt19937_64& eng, unsigned int num,
+                                   unsigned int maxLength = 300) {
+  TxBodyStore::Bodies bodies(num);
+  for (auto& body : bodies) {
+    for (unsigned int i = 0; i < dev::h256::size; i++) {
+      body.first.data()[i] = eng();
+    }
+    body.second.resize(1 + eng() % maxLength);
+    for (auto& b : body.second) {
+      b = eng();
+    }
+  }
+  return bodies;
+}
+
+bfs::path TempDir() {
+  return bfs::temp_directory_path() /
+         bfs::unique_path("txbodystore_%%%%-%%%%-%%%%");
+}
+
+uint64_t PerSecond(size_t num, const chrono::steady_clock::duration& d) {
+  const auto us = chrono::duration_cast<chrono::microseconds>(d).count();
+  return us > 0 ? num * 1000000 / us : 0;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(txbodystoretest)
+
+BOOST_AUTO_TEST_CASE(test_put_get_delete) {
+  INIT_STDOUT_LOGGER();
+
+  const auto dir = TempDir();
+  mt19937_64 eng(0);
+  const auto bodies = GenerateBodies(eng, 100);
+  {
+    TxBodyStore store(dir.string(), 1 << 20);
+    BOOST_REQUIRE(store.IsOpen());
+    BOOST_REQUIRE(store.Put(1, bodies));
+    BOOST_CHECK_EQUAL(store.GetNumBodies(), bodies.size());
+
+    bytes body;
+    for (const auto& expected : bodies) {
+      BOOST_REQUIRE(store.Exists(expected.first));
+      BOOST_REQUIRE(store.Get(expected.first, body));
+      BOOST_REQUIRE(body == expected.second);
+    }
+    BOOST_CHECK(!store.Exists(dev::h256()));
+    BOOST_CHECK(!store.Get(dev::h256(), body));
+
+    BOOST_REQUIRE(store.Delete(bodies[5].first));
+    BOOST_CHECK(!store.Exists(bodies[5].first));
+    BOOST_CHECK(store.Delete(bodies[5].first));
+
+    // Putting a body again replaces it
+    BOOST_REQUIRE(store.Put(2, {{bodies[6].first, bytes{1, 2, 3}}}));
+    BOOST_REQUIRE(store.Get(bodies[6].first, body));
+    BOOST_CHECK(body == bytes({1, 2, 3}));
+  }
+
+  // Everything is found again after reopening
+  TxBodyStore store(dir.string(), 1 << 20);
+  BOOST_REQUIRE(store.IsOpen());
+  BOOST_CHECK_EQUAL(store.GetNumBodies(), bodies.size() - 1);
+  BOOST_CHECK(!store.Exists(bodies[5].first));
+  bytes body;
+  BOOST_REQUIRE(store.Get(bodies[6].first, body));
+  BOOST_CHECK(body == bytes({1, 2, 3}));
+  BOOST_REQUIRE(store.Get(bodies[7].first, body));
+  BOOST_CHECK(body == bodies[7].second);
+
+  BOOST_REQUIRE(store.Reset());
+  BOOST_CHECK_EQUAL(store.GetNumBodies(), 0);
+  BOOST_CHECK(!store.Exists(bodies[7].first));
+
+  bfs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(test_segments_and_range) {
+  INIT_STDOUT_LOGGER();
+
+  const auto dir = TempDir();
+  mt19937_64 eng(1);
+  map<uint64_t, TxBodyStore::Bodies> epochs;
+  {
+    TxBodyStore store(dir.string(), 16 * 1024);
+    for (uint64_t epoch = 0; epoch < 50; epoch++) {
+      epochs[epoch] = GenerateBodies(eng, 20);
+      BOOST_REQUIRE(store.Put(epoch, epochs[epoch]));
+    }
+    BOOST_CHECK_GT(store.GetNumSegments(), 1);
+  }
+
+  TxBodyStore store(dir.string(), 16 * 1024);
+  BOOST_REQUIRE(store.IsOpen());
+  BOOST_CHECK_EQUAL(store.GetNumBodies(), 50 * 20);
+
+  // Bodies come back in put order
+  TxBodyStore::Bodies range;
+  BOOST_REQUIRE(store.GetRange(10, 12, range));
+  TxBodyStore::Bodies expected;
+  for (uint64_t epoch = 10; epoch <= 12; epoch++) {
+    expected.insert(expected.end(), epochs[epoch].begin(),
+                    epochs[epoch].end());
+  }
+  BOOST_REQUIRE(range == expected);
+
+  BOOST_REQUIRE(store.Delete(epochs[20][3].first));
+  BOOST_REQUIRE(store.GetRange(20, 20, range));
+  BOOST_CHECK_EQUAL(range.size(), epochs[20].size() - 1);
+
+  BOOST_REQUIRE(store.GetRange(100, 200, range));
+  BOOST_CHECK(range.empty());
+
+  bfs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(test_partial_record) {
+  INIT_STDOUT_LOGGER();
+
+  const auto dir = TempDir();
+  mt19937_64 eng(2);
+  const auto bodies = GenerateBodies(eng, 10);
+  {
+    TxBodyStore store(dir.string(), 1 << 20);
+    BOOST_REQUIRE(store.Put(1, bodies));
+  }
+
+  // Simulate a crash in the middle of an append
+  vector<bfs::path> segments;
+  for (bfs::directory_iterator it(dir), end; it != end; ++it) {
+    segments.emplace_back(it->path());
+  }
+  BOOST_REQUIRE_EQUAL(segments.size(), 1);
+  const auto size = bfs::file_size(segments[0]);
+  {
+    ofstream file(segments[0].string(), ios::binary | ios::app);
+    file.write("partial record", 14);
+  }
+
+  TxBodyStore store(dir.string(), 1 << 20);
+  BOOST_REQUIRE(store.IsOpen());
+  BOOST_CHECK_EQUAL(store.GetNumBodies(), bodies.size());
+  BOOST_CHECK_EQUAL(bfs::file_size(segments[0]), size);
+
+  const auto more = GenerateBodies(eng, 10);
+  BOOST_REQUIRE(store.Put(2, more));
+  bytes body;
+  BOOST_REQUIRE(store.Get(more.back().first, body));
+  BOOST_CHECK(body == more.back().second);
+
+  bfs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(test_retire) {
+  INIT_STDOUT_LOGGER();
+
+  const auto dir = TempDir();
+  const auto archiveDir = TempDir();
+  mt19937_64 eng(3);
+  map<uint64_t, TxBodyStore::Bodies> epochs;
+  TxBodyStore store(dir.string(), 8 * 1024);
+  for (uint64_t epoch = 0; epoch < 40; epoch++) {
+    epochs[epoch] = GenerateBodies(eng, 20);
+    BOOST_REQUIRE(store.Put(epoch, epochs[epoch]));
+  }
+  const auto numSegments = store.GetNumSegments();
+
+  BOOST_REQUIRE(store.RetireSegmentsBefore(20, archiveDir.string()));
+  BOOST_CHECK_LT(store.GetNumSegments(), numSegments);
+  BOOST_CHECK(!store.Exists(epochs[0][0].first));
+  for (uint64_t epoch = 20; epoch < 40; epoch++) {
+    for (const auto& body : epochs[epoch]) {
+      BOOST_REQUIRE(store.Exists(body.first));
+    }
+  }
+
+  // The retired segments can still be read as a store of their own
+  {
+    TxBodyStore archive(archiveDir.string(), 8 * 1024);
+    BOOST_REQUIRE(archive.IsOpen());
+    bytes body;
+    BOOST_REQUIRE(archive.Get(epochs[0][0].first, body));
+    BOOST_CHECK(body == epochs[0][0].second);
+    BOOST_CHECK_EQUAL(archive.GetNumBodies() + store.GetNumBodies(), 40 * 20);
+  }
+
+  // The unsealed segment is never retired
+  BOOST_REQUIRE(store.RetireSegmentsBefore(1000, ""));
+  BOOST_CHECK_EQUAL(store.GetNumSegments(), 1);
+
+  bfs::remove_all(dir);
+  bfs::remove_all(archiveDir);
+}
+
+BOOST_AUTO_TEST_CASE(test_throughput_against_leveldb) {
+  INIT_STDOUT_LOGGER();
+
+  // Logs the throughput of both stores for txn body sized records; there is
+  // no assertion as the numbers depend on the machine
+  const unsigned int NUM_EPOCHS = 20;
+  const unsigned int BODIES_PER_EPOCH = 1000;
+  mt19937_64 eng(4);
+  vector<TxBodyStore::Bodies> epochs;
+  for (unsigned int i = 0; i < NUM_EPOCHS; i++) {
+    epochs.emplace_back(GenerateBodies(eng, BODIES_PER_EPOCH, 600));
+  }
+  const size_t total = NUM_EPOCHS * BODIES_PER_EPOCH;
+
+  LevelDB db("bench_txBodies");
+  db.ResetDB();
+  auto start = chrono::steady_clock::now();
+  for (const auto& epoch : epochs) {
+    for (const auto& body : epoch) {
+      BOOST_REQUIRE(db.Insert(body.first, body.second) == 0);
+    }
+  }
+  const auto dbPut = chrono::steady_clock::now() - start;
+  start = chrono::steady_clock::now();
+  for (const auto& epoch : epochs) {
+    for (const auto& body : epoch) {
+      BOOST_REQUIRE(!db.Lookup(body.first).empty());
+    }
+  }
+  const auto dbGet = chrono::steady_clock::now() - start;
+  db.ResetDB();
+
+  const auto dir = TempDir();
+  TxBodyStore store(dir.string(), 4 * 1024 * 1024);
+  start = chrono::steady_clock::now();
+  for (unsigned int i = 0; i < NUM_EPOCHS; i++) {
+    BOOST_REQUIRE(store.Put(i, epochs[i]));
+  }
+  const auto storePut = chrono::steady_clock::now() - start;
+  start = chrono::steady_clock::now();
+  bytes body;
+  for (const auto& epoch : epochs) {
+    for (const auto& expected : epoch) {
+      BOOST_REQUIRE(store.Get(expected.first, body));
+    }
+  }
+  const auto storeGet = chrono::steady_clock::now() - start;
+  start = chrono::steady_clock::now();
+  TxBodyStore::Bodies range;
+  for (unsigned int i = 0; i < NUM_EPOCHS; i++) {
+    BOOST_REQUIRE(store.GetRange(i, i, range));
+    BOOST_REQUIRE_EQUAL(range.size(), BODIES_PER_EPOCH);
+  }
+  const auto storeRange = chrono::steady_clock::now() - start;
+
+  LOG_GENERAL(INFO, "Bodies/s for "
+                        << total << " bodies: LevelDB put "
+                        << PerSecond(total, dbPut) << " get "
+                        << PerSecond(total, dbGet) << "; segments put "
+                        << PerSecond(total, storePut) << " get "
+                        << PerSecond(total, storeGet) << " range "
+                        << PerSecond(total, storeRange));
+
+  bfs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
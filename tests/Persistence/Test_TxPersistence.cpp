@@ -20,10 +20,19 @@
 #include <thread>
 #include <vector>
 
+#include <MultiSig.h>
+#include <boost/filesystem.hpp>
+
 #include "libData/BlockData/Block.h"
+#include "libDirectoryService/DirectoryService.h"
+#include "libLookup/Lookup.h"
+#include "libMediator/Mediator.h"
+#include "libNode/Node.h"
 #include "libPersistence/BlockStorage.h"
 #include "libPersistence/DB.h"
+#include "libUtils/BitVector.h"
 #include "libUtils/TimeUtils.h"
+#include "libValidator/Validator.h"
 
 #define BOOST_TEST_MODULE persistencetest
 #define BOOST_TEST_DYN_LINK
@@ -327,4 +336,150 @@ BOOST_AUTO_TEST_CASE(testRetrieveAllTheTxBlocksInDB) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(testLatestTxBlockNum) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  // Synthetic chain for timing the latest Tx block lookup CheckIntegrity
+  // starts from; raise to 1000000 to reproduce mainnet-size numbers
+  const uint64_t NUM_SYNTHETIC_BLOCKS = 100000;
+
+  BOOST_REQUIRE(
+      BlockStorage::GetBlockStorage().ResetDB(BlockStorage::DBTYPE::TX_BLOCK));
+
+  const PairOfKey keyPair = Schnorr::GenKeyPair();
+  BlockHash prevHash;
+  auto startTime = r_timer_start();
+  for (uint64_t i = 0; i < NUM_SYNTHETIC_BLOCKS; i++) {
+    TxBlock block(TxBlockHeader(1, 1, 1, i, TxBlockHashSet(), 0,
+                                keyPair.second, i / 100, TXBLOCK_VERSION,
+                                CommitteeHash(), prevHash),
+                  vector<MicroBlockInfo>(), CoSignatures());
+    prevHash = block.GetHeader().GetMyHash();
+
+    bytes serializedTxBlock;
+    block.Serialize(serializedTxBlock, 0);
+    BlockStorage::GetBlockStorage().PutTxBlock(i, serializedTxBlock);
+  }
+  LOG_GENERAL(INFO, "Wrote " << NUM_SYNTHETIC_BLOCKS << " Tx blocks in "
+                             << r_timer_end(startTime) / 1000 << " ms");
+
+  startTime = r_timer_start();
+  TxBlockSharedPtr latestByScan;
+  BOOST_REQUIRE(BlockStorage::GetBlockStorage().GetLatestTxBlock(latestByScan));
+  const double scanMs = r_timer_end(startTime) / 1000;
+
+  startTime = r_timer_start();
+  uint64_t latestNum = 0;
+  BOOST_REQUIRE(BlockStorage::GetBlockStorage().GetLatestTxBlockNum(latestNum));
+  const double searchMs = r_timer_end(startTime) / 1000;
+
+  BOOST_CHECK_EQUAL(latestNum, NUM_SYNTHETIC_BLOCKS - 1);
+  BOOST_CHECK_EQUAL(latestByScan->GetHeader().GetBlockNum(), latestNum);
+  LOG_GENERAL(INFO, "Latest Tx block: full scan " << scanMs << " ms, search "
+                                                  << searchMs << " ms");
+}
+
+namespace {
+/// Cosigns the header the way a one-member DS committee would
+CoSignatures CosignTxBlockHeader(const TxBlockHeader& header,
+                                 const PairOfKey& key) {
+  CoSignatures cosigs(1);
+  cosigs.m_B1 = {true};
+  cosigs.m_B2 = {true};
+
+  bytes message;
+  header.Serialize(message, 0);
+  cosigs.m_CS1.Serialize(message, message.size());
+  BitVector::SetBitVector(message, message.size(), cosigs.m_B1);
+
+  CommitSecret secret;
+  CommitPoint point(secret);
+  Challenge challenge(point, key.second, message);
+  Response response(secret, challenge, key.first);
+  cosigs.m_CS2 = *MultiSig::AggregateSign(challenge, response);
+  return cosigs;
+}
+
+void PutTxBlock(const TxBlock& block) {
+  bytes serializedTxBlock;
+  block.Serialize(serializedTxBlock, 0);
+  BOOST_REQUIRE(BlockStorage::GetBlockStorage().PutTxBlock(
+      block.GetHeader().GetBlockNum(), serializedTxBlock));
+}
+
+/// Replaces a stored Tx block with one that breaks the prevHash links
+void BreakTxBlockLink(const uint64_t blockNum, const PairOfKey& key) {
+  PutTxBlock(TxBlock(
+      TxBlockHeader(1, 1, 1, blockNum, TxBlockHashSet(), 0, key.second,
+                    blockNum / 100, TXBLOCK_VERSION, CommitteeHash(),
+                    BlockHash::random()),
+      vector<MicroBlockInfo>(), CoSignatures()));
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(testCheckIntegrityResume) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  // Three chunks of Tx blocks for Node::CheckIntegrity, anchored by a
+  // cosignature from a one-member DS committee
+  const uint64_t NUM_BLOCKS = 2500;
+  const string CHECKPOINT_FILE = "validateDB.checkpoint";
+
+  const PairOfKey dsKey = Schnorr::GenKeyPair();
+  Mediator mediator(Schnorr::GenKeyPair(), Peer());
+  DirectoryService ds(mediator);
+  Node node(mediator, 0, false);
+  Lookup lookup(mediator, SyncType::NO_SYNC);
+  Validator validator(mediator);
+  mediator.RegisterColleagues(&ds, &node, &lookup, &validator);
+  mediator.m_initialDSCommittee =
+      make_shared<vector<PubKey>>(1, dsKey.second);
+
+  BOOST_REQUIRE(
+      BlockStorage::GetBlockStorage().ResetDB(BlockStorage::DBTYPE::TX_BLOCK));
+  BOOST_REQUIRE(
+      BlockStorage::GetBlockStorage().ResetDB(BlockStorage::DBTYPE::BLOCKLINK));
+  mediator.m_blocklinkchain.AddBlockLink(0, 0, BlockType::DS, BlockHash());
+
+  vector<TxBlock> blocks;
+  BlockHash prevHash;
+  for (uint64_t i = 0; i < NUM_BLOCKS; i++) {
+    TxBlockHeader header(1, 1, 1, i, TxBlockHashSet(), 0, dsKey.second,
+                         i / 100, TXBLOCK_VERSION, CommitteeHash(), prevHash);
+    blocks.emplace_back(header, vector<MicroBlockInfo>(),
+                        i == NUM_BLOCKS - 1 ? CosignTxBlockHeader(header, dsKey)
+                                            : CoSignatures());
+    prevHash = header.GetMyHash();
+    PutTxBlock(blocks.back());
+  }
+
+  boost::filesystem::remove(CHECKPOINT_FILE);
+  BOOST_CHECK(node.CheckIntegrity(true));
+  BOOST_CHECK(boost::filesystem::exists(CHECKPOINT_FILE));
+
+  // A broken link in the second chunk fails the run, and the checkpoint only
+  // covers the first chunk
+  boost::filesystem::remove(CHECKPOINT_FILE);
+  BreakTxBlockLink(1500, dsKey);
+  BOOST_CHECK(!node.CheckIntegrity(true));
+
+  // After repairing it, a resumed run skips the first chunk, so a broken link
+  // there goes unnoticed
+  PutTxBlock(blocks[1500]);
+  BreakTxBlockLink(10, dsKey);
+  BOOST_CHECK(node.CheckIntegrity(true));
+
+  // Without a checkpoint the whole chain is checked again
+  boost::filesystem::remove(CHECKPOINT_FILE);
+  BOOST_CHECK(!node.CheckIntegrity(true));
+  PutTxBlock(blocks[10]);
+  BOOST_CHECK(node.CheckIntegrity(true));
+
+  boost::filesystem::remove(CHECKPOINT_FILE);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+
+#include "libPersistence/TxnArchive.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE txnarchivetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const chrono::milliseconds WAIT_TIMEOUT{10000};
+
+ArchivedTxns GenerateTxns(mt19937_64& eng, unsigned int num) {
+  ArchivedTxns txns(num);
+  for (auto& txn : txns) {
+    for (unsigned int i = 0; i < TxnHash::size; i++) {
+      txn.first.data()[i] = eng();
+    }
+    txn.second.resize(eng() % 300);
+    for (auto& b : txn.second) {
+      b = eng();
+    }
+  }
+  return txns;
+}
+
+/// Holds the segments in memory and takes a while to store each one.
+class SlowTxnArchiveBackend : public TxnArchiveBackend {
+  mutex m_mutex;
+  map<string, bytes> m_segments;
+
+ public:
+  const chrono::milliseconds m_latency{20};
+
+  bool PutSegment(const string& name, const bytes& segment) override {
+    this_thread::sleep_for(m_latency);
+    lock_guard<mutex> g(m_mutex);
+    m_segments[name] = segment;
+    return true;
+  }
+
+  bool GetSegment(const string& name, bytes& segment) override {
+    lock_guard<mutex> g(m_mutex);
+    const auto it = m_segments.find(name);
+    if (it == m_segments.end()) {
+      return false;
+    }
+    segment = it->second;
+    return true;
+  }
+
+  bool ListSegments(vector<string>& names) override {
+    lock_guard<mutex> g(m_mutex);
+    names.clear();
+    for (const auto& segment : m_segments) {
+      names.emplace_back(segment.first);
+    }
+    return true;
+  }
+};
+
+/// Counts what is read from disk, and fails whole segment reads.
+class RangeOnlyTxnArchiveBackend : public LocalTxnArchiveBackend {
+ public:
+  uint64_t m_bytesRead{};
+
+  using LocalTxnArchiveBackend::LocalTxnArchiveBackend;
+
+  bool GetSegment([[gnu::unused]] const string& name,
+                  [[gnu::unused]] bytes& segment) override {
+    return false;
+  }
+
+  bool GetSegmentRange(const string& name, uint64_t offset, uint64_t len,
+                       bytes& data) override {
+    m_bytesRead += len;
+    return LocalTxnArchiveBackend::GetSegmentRange(name, offset, len, data);
+  }
+};
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(txnarchivetest)
+
+BOOST_AUTO_TEST_CASE(test_segment_index) {
+  INIT_STDOUT_LOGGER();
+
+  mt19937_64 eng(0);
+  const auto txns = GenerateTxns(eng, 500);
+  bytes segment;
+  TxnArchive::BuildSegment(txns, segment);
+
+  for (const auto& txn : txns) {
+    bytes body;
+    BOOST_REQUIRE(TxnArchive::FindTxn(segment, txn.first, body));
+    BOOST_REQUIRE(body == txn.second);
+  }
+  bytes body;
+  BOOST_CHECK(!TxnArchive::FindTxn(segment, TxnHash(), body));
+
+  ArchivedTxns readTxns;
+  BOOST_REQUIRE(TxnArchive::ReadAllTxns(segment, readTxns));
+  BOOST_CHECK_EQUAL(readTxns.size(), txns.size());
+  map<TxnHash, bytes> expected(txns.begin(), txns.end());
+  for (const auto& txn : readTxns) {
+    BOOST_REQUIRE(expected.at(txn.first) == txn.second);
+  }
+
+  // An empty epoch still makes a valid segment
+  TxnArchive::BuildSegment({}, segment);
+  BOOST_CHECK(TxnArchive::ReadAllTxns(segment, readTxns));
+  BOOST_CHECK(readTxns.empty());
+
+  // Truncated or foreign data is rejected
+  TxnArchive::BuildSegment(txns, segment);
+  segment.pop_back();
+  BOOST_CHECK(!TxnArchive::ReadAllTxns(segment, readTxns));
+  BOOST_CHECK(!TxnArchive::FindTxn(bytes(100, 0), txns[0].first, body));
+}
+
+BOOST_AUTO_TEST_CASE(test_local_backend) {
+  INIT_STDOUT_LOGGER();
+
+  const auto dir =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("txnarchive_%%%%-%%%%-%%%%");
+  mt19937_64 eng(1);
+  map<string, ArchivedTxns> archived;
+  {
+    TxnArchive archive(make_shared<LocalTxnArchiveBackend>(dir.string()), 4);
+    for (unsigned int epoch = 0; epoch < 10; epoch++) {
+      const string name = "txns_shard_0_txblk_" + to_string(epoch);
+      archived[name] = GenerateTxns(eng, 50);
+      BOOST_REQUIRE(archive.Archive(name, archived[name]));
+      BOOST_REQUIRE(archive.WaitUntilIdle(WAIT_TIMEOUT));
+    }
+    BOOST_CHECK_EQUAL(archive.GetStats().m_written, 10);
+
+    bytes body;
+    const auto& txn = archived["txns_shard_0_txblk_3"][7];
+    BOOST_REQUIRE(archive.GetTxn("txns_shard_0_txblk_3", txn.first, body));
+    BOOST_CHECK(body == txn.second);
+    BOOST_CHECK(!archive.GetTxn("txns_shard_0_txblk_99", txn.first, body));
+  }
+
+  // Read back as genTxnBodiesFromS3 does
+  LocalTxnArchiveBackend backend(dir.string());
+  vector<string> names;
+  BOOST_REQUIRE(backend.ListSegments(names));
+  BOOST_REQUIRE_EQUAL(names.size(), archived.size());
+  for (const auto& name : names) {
+    bytes segment;
+    ArchivedTxns txns;
+    BOOST_REQUIRE(backend.GetSegment(name, segment));
+    BOOST_REQUIRE(TxnArchive::ReadAllTxns(segment, txns));
+    BOOST_CHECK_EQUAL(txns.size(), archived.at(name).size());
+  }
+
+  boost::filesystem::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(test_legacy_txns_file) {
+  INIT_STDOUT_LOGGER();
+
+  const auto dir =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("txnarchive_%%%%-%%%%-%%%%");
+  boost::filesystem::create_directories(dir);
+  mt19937_64 eng(4);
+  const auto txns = GenerateTxns(eng, 50);
+
+  // Written the way shard leaders uploaded txns before segments
+  const string name = "txns_shard_0_txblk_7";
+  {
+    ofstream file((dir / name).string(), ios::binary);
+    for (const auto& txn : txns) {
+      size_t size = txn.first.size;
+      file.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
+      file.write(reinterpret_cast<const char*>(txn.first.data()), size);
+      size = txn.second.size();
+      file.write(reinterpret_cast<const char*>(&size), sizeof(size_t));
+      file.write(reinterpret_cast<const char*>(txn.second.data()), size);
+    }
+  }
+
+  LocalTxnArchiveBackend backend(dir.string());
+  bytes data;
+  ArchivedTxns readTxns;
+  BOOST_REQUIRE(backend.GetSegment(name, data));
+  BOOST_CHECK(!TxnArchive::ReadAllTxns(data, readTxns));
+  BOOST_REQUIRE(TxnArchive::ReadSegmentOrLegacyTxns(data, readTxns));
+  BOOST_CHECK(readTxns == txns);
+
+  // Segments are still read as segments
+  bytes segment;
+  TxnArchive::BuildSegment(txns, segment);
+  BOOST_REQUIRE(TxnArchive::ReadSegmentOrLegacyTxns(segment, readTxns));
+  BOOST_CHECK_EQUAL(readTxns.size(), txns.size());
+
+  // A truncated legacy file is rejected
+  data.pop_back();
+  BOOST_CHECK(!TxnArchive::ReadSegmentOrLegacyTxns(data, readTxns));
+  BOOST_CHECK(!TxnArchive::ReadLegacyTxns(bytes(3, 0), readTxns));
+
+  boost::filesystem::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(test_get_txn_range_reads) {
+  INIT_STDOUT_LOGGER();
+
+  const auto dir =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("txnarchive_%%%%-%%%%-%%%%");
+  mt19937_64 eng(3);
+  const auto txns = GenerateTxns(eng, 500);
+  bytes segment;
+  TxnArchive::BuildSegment(txns, segment);
+  auto backend = make_shared<RangeOnlyTxnArchiveBackend>(dir.string());
+  BOOST_REQUIRE(backend->PutSegment("seg", segment));
+  BOOST_REQUIRE(backend->PutSegment("short", bytes(segment.begin(),
+                                                   segment.end() - 1)));
+  BOOST_REQUIRE(backend->PutSegment("foreign", bytes(100, 0)));
+
+  // Only the header, footer, index and the one body are read
+  TxnArchive archive(backend, 1);
+  bytes body;
+  const auto& txn = txns[123];
+  BOOST_REQUIRE(archive.GetTxn("seg", txn.first, body));
+  BOOST_CHECK(body == txn.second);
+  BOOST_CHECK_EQUAL(backend->m_bytesRead,
+                    8 + 12 + txns.size() * (32 + 8 + 4) + txn.second.size());
+  BOOST_CHECK_LT(backend->m_bytesRead, segment.size());
+
+  BOOST_CHECK(!archive.GetTxn("seg", TxnHash(), body));
+  BOOST_CHECK(!archive.GetTxn("short", txn.first, body));
+  BOOST_CHECK(!archive.GetTxn("foreign", txn.first, body));
+  BOOST_CHECK(!archive.GetTxn("missing", txn.first, body));
+
+  boost::filesystem::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(test_writer_behind) {
+  INIT_STDOUT_LOGGER();
+
+  // Compares the time the caller spends per epoch against writing through
+  const unsigned int NUM_EPOCHS = 10;
+  mt19937_64 eng(2);
+  auto backend = make_shared<SlowTxnArchiveBackend>();
+  vector<ArchivedTxns> epochs;
+  for (unsigned int i = 0; i < NUM_EPOCHS; i++) {
+    epochs.emplace_back(GenerateTxns(eng, 200));
+  }
+
+  auto start = chrono::steady_clock::now();
+  for (unsigned int i = 0; i < NUM_EPOCHS; i++) {
+    bytes segment;
+    TxnArchive::BuildSegment(epochs[i], segment);
+    BOOST_REQUIRE(backend->PutSegment("sync_" + to_string(i), segment));
+  }
+  const auto syncTime = chrono::steady_clock::now() - start;
+
+  TxnArchive archive(backend, NUM_EPOCHS);
+  start = chrono::steady_clock::now();
+  for (unsigned int i = 0; i < NUM_EPOCHS; i++) {
+    BOOST_REQUIRE(archive.Archive("async_" + to_string(i), epochs[i]));
+  }
+  const auto asyncTime = chrono::steady_clock::now() - start;
+  BOOST_REQUIRE(archive.WaitUntilIdle(WAIT_TIMEOUT));
+
+  LOG_GENERAL(INFO,
+              "Caller time for " << NUM_EPOCHS << " epochs: sync "
+                                 << chrono::duration_cast<chrono::microseconds>(
+                                        syncTime)
+                                        .count()
+                                 << " us, background "
+                                 << chrono::duration_cast<chrono::microseconds>(
+                                        asyncTime)
+                                        .count()
+                                 << " us");
+
+  // Segments beyond the limit are dropped rather than waited for, and the
+  // accepted ones are still written when stopping
+  TxnArchive smallArchive(backend, 2);
+  unsigned int accepted = 0;
+  for (unsigned int i = 0; i < NUM_EPOCHS; i++) {
+    accepted += smallArchive.Archive("small_" + to_string(i), epochs[i]);
+  }
+  BOOST_CHECK_LT(accepted, NUM_EPOCHS);
+  smallArchive.Stop();
+  BOOST_CHECK(!smallArchive.Archive("small_late", epochs[0]));
+
+  const auto stats = smallArchive.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_written, accepted);
+  BOOST_CHECK_EQUAL(stats.m_dropped, NUM_EPOCHS - accepted + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "libRemoteStorageDB/RemoteStorageDB.h"
+#include "libRemoteStorageDB/RemoteStorageQueue.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE remotestoragequeuetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const chrono::milliseconds WAIT_TIMEOUT{10000};
+
+RemoteStorageOp MakeInsert(unsigned int i) {
+  RemoteStorageOp op;
+  op.m_type = RemoteStorageOp::INSERT;
+  op.m_txnHash = to_string(i);
+  op.m_fields["ID"] = op.m_txnHash;
+  op.m_fields["status"] = 1;
+  op.m_fields["modificationState"] = 0;
+  return op;
+}
+
+RemoteStorageOp MakeUpdate(unsigned int i, int status, int state) {
+  RemoteStorageOp op;
+  op.m_type = RemoteStorageOp::UPDATE;
+  op.m_txnHash = to_string(i);
+  op.m_modificationState = state;
+  op.m_fields["status"] = status;
+  op.m_fields["modificationState"] = state;
+  return op;
+}
+
+RemoteStorageQueue::Options MakeOptions() {
+  RemoteStorageQueue::Options options;
+  options.m_maxQueued = 1000;
+  options.m_batchSize = 100;
+  options.m_batchInterval = chrono::milliseconds(50);
+  options.m_retryBackoff = chrono::milliseconds(1);
+  return options;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(remotestoragequeuetest)
+
+BOOST_AUTO_TEST_CASE(test_batches_and_ordering) {
+  INIT_STDOUT_LOGGER();
+
+  auto backend = make_shared<MemoryRemoteStorageBackend>();
+  RemoteStorageQueue queue(backend, MakeOptions());
+
+  for (unsigned int i = 0; i < 250; i++) {
+    BOOST_REQUIRE(queue.Push(MakeInsert(i)));
+  }
+  // Updates follow their inserts, and a stale state does not win
+  BOOST_REQUIRE(queue.Push(MakeUpdate(7, 3, 2)));
+  BOOST_REQUIRE(queue.Push(MakeUpdate(7, 2, 1)));
+  BOOST_REQUIRE(queue.Push(MakeUpdate(1000, 3, 2)));
+  // A repeated insert leaves the document alone
+  BOOST_REQUIRE(queue.Push(MakeInsert(7)));
+
+  BOOST_REQUIRE(queue.WaitUntilIdle(WAIT_TIMEOUT));
+  BOOST_CHECK_EQUAL(backend->GetNumDocuments(), 250);
+  BOOST_CHECK_EQUAL(backend->Get("7")["status"].asInt(), 3);
+  BOOST_CHECK_EQUAL(backend->Get("7")["modificationState"].asInt(), 2);
+  BOOST_CHECK(backend->Get("1000").isNull());
+
+  const auto stats = queue.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_queued, 254);
+  BOOST_CHECK_EQUAL(stats.m_written, 254);
+  BOOST_CHECK_EQUAL(stats.m_dropped, 0);
+  // Batches are capped at the batch size
+  BOOST_CHECK_GE(stats.m_batches, 3);
+  BOOST_CHECK_EQUAL(backend->GetNumWrites(), stats.m_batches);
+}
+
+BOOST_AUTO_TEST_CASE(test_batch_interval) {
+  INIT_STDOUT_LOGGER();
+
+  auto backend = make_shared<MemoryRemoteStorageBackend>();
+  RemoteStorageQueue queue(backend, MakeOptions());
+
+  // Well short of a batch, so only the interval sends it
+  BOOST_REQUIRE(queue.Push(MakeInsert(1)));
+  const auto deadline = chrono::steady_clock::now() + WAIT_TIMEOUT;
+  while (backend->GetNumDocuments() == 0 &&
+         chrono::steady_clock::now() < deadline) {
+    this_thread::sleep_for(chrono::milliseconds(5));
+  }
+  BOOST_CHECK_EQUAL(backend->GetNumDocuments(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_overflow_policies) {
+  INIT_STDOUT_LOGGER();
+
+  for (const auto& policy :
+       {RemoteStorageQueue::DROP_NEWEST, RemoteStorageQueue::DROP_OLDEST,
+        RemoteStorageQueue::BLOCK}) {
+    auto backend = make_shared<MemoryRemoteStorageBackend>();
+    // The first batch holds the writer while the queue fills up
+    backend->SetLatency(200);
+    auto options = MakeOptions();
+    options.m_maxQueued = 10;
+    options.m_batchSize = 1;
+    options.m_overflowPolicy = policy;
+    RemoteStorageQueue queue(backend, options);
+
+    BOOST_REQUIRE(queue.Push(MakeInsert(0)));
+    this_thread::sleep_for(chrono::milliseconds(50));
+    unsigned int pushed = 0;
+    for (unsigned int i = 1; i <= 20; i++) {
+      pushed += queue.Push(MakeInsert(i));
+    }
+    BOOST_REQUIRE(queue.WaitUntilIdle(WAIT_TIMEOUT));
+
+    const auto stats = queue.GetStats();
+    BOOST_CHECK_EQUAL(stats.m_written + stats.m_dropped, 21);
+    BOOST_CHECK_EQUAL(backend->GetNumDocuments(), stats.m_written);
+    if (policy == RemoteStorageQueue::DROP_NEWEST) {
+      BOOST_CHECK_EQUAL(pushed, 10);
+      BOOST_CHECK(!backend->Get("10").isNull());
+      BOOST_CHECK(backend->Get("20").isNull());
+    } else if (policy == RemoteStorageQueue::DROP_OLDEST) {
+      BOOST_CHECK_EQUAL(pushed, 20);
+      BOOST_CHECK_EQUAL(stats.m_dropped, 10);
+      BOOST_CHECK(backend->Get("1").isNull());
+      BOOST_CHECK(!backend->Get("20").isNull());
+    } else {
+      // Pushes wait for the writer to make room instead of dropping
+      BOOST_CHECK_GT(pushed, 10);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_retries) {
+  INIT_STDOUT_LOGGER();
+
+  auto backend = make_shared<MemoryRemoteStorageBackend>();
+  auto options = MakeOptions();
+  options.m_maxRetries = 2;
+  RemoteStorageQueue queue(backend, options);
+
+  // Recovers within the retries
+  backend->FailNextWrites(2);
+  BOOST_REQUIRE(queue.Push(MakeInsert(1)));
+  BOOST_REQUIRE(queue.WaitUntilIdle(WAIT_TIMEOUT));
+  BOOST_CHECK(!backend->Get("1").isNull());
+
+  // Runs out of retries, and the next batch still goes through
+  backend->FailNextWrites(3);
+  BOOST_REQUIRE(queue.Push(MakeInsert(2)));
+  BOOST_REQUIRE(queue.WaitUntilIdle(WAIT_TIMEOUT));
+  BOOST_REQUIRE(queue.Push(MakeInsert(3)));
+  BOOST_REQUIRE(queue.WaitUntilIdle(WAIT_TIMEOUT));
+  BOOST_CHECK(backend->Get("2").isNull());
+  BOOST_CHECK(!backend->Get("3").isNull());
+
+  const auto stats = queue.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_retries, 4);
+  BOOST_CHECK_EQUAL(stats.m_failed, 1);
+  BOOST_CHECK_EQUAL(stats.m_written, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_flush_on_stop) {
+  INIT_STDOUT_LOGGER();
+
+  auto backend = make_shared<MemoryRemoteStorageBackend>();
+  auto options = MakeOptions();
+  options.m_batchInterval = chrono::milliseconds(60000);
+  {
+    RemoteStorageQueue queue(backend, options);
+    for (unsigned int i = 0; i < 150; i++) {
+      BOOST_REQUIRE(queue.Push(MakeInsert(i)));
+    }
+  }
+  BOOST_CHECK_EQUAL(backend->GetNumDocuments(), 150);
+
+  RemoteStorageQueue queue(backend, options);
+  queue.Stop();
+  BOOST_CHECK(!queue.Push(MakeInsert(1000)));
+}
+
+BOOST_AUTO_TEST_CASE(test_write_behind_latency) {
+  INIT_STDOUT_LOGGER();
+
+  // Compares the time the caller spends per write against writing through
+  const unsigned int NUM_OPS = 200;
+  const unsigned int BATCH_SIZE = 50;
+  auto backend = make_shared<MemoryRemoteStorageBackend>();
+  backend->SetLatency(5);
+
+  auto start = chrono::steady_clock::now();
+  for (unsigned int i = 0; i < NUM_OPS; i += BATCH_SIZE) {
+    vector<RemoteStorageOp> batch;
+    for (unsigned int j = i; j < i + BATCH_SIZE; j++) {
+      batch.emplace_back(MakeInsert(j));
+    }
+    BOOST_REQUIRE(backend->Write(batch));
+  }
+  const auto syncTime = chrono::steady_clock::now() - start;
+
+  auto options = MakeOptions();
+  options.m_batchSize = BATCH_SIZE;
+  RemoteStorageQueue queue(backend, options);
+  start = chrono::steady_clock::now();
+  for (unsigned int i = 0; i < NUM_OPS; i++) {
+    BOOST_REQUIRE(queue.Push(MakeUpdate(i, 2, 1)));
+  }
+  const auto asyncTime = chrono::steady_clock::now() - start;
+  BOOST_REQUIRE(queue.WaitUntilIdle(WAIT_TIMEOUT));
+
+  LOG_GENERAL(
+      INFO,
+      "Caller time for " << NUM_OPS << " writes: sync "
+                         << chrono::duration_cast<chrono::microseconds>(
+                                syncTime)
+                                .count()
+                         << " us, write-behind "
+                         << chrono::duration_cast<chrono::microseconds>(
+                                asyncTime)
+                                .count()
+                         << " us");
+  BOOST_CHECK_EQUAL(backend->Get("3")["status"].asInt(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_reset_while_writing) {
+  INIT_STDOUT_LOGGER();
+
+  // Init(reset) swaps the write queue while the block commit path is still
+  // pushing txn writes into it
+  const unsigned int NUM_WRITERS = 4;
+  const unsigned int NUM_TXNS_PER_WRITER = 250;
+  const unsigned int NUM_RESETS = 20;
+
+  RemoteStorageDB db("TestResetCollection");
+  vector<shared_ptr<MemoryRemoteStorageBackend>> backends;
+  backends.emplace_back(make_shared<MemoryRemoteStorageBackend>());
+  db.InitWithBackend(backends.back());
+
+  atomic<unsigned int> numPushed{0};
+  vector<thread> writers;
+  for (unsigned int w = 0; w < NUM_WRITERS; w++) {
+    writers.emplace_back([&db, &numPushed, w]() {
+      for (unsigned int i = 0; i < NUM_TXNS_PER_WRITER; i++) {
+        const auto txn = TestUtils::GenerateRandomTransaction(
+            1, w * NUM_TXNS_PER_WRITER + i, Transaction::NON_CONTRACT);
+        if (db.InsertTxn(txn, TxnStatus::DISPATCHED, 1)) {
+          numPushed++;
+        }
+      }
+    });
+  }
+  for (unsigned int i = 0; i < NUM_RESETS; i++) {
+    backends.emplace_back(make_shared<MemoryRemoteStorageBackend>());
+    db.InitWithBackend(backends.back());
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  BOOST_REQUIRE(db.WaitUntilWritten(WAIT_TIMEOUT.count()));
+
+  // Every accepted write reached the backend of the queue it went into
+  size_t numDocuments = 0;
+  for (const auto& backend : backends) {
+    numDocuments += backend->GetNumDocuments();
+  }
+  BOOST_CHECK_EQUAL(numDocuments, numPushed.load());
+  BOOST_CHECK_GT(numPushed.load(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(test_reset_drains_in_background) {
+  INIT_STDOUT_LOGGER();
+
+  // The thread that drops the last reference to a replaced queue must not
+  // wait for the queue to send what it holds
+  RemoteStorageDB db("TestResetDrainCollection");
+  auto slowBackend = make_shared<MemoryRemoteStorageBackend>();
+  slowBackend->SetLatency(5000);
+  db.InitWithBackend(slowBackend);
+
+  const auto txn =
+      TestUtils::GenerateRandomTransaction(1, 1, Transaction::NON_CONTRACT);
+  BOOST_REQUIRE(db.InsertTxn(txn, TxnStatus::DISPATCHED, 1));
+
+  // Here the test thread holds the last reference to the slow queue
+  db.InitWithBackend(make_shared<MemoryRemoteStorageBackend>());
+  BOOST_CHECK_EQUAL(slowBackend->GetNumDocuments(), 0);
+
+  // The write is still sent, and waited for along with the current queue
+  BOOST_REQUIRE(db.WaitUntilWritten(WAIT_TIMEOUT.count()));
+  BOOST_CHECK_EQUAL(slowBackend->GetNumDocuments(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -25,6 +25,9 @@
 
 using namespace std;
 
+// Writes go through a background queue, so wait for them before querying
+const unsigned int WRITE_TIMEOUT_MS = 10000;
+
 BOOST_AUTO_TEST_SUITE(mongodbtest)
 
 BOOST_AUTO_TEST_CASE(test_mongo) {
@@ -42,18 +45,21 @@ BOOST_AUTO_TEST_CASE(test_mongo) {
   RemoteStorageDB::GetInstance().InsertTxn(txn1, TxnStatus::DISPATCHED,
                                            epochNum);
   RemoteStorageDB::GetInstance().ExecuteWrite();
+  RemoteStorageDB::GetInstance().WaitUntilWritten(WRITE_TIMEOUT_MS);
   auto query_ret = RemoteStorageDB::GetInstance().QueryTxnHash(txn1_hash);
   cout << query_ret.toStyledString() << endl;
 
   RemoteStorageDB::GetInstance().UpdateTxn(txn1_hash, TxnStatus::CONFIRMED,
                                            epochNum + 2, true);
   RemoteStorageDB::GetInstance().ExecuteWrite();
+  RemoteStorageDB::GetInstance().WaitUntilWritten(WRITE_TIMEOUT_MS);
   query_ret = RemoteStorageDB::GetInstance().QueryTxnHash(txn1_hash);
   cout << query_ret.toStyledString() << endl;
   // try and insert same txn
   RemoteStorageDB::GetInstance().InsertTxn(txn1, TxnStatus::DISPATCHED,
                                            epochNum);
   RemoteStorageDB::GetInstance().ExecuteWrite();
+  RemoteStorageDB::GetInstance().WaitUntilWritten(WRITE_TIMEOUT_MS);
 
   // try and query non-existent txn
   query_ret = RemoteStorageDB::GetInstance().QueryTxnHash("abcd");
@@ -64,6 +70,7 @@ BOOST_AUTO_TEST_CASE(test_mongo) {
   RemoteStorageDB::GetInstance().UpdateTxn(txn2_hash, TxnStatus::DISPATCHED,
                                            epochNum + 2, true);
   RemoteStorageDB::GetInstance().ExecuteWrite();
+  RemoteStorageDB::GetInstance().WaitUntilWritten(WRITE_TIMEOUT_MS);
 
   query_ret = RemoteStorageDB::GetInstance().QueryTxnHash(txn2_hash);
   BOOST_CHECK_EQUAL(Json::Value::null, query_ret);
@@ -72,10 +79,12 @@ BOOST_AUTO_TEST_CASE(test_mongo) {
   RemoteStorageDB::GetInstance().UpdateTxn(txn1_hash, TxnStatus::SOFT_CONFIRMED,
                                            epochNum + 1, true);
   RemoteStorageDB::GetInstance().ExecuteWrite();
+  RemoteStorageDB::GetInstance().WaitUntilWritten(WRITE_TIMEOUT_MS);
 
   RemoteStorageDB::GetInstance().InsertTxn(txn2, TxnStatus::DISPATCHED,
                                            epochNum + 3);
   RemoteStorageDB::GetInstance().ExecuteWrite();
+  RemoteStorageDB::GetInstance().WaitUntilWritten(WRITE_TIMEOUT_MS);
 
   // insert 100 txns
   const auto num = 100;
@@ -88,5 +97,6 @@ BOOST_AUTO_TEST_CASE(test_mongo) {
   }
 
   RemoteStorageDB::GetInstance().ExecuteWrite();
+  RemoteStorageDB::GetInstance().WaitUntilWritten(WRITE_TIMEOUT_MS);
 }
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "libServer/AdmissionControl.h"
+#include "libUtils/Logger.h"
+#include "libUtils/TimeUtils.h"
+
+#define BOOST_TEST_MODULE admissioncontroltest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const unsigned int NUM_SERVER_THREADS = 8;
+const unsigned int NUM_REQUESTS = 200;
+const unsigned int HEAVY_CALL_IN_MS = 10;
+
+struct Request {
+  bool m_stop;
+  bool m_heavy;
+  decltype(r_timer_start()) m_start;
+};
+
+/// Runs an equal mix of heavy and cheap calls, all arriving at once, on a
+/// fixed pool of server threads, and returns the cheap call latencies in us.
+vector<double> RunMixedWorkload(AdmissionControl* admission) {
+  mutex m;
+  condition_variable cv;
+  deque<Request> queue;
+  vector<double> latencies;
+
+  auto serve = [&]() -> void {
+    while (true) {
+      Request request;
+      {
+        unique_lock<mutex> lock(m);
+        cv.wait(lock, [&queue]() { return !queue.empty(); });
+        request = queue.front();
+        queue.pop_front();
+      }
+
+      if (request.m_stop) {
+        return;
+      }
+
+      if (request.m_heavy) {
+        if (admission == nullptr) {
+          this_thread::sleep_for(chrono::milliseconds(HEAVY_CALL_IN_MS));
+        } else {
+          const auto ticket = admission->Admit("heavy");
+          if (ticket.IsAdmitted()) {
+            this_thread::sleep_for(chrono::milliseconds(HEAVY_CALL_IN_MS));
+          }
+        }
+        continue;
+      }
+
+      const double latency = r_timer_end(request.m_start);
+      lock_guard<mutex> g(m);
+      latencies.emplace_back(latency);
+    }
+  };
+
+  vector<thread> threads;
+  for (unsigned int i = 0; i < NUM_SERVER_THREADS; i++) {
+    threads.emplace_back(serve);
+  }
+
+  {
+    lock_guard<mutex> g(m);
+    for (unsigned int i = 0; i < NUM_REQUESTS; i++) {
+      queue.push_back({false, i % 2 == 0, r_timer_start()});
+    }
+    // One stop marker per thread
+    for (unsigned int i = 0; i < NUM_SERVER_THREADS; i++) {
+      queue.push_back({true, false, r_timer_start()});
+    }
+  }
+  cv.notify_all();
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  sort(latencies.begin(), latencies.end());
+  return latencies;
+}
+
+double Percentile(const vector<double>& sorted, double p) {
+  return sorted[min<size_t>(sorted.size() - 1, sorted.size() * p)];
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(admissioncontroltest)
+
+BOOST_AUTO_TEST_CASE(test_limits) {
+  INIT_STDOUT_LOGGER();
+
+  AdmissionControl admission(10, 1000);
+  admission.SetLimit("heavy", 1, 1);
+
+  BOOST_CHECK(admission.Admit("cheap").IsAdmitted());
+  BOOST_CHECK(!admission.IsLimited("cheap"));
+
+  {
+    auto held =
+        make_unique<AdmissionControl::Ticket>(admission.Admit("heavy"));
+    BOOST_REQUIRE(held->IsAdmitted());
+
+    // Reentrant on the same thread
+    BOOST_CHECK(admission.Admit("heavy").IsAdmitted());
+
+    // The first waiter queues, the next one finds the queue full
+    bool waiterAdmitted = false;
+    thread waiter([&admission, &waiterAdmitted]() {
+      waiterAdmitted = admission.Admit("heavy").IsAdmitted();
+    });
+    this_thread::sleep_for(chrono::milliseconds(100));
+
+    bool rejected = true;
+    thread(
+        [&admission, &rejected]() {
+          rejected = !admission.Admit("heavy").IsAdmitted();
+        })
+        .join();
+    BOOST_CHECK(rejected);
+
+    // Releasing the slot lets the waiter in
+    held.reset();
+    waiter.join();
+    BOOST_CHECK(waiterAdmitted);
+  }
+
+  const auto stats = admission.GetStats("heavy");
+  BOOST_CHECK_EQUAL(stats.m_admitted, 2);
+  BOOST_CHECK_EQUAL(stats.m_queued, 1);
+  BOOST_CHECK_EQUAL(stats.m_rejected, 1);
+  BOOST_CHECK_EQUAL(stats.m_timedOut, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_timeout_and_budget) {
+  INIT_STDOUT_LOGGER();
+
+  AdmissionControl admission(2, 50);
+  admission.SetLimit("a", 1, 1);
+  admission.SetLimit("b", 1, 1);
+
+  const auto heldA = admission.Admit("a");
+  BOOST_REQUIRE(heldA.IsAdmitted());
+
+  // Waits for the slot held by this thread, and gives up
+  bool admitted = true;
+  thread([&admission, &admitted]() {
+    admitted = admission.Admit("a").IsAdmitted();
+  }).join();
+  BOOST_CHECK(!admitted);
+  BOOST_CHECK_EQUAL(admission.GetStats("a").m_timedOut, 1);
+
+  // Another method shares the budget of two
+  const auto heldB = admission.Admit("b");
+  BOOST_REQUIRE(heldB.IsAdmitted());
+  thread([&admission, &admitted]() {
+    admitted = admission.Admit("a").IsAdmitted();
+  }).join();
+  BOOST_CHECK(!admitted);
+  BOOST_CHECK_EQUAL(admission.GetStats("a").m_rejected, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_mixed_workload_latency) {
+  INIT_STDOUT_LOGGER();
+
+  const auto without = RunMixedWorkload(nullptr);
+
+  AdmissionControl admission(NUM_SERVER_THREADS / 2, HEAVY_CALL_IN_MS);
+  admission.SetLimit("heavy", NUM_SERVER_THREADS / 4, NUM_SERVER_THREADS / 4);
+  const auto with = RunMixedWorkload(&admission);
+
+  BOOST_REQUIRE_EQUAL(without.size(), NUM_REQUESTS / 2);
+  BOOST_REQUIRE_EQUAL(with.size(), NUM_REQUESTS / 2);
+
+  LOG_GENERAL(INFO, "Cheap calls without admission p50 = "
+                        << Percentile(without, 0.5)
+                        << " us p99 = " << Percentile(without, 0.99) << " us");
+  LOG_GENERAL(INFO, "Cheap calls with admission    p50 = "
+                        << Percentile(with, 0.5)
+                        << " us p99 = " << Percentile(with, 0.99) << " us");
+
+  const auto stats = admission.GetStats("heavy");
+  LOG_GENERAL(INFO, "Heavy calls admitted = " << stats.m_admitted
+                                              << " rejected = "
+                                              << stats.m_rejected
+                                              << " timed out = "
+                                              << stats.m_timedOut);
+
+  // Latencies depend on the machine and are only logged. Every heavy call
+  // gets a decision, and the burst is more than the limits let through.
+  BOOST_CHECK_EQUAL(stats.m_admitted + stats.m_rejected + stats.m_timedOut,
+                    NUM_REQUESTS / 2);
+  BOOST_CHECK_GT(stats.m_admitted, 0U);
+  BOOST_CHECK_GT(stats.m_rejected + stats.m_timedOut, 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
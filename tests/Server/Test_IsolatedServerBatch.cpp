@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2020 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <jsonrpccpp/server/connectors/httpserver.h>
+
+#include "libData/AccountData/AccountStore.h"
+#include "libLookup/Lookup.h"
+#include "libMediator/Mediator.h"
+#include "libNode/Node.h"
+#include "libPersistence/BlockStorage.h"
+#include "libServer/AddressChecksum.h"
+#include "libServer/IsolatedServer.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+#include "libValidator/Validator.h"
+
+#define BOOST_TEST_MODULE isolatedserverbatchtest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace jsonrpc;
+
+namespace {
+// Every scenario queues exactly this many txns, so that each one is applied
+// as a batch of its own without a block tick
+const uint32_t BATCH_SIZE = 3;
+// Long enough that no block is produced while the test runs
+const uint32_t BLOCK_TIME_MS = 3600 * 1000;
+const uint128_t INITIAL_BALANCE("1000000000000000000");
+
+struct Env {
+  Mediator mediator{Schnorr::GenKeyPair(), Peer()};
+  Node node{mediator, 0, false};
+  Lookup lookup{mediator, SyncType::NO_SYNC};
+  Validator validator{mediator};
+  HttpServer connector{0};
+  unique_ptr<IsolatedServer> server;
+
+  Env() {
+    BlockStorage::GetBlockStorage().RefreshAll();
+    AccountStore::GetInstance().RefreshDB();
+    mediator.RegisterColleagues(nullptr, &node, &lookup, &validator);
+    AccountStore::GetInstance().InitSoft();
+    server = make_unique<IsolatedServer>(mediator, connector, 1,
+                                         BLOCK_TIME_MS, BATCH_SIZE);
+  }
+};
+
+/// The server's block thread keeps running until exit, so the environment
+/// is never torn down
+IsolatedServer& GetServer() {
+  static Env* env = new Env();
+  return *env->server;
+}
+
+PairOfKey NewSender() {
+  const PairOfKey key = Schnorr::GenKeyPair();
+  AccountStore::GetInstance().AddAccount(
+      Account::GetAddressFromPublicKey(key.second), {INITIAL_BALANCE, 0});
+  AccountStore::GetInstance().UpdateStateTrieAll();
+  return key;
+}
+
+Json::Value ToJson(const Transaction& tx) {
+  string pubKeyStr, signatureStr;
+  BOOST_REQUIRE(
+      DataConversion::SerializableToHexStr(tx.GetSenderPubKey(), pubKeyStr));
+  BOOST_REQUIRE(
+      DataConversion::SerializableToHexStr(tx.GetSignature(), signatureStr));
+
+  Json::Value _json;
+  _json["version"] = tx.GetVersion();
+  _json["nonce"] = Json::UInt64(tx.GetNonce());
+  _json["toAddr"] = AddressChecksum::GetCheckSumedAddress(tx.GetToAddr().hex());
+  _json["amount"] = tx.GetAmount().str();
+  _json["pubKey"] = pubKeyStr;
+  _json["gasPrice"] = tx.GetGasPrice().str();
+  _json["gasLimit"] = to_string(tx.GetGasLimit());
+  _json["code"] = DataConversion::CharArrayToString(tx.GetCode());
+  _json["data"] = DataConversion::CharArrayToString(tx.GetData());
+  _json["signature"] = signatureStr;
+  return _json;
+}
+
+Transaction Transfer(const PairOfKey& sender, const uint64_t nonce,
+                     const uint128_t& amount) {
+  return Transaction(DataConversion::Pack(CHAIN_ID, TRANSACTION_VERSION),
+                     nonce, Address::random(), sender, amount,
+                     GAS_PRICE_MIN_VALUE, NORMAL_TRAN_GAS);
+}
+
+/// Returns GetTransaction for the txn once its batch has been applied
+Json::Value WaitForTxn(const Transaction& tx) {
+  const auto deadline = chrono::steady_clock::now() + chrono::seconds(60);
+  while (true) {
+    try {
+      return GetServer().GetTransaction(tx.GetTranID().hex());
+    } catch (const JsonRpcException&) {
+      if (chrono::steady_clock::now() > deadline) {
+        throw;
+      }
+    }
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(isolatedserverbatchtest)
+
+BOOST_AUTO_TEST_CASE(test_nonce_chaining) {
+  INIT_STDOUT_LOGGER();
+
+  IsolatedServer& server = GetServer();
+  const PairOfKey sender = NewSender();
+
+  // Expected nonces continue from the queued txns, not the committed state
+  const Transaction first = Transfer(sender, 1, 1);
+  const Transaction second = Transfer(sender, 2, 1);
+  BOOST_CHECK_EQUAL(server.CreateTransaction(ToJson(first))["Info"].asString(),
+                    "Txn queued");
+  BOOST_CHECK_NO_THROW(server.CreateTransaction(ToJson(second)));
+  BOOST_CHECK_THROW(server.CreateTransaction(ToJson(Transfer(sender, 2, 2))),
+                    JsonRpcException);
+  BOOST_CHECK_THROW(server.CreateTransaction(ToJson(Transfer(sender, 4, 1))),
+                    JsonRpcException);
+
+  const Transaction third = Transfer(sender, 3, 1);
+  BOOST_CHECK_NO_THROW(server.CreateTransaction(ToJson(third)));
+
+  for (const auto& tx : {first, second, third}) {
+    BOOST_CHECK(WaitForTxn(tx)["receipt"]["success"].asBool());
+  }
+
+  // Once applied, the sender continues from the committed nonce
+  BOOST_CHECK_THROW(server.CreateTransaction(ToJson(Transfer(sender, 3, 2))),
+                    JsonRpcException);
+  const Account* account = AccountStore::GetInstance().GetAccount(
+      Account::GetAddressFromPublicKey(sender.second));
+  BOOST_REQUIRE(account != nullptr);
+  BOOST_CHECK_EQUAL(account->GetNonce(), 3U);
+}
+
+BOOST_AUTO_TEST_CASE(test_queued_contract_call) {
+  INIT_STDOUT_LOGGER();
+
+  BOOST_REQUIRE_MESSAGE(ENABLE_SC, "Needs ENABLE_SC in constants.xml");
+
+  IsolatedServer& server = GetServer();
+  const PairOfKey sender = NewSender();
+
+  const string code = "scilla_version 0\ncontract Empty()\n";
+  const string init =
+      R"([{"vname":"_scilla_version","type":"Uint32","value":"0"}])";
+  const Transaction create(
+      DataConversion::Pack(CHAIN_ID, TRANSACTION_VERSION), 1, NullAddress,
+      sender, 0, GAS_PRICE_MIN_VALUE, 10000,
+      DataConversion::StringToCharArray(code),
+      DataConversion::StringToCharArray(init));
+  const Json::Value created = server.CreateTransaction(ToJson(create));
+  const Address contractAddr(created["ContractAddress"].asString());
+  BOOST_CHECK(contractAddr == Account::GetAddressForContract(
+                                  create.GetSenderAddr(), 0));
+
+  // The contract only exists once the batch is applied, but a call to it
+  // may already be queued
+  const Transaction call(
+      DataConversion::Pack(CHAIN_ID, TRANSACTION_VERSION), 2, contractAddr,
+      sender, 0, GAS_PRICE_MIN_VALUE, 10000, {},
+      DataConversion::StringToCharArray(
+          R"({"_tag":"Noop","params":[]})"));
+  BOOST_CHECK_NO_THROW(server.CreateTransaction(ToJson(call)));
+
+  // Calls to addresses that are neither contracts nor queued are still
+  // rejected up front
+  const Transaction badCall(
+      DataConversion::Pack(CHAIN_ID, TRANSACTION_VERSION), 3,
+      Address::random(), sender, 0, GAS_PRICE_MIN_VALUE, 10000, {},
+      DataConversion::StringToCharArray(
+          R"({"_tag":"Noop","params":[]})"));
+  BOOST_CHECK_THROW(server.CreateTransaction(ToJson(badCall)),
+                    JsonRpcException);
+
+  const Transaction pad = Transfer(sender, 3, 1);
+  BOOST_CHECK_NO_THROW(server.CreateTransaction(ToJson(pad)));
+
+  // Whether Scilla is available decides the receipts, but every queued txn
+  // must be found
+  for (const auto& tx : {create, call, pad}) {
+    const Json::Value txn = WaitForTxn(tx);
+    BOOST_CHECK(txn["receipt"].isMember("success"));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_failed_txn_receipt) {
+  INIT_STDOUT_LOGGER();
+
+  IsolatedServer& server = GetServer();
+  const PairOfKey sender = NewSender();
+
+  // Each transfer passes the check against the committed balance, but both
+  // together overdraw it
+  const uint128_t amount = INITIAL_BALANCE * 6 / 10;
+  const Transaction first = Transfer(sender, 1, amount);
+  const Transaction overdraw = Transfer(sender, 2, amount);
+  const Transaction after = Transfer(sender, 3, 1);
+  for (const auto& tx : {first, overdraw, after}) {
+    BOOST_CHECK_NO_THROW(server.CreateTransaction(ToJson(tx)));
+  }
+
+  BOOST_CHECK(WaitForTxn(first)["receipt"]["success"].asBool());
+
+  // The failure is reported through GetTransaction instead of being dropped
+  const Json::Value failed = WaitForTxn(overdraw);
+  BOOST_CHECK(!failed["receipt"]["success"].asBool());
+  BOOST_REQUIRE_EQUAL(failed["receipt"]["exceptions"].size(), 1U);
+  BOOST_CHECK_EQUAL(
+      failed["receipt"]["exceptions"][0]["message"].asString(),
+      "Error Code: " + to_string(TxnStatus::INSUFFICIENT_BALANCE));
+
+  // The txn behind it is left with a nonce gap
+  const Json::Value skipped = WaitForTxn(after);
+  BOOST_CHECK(!skipped["receipt"]["success"].asBool());
+  BOOST_CHECK_EQUAL(
+      skipped["receipt"]["exceptions"][0]["message"].asString(),
+      "Error Code: " + to_string(TxnStatus::PRESENT_NONCE_HIGH));
+
+  // The sender carries on from the last txn that went through
+  BOOST_CHECK_NO_THROW(
+      server.CreateTransaction(ToJson(Transfer(sender, 2, 1))));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "libData/AccountData/TransactionReceipt.h"
+#include "libServer/JSONConversion.h"
+#include "libServer/JsonResponseCache.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/Logger.h"
+#include "libUtils/TimeUtils.h"
+
+#define BOOST_TEST_MODULE jsonresponsecachetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const unsigned int NUM_TXNS = 1000;
+const unsigned int NUM_CLIENTS = 8;
+const unsigned int REQUESTS_PER_CLIENT = 20000;
+
+/// Issues GetTransaction-style requests from NUM_CLIENTS threads, each
+/// picking hashes from the set of txns, and returns the requests per second.
+/// The requests are the same on every run, so totalBytes only depends on
+/// the responses.
+template <class Handler>
+double RunLoad(const vector<TxnHash>& hashes, const Handler& handler,
+               size_t& totalBytes) {
+  atomic<size_t> responseBytes{0};
+  vector<thread> clients;
+
+  auto startTime = r_timer_start();
+  for (unsigned int c = 0; c < NUM_CLIENTS; c++) {
+    clients.emplace_back([&hashes, &handler, &responseBytes, c]() {
+      Json::FastWriter writer;
+      size_t bytesWritten = 0;
+      for (unsigned int i = 0; i < REQUESTS_PER_CLIENT; i++) {
+        // Skewed towards the most recent txns, like explorer traffic
+        const unsigned int index =
+            (i * 7 + c) % (i % 4 == 0 ? hashes.size() : hashes.size() / 10);
+        bytesWritten += writer.write(handler(hashes[index])).size();
+      }
+      responseBytes += bytesWritten;
+    });
+  }
+  for (auto& client : clients) {
+    client.join();
+  }
+  const double us = r_timer_end(startTime);
+
+  totalBytes = responseBytes;
+  BOOST_CHECK(totalBytes > 0);
+  return NUM_CLIENTS * REQUESTS_PER_CLIENT * 1000000.0 / us;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(jsonresponsecachetest)
+
+BOOST_AUTO_TEST_CASE(test_lru_eviction) {
+  INIT_STDOUT_LOGGER();
+
+  JsonResponseCache<uint64_t> cache(2);
+  BOOST_CHECK(cache.IsEnabled());
+  BOOST_CHECK(cache.Get(1) == nullptr);
+
+  cache.Put(1, Json::Value("one"));
+  cache.Put(2, Json::Value("two"));
+  BOOST_REQUIRE(cache.Get(1) != nullptr);
+  BOOST_CHECK_EQUAL(cache.Get(1)->asString(), "one");
+
+  // 2 is now the least recently used
+  cache.Put(3, Json::Value("three"));
+  BOOST_CHECK(cache.Get(2) == nullptr);
+  BOOST_REQUIRE(cache.Get(3) != nullptr);
+  BOOST_CHECK_EQUAL(cache.Get(3)->asString(), "three");
+
+  // Overwriting keeps the size
+  cache.Put(3, Json::Value("third"));
+  BOOST_CHECK_EQUAL(cache.Get(3)->asString(), "third");
+
+  const auto stats = cache.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_size, 2U);
+  BOOST_CHECK_EQUAL(stats.m_hits, 5U);
+  BOOST_CHECK_EQUAL(stats.m_misses, 2U);
+
+  cache.Clear();
+  BOOST_CHECK(cache.Get(1) == nullptr);
+  BOOST_CHECK_EQUAL(cache.GetStats().m_size, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(test_disabled) {
+  INIT_STDOUT_LOGGER();
+
+  JsonResponseCache<uint64_t> cache(0);
+  BOOST_CHECK(!cache.IsEnabled());
+
+  // The value is still handed back to the caller
+  const auto value = cache.Put(1, Json::Value("one"));
+  BOOST_REQUIRE(value != nullptr);
+  BOOST_CHECK_EQUAL(value->asString(), "one");
+  BOOST_CHECK(cache.Get(1) == nullptr);
+
+  const auto stats = cache.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_size, 0U);
+  BOOST_CHECK_EQUAL(stats.m_hits + stats.m_misses, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(test_txn_load) {
+  INIT_STDOUT_LOGGER();
+
+  // Stored txn bodies, as GetTransaction reads them from BlockStorage
+  vector<TxnHash> hashes;
+  unordered_map<TxnHash, bytes> bodies;
+  for (unsigned int i = 0; i < NUM_TXNS; i++) {
+    const TransactionWithReceipt twr(
+        TestUtils::GenerateRandomTransaction(1, i, Transaction::NON_CONTRACT),
+        TransactionReceipt());
+    bytes body;
+    twr.Serialize(body, 0);
+    hashes.emplace_back(twr.GetTransaction().GetTranID());
+    bodies.emplace(hashes.back(), move(body));
+  }
+
+  auto uncached = [&bodies](const TxnHash& hash) -> Json::Value {
+    const TransactionWithReceipt twr(bodies.at(hash), 0);
+    return JSONConversion::convertTxtoJson(twr);
+  };
+
+  JsonResponseCache<TxnHash> cache(NUM_TXNS);
+  auto cached = [&cache, &uncached](const TxnHash& hash) -> Json::Value {
+    const auto value = cache.Get(hash);
+    if (value != nullptr) {
+      return *value;
+    }
+    return *cache.Put(hash, uncached(hash));
+  };
+
+  // Both paths give the same response
+  for (const auto& hash : hashes) {
+    BOOST_CHECK(cached(hash) == uncached(hash));
+  }
+
+  size_t uncachedBytes = 0;
+  size_t cachedBytes = 0;
+  const double uncachedRate = RunLoad(hashes, uncached, uncachedBytes);
+  const double cachedRate = RunLoad(hashes, cached, cachedBytes);
+
+  const auto stats = cache.GetStats();
+  LOG_GENERAL(INFO, NUM_CLIENTS << " clients, GetTransaction requests/s: "
+                                << "uncached " << uncachedRate << ", cached "
+                                << cachedRate << " (hits " << stats.m_hits
+                                << ", misses " << stats.m_misses << ")");
+
+  // The rates are only logged. Under load the cache serves the same
+  // responses, and every txn was cached by the first pass, so it only hits.
+  BOOST_CHECK_EQUAL(cachedBytes, uncachedBytes);
+  BOOST_CHECK_EQUAL(stats.m_misses, NUM_TXNS);
+  BOOST_CHECK_EQUAL(stats.m_hits, NUM_CLIENTS * REQUESTS_PER_CLIENT);
+  BOOST_CHECK_EQUAL(stats.m_size, NUM_TXNS);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "libPersistence/BlockStorage.h"
+#include "libServer/TxnCountIndex.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE txncountindextest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const uint64_t NUM_BLOCKS = 1000;
+const uint64_t NUM_TX_BLOCKS_PER_DS = 10;
+const unsigned int NUM_QUERIES = 1000;
+
+uint64_t DSBlockNumOf(uint64_t txBlockNum) {
+  return txBlockNum == 0 ? 0 : (txBlockNum - 1) / NUM_TX_BLOCKS_PER_DS + 1;
+}
+
+TxBlock CreateTxBlock(uint64_t blockNum, uint32_t numTxs) {
+  return TxBlock(
+      TxBlockHeader(1, 1, 0, blockNum, TxBlockHashSet(), numTxs,
+                    TestUtils::GenerateRandomPubKey(), DSBlockNumOf(blockNum)),
+      vector<MicroBlockInfo>(), CoSignatures());
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(txncountindextest)
+
+BOOST_AUTO_TEST_CASE(test_ranges_match_block_scan) {
+  INIT_STDOUT_LOGGER();
+
+  TxnCountIndex index(false);
+  vector<uint32_t> numTxs;
+  for (uint64_t i = 0; i < NUM_BLOCKS; i++) {
+    numTxs.emplace_back(TestUtils::RandomIntInRng<uint32_t>(0, 5000));
+    BOOST_REQUIRE(index.Append(i, DSBlockNumOf(i), numTxs.back()));
+  }
+  BOOST_CHECK_EQUAL(index.GetNumBlocks(), NUM_BLOCKS);
+
+  // Blocks must come in order
+  BOOST_CHECK(!index.Append(NUM_BLOCKS + 1, DSBlockNumOf(NUM_BLOCKS), 1));
+
+  for (unsigned int q = 0; q < NUM_QUERIES; q++) {
+    const uint64_t from =
+        TestUtils::RandomIntInRng<uint64_t>(0, NUM_BLOCKS - 1);
+    const uint64_t to = TestUtils::RandomIntInRng<uint64_t>(0, NUM_BLOCKS - 1);
+
+    uint128_t expected = 0;
+    for (uint64_t i = from + 1; i <= to; i++) {
+      expected += numTxs[i];
+    }
+    BOOST_CHECK_EQUAL(index.GetNumTxns(from, to), expected);
+
+    const uint64_t dsBlockNum = DSBlockNumOf(to);
+    expected = 0;
+    for (uint64_t i = 0; i <= to; i++) {
+      if (DSBlockNumOf(i) == dsBlockNum) {
+        expected += numTxs[i];
+      }
+    }
+    BOOST_CHECK_EQUAL(index.GetNumTxnsInDSEpoch(dsBlockNum, to), expected);
+  }
+
+  // Past the tip is clamped, unknown epochs are empty
+  BOOST_CHECK_EQUAL(index.GetNumTxns(0, NUM_BLOCKS * 2),
+                    index.GetNumTxns(0, NUM_BLOCKS - 1));
+  BOOST_CHECK_EQUAL(index.GetNumTxnsInDSEpoch(NUM_BLOCKS, NUM_BLOCKS - 1), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_update_from_chain) {
+  INIT_STDOUT_LOGGER();
+
+  TxBlockChain txBlockChain;
+  txBlockChain.Reset();
+  TxnCountIndex index(false);
+
+  // Empty chain
+  BOOST_CHECK(!index.Update(txBlockChain));
+
+  uint128_t total = 0;
+  const uint64_t numBlocks = BLOCKCHAIN_SIZE / 2;
+  for (uint64_t i = 0; i < numBlocks; i++) {
+    txBlockChain.AddBlock(CreateTxBlock(i, i));
+    total += i;
+  }
+  BOOST_REQUIRE(index.Update(txBlockChain));
+  BOOST_CHECK_EQUAL(index.GetNumBlocks(), numBlocks);
+  BOOST_CHECK_EQUAL(index.GetNumTxns(0, numBlocks - 1), total);
+
+  // Only the new blocks are added
+  for (uint64_t i = numBlocks; i < BLOCKCHAIN_SIZE; i++) {
+    txBlockChain.AddBlock(CreateTxBlock(i, i));
+    total += i;
+  }
+  BOOST_REQUIRE(index.Update(txBlockChain));
+  BOOST_CHECK_EQUAL(index.GetNumBlocks(), BLOCKCHAIN_SIZE);
+  BOOST_CHECK_EQUAL(index.GetNumTxns(0, BLOCKCHAIN_SIZE - 1), total);
+
+  const uint64_t last = BLOCKCHAIN_SIZE - 1;
+  uint128_t expected = 0;
+  for (uint64_t i = 0; i <= last; i++) {
+    if (DSBlockNumOf(i) == DSBlockNumOf(last)) {
+      expected += i;
+    }
+  }
+  BOOST_CHECK_EQUAL(index.GetNumTxnsInDSEpoch(DSBlockNumOf(last), last),
+                    expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_missing_blocks_and_reload) {
+  INIT_STDOUT_LOGGER();
+
+  auto& storage = BlockStorage::GetBlockStorage();
+  BOOST_REQUIRE(storage.ResetDB(BlockStorage::TX_BLOCK));
+  BOOST_REQUIRE(storage.ResetDB(BlockStorage::TXN_COUNTS));
+
+  // The first blocks drop out of the in-memory chain and are not stored yet
+  const uint64_t numMissing = 10;
+  const uint64_t numBlocks = BLOCKCHAIN_SIZE + numMissing;
+  TxBlockChain txBlockChain;
+  txBlockChain.Reset();
+  vector<TxBlock> blocks;
+  uint128_t total = 0;
+  for (uint64_t i = 0; i < numBlocks; i++) {
+    blocks.emplace_back(CreateTxBlock(i, i + 1));
+    txBlockChain.AddBlock(blocks.back());
+    total += i + 1;
+  }
+
+  // Nothing past a missing block is counted
+  {
+    TxnCountIndex index(true);
+    BOOST_CHECK(!index.Update(txBlockChain));
+    BOOST_CHECK_EQUAL(index.GetNumBlocks(), 0);
+    BOOST_CHECK_EQUAL(index.GetNumTxns(0, numBlocks - 1), 0);
+  }
+
+  // Once the blocks can be read, the index covers the whole chain
+  for (uint64_t i = 0; i < numMissing; i++) {
+    bytes body;
+    BOOST_REQUIRE(blocks[i].Serialize(body, 0));
+    BOOST_REQUIRE(storage.PutTxBlock(i, body));
+  }
+  {
+    TxnCountIndex index(true);
+    BOOST_REQUIRE(index.Update(txBlockChain));
+    BOOST_CHECK_EQUAL(index.GetNumBlocks(), numBlocks);
+    BOOST_CHECK_EQUAL(index.GetNumTxns(0, numBlocks - 1), total - 1);
+  }
+
+  // After a restart the counts are reloaded, so the blocks that are gone
+  // again are not needed
+  BOOST_REQUIRE(storage.ResetDB(BlockStorage::TX_BLOCK));
+  TxnCountIndex reloaded(true);
+  BOOST_REQUIRE(reloaded.Update(txBlockChain));
+  BOOST_CHECK_EQUAL(reloaded.GetNumBlocks(), numBlocks);
+  BOOST_CHECK_EQUAL(reloaded.GetNumTxns(0, numBlocks - 1), total - 1);
+  BOOST_CHECK_EQUAL(reloaded.GetNumTxnsInDSEpoch(DSBlockNumOf(0), 0), 1);
+  const uint64_t last = numBlocks - 1;
+  uint128_t expected = 0;
+  for (uint64_t i = 0; i <= last; i++) {
+    if (DSBlockNumOf(i) == DSBlockNumOf(last)) {
+      expected += i + 1;
+    }
+  }
+  BOOST_CHECK_EQUAL(reloaded.GetNumTxnsInDSEpoch(DSBlockNumOf(last), last),
+                    expected);
+
+  BOOST_REQUIRE(storage.ResetDB(BlockStorage::TXN_COUNTS));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -15,8 +15,12 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <boost/algorithm/hex.hpp>
+#include <cstdlib>
+
 #include "libUtils/DataConversion.h"
 #include "libUtils/Logger.h"
+#include "libUtils/TimeUtils.h"
 
 #define BOOST_TEST_MODULE data_conversion
 #define BOOST_TEST_DYN_LINK
@@ -149,4 +153,107 @@ BOOST_AUTO_TEST_CASE(test_hexstr) {
   LOG_GENERAL(INFO, "Test HexString Conversion done!");
 }
 
+BOOST_AUTO_TEST_CASE(test_hex_codec) {
+  LOG_GENERAL(INFO, "Test hex codec start...");
+
+  // Lengths around the SIMD block sizes, checked against boost::algorithm
+  for (unsigned int len = 0; len < 200; len++) {
+    bytes input(len);
+    for (auto& b : input) {
+      b = rand();
+    }
+
+    std::string expected;
+    boost::algorithm::hex(input.begin(), input.end(),
+                          std::back_inserter(expected));
+
+    std::string encoded;
+    BOOST_REQUIRE(DataConversion::Uint8VecToHexStr(input, encoded));
+    BOOST_REQUIRE_EQUAL(encoded, expected);
+
+    std::string lower(len * 2, ' ');
+    DataConversion::BytesToHexChars(input.data(), len, &lower[0], false);
+    BOOST_REQUIRE_EQUAL(lower, boost::to_lower_copy(expected));
+
+    // Mixed case decodes back to the input
+    std::string mixed = expected;
+    for (unsigned int i = 0; i < mixed.size(); i += 3) {
+      mixed[i] = tolower(mixed[i]);
+    }
+    bytes decoded;
+    BOOST_REQUIRE(DataConversion::HexStrToUint8Vec(mixed, decoded));
+    BOOST_REQUIRE(decoded == input);
+
+    // A single non-hex character anywhere is rejected
+    if (len > 0) {
+      for (const char bad : {'g', 'G', 'x', ' ', '/', ':', '@', '`', '\x80'}) {
+        std::string corrupted = mixed;
+        corrupted[rand() % corrupted.size()] = bad;
+        BOOST_REQUIRE(!DataConversion::HexStrToUint8Vec(corrupted, decoded));
+      }
+    }
+  }
+
+  bytes decoded;
+  BOOST_CHECK(!DataConversion::HexStrToUint8Vec("ABC", decoded));
+
+  std::string str;
+  BOOST_CHECK(!DataConversion::Uint8VecToHexStr(bytes(4), 2, 3, str));
+  BOOST_CHECK(DataConversion::Uint8VecToHexStr(bytes{1, 2, 3, 4}, 1, 2, str));
+  BOOST_CHECK_EQUAL(str, "0203");
+
+  LOG_GENERAL(INFO, "Test hex codec done!");
+}
+
+BOOST_AUTO_TEST_CASE(test_hex_codec_benchmark) {
+  const unsigned int ITERATIONS = 1000000;
+  bytes hash(32);
+  for (auto& b : hash) {
+    b = rand();
+  }
+  std::string str;
+  size_t sink = 0;
+
+  auto startTime = r_timer_start();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    hash[0] = i;
+    str.clear();
+    boost::algorithm::hex(hash.begin(), hash.end(), std::back_inserter(str));
+    sink += str[1];
+  }
+  const double boostEncodeUs = r_timer_end(startTime);
+
+  startTime = r_timer_start();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    hash[0] = i;
+    DataConversion::Uint8VecToHexStr(hash, str);
+    sink += str[1];
+  }
+  const double encodeUs = r_timer_end(startTime);
+
+  bytes decoded;
+  startTime = r_timer_start();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    decoded.clear();
+    boost::algorithm::unhex(str.begin(), str.end(),
+                            std::back_inserter(decoded));
+    sink += decoded[1];
+  }
+  const double boostDecodeUs = r_timer_end(startTime);
+
+  startTime = r_timer_start();
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    DataConversion::HexStrToUint8Vec(str, decoded);
+    sink += decoded[1];
+  }
+  const double decodeUs = r_timer_end(startTime);
+
+  LOG_GENERAL(INFO, "32-byte hash, ns/op: encode "
+                        << encodeUs * 1000 / ITERATIONS << " (boost "
+                        << boostEncodeUs * 1000 / ITERATIONS << "), decode "
+                        << decodeUs * 1000 / ITERATIONS << " (boost "
+                        << boostDecodeUs * 1000 / ITERATIONS << ")");
+  BOOST_CHECK(sink > 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "libUtils/Logger.h"
+#include "libUtils/TimeUtils.h"
+
+#define BOOST_TEST_MODULE utils
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const unsigned int NUM_THREADS = 4;
+const unsigned int CALLS_PER_THREAD = 50000;
+
+size_t CountLines(const string& filename) {
+  ifstream in(filename);
+  size_t count = 0;
+  string line;
+  while (getline(in, line)) {
+    count++;
+  }
+  return count;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(utils)
+
+BOOST_AUTO_TEST_CASE(testLogger4) {
+  // Measure the caller-side cost of logging from several threads, and confirm
+  // every record reaches the file once the logger is flushed
+
+  Logger::GetLogger("test4", true, "./");
+  const string filename = "./test4-00001-log.txt";
+  const size_t linesBefore = CountLines(filename);
+
+  auto worker = [](unsigned int id) {
+    for (unsigned int i = 0; i < CALLS_PER_THREAD; i++) {
+      LOG_GENERAL(INFO, "Thread " << id << " message " << i);
+    }
+  };
+
+  auto startTime = r_timer_start();
+  vector<thread> threads;
+  for (unsigned int i = 0; i < NUM_THREADS; i++) {
+    threads.emplace_back(worker, i);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  const double enabledUs = r_timer_end(startTime);
+
+  Logger::GetLogger().Flush();
+  BOOST_CHECK_EQUAL(CountLines(filename) - linesBefore,
+                    (size_t)NUM_THREADS * CALLS_PER_THREAD);
+
+  // Disabled levels must not even build the message
+  LOG_DISABLE_LEVEL(DEBUG);
+  unsigned int evaluated = 0;
+  auto countEval = [&evaluated]() { return ++evaluated; };
+  startTime = r_timer_start();
+  for (unsigned int i = 0; i < CALLS_PER_THREAD; i++) {
+    LOG_GENERAL(DEBUG, "Filtered " << countEval());
+  }
+  const double filteredUs = r_timer_end(startTime);
+  LOG_ENABLE_LEVEL(DEBUG);
+  BOOST_CHECK_EQUAL(evaluated, 0);
+
+  LOG_GENERAL(INFO, "Enabled: "
+                        << enabledUs * 1000 / (NUM_THREADS * CALLS_PER_THREAD)
+                        << " ns/call (" << NUM_THREADS
+                        << " threads), filtered: "
+                        << filteredUs * 1000 / CALLS_PER_THREAD << " ns/call");
+}
+
+BOOST_AUTO_TEST_CASE(testShortLivedThreads) {
+  // Threads that log a few lines and exit, as detached helpers do, must not
+  // lose records or leave per-thread state behind
+
+  Logger::GetLogger("test4", true, "./");
+  const string filename = "./test4-00001-log.txt";
+  Logger::GetLogger().Flush();
+  const size_t linesBefore = CountLines(filename);
+
+  const unsigned int NUM_SHORT_THREADS = 1000;
+  for (unsigned int i = 0; i < NUM_SHORT_THREADS; i++) {
+    thread([i]() { LOG_GENERAL(INFO, "Short-lived thread " << i); }).join();
+  }
+
+  Logger::GetLogger().Flush();
+  BOOST_CHECK_EQUAL(CountLines(filename) - linesBefore, NUM_SHORT_THREADS);
+}
+
+BOOST_AUTO_TEST_CASE(testFlushOnSignal) {
+  // The signal handler only writes lines that are already formatted: the
+  // records flushed before the signal appear exactly once, and the ones
+  // still queued unformatted are dropped rather than formatted in the handler
+
+  Logger::GetLogger("test4", true, "./");
+  const string filename = "./test4-00001-log.txt";
+  Logger::GetLogger().Flush();
+  const size_t linesBefore = CountLines(filename);
+
+  const unsigned int NUM_LINES = 100;
+  const pid_t pid = fork();
+  BOOST_REQUIRE(pid >= 0);
+  if (pid == 0) {
+    // The writer thread is not carried over by fork, so nothing but Flush
+    // and the signal handler can write records out
+    for (unsigned int i = 0; i < NUM_LINES; i++) {
+      LOG_GENERAL(INFO, "Flushed " << i);
+    }
+    Logger::GetLogger().Flush();
+    for (unsigned int i = 0; i < NUM_LINES; i++) {
+      LOG_GENERAL(INFO, "Queued " << i);
+    }
+    // SIGTERM rather than abort(), which the test framework intercepts
+    raise(SIGTERM);
+    _exit(0);
+  }
+
+  int status = 0;
+  BOOST_REQUIRE_EQUAL(waitpid(pid, &status, 0), pid);
+  BOOST_CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGTERM);
+  BOOST_CHECK_EQUAL(CountLines(filename) - linesBefore, NUM_LINES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "libUtils/Logger.h"
+#include "libUtils/Metrics.h"
+#include "libUtils/TimeUtils.h"
+
+#define BOOST_TEST_MODULE metricstest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const unsigned int NUM_THREADS = 8;
+const unsigned int NUM_RECORDS = 1000000;
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(metricstest)
+
+BOOST_AUTO_TEST_CASE(test_bucket_bounds) {
+  INIT_STDOUT_LOGGER();
+
+  mt19937_64 eng(0);
+  unsigned int lastIndex = 0;
+  for (uint64_t v = 0; v < 100000; v++) {
+    const auto index = Metrics::Histogram::GetBucketIndex(v);
+    BOOST_REQUIRE_LT(index, Metrics::Histogram::NUM_BUCKETS);
+    BOOST_REQUIRE_GE(index, lastIndex);
+    BOOST_REQUIRE_GE(Metrics::Histogram::GetBucketUpperBound(index), v);
+    lastIndex = index;
+  }
+
+  for (unsigned int i = 0; i < 100000; i++) {
+    const uint64_t v = eng() >> (eng() % 64);
+    const auto upper = Metrics::Histogram::GetBucketUpperBound(
+        Metrics::Histogram::GetBucketIndex(v));
+    BOOST_REQUIRE_GE(upper, v);
+    BOOST_REQUIRE_LE(upper - v, v / Metrics::Histogram::SUB_BUCKETS);
+  }
+
+  BOOST_CHECK_EQUAL(
+      Metrics::Histogram::GetBucketIndex(UINT64_MAX),
+      Metrics::Histogram::NUM_BUCKETS - 1);
+  BOOST_CHECK_EQUAL(Metrics::Histogram::GetBucketUpperBound(
+                        Metrics::Histogram::NUM_BUCKETS - 1),
+                    UINT64_MAX);
+}
+
+BOOST_AUTO_TEST_CASE(test_percentiles) {
+  INIT_STDOUT_LOGGER();
+
+  Metrics::Histogram histogram;
+  BOOST_CHECK_EQUAL(histogram.GetSnapshot().GetPercentile(0.5), 0);
+
+  vector<uint64_t> values;
+  mt19937_64 eng(1);
+  for (unsigned int i = 0; i < 100000; i++) {
+    values.emplace_back(eng() % 1000000);
+    histogram.Record(values.back());
+  }
+  sort(values.begin(), values.end());
+
+  const auto snapshot = histogram.GetSnapshot();
+  BOOST_CHECK_EQUAL(snapshot.m_count, values.size());
+  BOOST_CHECK_EQUAL(snapshot.m_max, values.back());
+
+  for (const double p : {0.5, 0.9, 0.99, 0.999, 1.0}) {
+    const uint64_t exact = values[ceil(p * values.size()) - 1];
+    const uint64_t estimate = snapshot.GetPercentile(p);
+    BOOST_CHECK_GE(estimate, exact);
+    BOOST_CHECK_LE(estimate - exact, exact / Metrics::Histogram::SUB_BUCKETS);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_registry_and_prometheus) {
+  INIT_STDOUT_LOGGER();
+
+  auto& metrics = Metrics::GetInstance();
+  auto& counter = metrics.GetCounter("test_total", "kind=\"a\"");
+  BOOST_CHECK_EQUAL(&counter, &metrics.GetCounter("test_total", "kind=\"a\""));
+  counter.Increment(3);
+  metrics.GetGauge("test_depth").Set(-2);
+  metrics.GetHistogram("test_latency_us", "op=\"get\"").Record(100);
+
+  const string text = metrics.ToPrometheus();
+  LOG_GENERAL(INFO, text);
+
+  for (const auto& line :
+       {"# TYPE test_total counter\n", "test_total{kind=\"a\"} 3\n",
+        "# TYPE test_depth gauge\n", "test_depth -2\n",
+        "# TYPE test_latency_us summary\n",
+        "test_latency_us{op=\"get\",quantile=\"0.5\"} 100\n",
+        "test_latency_us_sum{op=\"get\"} 100\n",
+        "test_latency_us_count{op=\"get\"} 1\n"}) {
+    BOOST_CHECK_MESSAGE(text.find(line) != string::npos, line);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_recording_overhead) {
+  INIT_STDOUT_LOGGER();
+
+  Metrics::Histogram histogram;
+  Metrics::Histogram timerHistogram;
+
+  auto start = r_timer_start();
+  for (unsigned int i = 0; i < NUM_RECORDS; i++) {
+    histogram.Record(i & 0xFFFF);
+  }
+  const double singleNs = r_timer_end(start) * 1000 / NUM_RECORDS;
+
+  start = r_timer_start();
+  for (unsigned int i = 0; i < NUM_RECORDS; i++) {
+    Metrics::ScopedTimer timer(timerHistogram);
+  }
+  const double timerNs = r_timer_end(start) * 1000 / NUM_RECORDS;
+
+  // All threads on the same histogram, the worst case for contention
+  vector<thread> threads;
+  start = r_timer_start();
+  for (unsigned int t = 0; t < NUM_THREADS; t++) {
+    threads.emplace_back([&histogram]() {
+      for (unsigned int i = 0; i < NUM_RECORDS; i++) {
+        histogram.Record(i & 0xFFFF);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  const double contendedNs = r_timer_end(start) * 1000 / NUM_RECORDS;
+
+  LOG_GENERAL(INFO, "Record " << singleNs << " ns, ScopedTimer " << timerNs
+                              << " ns, " << NUM_THREADS
+                              << " threads contended " << contendedNs
+                              << " ns per record per thread");
+
+  // Costs depend on the machine and are only logged. What is checked is
+  // that no record is lost or torn under contention.
+  uint64_t expectedSum = 0;
+  for (unsigned int i = 0; i < NUM_RECORDS; i++) {
+    expectedSum += i & 0xFFFF;
+  }
+  const auto snapshot = histogram.GetSnapshot();
+  BOOST_CHECK_EQUAL(snapshot.m_count, (NUM_THREADS + 1) * NUM_RECORDS);
+  BOOST_CHECK_EQUAL(snapshot.m_sum, (NUM_THREADS + 1) * expectedSum);
+  BOOST_CHECK_EQUAL(snapshot.m_max, 0xFFFF);
+  BOOST_CHECK_EQUAL(timerHistogram.GetSnapshot().m_count, NUM_RECORDS);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "libUtils/DetachedFunction.h"
+#include "libUtils/Logger.h"
+#include "libUtils/Scheduler.h"
+
+#define BOOST_TEST_MODULE schedulertest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace {
+const unsigned int NUM_TIMERS = 200;
+const int64_t MAX_DELAY_MS = 200;
+
+void WaitFor(const atomic<unsigned int>& count, unsigned int target) {
+  for (unsigned int i = 0; i < 1000 && count < target; i++) {
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(schedulertest)
+
+BOOST_AUTO_TEST_CASE(test_order_and_cancel) {
+  INIT_STDOUT_LOGGER();
+
+  // A single worker runs the callbacks in deadline order
+  Scheduler scheduler(1);
+  mt19937 eng(0);
+  mutex m;
+  vector<unsigned int> fired;
+  atomic<unsigned int> count{0};
+
+  const auto start = Scheduler::Clock::now();
+  vector<Scheduler::Clock::time_point> deadlines;
+  vector<Scheduler::TimerId> ids;
+  for (unsigned int i = 0; i < NUM_TIMERS; i++) {
+    deadlines.emplace_back(start +
+                           chrono::milliseconds(eng() % MAX_DELAY_MS + 50));
+    ids.emplace_back(scheduler.ScheduleAt(
+        [i, &m, &fired, &count]() {
+          lock_guard<mutex> g(m);
+          fired.emplace_back(i);
+          count++;
+        },
+        deadlines.back()));
+    BOOST_REQUIRE_NE(ids.back(), Scheduler::INVALID_TIMER);
+  }
+  BOOST_CHECK_EQUAL(scheduler.GetNumPending(), NUM_TIMERS);
+
+  for (unsigned int i = 0; i < NUM_TIMERS; i += 3) {
+    BOOST_CHECK(scheduler.Cancel(ids[i]));
+    BOOST_CHECK(!scheduler.Cancel(ids[i]));
+  }
+  const unsigned int expected = NUM_TIMERS - (NUM_TIMERS + 2) / 3;
+
+  WaitFor(count, expected);
+  this_thread::sleep_for(chrono::milliseconds(50));
+
+  lock_guard<mutex> g(m);
+  BOOST_REQUIRE_EQUAL(fired.size(), expected);
+  for (unsigned int i = 0; i < fired.size(); i++) {
+    BOOST_CHECK_NE(fired[i] % 3, 0);
+    if (i > 0) {
+      BOOST_CHECK(deadlines[fired[i - 1]] <= deadlines[fired[i]]);
+    }
+    BOOST_CHECK(!scheduler.Cancel(ids[fired[i]]));
+  }
+  BOOST_CHECK_EQUAL(scheduler.GetNumPending(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_periodic) {
+  INIT_STDOUT_LOGGER();
+
+  Scheduler scheduler(2);
+  atomic<unsigned int> count{0};
+  const auto id = scheduler.SchedulePeriodically([&count]() { count++; }, 10);
+
+  WaitFor(count, 5);
+  BOOST_CHECK_GE(count.load(), 5);
+  BOOST_CHECK(scheduler.Cancel(id));
+
+  // At most a run already handed to a worker may still complete
+  this_thread::sleep_for(chrono::milliseconds(20));
+  const unsigned int stopped = count;
+  this_thread::sleep_for(chrono::milliseconds(100));
+  BOOST_CHECK_EQUAL(count.load(), stopped);
+  BOOST_CHECK_EQUAL(scheduler.GetNumPending(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_callback_exception) {
+  INIT_STDOUT_LOGGER();
+
+  Scheduler scheduler(1);
+  atomic<unsigned int> count{0};
+  scheduler.ScheduleAfter([]() { throw runtime_error("test"); }, 0);
+  scheduler.ScheduleAfter([&count]() { count++; }, 10);
+
+  WaitFor(count, 1);
+  BOOST_CHECK_EQUAL(count.load(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_lateness_vs_detached_sleep) {
+  INIT_STDOUT_LOGGER();
+
+  // The same timeouts, armed as timers and as sleeping detached threads
+  const auto lateness = [](bool useScheduler) {
+    Scheduler scheduler(2);
+    atomic<unsigned int> count{0};
+    atomic<int64_t> totalUs{0};
+    const auto start = Scheduler::Clock::now();
+    for (unsigned int i = 0; i < NUM_TIMERS; i++) {
+      const auto deadline = start + chrono::milliseconds(50 + i % 50);
+      auto func = [deadline, &count, &totalUs]() {
+        totalUs += chrono::duration_cast<chrono::microseconds>(
+                       Scheduler::Clock::now() - deadline)
+                       .count();
+        count++;
+      };
+      if (useScheduler) {
+        scheduler.ScheduleAt(func, deadline);
+      } else {
+        DetachedFunction(1, [deadline, func]() {
+          this_thread::sleep_until(deadline);
+          func();
+        });
+      }
+    }
+    WaitFor(count, NUM_TIMERS);
+    BOOST_REQUIRE_EQUAL(count.load(), NUM_TIMERS);
+    return totalUs.load() / NUM_TIMERS;
+  };
+
+  const int64_t threadUs = lateness(false);
+  const int64_t timerUs = lateness(true);
+  LOG_GENERAL(INFO, NUM_TIMERS << " timeouts, mean lateness: detached threads "
+                               << threadUs << " us (" << NUM_TIMERS
+                               << " threads), Scheduler " << timerUs
+                               << " us (3 threads)");
+}
+
+BOOST_AUTO_TEST_SUITE_END()